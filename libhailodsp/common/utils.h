@@ -34,6 +34,7 @@ extern "C" {
 #define MAX(a, b) (((a) > (b)) ? (a) : (b))
 
 #define ROUND_UP(N, S) ((((N) + (S)-1) / (S)) * (S))
+#define DIV_ROUND_UP(N, S) (((N) + (S)-1) / (S))
 
 __attribute__((unused)) static inline const char *format_arg_to_string(int format)
 {
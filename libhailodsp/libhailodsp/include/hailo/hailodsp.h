@@ -53,6 +53,9 @@ typedef enum {
     DSP_MAP_BUFFER_FAILED,          /**< Failed mapping buffer */
     DSP_UNMAP_BUFFER_FAILED,        /**< Failed unmapping buffer */
     DSP_SYNC_BUFFER_FAILED,         /**< Failed synching buffer */
+    DSP_IN_PROGRESS,                /**< The operation was submitted and has not completed yet */
+    DSP_OUT_OF_ATLAS_SPACE,         /**< The overlay atlas has no room for the image */
+    DSP_CANCELED,                   /**< The operation was canceled before it started */
 
     DSP_STATUS_COUNT,                  /* Must be last */
     DSP_STATUS_MAX_ENUM = DSP_MAX_ENUM /**< Max enum value to maintain ABI Integrity */
@@ -191,7 +194,14 @@ typedef enum {
  *  @{
  */
 
-/** Opaque pointer to dsp_device object. The device object holds state and data required to issue commands */
+/** Opaque pointer to dsp_device object. The device object holds state and data required to issue commands
+ * @details Thread safety: a device may be used by any number of threads at the same time. Operations, asynchronous
+ *          submissions, buffer creation and registration, and plan and command buffer creation can be issued
+ *          concurrently on the same device. Every thread submits through its own submission context, created on
+ *          its first submission to the device, so synchronous submissions of different threads do not contend on
+ *          shared state in the library. A ::dsp_cmdbuf or a ::dsp_plan object may be used by one thread at a time.
+ *          A device must not be released while other threads use it.
+ */
 typedef struct _dsp_device *dsp_device;
 
 /**
@@ -203,14 +213,154 @@ typedef struct _dsp_device *dsp_device;
  */
 dsp_status dsp_create_device(dsp_device *device);
 
+/** Driver used by a ::dsp_device to communicate with the DSP */
+typedef enum {
+    /** Selected by the HAILODSP_DRIVER environment variable ("kernel" or "emulator").
+     *  If the variable is not set, ::DSP_DRIVER_TYPE_KERNEL is used */
+    DSP_DRIVER_TYPE_DEFAULT,
+    /** The XRP kernel driver */
+    DSP_DRIVER_TYPE_KERNEL,
+    /** In-process emulation of the kernel driver, with the DSP operations executed on the CPU.
+     *  Intended for testing and benchmarking on hosts without a DSP.
+     *  The HAILODSP_EMULATOR_LATENCY_US environment variable sets a minimum duration (in microseconds) for every
+     *  command, to simulate the DSP latency.
+     *  When the HAILODSP_EMULATOR_NOOP environment variable is set to 1, imaging commands complete without being
+     *  executed, which isolates the host side cost of the library.
+     *  When the HAILODSP_EMULATOR_FAILING_SYNC environment variable is set to N, the Nth buffer cache
+     *  synchronization of the device fails, to test the error handling of the library and the application */
+    DSP_DRIVER_TYPE_EMULATOR,
+
+    /* Must be last */
+    DSP_DRIVER_TYPE_COUNT,
+    /** Max enum value to maintain ABI Integrity */
+    DSP_DRIVER_TYPE_MAX_ENUM = DSP_MAX_ENUM
+} dsp_driver_type_t;
+
+/** Priority of DSP commands
+ * @details Commands of higher priority are executed before waiting commands of lower priority. The priority selects
+ *          the XRP queue of the command, and is effective when the kernel driver is configured with several queues.
+ *          ::DSP_PRIORITY_NORMAL commands use queue 0, so a driver with a single queue runs them as before.
+ *          ::DSP_PRIORITY_HIGH commands use queue 1. ::DSP_PRIORITY_LOW commands share queue 0 with
+ *          ::DSP_PRIORITY_NORMAL, since no queue is below it.
+ */
+typedef enum {
+    /** When setting a device priority, ::DSP_PRIORITY_NORMAL. When setting a thread priority, the priority of the
+     *  device the command is issued on */
+    DSP_PRIORITY_DEFAULT,
+    /** Bulk work, such as analytics crops */
+    DSP_PRIORITY_LOW,
+    DSP_PRIORITY_NORMAL,
+    /** Latency critical work, such as live view resizes */
+    DSP_PRIORITY_HIGH,
+
+    /* Must be last */
+    DSP_PRIORITY_COUNT,
+    /** Max enum value to maintain ABI Integrity */
+    DSP_PRIORITY_MAX_ENUM = DSP_MAX_ENUM
+} dsp_priority_t;
+
+/** Device creation parameters */
+typedef struct {
+    /** Driver to use */
+    dsp_driver_type_t driver;
+    /** Index of the DSP to open, in the range [0, count) where count is returned by ::dsp_get_devices_count.
+     *  With the kernel driver, index N opens "/dev/xvpN". Ignored when #path is set */
+    uint32_t index;
+    /** Path of the kernel driver device node to open (optional, can be NULL) */
+    const char *path;
+    /** Priority of the commands issued on the device. Can be changed with ::dsp_set_device_priority */
+    dsp_priority_t priority;
+} dsp_device_params_t;
+
+/**
+ * Get the number of DSPs available to the given driver
+ *
+ * @param driver Driver to enumerate the DSPs of
+ * @param[out] count A pointer to size_t that receives the number of DSPs
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ * @note The kernel driver DSPs are "/dev/xvp0" to "/dev/xvp<count-1>". The emulator provides a single DSP, unless the
+ *       HAILODSP_EMULATOR_DEVICES environment variable sets a different number
+ */
+dsp_status dsp_get_devices_count(dsp_driver_type_t driver, size_t *count);
+
+/**
+ * Create new dsp_device object with the given parameters
+ *
+ * @param params Pointer to ::dsp_device_params_t with the device creation parameters
+ * @param[out] device A pointer to a ::dsp_device that receives the allocated device
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ * @note To release a device, call the ::dsp_release_device function with the returned ::dsp_device
+ */
+dsp_status dsp_create_device_ex(const dsp_device_params_t *params, dsp_device *device);
+
 /**
  * Release dsp_device object
  *
  * @param device A ::dsp_device to be released
  * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ * @note Waits for the submitted asynchronous operations to complete. Operations that wait for a fence queued with
+ *       ::dsp_queue_fence_wait that is not signaled yet are canceled
  */
 dsp_status dsp_release_device(dsp_device device);
 
+/**
+ * Set the priority of the commands issued on a device
+ *
+ * @param device A ::dsp_device object
+ * @param priority Priority of the commands. ::DSP_PRIORITY_DEFAULT selects ::DSP_PRIORITY_NORMAL
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ * @note Applies to commands issued after the call. Asynchronous operations keep the priority they were submitted with
+ */
+dsp_status dsp_set_device_priority(dsp_device device, dsp_priority_t priority);
+
+/**
+ * Set the priority of the commands issued by the calling thread, overriding the priority of the device
+ *
+ * @param priority Priority of the commands. ::DSP_PRIORITY_DEFAULT restores the priority of the device
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ * @note Covers all the operations of the thread, including asynchronous operations, command buffers and plans
+ */
+dsp_status dsp_set_thread_priority(dsp_priority_t priority);
+
+/** Opaque pointer to dsp_device_group object.
+ * @details A device group balances the load of operations between several devices. Each operation should be issued
+ *          on the device returned by ::dsp_device_group_select, which picks the device with the least outstanding work
+ *          (synchronous operations in progress and queued asynchronous operations) of this process. Ties are broken
+ *          by the DSP utilization reported by the devices, which also accounts for the work of other processes.
+ */
+typedef struct _dsp_device_group *dsp_device_group;
+
+/**
+ * Create new dsp_device_group object
+ *
+ * @param devices Array of the devices to balance the load between
+ * @param devices_count Number of devices in the @p devices array
+ * @param[out] group A pointer to a ::dsp_device_group that receives the allocated group
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ * @note The group does not take ownership of the devices, which must be released after the group
+ * @note To release a group, call the ::dsp_release_device_group function with the returned ::dsp_device_group
+ */
+dsp_status dsp_create_device_group(const dsp_device devices[], size_t devices_count, dsp_device_group *group);
+
+/**
+ * Select the least loaded device of a group
+ *
+ * @param group A ::dsp_device_group object
+ * @param[out] device A pointer to a ::dsp_device that receives the selected device
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ * @note Buffers created with ::dsp_create_buffer on any device of the group can be used with the selected device.
+ *       Registrations made with ::dsp_register_buffer only apply to the device they were made on
+ */
+dsp_status dsp_device_group_select(dsp_device_group group, dsp_device *device);
+
+/**
+ * Release dsp_device_group object
+ *
+ * @param group A ::dsp_device_group to be released
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ */
+dsp_status dsp_release_device_group(dsp_device_group group);
+
 /**
  *  @}
  *
@@ -234,9 +384,107 @@ dsp_status dsp_create_buffer(dsp_device device, size_t size, void **buffer);
  * @param device A ::dsp_device object
  * @param buffer The buffer to release
  * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ * @note The buffer is returned to the pool of the device it was created on, which may be another device of the
+ *       ::dsp_device_group of @p device
  */
 dsp_status dsp_release_buffer(dsp_device device, void *buffer);
 
+/** Buffers allocated ahead of time by ::dsp_configure_buffer_pool */
+typedef struct {
+    /** Buffer size, as would be passed to ::dsp_create_buffer */
+    size_t size;
+    /** Number of buffers to allocate */
+    size_t count;
+} dsp_buffer_pool_preallocation_t;
+
+/** Buffer pool configuration
+ * @details Buffers created with ::dsp_create_buffer are served from a per-device pool. Buffer sizes are rounded up to
+ *          size classes (four per power of two), and released buffers are cached for reuse by later allocations of
+ *          the same class, instead of being returned to the kernel driver.
+ *          By default, up to 64MB of released buffers are cached.
+ */
+typedef struct {
+    /** High-water mark for the total size of cached buffers. Buffers released while the pool is full are returned
+     *  to the kernel driver. 0 disables pooling */
+    size_t max_cached_bytes;
+    /** Buffers to allocate into the pool up front (optional, can be NULL). The preallocated size must not exceed
+     *  max_cached_bytes */
+    const dsp_buffer_pool_preallocation_t *preallocations;
+    /** Number of entries in #preallocations */
+    size_t preallocations_count;
+} dsp_buffer_pool_params_t;
+
+/** Buffer pool statistics */
+typedef struct {
+    /** Number of allocations served from cached buffers */
+    uint64_t hits;
+    /** Number of allocations served by the kernel driver */
+    uint64_t misses;
+    /** Number of cached buffers returned to the kernel driver, because the pool was full or was trimmed */
+    uint64_t trimmed;
+    /** Number of buffers currently cached */
+    size_t cached_buffers;
+    /** Total size of the buffers currently cached */
+    size_t cached_bytes;
+    /** Number of buffers currently allocated by the application */
+    size_t in_use_buffers;
+    /** Total size of the buffers currently allocated by the application, after rounding to size classes */
+    size_t in_use_bytes;
+    /** Highest value of #in_use_bytes */
+    size_t peak_in_use_bytes;
+} dsp_buffer_pool_stats_t;
+
+/**
+ * Configure the buffer pool of a device
+ *
+ * @param device A ::dsp_device object
+ * @param params Pool configuration. Cached buffers above the new high-water mark are released
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ */
+dsp_status dsp_configure_buffer_pool(dsp_device device, const dsp_buffer_pool_params_t *params);
+
+/**
+ * Return all the cached buffers of a device's buffer pool to the kernel driver
+ *
+ * @param device A ::dsp_device object
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ */
+dsp_status dsp_trim_buffer_pool(dsp_device device);
+
+/**
+ * Get statistics of a device's buffer pool
+ *
+ * @param device A ::dsp_device object
+ * @param[out] stats Receives the statistics
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ */
+dsp_status dsp_get_buffer_pool_stats(dsp_device device, dsp_buffer_pool_stats_t *stats);
+
+/**
+ * Register a long-lived userspace buffer with the DSP driver
+ * @details A registered buffer is pinned and mapped by the driver once. Image planes of ::DSP_MEMORY_TYPE_USERPTR
+ *          images that lie within a registered buffer are then referenced by handle, instead of being pinned and
+ *          mapped again on every operation. No change is required in the operation calls.
+ *          Registration requires a kernel driver that implements the XRP registration ioctls. The library queries
+ *          the driver on the first registration, and with older drivers the buffer keeps being passed by address.
+ *
+ * @param device A ::dsp_device object
+ * @param buffer Start of the buffer
+ * @param size Size of the buffer in bytes. Registered buffers may not overlap
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ * @note The buffer must remain allocated until it is unregistered with ::dsp_unregister_buffer
+ */
+dsp_status dsp_register_buffer(dsp_device device, void *buffer, size_t size);
+
+/**
+ * Unregister a buffer that was registered using ::dsp_register_buffer
+ *
+ * @param device A ::dsp_device object
+ * @param buffer Start of the buffer, as passed to ::dsp_register_buffer
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ */
+dsp_status dsp_unregister_buffer(dsp_device device, void *buffer);
+
 /**
  * @brief Enum representing the synchronization direction for DSP buffers.
  */
@@ -271,6 +519,102 @@ dsp_status dsp_buffer_sync_start(void *buffer, dsp_sync_direction_t direction);
  */
 dsp_status dsp_buffer_sync_end(void *buffer, dsp_sync_direction_t direction);
 
+/**
+ *  @}
+ *
+ *  @defgroup job Asynchronous Job API
+ *  @details Every operation has an asynchronous variant (suffixed with _async) that validates the parameters, submits
+ *           the operation and returns immediately with a ::dsp_job. Jobs submitted on the same ::dsp_device are
+ *           executed in submission order.
+ *  @note The images (and any other buffers) referenced by an asynchronous operation must remain valid until the job
+ *        completes. The parameter structs themselves may be released as soon as the _async function returns
+ *  @{
+ */
+
+/** Opaque pointer to dsp_job object. A job tracks the completion of an asynchronously submitted operation */
+typedef struct _dsp_job *dsp_job;
+
+/**
+ * @brief Wait for a job to complete
+ *
+ * @param job A ::dsp_job object
+ * @return The completion status of the operation. ::DSP_SUCCESS if the operation completed successfully
+ */
+dsp_status dsp_job_wait(dsp_job job);
+
+/**
+ * @brief Check whether a job has completed, without blocking
+ *
+ * @param job A ::dsp_job object
+ * @return ::DSP_IN_PROGRESS if the operation has not completed yet. Otherwise, the completion status of the operation
+ */
+dsp_status dsp_job_poll(dsp_job job);
+
+/**
+ * @brief Get a file descriptor that becomes readable when the job completes
+ * @details The file descriptor can be used with poll/select/epoll to wait on several jobs (or other events) at once
+ *
+ * @param job A ::dsp_job object
+ * @param[out] fd A pointer to int that receives the file descriptor
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ * @note The file descriptor is owned by the job and is closed by ::dsp_job_release
+ */
+dsp_status dsp_job_get_fd(dsp_job job, int *fd);
+
+/**
+ * @brief Release dsp_job object
+ * @details If the job has not completed yet, the function waits for it to complete
+ *
+ * @param job A ::dsp_job to be released
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ */
+dsp_status dsp_job_release(dsp_job job);
+
+/**
+ * @brief Get a completion fence of a job
+ * @details The fence is a file descriptor that becomes readable (POLLIN) when the job completes, like a sync_file
+ *          fence. Unlike the file descriptor returned by ::dsp_job_get_fd, the fence is owned by the caller and
+ *          remains valid after the job is released, so it can be handed over to the consumer of the job outputs,
+ *          e.g. an encoder thread, together with the output dma-bufs.
+ *
+ * @param job A ::dsp_job object
+ * @param[out] fence A pointer to int that receives the fence
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ * @note The XRP driver does not create sync_file fences, so the fence can only be waited on with poll/select/epoll.
+ *       It must not be read from, and can't be passed to kernel APIs that expect a sync_file
+ * @note The fence must be closed by the caller
+ */
+dsp_status dsp_job_get_fence(dsp_job job, int *fence);
+
+/**
+ * @brief Make the next job of the calling thread on a device wait for a fence
+ * @details The next asynchronous operation submitted on @p device by the calling thread does not start before
+ *          @p fence is signaled (becomes readable). The later operations of the thread keep their order behind it.
+ *          Operations of other threads are not held back. Any pollable file descriptor can be used, including
+ *          sync_file fences of dma-buf producers and fences returned by ::dsp_job_get_fence of other devices. The
+ *          calling thread does not block.
+ *
+ * @param device A ::dsp_device object
+ * @param fence The fence to wait for. The fence is duplicated, and may be closed by the caller once the function
+ *              returns
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ * @note Synchronous operations, command buffers and plans are not ordered against the fence
+ * @note A fence in an error state (POLLERR) is treated as signaled
+ * @note ::dsp_release_device does not wait for the fences. The operations still waiting for a fence complete with
+ *       ::DSP_CANCELED
+ */
+dsp_status dsp_queue_fence_wait(dsp_device device, int fence);
+
+/**
+ * @brief Release a dsp_job object without waiting for it to complete
+ * @details The job is released automatically once it completes. Together with ::dsp_job_get_fence, this lets a
+ *          producer thread submit operations without ever blocking on the DSP.
+ *
+ * @param job A ::dsp_job to be released. It must not be used after the call
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ */
+dsp_status dsp_job_detach(dsp_job job);
+
 /**
  *  @}
  *
@@ -316,6 +660,19 @@ typedef struct {
     dsp_interpolation_type_t interpolation;
 } dsp_multi_resize_params_t;
 
+/** Multi-Resize parameters for any number of outputs */
+typedef struct {
+    /** Image metadata for source image. Image data will not change */
+    const dsp_image_properties_t *src;
+    /** Array of #dst_count destination images, with the format rules of ::dsp_multi_crop_and_resize */
+    const dsp_image_properties_t *const *dst;
+    /** Number of entries in #dst. Must be at least 1 */
+    size_t dst_count;
+    /** Interpolation method to use.
+     *  Only ::INTERPOLATION_TYPE_BILINEAR and ::INTERPOLATION_TYPE_BICUBIC are supported. */
+    dsp_interpolation_type_t interpolation;
+} dsp_multi_resize_list_params_t;
+
 /** Privacy-Mask parameters */
 typedef struct {
     /**
@@ -325,6 +682,7 @@ typedef struct {
      * e.g. a bitmask for a 4K image should be 120x540 bytes in size
      * @note The stride of the bitmask should be divisible by 8, so padding may be required.
      * This padding is ignored and only the actual bitmask width is used
+     * @note ::dsp_privacy_mask_build_from_polygons and ::dsp_privacy_mask_build_from_mask build the bitmask and ROIs
      */
     uint8_t *bitmask;
 
@@ -338,17 +696,123 @@ typedef struct {
      * Polygon. This will allow the DSP to ignore coloring the pixels outside the ROI, and thus improve performance. For
      * simpler (and slower) usage, it is possible to pass 1 ROI which covers the entire image
      * @note The ROI coordinates are for a 4x4 quantized image
-     * @note Supports between 1 and 8 \p rois
+     * @note At least 1 ROI is required. Up to ::DSP_PRIVACY_MASK_MAX_ROIS (8) ROIs are passed to the DSP as is.
+     * @note Behavior change: more than 8 ROIs used to be rejected with ::DSP_INVALID_ARGUMENT. They are now accepted
+     *       and merged into 8 bounding boxes, so set bitmask bits outside the given ROIs but inside the merged boxes
+     *       are colored as well. A bitmask that is clear outside the ROIs, such as the ones built by
+     *       ::dsp_privacy_mask_build_from_polygons, is colored the same either way
      */
     dsp_roi_t *rois;
     size_t rois_count;
 } dsp_privacy_mask_t;
 
+/** Tensor layout */
+typedef enum {
+    /** Interleaved channels: element (y, x, c) is at y * bytesperline + (x * 3 + c) * element size */
+    DSP_TENSOR_LAYOUT_NHWC,
+    /** Planar channels: element (c, y, x) is at (c * height + y) * bytesperline + x * element size */
+    DSP_TENSOR_LAYOUT_NCHW,
+
+    /* Must be last */
+    DSP_TENSOR_LAYOUT_COUNT,
+    /** Max enum value to maintain ABI Integrity */
+    DSP_TENSOR_LAYOUT_MAX_ENUM = DSP_MAX_ENUM
+} dsp_tensor_layout_t;
+
+/** Order of the color channels of a tensor */
+typedef enum {
+    DSP_TENSOR_CHANNEL_ORDER_RGB, /**< Channel 0 is red */
+    DSP_TENSOR_CHANNEL_ORDER_BGR, /**< Channel 0 is blue */
+
+    /* Must be last */
+    DSP_TENSOR_CHANNEL_ORDER_COUNT,
+    /** Max enum value to maintain ABI Integrity */
+    DSP_TENSOR_CHANNEL_ORDER_MAX_ENUM = DSP_MAX_ENUM
+} dsp_tensor_channel_order_t;
+
+/** Data type of tensor elements */
+typedef enum {
+    DSP_TENSOR_DATA_TYPE_UINT8,   /**< Quantized unsigned 8bit, saturated to [0, 255] */
+    DSP_TENSOR_DATA_TYPE_INT8,    /**< Quantized signed 8bit, saturated to [-128, 127] */
+    DSP_TENSOR_DATA_TYPE_FLOAT16, /**< IEEE 754 half precision */
+
+    /* Must be last */
+    DSP_TENSOR_DATA_TYPE_COUNT,
+    /** Max enum value to maintain ABI Integrity */
+    DSP_TENSOR_DATA_TYPE_MAX_ENUM = DSP_MAX_ENUM
+} dsp_tensor_data_type_t;
+
+/**
+ * Neural network input tensor of 3 color channels (N = 1)
+ * @details Every element is computed from the RGB pixel value p (in the range [0, 255]) of its channel as
+ *          value = (p - mean[c]) / std[c]. Quantized data types store round(value / quant_scale) + quant_zero_point,
+ *          saturated to the range of the data type. ::DSP_TENSOR_DATA_TYPE_FLOAT16 stores the value itself
+ */
+typedef struct {
+    /** Number of elements in each row */
+    size_t width;
+    /** Number of rows */
+    size_t height;
+    /** Tensor layout */
+    dsp_tensor_layout_t layout;
+    /** Channel order of the tensor. #mean and #std are given in the same order */
+    dsp_tensor_channel_order_t channel_order;
+    /** Element data type */
+    dsp_tensor_data_type_t data_type;
+    /** Per-channel mean, in pixel units */
+    float mean[3];
+    /** Per-channel standard deviation, in pixel units. Must not be 0 */
+    float std[3];
+    /** Quantization scale of quantized data types. Must be positive. Ignored for ::DSP_TENSOR_DATA_TYPE_FLOAT16 */
+    float quant_scale;
+    /** Quantization zero point of quantized data types. Ignored for ::DSP_TENSOR_DATA_TYPE_FLOAT16 */
+    int32_t quant_zero_point;
+    /** Tensor data. bytesperline is the distance between rows (of the same channel, for ::DSP_TENSOR_LAYOUT_NCHW) */
+    dsp_data_plane_t plane;
+    /** Tensor data memory type. For more information, refer to ::dsp_data_plane_t */
+    dsp_memory_type_t memory;
+} dsp_tensor_t;
+
+/** Resize to tensor parameters */
+typedef struct {
+    /** Image metadata for source image. Image data will not change */
+    const dsp_image_properties_t *src;
+    /** Destination tensor. Specify the required size in the tensor metadata */
+    const dsp_tensor_t *dst;
+    /** Interpolation method to use */
+    dsp_interpolation_type_t interpolation;
+} dsp_tensor_resize_params_t;
+
+/** Maximum number of ROIs supported in ::dsp_batch_crop_and_resize */
+#define DSP_BATCH_RESIZE_MAX_ROIS (256)
+
+/** Batch crop&resize parameters */
+typedef struct {
+    /** Image metadata for source image. Image data will not change */
+    const dsp_image_properties_t *src;
+    /** Array of crop regions, one per output */
+    const dsp_roi_t *rois;
+    /** Number of entries in #rois. Supports between 1 and ::DSP_BATCH_RESIZE_MAX_ROIS ROIs */
+    size_t rois_count;
+    /** Array of #rois_count destination images, one per ROI, with the format rules of ::dsp_crop_and_resize.
+     *  Must be NULL when #dst_tensor is used */
+    const dsp_image_properties_t *const *dst;
+    /** Batch tensor destination, used instead of #dst. The tensor metadata describes a single tensor of the batch,
+     *  and ROI i is written at an offset of i * bytesperline * rows from its data, where rows is height for
+     *  ::DSP_TENSOR_LAYOUT_NHWC and 3 * height for ::DSP_TENSOR_LAYOUT_NCHW. The plane bytesused must cover all
+     *  #rois_count tensors */
+    const dsp_tensor_t *dst_tensor;
+    /** Interpolation method to use */
+    dsp_interpolation_type_t interpolation;
+} dsp_batch_resize_params_t;
+
 /**
  * @brief Perform resize operation
  * @details The function resizes the image down to or up to the specified size
  *          Supported formats of the operation are ::DSP_IMAGE_FORMAT_GRAY8, ::DSP_IMAGE_FORMAT_RGB and
- *          ::DSP_IMAGE_FORMAT_NV12. The formats of the src image and dst image must be identical
+ *          ::DSP_IMAGE_FORMAT_NV12. The formats of the src image and dst image must be identical, except for
+ *          ::DSP_IMAGE_FORMAT_NV12 to ::DSP_IMAGE_FORMAT_RGB and ::DSP_IMAGE_FORMAT_RGB to ::DSP_IMAGE_FORMAT_NV12,
+ *          which are converted in the same pass (see ::dsp_convert_format for the color conversion)
  * @param device A ::dsp_device object
  * @param resize_params Pointer to ::dsp_resize_params_t with the required resize parameters
  * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
@@ -359,7 +823,9 @@ dsp_status dsp_resize(dsp_device device, const dsp_resize_params_t *resize_param
  * @brief Perform crop&resize operation
  * @details Perform crop operation on an image and then resize the cropped image to the specified size.
  *          Supported formats of the operation are ::DSP_IMAGE_FORMAT_GRAY8, ::DSP_IMAGE_FORMAT_RGB and
- *          ::DSP_IMAGE_FORMAT_NV12. The formats of the src image and dst image must be identical
+ *          ::DSP_IMAGE_FORMAT_NV12. The formats of the src image and dst image must be identical, except for
+ *          ::DSP_IMAGE_FORMAT_NV12 to ::DSP_IMAGE_FORMAT_RGB and ::DSP_IMAGE_FORMAT_RGB to ::DSP_IMAGE_FORMAT_NV12,
+ *          which are converted in the same pass (see ::dsp_convert_format for the color conversion)
  * @param device A ::dsp_device object
  * @param resize_params Pointer to ::dsp_resize_params_t with the required resize parameters
  * @param crop_params Pointer to ::dsp_roi_t with the required crop parameters
@@ -369,11 +835,33 @@ dsp_status dsp_crop_and_resize(dsp_device device,
                                const dsp_resize_params_t *resize_params,
                                const dsp_roi_t *crop_params);
 
+/**
+ * @brief Perform privacy mask and crop&resize operation
+ * @details Same as ::dsp_crop_and_resize, with the privacy mask applied to the src image before it is resized. The
+ *          src image itself is not modified. Only the masked ROIs of the privacy mask are scanned, so the mask costs
+ *          little when it covers a small part of the image. The src image must be ::DSP_IMAGE_FORMAT_NV12, and the
+ *          dst image may be ::DSP_IMAGE_FORMAT_NV12 or ::DSP_IMAGE_FORMAT_RGB
+ * @param device A ::dsp_device object
+ * @param resize_params Pointer to ::dsp_resize_params_t with the required resize parameters
+ * @param crop_params Pointer to ::dsp_roi_t with the required crop parameters
+ * @param privacy_mask_params Pointer to ::dsp_privacy_mask_t with the required privacy mask parameters, for the size
+ *                            of the src image
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ */
+dsp_status dsp_crop_and_resize_privacy_mask(dsp_device device,
+                                            const dsp_resize_params_t *resize_params,
+                                            const dsp_roi_t *crop_params,
+                                            const dsp_privacy_mask_t *privacy_mask_params);
+
 /**
  * @brief Perform multi crop&resize operation
  * @details Perform crop operation on an image and then resize the cropped image to the specified sizes.
- *          Supported format of the operation is ::DSP_IMAGE_FORMAT_NV12.
- *          The formats of the src image and dst image must be identical.
+ *          The src image is read once for all the dst images.
+ *          The src image format may be ::DSP_IMAGE_FORMAT_NV12, ::DSP_IMAGE_FORMAT_GRAY8 or ::DSP_IMAGE_FORMAT_RGB.
+ *          Every dst image has the src format, or is converted while resizing between ::DSP_IMAGE_FORMAT_NV12 and
+ *          ::DSP_IMAGE_FORMAT_RGB, so a single operation can produce both encoder and inference inputs.
+ * @note ::DSP_IMAGE_FORMAT_GRAY8 and ::DSP_IMAGE_FORMAT_RGB sources, like converted dst images, require a DSP firmware
+ *       with the converting multi crop&resize operation
  * @param device A ::dsp_device object
  * @param resize_params Pointer to ::dsp_multi_resize_params_t with the required resize parameters
  * @param crop_params Pointer to ::dsp_roi_t with the required crop parameters
@@ -387,7 +875,7 @@ dsp_status dsp_multi_crop_and_resize(dsp_device device,
  * @brief Apply a privacy mask and perform multi crop&resize operation
  * @details Same as ::dsp_multi_crop_and_resize, but before performing the crop&resize,
  *          a privacy mask is applied to the source image (the image is unmodified)
- *          Every output preserves the privacy mask
+ *          Every output preserves the privacy mask. The src image format must be ::DSP_IMAGE_FORMAT_NV12
  * @param device A ::dsp_device object
  * @param resize_params Pointer to ::dsp_multi_resize_params_t with the required resize parameters
  * @param crop_params Pointer to ::dsp_roi_t with the required crop parameters
@@ -398,77 +886,824 @@ dsp_status dsp_multi_crop_and_resize_privacy_mask(dsp_device device,
                                                   const dsp_multi_resize_params_t *resize_params,
                                                   const dsp_roi_t *crop_params,
                                                   const dsp_privacy_mask_t *privacy_mask_params);
+
 /**
- *  @}
- *
- *  @defgroup blend Blend API
- *  @{
+ * @brief Perform multi crop&resize operation with any number of outputs
+ * @details Same as ::dsp_multi_crop_and_resize and ::dsp_multi_crop_and_resize_privacy_mask, but with any number of
+ *          outputs. Outputs are resized in groups of up to ::DSP_MULTI_RESIZE_OUTPUTS_COUNT, each group reading the
+ *          source once, and all groups are submitted back to back as a single command
+ * @param device A ::dsp_device object
+ * @param resize_params Pointer to ::dsp_multi_resize_list_params_t with the required resize parameters
+ * @param crop_params Pointer to ::dsp_roi_t with the required crop parameters
+ * @param privacy_mask_params Pointer to ::dsp_privacy_mask_t with the required privacy mask parameters, or NULL
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
  */
+dsp_status dsp_multi_crop_and_resize_list(dsp_device device,
+                                          const dsp_multi_resize_list_params_t *resize_params,
+                                          const dsp_roi_t *crop_params,
+                                          const dsp_privacy_mask_t *privacy_mask_params);
 
-/** Overlay parameters */
-typedef struct {
-    /** Overlay image to blend. Only ::DSP_IMAGE_FORMAT_A420 format is supported */
-    dsp_image_properties_t overlay;
-    /** Offset in the horizontal axis to place the blended overlay */
-    size_t x_offset;
-    /** Offset in the vertical axis to place the blended overlay */
-    size_t y_offset;
-} dsp_overlay_properties_t;
+/**
+ * @brief Perform crop&resize operation into a neural network input tensor
+ * @details Crop and resize an image, and write it as a normalized and quantized tensor in a single operation,
+ *          without an intermediate image. See ::dsp_tensor_t for the computation of the tensor elements.
+ *          Supported formats of the src image are ::DSP_IMAGE_FORMAT_RGB and ::DSP_IMAGE_FORMAT_NV12
+ * @param device A ::dsp_device object
+ * @param resize_params Pointer to ::dsp_tensor_resize_params_t with the required resize parameters
+ * @param crop_params Pointer to ::dsp_roi_t with the required crop parameters
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ */
+dsp_status dsp_crop_and_resize_to_tensor(dsp_device device,
+                                         const dsp_tensor_resize_params_t *resize_params,
+                                         const dsp_roi_t *crop_params);
 
 /**
- * @brief Perform alpha blend operation
- * @details Alpha blend an array of overlay images into a base image.
- *          The base image data is overwritten with the alpha blend result
+ * @brief Perform crop&resize of many regions of one image
+ * @details Crop each ROI of the source image and resize it into its own destination image, or into its own tensor of
+ *          a contiguous batch tensor. All the ROIs are submitted to the DSP as a single command
  * @param device A ::dsp_device object
- * @param image A base image to alpha blend the overlays into. Only ::DSP_IMAGE_FORMAT_NV12 format is supported
- * @param overlays An array of overlays to alpha blend into the base image
- * @param overlays_count \p overlays array size
+ * @param resize_params Pointer to ::dsp_batch_resize_params_t with the required resize parameters
  * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
- * @note The operation supports up to 50 \p overlays
  */
-dsp_status dsp_blend(dsp_device device,
-                     const dsp_image_properties_t *image, // image data is overwritten
-                     const dsp_overlay_properties_t overlays[],
-                     size_t overlays_count);
+dsp_status dsp_batch_crop_and_resize(dsp_device device, const dsp_batch_resize_params_t *resize_params);
 
 /**
- *  @}
- *
- *  @defgroup blur Blur API
- *  @{
+ * @brief Submit resize operation asynchronously
+ * @details Same as ::dsp_resize, but returns once the operation is submitted
+ * @param device A ::dsp_device object
+ * @param resize_params Pointer to ::dsp_resize_params_t with the required resize parameters
+ * @param[out] job A pointer to a ::dsp_job that receives the submitted job
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ * @note To release the job, call ::dsp_job_release with the returned ::dsp_job
  */
+dsp_status dsp_resize_async(dsp_device device, const dsp_resize_params_t *resize_params, dsp_job *job);
 
 /**
- * Blur region of interest (ROI) parameters
- * @note This typedef is for backwards compatibility only. Use ::dsp_roi_t instead
+ * @brief Submit crop&resize operation asynchronously
+ * @details Same as ::dsp_crop_and_resize, but returns once the operation is submitted
+ * @param device A ::dsp_device object
+ * @param resize_params Pointer to ::dsp_resize_params_t with the required resize parameters
+ * @param crop_params Pointer to ::dsp_roi_t with the required crop parameters
+ * @param[out] job A pointer to a ::dsp_job that receives the submitted job
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ * @note To release the job, call ::dsp_job_release with the returned ::dsp_job
  */
-typedef dsp_roi_t dsp_blur_roi_t;
+dsp_status dsp_crop_and_resize_async(dsp_device device,
+                                     const dsp_resize_params_t *resize_params,
+                                     const dsp_roi_t *crop_params,
+                                     dsp_job *job);
 
 /**
- * @brief Perform box blur operation
- * @details Box blur (filter) an array of regions of interet (ROIs) in a base image.
- *          The base image data is overwritten with the blurred result.
- *          Supported formats are ::DSP_IMAGE_FORMAT_GRAY8 and ::DSP_IMAGE_FORMAT_NV12
+ * @brief Submit privacy mask and crop&resize operation asynchronously
+ * @details Same as ::dsp_crop_and_resize_privacy_mask, but returns once the operation is submitted
  * @param device A ::dsp_device object
- * @param image A base image to blur
- * @param rois An array of ROIs to blur in the base image
- * @param rois_count \p rois array size
- * @param kernel_size blurring kernel (matrix) size
- *                    odd number between 1 and 33
+ * @param resize_params Pointer to ::dsp_resize_params_t with the required resize parameters
+ * @param crop_params Pointer to ::dsp_roi_t with the required crop parameters
+ * @param privacy_mask_params Pointer to ::dsp_privacy_mask_t with the required privacy mask parameters
+ * @param[out] job A pointer to a ::dsp_job that receives the submitted job
  * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
- * @note The operation supports up to 80 \p ROIs
+ * @note To release the job, call ::dsp_job_release with the returned ::dsp_job
  */
-dsp_status dsp_blur(dsp_device device,
-                    dsp_image_properties_t *image,
-                    const dsp_roi_t rois[],
-                    size_t rois_count,
-                    uint32_t kernel_size);
+dsp_status dsp_crop_and_resize_privacy_mask_async(dsp_device device,
+                                                  const dsp_resize_params_t *resize_params,
+                                                  const dsp_roi_t *crop_params,
+                                                  const dsp_privacy_mask_t *privacy_mask_params,
+                                                  dsp_job *job);
 
 /**
- *  @}
- *
- *  @defgroup convert Format Conversion API
- *  @{
+ * @brief Submit multi crop&resize operation asynchronously
+ * @details Same as ::dsp_multi_crop_and_resize, but returns once the operation is submitted
+ * @param device A ::dsp_device object
+ * @param resize_params Pointer to ::dsp_multi_resize_params_t with the required resize parameters
+ * @param crop_params Pointer to ::dsp_roi_t with the required crop parameters
+ * @param[out] job A pointer to a ::dsp_job that receives the submitted job
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ * @note To release the job, call ::dsp_job_release with the returned ::dsp_job
+ */
+dsp_status dsp_multi_crop_and_resize_async(dsp_device device,
+                                           const dsp_multi_resize_params_t *resize_params,
+                                           const dsp_roi_t *crop_params,
+                                           dsp_job *job);
+
+/**
+ * @brief Submit privacy mask and multi crop&resize operation asynchronously
+ * @details Same as ::dsp_multi_crop_and_resize_privacy_mask, but returns once the operation is submitted
+ * @param device A ::dsp_device object
+ * @param resize_params Pointer to ::dsp_multi_resize_params_t with the required resize parameters
+ * @param crop_params Pointer to ::dsp_roi_t with the required crop parameters
+ * @param privacy_mask_params Pointer to ::dsp_privacy_mask_t with the required privacy mask parameters
+ * @param[out] job A pointer to a ::dsp_job that receives the submitted job
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ * @note The privacy mask bitmask must remain valid until the job completes
+ */
+dsp_status dsp_multi_crop_and_resize_privacy_mask_async(dsp_device device,
+                                                        const dsp_multi_resize_params_t *resize_params,
+                                                        const dsp_roi_t *crop_params,
+                                                        const dsp_privacy_mask_t *privacy_mask_params,
+                                                        dsp_job *job);
+
+/**
+ * @brief Submit multi crop&resize operation with any number of outputs asynchronously
+ * @details Same as ::dsp_multi_crop_and_resize_list, but returns once the operation is submitted
+ * @param device A ::dsp_device object
+ * @param resize_params Pointer to ::dsp_multi_resize_list_params_t with the required resize parameters
+ * @param crop_params Pointer to ::dsp_roi_t with the required crop parameters
+ * @param privacy_mask_params Pointer to ::dsp_privacy_mask_t with the required privacy mask parameters, or NULL
+ * @param[out] job A pointer to a ::dsp_job that receives the submitted job
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ * @note The privacy mask bitmask must remain valid until the job completes
+ */
+dsp_status dsp_multi_crop_and_resize_list_async(dsp_device device,
+                                                const dsp_multi_resize_list_params_t *resize_params,
+                                                const dsp_roi_t *crop_params,
+                                                const dsp_privacy_mask_t *privacy_mask_params,
+                                                dsp_job *job);
+
+/**
+ * @brief Submit crop&resize into a tensor operation asynchronously
+ * @details Same as ::dsp_crop_and_resize_to_tensor, but returns once the operation is submitted
+ * @param device A ::dsp_device object
+ * @param resize_params Pointer to ::dsp_tensor_resize_params_t with the required resize parameters
+ * @param crop_params Pointer to ::dsp_roi_t with the required crop parameters
+ * @param[out] job A pointer to a ::dsp_job that receives the submitted job
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ * @note The tensor data must remain valid until the job completes
+ */
+dsp_status dsp_crop_and_resize_to_tensor_async(dsp_device device,
+                                               const dsp_tensor_resize_params_t *resize_params,
+                                               const dsp_roi_t *crop_params,
+                                               dsp_job *job);
+
+/**
+ * @brief Submit batch crop&resize operation asynchronously
+ * @details Same as ::dsp_batch_crop_and_resize, but returns once the operation is submitted.
+ *          The ROIs array is copied, and may be released once the function returns
+ * @param device A ::dsp_device object
+ * @param resize_params Pointer to ::dsp_batch_resize_params_t with the required resize parameters
+ * @param[out] job A pointer to a ::dsp_job that receives the submitted job
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ * @note To release the job, call ::dsp_job_release with the returned ::dsp_job
+ */
+dsp_status dsp_batch_crop_and_resize_async(dsp_device device,
+                                           const dsp_batch_resize_params_t *resize_params,
+                                           dsp_job *job);
+/**
+ *  @}
+ *
+ *  @defgroup privacy_mask Privacy Mask API
+ *  @brief Host side helpers that build the bitmask and ROIs of a ::dsp_privacy_mask_t
+ *  @{
+ */
+
+/** Maximum number of privacy mask ROIs handled by the DSP in a single operation */
+#define DSP_PRIVACY_MASK_MAX_ROIS (8)
+
+/** A point in an image, in pixel units */
+typedef struct {
+    size_t x;
+    size_t y;
+} dsp_point_t;
+
+/** A closed polygon. The last point is connected to the first one */
+typedef struct {
+    const dsp_point_t *points;
+    /** Number of entries in #points. Must be at least 3 */
+    size_t points_count;
+} dsp_polygon_t;
+
+/**
+ * @brief Get the size of the privacy mask bitmask of an image
+ * @details The bitmask has a bit per 4x4 pixels of the image, with a line stride that is a multiple of 8 bytes
+ * @param image_width Width of the image in pixels
+ * @param image_height Height of the image in pixels
+ * @param[out] bitmask_size The size of the bitmask in bytes
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ */
+dsp_status dsp_privacy_mask_get_bitmask_size(size_t image_width, size_t image_height, size_t *bitmask_size);
+
+/**
+ * @brief Build a privacy mask from polygons
+ * @details Rasterizes the polygons into the bitmask of ::dsp_privacy_mask_t, and computes ROIs that tightly surround
+ *          the masked regions. A pixel is masked when its center is inside a polygon (even-odd rule), and a bitmask
+ *          bit is set when any of the 4x4 pixels that it covers is masked. The whole bitmask is written, including
+ *          the line padding
+ * @param image_width Width of the image in pixels
+ * @param image_height Height of the image in pixels
+ * @param polygons Array of polygons to rasterize
+ * @param polygons_count Number of entries in polygons
+ * @param[out] bitmask Bitmask to write, of the size returned by ::dsp_privacy_mask_get_bitmask_size
+ * @param bitmask_size Size of bitmask in bytes
+ * @param[out] rois Array of ::DSP_PRIVACY_MASK_MAX_ROIS ROIs to write
+ * @param[out] rois_count The number of ROIs written. At least 1 ROI is always written, so the result can be passed
+ *             as is to the privacy mask operations, even if nothing is masked
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ */
+dsp_status dsp_privacy_mask_build_from_polygons(size_t image_width,
+                                                size_t image_height,
+                                                const dsp_polygon_t polygons[],
+                                                size_t polygons_count,
+                                                uint8_t *bitmask,
+                                                size_t bitmask_size,
+                                                dsp_roi_t rois[DSP_PRIVACY_MASK_MAX_ROIS],
+                                                size_t *rois_count);
+
+/**
+ * @brief Build a privacy mask from a per-pixel mask
+ * @details Packs a segmentation mask into the bitmask of ::dsp_privacy_mask_t, and computes ROIs that tightly surround
+ *          the masked regions. A pixel is masked when its mask value is not 0, and a bitmask bit is set when any of the
+ *          4x4 pixels that it covers is masked. The whole bitmask is written, including the line padding
+ * @param mask The mask image, of the size of the image to mask. Only ::DSP_IMAGE_FORMAT_GRAY8 format and
+ *             ::DSP_MEMORY_TYPE_USERPTR memory are supported
+ * @param[out] bitmask Bitmask to write, of the size returned by ::dsp_privacy_mask_get_bitmask_size
+ * @param bitmask_size Size of bitmask in bytes
+ * @param[out] rois Array of ::DSP_PRIVACY_MASK_MAX_ROIS ROIs to write
+ * @param[out] rois_count The number of ROIs written. At least 1 ROI is always written
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ */
+dsp_status dsp_privacy_mask_build_from_mask(const dsp_image_properties_t *mask,
+                                            uint8_t *bitmask,
+                                            size_t bitmask_size,
+                                            dsp_roi_t rois[DSP_PRIVACY_MASK_MAX_ROIS],
+                                            size_t *rois_count);
+
+/**
+ * Opaque pointer to dsp_privacy_mask object. A privacy mask object keeps its bitmask in a registered DSP buffer, so
+ * a mask that rarely changes is neither uploaded nor mapped again on every operation
+ */
+typedef struct _dsp_privacy_mask *dsp_privacy_mask;
+
+/**
+ * Create new dsp_privacy_mask object, with an empty mask
+ * @param device A ::dsp_device object. The mask may be used by operations on this device only
+ * @param image_width Width in pixels of the images to mask
+ * @param image_height Height in pixels of the images to mask
+ * @param y_color Y component of the mask color
+ * @param u_color U component of the mask color
+ * @param v_color V component of the mask color
+ * @param[out] privacy_mask A pointer to a ::dsp_privacy_mask that receives the allocated privacy mask
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ * @note To release a privacy mask, call the ::dsp_release_privacy_mask function with the returned ::dsp_privacy_mask
+ */
+dsp_status dsp_create_privacy_mask(dsp_device device,
+                                   size_t image_width,
+                                   size_t image_height,
+                                   uint8_t y_color,
+                                   uint8_t u_color,
+                                   uint8_t v_color,
+                                   dsp_privacy_mask *privacy_mask);
+
+/**
+ * Release dsp_privacy_mask object
+ * @param privacy_mask A ::dsp_privacy_mask to be released
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ */
+dsp_status dsp_release_privacy_mask(dsp_privacy_mask privacy_mask);
+
+/**
+ * @brief Replace the mask with polygons
+ * @details Same rasterization as ::dsp_privacy_mask_build_from_polygons. Only the bitmask lines that changed are
+ *          written to the DSP buffer, and the ROIs are recomputed
+ * @param privacy_mask A ::dsp_privacy_mask object
+ * @param polygons Array of polygons to rasterize
+ * @param polygons_count Number of entries in polygons
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ * @note The mask may not be updated while operations that use it are in progress
+ */
+dsp_status dsp_privacy_mask_update_polygons(dsp_privacy_mask privacy_mask,
+                                            const dsp_polygon_t polygons[],
+                                            size_t polygons_count);
+
+/**
+ * @brief Replace the mask with a per-pixel mask
+ * @details Same packing as ::dsp_privacy_mask_build_from_mask. Only the bitmask lines that changed are written to
+ *          the DSP buffer, and the ROIs are recomputed
+ * @param privacy_mask A ::dsp_privacy_mask object
+ * @param mask The mask image, of the size that the privacy mask was created with
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ * @note The mask may not be updated while operations that use it are in progress
+ */
+dsp_status dsp_privacy_mask_update_mask(dsp_privacy_mask privacy_mask, const dsp_image_properties_t *mask);
+
+/**
+ * @brief Replace the mask with a ready bitmask
+ * @details Only the bitmask lines that changed are written to the DSP buffer, and the ROIs are recomputed
+ * @param privacy_mask A ::dsp_privacy_mask object
+ * @param bitmask Bitmask in the layout of ::dsp_privacy_mask_t, of the size returned by
+ *                ::dsp_privacy_mask_get_bitmask_size for the image size of the privacy mask
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ * @note The mask may not be updated while operations that use it are in progress
+ */
+dsp_status dsp_privacy_mask_update_bitmask(dsp_privacy_mask privacy_mask, const uint8_t *bitmask);
+
+/**
+ * @brief Get the privacy mask parameters of a privacy mask object
+ * @details The parameters reference the DSP buffer and the ROIs of the object, and can be passed to every operation
+ *          that takes a ::dsp_privacy_mask_t, such as ::dsp_multi_crop_and_resize_privacy_mask. The bitmask is then
+ *          referenced by handle, with no upload or mapping
+ * @param privacy_mask A ::dsp_privacy_mask object
+ * @param[out] params Receives the privacy mask parameters. They remain valid until the next update of the mask
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ */
+dsp_status dsp_privacy_mask_get_params(dsp_privacy_mask privacy_mask, dsp_privacy_mask_t *params);
+
+/**
+ * @brief Apply a privacy mask to an image in place
+ * @details The masked pixels of the image are painted with the colors of the privacy mask. Only the masked ROIs of
+ *          the privacy mask are scanned, and the rest of the image is not touched. The image must be
+ *          ::DSP_IMAGE_FORMAT_NV12
+ * @param device A ::dsp_device object
+ * @param image Pointer to ::dsp_image_properties_t with the image to mask
+ * @param privacy_mask_params Pointer to ::dsp_privacy_mask_t with the required privacy mask parameters, for the size
+ *                            of the image
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ */
+dsp_status dsp_apply_privacy_mask(dsp_device device,
+                                  dsp_image_properties_t *image,
+                                  const dsp_privacy_mask_t *privacy_mask_params);
+
+/**
+ * @brief Submit privacy mask operation asynchronously
+ * @details Same as ::dsp_apply_privacy_mask, but returns once the operation is submitted
+ * @param device A ::dsp_device object
+ * @param image Pointer to ::dsp_image_properties_t with the image to mask
+ * @param privacy_mask_params Pointer to ::dsp_privacy_mask_t with the required privacy mask parameters
+ * @param[out] job A pointer to a ::dsp_job that receives the submitted job
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ * @note To release the job, call ::dsp_job_release with the returned ::dsp_job
+ */
+dsp_status dsp_apply_privacy_mask_async(dsp_device device,
+                                        dsp_image_properties_t *image,
+                                        const dsp_privacy_mask_t *privacy_mask_params,
+                                        dsp_job *job);
+/**
+ *  @}
+ *
+ *  @defgroup blend Blend API
+ *  @{
+ */
+
+/** Overlay parameters */
+typedef struct {
+    /** Overlay image to blend. Only ::DSP_IMAGE_FORMAT_A420 format is supported */
+    dsp_image_properties_t overlay;
+    /** Offset in the horizontal axis to place the blended overlay */
+    size_t x_offset;
+    /** Offset in the vertical axis to place the blended overlay */
+    size_t y_offset;
+} dsp_overlay_properties_t;
+
+/**
+ * @brief Perform alpha blend operation
+ * @details Alpha blend an array of overlay images into a base image.
+ *          The base image data is overwritten with the alpha blend result
+ * @param device A ::dsp_device object
+ * @param image A base image to alpha blend the overlays into. Only ::DSP_IMAGE_FORMAT_NV12 format is supported
+ * @param overlays An array of overlays to alpha blend into the base image
+ * @param overlays_count \p overlays array size
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ * @note Up to 50 \p overlays are blended by a single DSP request. More overlays are blended by chained requests of
+ *       the same command, in order
+ */
+dsp_status dsp_blend(dsp_device device,
+                     const dsp_image_properties_t *image, // image data is overwritten
+                     const dsp_overlay_properties_t overlays[],
+                     size_t overlays_count);
+
+/**
+ * @brief Submit alpha blend operation asynchronously
+ * @details Same as ::dsp_blend, but returns once the operation is submitted
+ * @param device A ::dsp_device object
+ * @param image A base image to alpha blend the overlays into. Only ::DSP_IMAGE_FORMAT_NV12 format is supported
+ * @param overlays An array of overlays to alpha blend into the base image
+ * @param overlays_count \p overlays array size
+ * @param[out] job A pointer to a ::dsp_job that receives the submitted job
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ * @note To release the job, call ::dsp_job_release with the returned ::dsp_job
+ */
+dsp_status dsp_blend_async(dsp_device device,
+                           const dsp_image_properties_t *image, // image data is overwritten
+                           const dsp_overlay_properties_t overlays[],
+                           size_t overlays_count,
+                           dsp_job *job);
+
+/**
+ * A persistent overlay image. Its planes are held in a registered DSP buffer, so overlays that are blended every
+ * frame are verified, copied and mapped once
+ */
+typedef struct _dsp_overlay *dsp_overlay;
+
+/** Placement of a persistent overlay in an overlay set */
+typedef struct {
+    /** Overlay to blend */
+    dsp_overlay overlay;
+    /** Offset in the horizontal axis to place the blended overlay */
+    size_t x_offset;
+    /** Offset in the vertical axis to place the blended overlay */
+    size_t y_offset;
+} dsp_overlay_placement_t;
+
+/** A fixed list of placed overlays, blended by a single call */
+typedef struct _dsp_overlay_set *dsp_overlay_set;
+
+/**
+ * @brief Create a persistent overlay
+ * @details The overlay image is verified and copied into a DSP buffer
+ * @param device A ::dsp_device object. The overlay can be blended on this device only
+ * @param image The initial overlay image. Only ::DSP_IMAGE_FORMAT_A420 format and ::DSP_MEMORY_TYPE_USERPTR memory
+ *              are supported
+ * @param[out] overlay A pointer to a ::dsp_overlay that receives the created overlay
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ */
+dsp_status dsp_create_overlay(dsp_device device, const dsp_image_properties_t *image, dsp_overlay *overlay);
+
+/**
+ * @brief Release a persistent overlay
+ * @param overlay A ::dsp_overlay object
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ * @note The overlay may not be released while overlay sets or command buffers that reference it are used
+ */
+dsp_status dsp_release_overlay(dsp_overlay overlay);
+
+/**
+ * @brief Update the content of a persistent overlay
+ * @details Only the lines and columns of \p dirty_rect are copied into the DSP buffer. The rect is widened to even
+ *          coordinates, to cover whole chroma samples
+ * @param overlay A ::dsp_overlay object
+ * @param image The new overlay image, of the size of the overlay. Only ::DSP_IMAGE_FORMAT_A420 format and
+ *              ::DSP_MEMORY_TYPE_USERPTR memory are supported
+ * @param dirty_rect The region of \p image that changed, or NULL to update the whole overlay
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ * @note The overlay may not be updated while blends that use it are in progress
+ */
+dsp_status dsp_overlay_update(dsp_overlay overlay, const dsp_image_properties_t *image, const dsp_roi_t *dirty_rect);
+
+/**
+ * @brief Get the image of a persistent overlay
+ * @details The image references the DSP buffer of the overlay, and can be used as the overlay of a
+ *          ::dsp_overlay_properties_t, to blend the overlay with ::dsp_blend
+ * @param overlay A ::dsp_overlay object
+ * @param[out] image Receives a pointer to the overlay image. It remains valid until the overlay is released
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ */
+dsp_status dsp_overlay_get_image(dsp_overlay overlay, const dsp_image_properties_t **image);
+
+/**
+ * @brief Convert an RGBA image to an A420 overlay image on the host
+ * @details The RGBA pixels are 4 bytes each, in R, G, B, A order. Luma and chroma use the BT.601 conversion of
+ *          ::dsp_convert_format, chroma is the average of the 2x2 pixels it covers, and the alpha channel is copied
+ *          to the alpha plane. The conversion is vectorized with NEON or SSE2 when available
+ * @param rgba The RGBA plane. Only its data pointer, line stride and size are used
+ * @param width Image width. Must be even
+ * @param height Image height. Must be even
+ * @param a420 A ::DSP_IMAGE_FORMAT_A420 image of the same size, in ::DSP_MEMORY_TYPE_USERPTR memory
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ */
+dsp_status dsp_convert_rgba_to_a420(const dsp_data_plane_t *rgba,
+                                    size_t width,
+                                    size_t height,
+                                    const dsp_image_properties_t *a420);
+
+/**
+ * @brief Create a persistent overlay from an RGBA image
+ * @details The image is converted as by ::dsp_convert_rgba_to_a420, directly into the DSP buffer of the overlay
+ * @param device A ::dsp_device object. The overlay can be blended on this device only
+ * @param rgba The RGBA plane
+ * @param width Image width. Must be even
+ * @param height Image height. Must be even
+ * @param[out] overlay A pointer to a ::dsp_overlay that receives the created overlay
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ */
+dsp_status dsp_create_overlay_rgba(dsp_device device,
+                                   const dsp_data_plane_t *rgba,
+                                   size_t width,
+                                   size_t height,
+                                   dsp_overlay *overlay);
+
+/**
+ * @brief Update the content of a persistent overlay from an RGBA image
+ * @details The overlay keeps a hash of every band of 16 lines of the RGBA image it was converted from. Only the bands
+ *          whose content changed are converted and written to the DSP buffer, so an unchanged image is never converted
+ *          again. An update with ::dsp_overlay_update makes the next RGBA update convert the whole image
+ * @param overlay A ::dsp_overlay object
+ * @param rgba The RGBA plane, of the size of the overlay
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ * @note The overlay may not be updated while blends that use it are in progress
+ */
+dsp_status dsp_overlay_update_rgba(dsp_overlay overlay, const dsp_data_plane_t *rgba);
+
+/**
+ * @brief Create an overlay set
+ * @details The placements are copied, and the set references the overlays. Later updates of the overlays are
+ *          blended by the set
+ * @param placements An array of overlay placements, in blending order
+ * @param placements_count \p placements array size. Must not be 0
+ * @param[out] overlay_set A pointer to a ::dsp_overlay_set that receives the created set
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ * @note All the overlays must be created on the same device, and must remain valid while the set is used
+ */
+dsp_status dsp_create_overlay_set(const dsp_overlay_placement_t placements[],
+                                  size_t placements_count,
+                                  dsp_overlay_set *overlay_set);
+
+/**
+ * @brief Release an overlay set
+ * @param overlay_set A ::dsp_overlay_set object
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ */
+dsp_status dsp_release_overlay_set(dsp_overlay_set overlay_set);
+
+/**
+ * @brief Perform alpha blend operation with an overlay set
+ * @details Same as ::dsp_blend, with the overlays of \p overlay_set. Only the base image is verified, since the
+ *          overlays were verified on creation
+ * @param device A ::dsp_device object. Must be the device of the overlays
+ * @param image A base image to alpha blend the overlays into. Only ::DSP_IMAGE_FORMAT_NV12 format is supported
+ * @param overlay_set A ::dsp_overlay_set object
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ */
+dsp_status dsp_blend_overlay_set(dsp_device device,
+                                 const dsp_image_properties_t *image, // image data is overwritten
+                                 dsp_overlay_set overlay_set);
+
+/**
+ * @brief Submit alpha blend operation with an overlay set asynchronously
+ * @details Same as ::dsp_blend_overlay_set, but returns once the operation is submitted
+ * @param device A ::dsp_device object. Must be the device of the overlays
+ * @param image A base image to alpha blend the overlays into. Only ::DSP_IMAGE_FORMAT_NV12 format is supported
+ * @param overlay_set A ::dsp_overlay_set object
+ * @param[out] job A pointer to a ::dsp_job that receives the submitted job
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ * @note To release the job, call ::dsp_job_release with the returned ::dsp_job
+ */
+dsp_status dsp_blend_overlay_set_async(dsp_device device,
+                                       const dsp_image_properties_t *image, // image data is overwritten
+                                       dsp_overlay_set overlay_set,
+                                       dsp_job *job);
+
+/** Maximum number of labels supported in ::dsp_blend_atlas */
+#define DSP_BLEND_ATLAS_MAX_LABELS (1024)
+
+/** A label blended from a region of an atlas image */
+typedef struct {
+    /** Region of the atlas image to blend. Coordinates must be even */
+    dsp_roi_t rect;
+    /** Offset in the horizontal axis to place the blended region */
+    size_t x_offset;
+    /** Offset in the vertical axis to place the blended region */
+    size_t y_offset;
+} dsp_atlas_label_t;
+
+/**
+ * A persistent overlay that small overlay images are packed into, so that many labels are blended from a single
+ * overlay buffer
+ */
+typedef struct _dsp_overlay_atlas *dsp_overlay_atlas;
+
+/**
+ * @brief Perform alpha blend operation with regions of an atlas image
+ * @details Alpha blend regions of a single overlay image into a base image, in order. Only the atlas image and an
+ *          array of label regions are transferred, so a single DSP request blends up to
+ *          ::DSP_BLEND_ATLAS_MAX_LABELS labels, regardless of the 50 overlays limit of ::dsp_blend
+ * @param device A ::dsp_device object
+ * @param image A base image to alpha blend the labels into. Only ::DSP_IMAGE_FORMAT_NV12 format is supported
+ * @param atlas The atlas image. Only ::DSP_IMAGE_FORMAT_A420 format is supported. The image of a
+ *              ::dsp_overlay_atlas is obtained with ::dsp_overlay_atlas_get_image
+ * @param labels An array of labels to alpha blend into the base image
+ * @param labels_count \p labels array size. Must be between 1 and ::DSP_BLEND_ATLAS_MAX_LABELS
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ */
+dsp_status dsp_blend_atlas(dsp_device device,
+                           const dsp_image_properties_t *image, // image data is overwritten
+                           const dsp_image_properties_t *atlas,
+                           const dsp_atlas_label_t labels[],
+                           size_t labels_count);
+
+/**
+ * @brief Submit alpha blend operation with regions of an atlas image asynchronously
+ * @details Same as ::dsp_blend_atlas, but returns once the operation is submitted. The labels are copied on
+ *          submission
+ * @param device A ::dsp_device object
+ * @param image A base image to alpha blend the labels into. Only ::DSP_IMAGE_FORMAT_NV12 format is supported
+ * @param atlas The atlas image. Only ::DSP_IMAGE_FORMAT_A420 format is supported
+ * @param labels An array of labels to alpha blend into the base image
+ * @param labels_count \p labels array size. Must be between 1 and ::DSP_BLEND_ATLAS_MAX_LABELS
+ * @param[out] job A pointer to a ::dsp_job that receives the submitted job
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ * @note To release the job, call ::dsp_job_release with the returned ::dsp_job
+ */
+dsp_status dsp_blend_atlas_async(dsp_device device,
+                                 const dsp_image_properties_t *image, // image data is overwritten
+                                 const dsp_image_properties_t *atlas,
+                                 const dsp_atlas_label_t labels[],
+                                 size_t labels_count,
+                                 dsp_job *job);
+
+/**
+ * @brief Create an overlay atlas
+ * @details The atlas is a persistent ::DSP_IMAGE_FORMAT_A420 overlay of the given size. Images are packed into it
+ *          by ::dsp_overlay_atlas_add and ::dsp_overlay_atlas_add_rgba, in rows of similar height
+ * @param device A ::dsp_device object. The atlas can be blended on this device only
+ * @param width Atlas width. Must be even
+ * @param height Atlas height. Must be even
+ * @param[out] atlas A pointer to a ::dsp_overlay_atlas that receives the created atlas
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ */
+dsp_status dsp_create_overlay_atlas(dsp_device device, size_t width, size_t height, dsp_overlay_atlas *atlas);
+
+/**
+ * @brief Release an overlay atlas
+ * @param atlas A ::dsp_overlay_atlas object
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ * @note The atlas may not be released while blends that use it are in progress
+ */
+dsp_status dsp_release_overlay_atlas(dsp_overlay_atlas atlas);
+
+/**
+ * @brief Pack an image into an overlay atlas
+ * @details The image is copied into a free region of the atlas
+ * @param atlas A ::dsp_overlay_atlas object
+ * @param image The image to pack. Only ::DSP_IMAGE_FORMAT_A420 format and ::DSP_MEMORY_TYPE_USERPTR memory are
+ *              supported
+ * @param[out] rect Receives the region of the atlas that holds the image, for use as the rect of a
+ *                  ::dsp_atlas_label_t
+ * @return Upon success, returns ::DSP_SUCCESS. Returns ::DSP_OUT_OF_ATLAS_SPACE when the atlas has no room for the
+ *         image. Otherwise, returns a ::dsp_status error
+ * @note The atlas may not be modified while blends that use it are in progress
+ */
+dsp_status dsp_overlay_atlas_add(dsp_overlay_atlas atlas, const dsp_image_properties_t *image, dsp_roi_t *rect);
+
+/**
+ * @brief Pack an RGBA image into an overlay atlas
+ * @details The image is converted as by ::dsp_convert_rgba_to_a420, directly into a free region of the atlas
+ * @param atlas A ::dsp_overlay_atlas object
+ * @param rgba The RGBA plane
+ * @param width Image width. Must be even
+ * @param height Image height. Must be even
+ * @param[out] rect Receives the region of the atlas that holds the image, for use as the rect of a
+ *                  ::dsp_atlas_label_t
+ * @return Upon success, returns ::DSP_SUCCESS. Returns ::DSP_OUT_OF_ATLAS_SPACE when the atlas has no room for the
+ *         image. Otherwise, returns a ::dsp_status error
+ * @note The atlas may not be modified while blends that use it are in progress
+ */
+dsp_status dsp_overlay_atlas_add_rgba(dsp_overlay_atlas atlas,
+                                      const dsp_data_plane_t *rgba,
+                                      size_t width,
+                                      size_t height,
+                                      dsp_roi_t *rect);
+
+/**
+ * @brief Remove all the images of an overlay atlas
+ * @details The whole atlas becomes free for packing. Regions returned before the reset must not be blended again
+ * @param atlas A ::dsp_overlay_atlas object
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ */
+dsp_status dsp_overlay_atlas_reset(dsp_overlay_atlas atlas);
+
+/**
+ * @brief Get the image of an overlay atlas
+ * @details The image references the DSP buffer of the atlas, and is used as the atlas of ::dsp_blend_atlas
+ * @param atlas A ::dsp_overlay_atlas object
+ * @param[out] image Receives a pointer to the atlas image. It remains valid until the atlas is released
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ */
+dsp_status dsp_overlay_atlas_get_image(dsp_overlay_atlas atlas, const dsp_image_properties_t **image);
+
+/**
+ *  @}
+ *
+ *  @defgroup blur Blur API
+ *  @{
+ */
+
+/**
+ * Blur region of interest (ROI) parameters
+ * @note This typedef is for backwards compatibility only. Use ::dsp_roi_t instead
+ */
+typedef dsp_roi_t dsp_blur_roi_t;
+
+/**
+ * @brief Perform box blur operation
+ * @details Box blur (filter) an array of regions of interet (ROIs) in a base image.
+ *          The base image data is overwritten with the blurred result.
+ *          Supported formats are ::DSP_IMAGE_FORMAT_GRAY8 and ::DSP_IMAGE_FORMAT_NV12
+ * @param device A ::dsp_device object
+ * @param image A base image to blur
+ * @param rois An array of ROIs to blur in the base image
+ * @param rois_count \p rois array size
+ * @param kernel_size blurring kernel (matrix) size
+ *                    odd number between 1 and 33
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ * @note Up to 80 \p ROIs are blurred by a single DSP request. More ROIs are blurred by chained requests of the same
+ *       command
+ */
+dsp_status dsp_blur(dsp_device device,
+                    dsp_image_properties_t *image,
+                    const dsp_roi_t rois[],
+                    size_t rois_count,
+                    uint32_t kernel_size);
+
+/**
+ * @brief Submit box blur operation asynchronously
+ * @details Same as ::dsp_blur, but returns once the operation is submitted
+ * @param device A ::dsp_device object
+ * @param image A base image to blur
+ * @param rois An array of ROIs to blur in the base image
+ * @param rois_count \p rois array size
+ * @param kernel_size blurring kernel (matrix) size
+ *                    odd number between 1 and 33
+ * @param[out] job A pointer to a ::dsp_job that receives the submitted job
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ * @note To release the job, call ::dsp_job_release with the returned ::dsp_job
+ */
+dsp_status dsp_blur_async(dsp_device device,
+                          dsp_image_properties_t *image,
+                          const dsp_roi_t rois[],
+                          size_t rois_count,
+                          uint32_t kernel_size,
+                          dsp_job *job);
+
+/** Blur modes */
+typedef enum {
+    DSP_BLUR_MODE_BOX,      /**< Box filter, as in ::dsp_blur */
+    DSP_BLUR_MODE_GAUSSIAN, /**< Gaussian filter, with the sigma of the kernel size used by OpenCV */
+    DSP_BLUR_MODE_PIXELATE, /**< Mosaic of square blocks, each filled with its mean value */
+
+    /* Must be last */
+    DSP_BLUR_MODE_COUNT,
+    /** Max enum value to maintain ABI Integrity */
+    DSP_BLUR_MODE_MAX_ENUM = DSP_MAX_ENUM
+} dsp_blur_mode_t;
+
+/** Maximum kernel size of ::DSP_BLUR_MODE_BOX and ::DSP_BLUR_MODE_GAUSSIAN */
+#define DSP_BLUR_MAX_KERNEL_SIZE (33)
+
+/** Maximum block size of ::DSP_BLUR_MODE_PIXELATE */
+#define DSP_BLUR_MAX_PIXELATE_BLOCK (128)
+
+/** Maximum downscale factor of ::dsp_blur_roi_params_t */
+#define DSP_BLUR_MAX_DOWNSCALE (16)
+
+/** Blur parameters of a single ROI */
+typedef struct {
+    /** Region to blur */
+    dsp_roi_t roi;
+    /** Blur mode */
+    dsp_blur_mode_t mode;
+    /** For ::DSP_BLUR_MODE_BOX and ::DSP_BLUR_MODE_GAUSSIAN, the kernel size, an odd number between 1 and
+     *  ::DSP_BLUR_MAX_KERNEL_SIZE. For ::DSP_BLUR_MODE_PIXELATE, the block size, between 1 and
+     *  ::DSP_BLUR_MAX_PIXELATE_BLOCK. Blocks are aligned to the ROI start */
+    size_t kernel_size;
+    /** For ::DSP_BLUR_MODE_BOX and ::DSP_BLUR_MODE_GAUSSIAN, a power of 2 up to ::DSP_BLUR_MAX_DOWNSCALE. A factor
+     *  greater than 1 blurs the ROI and its surroundings downscaled by that factor, and upscales the result back, for
+     *  an effective kernel size of kernel_size * downscale. Must be 1 for ::DSP_BLUR_MODE_PIXELATE */
+    size_t downscale;
+} dsp_blur_roi_params_t;
+
+/**
+ * @brief Perform blur operation with a mode and a kernel size per ROI
+ * @details Blur an array of regions of interest (ROIs) in a base image, in order.
+ *          The base image data is overwritten with the blurred result.
+ *          Supported formats are ::DSP_IMAGE_FORMAT_GRAY8 and ::DSP_IMAGE_FORMAT_NV12. The chroma of NV12 images is
+ *          blurred with a kernel covering the same area as the luma kernel. When pixelating, every luma block fills
+ *          the chroma pixels it covers, from start / 2 to ceil(end / 2), with their mean, so the chroma tiles line up
+ *          with the luma tiles.
+ *          The emulator device (::DSP_DRIVER_TYPE_EMULATOR) implements every mode on the CPU, and serves as the
+ *          reference for validating the output
+ * @param device A ::dsp_device object
+ * @param image A base image to blur
+ * @param rois An array of ROI blur parameters
+ * @param rois_count \p rois array size
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ * @note Up to 80 \p ROIs are blurred by a single DSP request. More ROIs are blurred by chained requests of the same
+ *       command
+ */
+dsp_status dsp_blur_rois(dsp_device device,
+                         dsp_image_properties_t *image,
+                         const dsp_blur_roi_params_t rois[],
+                         size_t rois_count);
+
+/**
+ * @brief Submit blur operation with a mode and a kernel size per ROI asynchronously
+ * @details Same as ::dsp_blur_rois, but returns once the operation is submitted
+ * @param device A ::dsp_device object
+ * @param image A base image to blur
+ * @param rois An array of ROI blur parameters
+ * @param rois_count \p rois array size
+ * @param[out] job A pointer to a ::dsp_job that receives the submitted job
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ * @note To release the job, call ::dsp_job_release with the returned ::dsp_job
+ */
+dsp_status dsp_blur_rois_async(dsp_device device,
+                               dsp_image_properties_t *image,
+                               const dsp_blur_roi_params_t rois[],
+                               size_t rois_count,
+                               dsp_job *job);
+
+/**
+ *  @}
+ *
+ *  @defgroup convert Format Conversion API
+ *  @{
  */
 
 /**
@@ -485,6 +1720,21 @@ dsp_status dsp_blur(dsp_device device,
  */
 dsp_status dsp_convert_format(dsp_device device, const dsp_image_properties_t *src, dsp_image_properties_t *dst);
 
+/**
+ * @brief Submit format conversion operation asynchronously
+ * @details Same as ::dsp_convert_format, but returns once the operation is submitted
+ * @param device A ::dsp_device object
+ * @param src Source image metadata - holds the image to convert
+ * @param dst Destination image metadata - will hold the converted image
+ * @param[out] job A pointer to a ::dsp_job that receives the submitted job
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ * @note To release the job, call ::dsp_job_release with the returned ::dsp_job
+ */
+dsp_status dsp_convert_format_async(dsp_device device,
+                                    const dsp_image_properties_t *src,
+                                    dsp_image_properties_t *dst,
+                                    dsp_job *job);
+
 /**
  *  @}
  *
@@ -525,6 +1775,583 @@ dsp_status dsp_dewarp(dsp_device device,
                       const dsp_dewarp_mesh_t *mesh,
                       dsp_interpolation_type_t interpolation);
 
+/**
+ * @brief Submit dewarp operation asynchronously
+ * @details Same as ::dsp_dewarp, but returns once the operation is submitted
+ * @param device A ::dsp_device object
+ * @param src Image metadata for source image. Image data will not change
+ * @param dst Image metadata for destination image
+ * @param mesh Mesh information. The mesh table must remain valid until the job completes
+ * @param interpolation Interpolation method to use.
+ *                      Only ::INTERPOLATION_TYPE_BILINEAR and ::INTERPOLATION_TYPE_BICUBIC are supported
+ * @param[out] job A pointer to a ::dsp_job that receives the submitted job
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ * @note To release the job, call ::dsp_job_release with the returned ::dsp_job
+ */
+dsp_status dsp_dewarp_async(dsp_device device,
+                            const dsp_image_properties_t *src,
+                            const dsp_image_properties_t *dst,
+                            const dsp_dewarp_mesh_t *mesh,
+                            dsp_interpolation_type_t interpolation,
+                            dsp_job *job);
+
+/**
+ *  @}
+ *
+ *  @defgroup cmdbuf Command Buffer API
+ *  @details A command buffer records a sequence of operations once, and then submits the whole sequence to the DSP
+ *           as a single command. The parameters of each operation are validated and encoded at record time.
+ *           Between submissions, the data of the recorded images can be replaced using ::dsp_cmdbuf_bind_image,
+ *           so a per-frame pipeline can be recorded once and re-submitted on every frame.
+ *           The operations are executed in the order they were recorded.
+ *  @{
+ */
+
+/** Opaque pointer to dsp_cmdbuf object. The command buffer holds a sequence of recorded operations */
+typedef struct _dsp_cmdbuf *dsp_cmdbuf;
+
+/**
+ * Create new, empty, dsp_cmdbuf object
+ *
+ * @param device A ::dsp_device object. The recorded operations are submitted to this device
+ * @param[out] cmdbuf A pointer to a ::dsp_cmdbuf that receives the allocated command buffer
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ * @note To release a command buffer, call the ::dsp_release_cmdbuf function with the returned ::dsp_cmdbuf
+ */
+dsp_status dsp_create_cmdbuf(dsp_device device, dsp_cmdbuf *cmdbuf);
+
+/**
+ * Release dsp_cmdbuf object
+ *
+ * @param cmdbuf A ::dsp_cmdbuf to be released
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ */
+dsp_status dsp_release_cmdbuf(dsp_cmdbuf cmdbuf);
+
+/**
+ * Remove all recorded operations from a command buffer
+ *
+ * @param cmdbuf A ::dsp_cmdbuf object
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ */
+dsp_status dsp_cmdbuf_reset(dsp_cmdbuf cmdbuf);
+
+/**
+ * @brief Record resize operation. See ::dsp_resize
+ * @param cmdbuf A ::dsp_cmdbuf object
+ * @param resize_params Pointer to ::dsp_resize_params_t with the required resize parameters
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ */
+dsp_status dsp_cmdbuf_record_resize(dsp_cmdbuf cmdbuf, const dsp_resize_params_t *resize_params);
+
+/**
+ * @brief Record crop&resize operation. See ::dsp_crop_and_resize
+ * @param cmdbuf A ::dsp_cmdbuf object
+ * @param resize_params Pointer to ::dsp_resize_params_t with the required resize parameters
+ * @param crop_params Pointer to ::dsp_roi_t with the required crop parameters
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ */
+dsp_status dsp_cmdbuf_record_crop_and_resize(dsp_cmdbuf cmdbuf,
+                                             const dsp_resize_params_t *resize_params,
+                                             const dsp_roi_t *crop_params);
+
+/**
+ * @brief Record privacy mask and crop&resize operation. See ::dsp_crop_and_resize_privacy_mask
+ * @param cmdbuf A ::dsp_cmdbuf object
+ * @param resize_params Pointer to ::dsp_resize_params_t with the required resize parameters
+ * @param crop_params Pointer to ::dsp_roi_t with the required crop parameters
+ * @param privacy_mask_params Pointer to ::dsp_privacy_mask_t with the required privacy mask parameters
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ * @note The privacy mask bitmask is referenced, not copied. It must remain valid while the command buffer is used
+ */
+dsp_status dsp_cmdbuf_record_crop_and_resize_privacy_mask(dsp_cmdbuf cmdbuf,
+                                                          const dsp_resize_params_t *resize_params,
+                                                          const dsp_roi_t *crop_params,
+                                                          const dsp_privacy_mask_t *privacy_mask_params);
+
+/**
+ * @brief Record privacy mask operation. See ::dsp_apply_privacy_mask
+ * @param cmdbuf A ::dsp_cmdbuf object
+ * @param image Pointer to ::dsp_image_properties_t with the image to mask
+ * @param privacy_mask_params Pointer to ::dsp_privacy_mask_t with the required privacy mask parameters
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ * @note The privacy mask bitmask is referenced, not copied. It must remain valid while the command buffer is used
+ */
+dsp_status dsp_cmdbuf_record_apply_privacy_mask(dsp_cmdbuf cmdbuf,
+                                                dsp_image_properties_t *image,
+                                                const dsp_privacy_mask_t *privacy_mask_params);
+
+/**
+ * @brief Record multi crop&resize operation. See ::dsp_multi_crop_and_resize
+ * @param cmdbuf A ::dsp_cmdbuf object
+ * @param resize_params Pointer to ::dsp_multi_resize_params_t with the required resize parameters
+ * @param crop_params Pointer to ::dsp_roi_t with the required crop parameters
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ */
+dsp_status dsp_cmdbuf_record_multi_crop_and_resize(dsp_cmdbuf cmdbuf,
+                                                   const dsp_multi_resize_params_t *resize_params,
+                                                   const dsp_roi_t *crop_params);
+
+/**
+ * @brief Record privacy mask and multi crop&resize operation. See ::dsp_multi_crop_and_resize_privacy_mask
+ * @param cmdbuf A ::dsp_cmdbuf object
+ * @param resize_params Pointer to ::dsp_multi_resize_params_t with the required resize parameters
+ * @param crop_params Pointer to ::dsp_roi_t with the required crop parameters
+ * @param privacy_mask_params Pointer to ::dsp_privacy_mask_t with the required privacy mask parameters
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ * @note The privacy mask bitmask is referenced, not copied. It must remain valid while the command buffer is used
+ */
+dsp_status dsp_cmdbuf_record_multi_crop_and_resize_privacy_mask(dsp_cmdbuf cmdbuf,
+                                                                const dsp_multi_resize_params_t *resize_params,
+                                                                const dsp_roi_t *crop_params,
+                                                                const dsp_privacy_mask_t *privacy_mask_params);
+
+/**
+ * @brief Record multi crop&resize operation with any number of outputs. See ::dsp_multi_crop_and_resize_list
+ * @param cmdbuf A ::dsp_cmdbuf object
+ * @param resize_params Pointer to ::dsp_multi_resize_list_params_t with the required resize parameters
+ * @param crop_params Pointer to ::dsp_roi_t with the required crop parameters
+ * @param privacy_mask_params Pointer to ::dsp_privacy_mask_t with the required privacy mask parameters, or NULL
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ * @note The privacy mask bitmask is referenced, not copied. It must remain valid while the command buffer is used
+ */
+dsp_status dsp_cmdbuf_record_multi_crop_and_resize_list(dsp_cmdbuf cmdbuf,
+                                                        const dsp_multi_resize_list_params_t *resize_params,
+                                                        const dsp_roi_t *crop_params,
+                                                        const dsp_privacy_mask_t *privacy_mask_params);
+
+/**
+ * @brief Record crop&resize into a tensor operation. See ::dsp_crop_and_resize_to_tensor
+ * @param cmdbuf A ::dsp_cmdbuf object
+ * @param resize_params Pointer to ::dsp_tensor_resize_params_t with the required resize parameters
+ * @param crop_params Pointer to ::dsp_roi_t with the required crop parameters
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ * @note Only the src image can be re-bound. The tensor data is referenced, not copied, and must remain valid while
+ *       the command buffer is used
+ */
+dsp_status dsp_cmdbuf_record_crop_and_resize_to_tensor(dsp_cmdbuf cmdbuf,
+                                                       const dsp_tensor_resize_params_t *resize_params,
+                                                       const dsp_roi_t *crop_params);
+
+/**
+ * @brief Record alpha blend operation. See ::dsp_blend
+ * @param cmdbuf A ::dsp_cmdbuf object
+ * @param image A base image to alpha blend the overlays into
+ * @param overlays An array of overlays to alpha blend into the base image
+ * @param overlays_count \p overlays array size
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ */
+dsp_status dsp_cmdbuf_record_blend(dsp_cmdbuf cmdbuf,
+                                   const dsp_image_properties_t *image,
+                                   const dsp_overlay_properties_t overlays[],
+                                   size_t overlays_count);
+
+/**
+ * @brief Record alpha blend operation with an overlay set. See ::dsp_blend_overlay_set
+ * @param cmdbuf A ::dsp_cmdbuf object, of the device of the overlays
+ * @param image A base image to alpha blend the overlays into
+ * @param overlay_set A ::dsp_overlay_set object
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ * @note The set is referenced when recording only. The overlays themselves must remain valid while the command buffer
+ *       is used, and their updates are blended by the command buffer
+ */
+dsp_status dsp_cmdbuf_record_blend_overlay_set(dsp_cmdbuf cmdbuf,
+                                               const dsp_image_properties_t *image,
+                                               dsp_overlay_set overlay_set);
+
+/**
+ * @brief Record box blur operation. See ::dsp_blur
+ * @param cmdbuf A ::dsp_cmdbuf object
+ * @param image A base image to blur
+ * @param rois An array of ROIs to blur in the base image
+ * @param rois_count \p rois array size
+ * @param kernel_size blurring kernel (matrix) size
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ */
+dsp_status dsp_cmdbuf_record_blur(dsp_cmdbuf cmdbuf,
+                                  dsp_image_properties_t *image,
+                                  const dsp_roi_t rois[],
+                                  size_t rois_count,
+                                  uint32_t kernel_size);
+
+/**
+ * @brief Record blur operation with a mode and a kernel size per ROI. See ::dsp_blur_rois
+ * @param cmdbuf A ::dsp_cmdbuf object
+ * @param image A base image to blur
+ * @param rois An array of ROI blur parameters
+ * @param rois_count \p rois array size
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ */
+dsp_status dsp_cmdbuf_record_blur_rois(dsp_cmdbuf cmdbuf,
+                                       dsp_image_properties_t *image,
+                                       const dsp_blur_roi_params_t rois[],
+                                       size_t rois_count);
+
+/**
+ * @brief Record format conversion operation. See ::dsp_convert_format
+ * @param cmdbuf A ::dsp_cmdbuf object
+ * @param src Source image metadata - holds the image to convert
+ * @param dst Destination image metadata - will hold the converted image
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ */
+dsp_status dsp_cmdbuf_record_convert_format(dsp_cmdbuf cmdbuf,
+                                            const dsp_image_properties_t *src,
+                                            dsp_image_properties_t *dst);
+
+/**
+ * @brief Record dewarp operation. See ::dsp_dewarp
+ * @param cmdbuf A ::dsp_cmdbuf object
+ * @param src Image metadata for source image
+ * @param dst Image metadata for destination image
+ * @param mesh Mesh information. The mesh table is referenced, not copied
+ * @param interpolation Interpolation method to use
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ */
+dsp_status dsp_cmdbuf_record_dewarp(dsp_cmdbuf cmdbuf,
+                                    const dsp_image_properties_t *src,
+                                    const dsp_image_properties_t *dst,
+                                    const dsp_dewarp_mesh_t *mesh,
+                                    dsp_interpolation_type_t interpolation);
+
+/**
+ * @brief Replace the data of a recorded image
+ * @details Every recorded operation that references \p recorded_image will use the planes of \p image from the next
+ *          submission on. Only the plane data may change: the size, format, memory type, line strides and plane sizes
+ *          of \p image must be identical to the recorded image
+ * @param cmdbuf A ::dsp_cmdbuf object
+ * @param recorded_image The image pointer that was passed when recording. It is used as a key only and is not accessed
+ * @param image Image metadata with the new planes
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ */
+dsp_status dsp_cmdbuf_bind_image(dsp_cmdbuf cmdbuf,
+                                 const dsp_image_properties_t *recorded_image,
+                                 const dsp_image_properties_t *image);
+
+/**
+ * @brief Submit all recorded operations to the DSP as a single command, and wait for them to complete
+ * @param cmdbuf A ::dsp_cmdbuf object
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ */
+dsp_status dsp_cmdbuf_submit(dsp_cmdbuf cmdbuf);
+
+/**
+ *  @}
+ *
+ *  @defgroup graph Operation Graph API
+ *  @details An operation graph is a pipeline of operations whose intermediate images are owned by the library.
+ *           The nodes of the graph are recorded into the graph command buffer (see ::dsp_graph_get_cmdbuf) with the
+ *           regular dsp_cmdbuf_record_* functions, in dependency order. Images created by ::dsp_graph_create_image
+ *           connect the nodes: they are allocated from the device buffer pool, registered with the driver, and
+ *           never accessed by the CPU. The graph is compiled once, and then executed on every frame as a single DSP
+ *           command, after binding the frame's input and output images with ::dsp_graph_bind_image.
+ *  @code
+ *  dsp_graph_create_image(graph, 1920, 1080, DSP_IMAGE_FORMAT_NV12, &dewarped);
+ *  dsp_graph_get_cmdbuf(graph, &cmdbuf);
+ *  dsp_cmdbuf_record_dewarp(cmdbuf, &input, dewarped, &mesh, INTERPOLATION_TYPE_BILINEAR);
+ *  dsp_cmdbuf_record_multi_crop_and_resize(cmdbuf, &resize_params_from_dewarped, &roi);
+ *  dsp_graph_compile(graph);
+ *  // Per frame
+ *  dsp_graph_bind_image(graph, &input, &frame_input);
+ *  dsp_graph_execute(graph);
+ *  @endcode
+ *  @{
+ */
+
+/** Opaque pointer to dsp_graph object */
+typedef struct _dsp_graph *dsp_graph;
+
+/**
+ * Create new, empty, dsp_graph object
+ * @param device A ::dsp_device object. The graph is executed on this device
+ * @param[out] graph A pointer to a ::dsp_graph that receives the allocated graph
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ * @note To release a graph, call the ::dsp_release_graph function with the returned ::dsp_graph
+ */
+dsp_status dsp_create_graph(dsp_device device, dsp_graph *graph);
+
+/**
+ * Release dsp_graph object, together with its intermediate images
+ * @param graph A ::dsp_graph to be released
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ */
+dsp_status dsp_release_graph(dsp_graph graph);
+
+/**
+ * Create an intermediate image owned by the graph
+ * @details The image is tightly packed (the line stride of every plane is the minimal one). It can be passed as the
+ *          source or destination image of the graph nodes, and must be written by a node before other nodes read it
+ * @param graph A ::dsp_graph object
+ * @param width Image width
+ * @param height Image height
+ * @param format Image format
+ * @param[out] image A pointer that receives the image properties. Owned by the graph, and valid until it is released
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ * @note The image data must not be accessed by the CPU
+ */
+dsp_status dsp_graph_create_image(dsp_graph graph,
+                                  size_t width,
+                                  size_t height,
+                                  dsp_image_format_t format,
+                                  dsp_image_properties_t **image);
+
+/**
+ * Get the command buffer the graph nodes are recorded into
+ * @param graph A ::dsp_graph object
+ * @param[out] cmdbuf A pointer to a ::dsp_cmdbuf that receives the command buffer. Owned by the graph
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ * @note Recording into the command buffer after ::dsp_graph_compile requires compiling the graph again
+ */
+dsp_status dsp_graph_get_cmdbuf(dsp_graph graph, dsp_cmdbuf *cmdbuf);
+
+/**
+ * Validate the recorded graph and prepare it for execution
+ * @details Verifies that the nodes were recorded in dependency order: every intermediate image is written by a
+ *          node before any node reads it
+ * @param graph A ::dsp_graph object
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ */
+dsp_status dsp_graph_compile(dsp_graph graph);
+
+/**
+ * Replace the data of a recorded input or output image of the graph. See ::dsp_cmdbuf_bind_image
+ * @param graph A ::dsp_graph object
+ * @param recorded_image The image pointer that was passed when recording. Intermediate images can't be re-bound
+ * @param image Image metadata with the new planes
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ */
+dsp_status dsp_graph_bind_image(dsp_graph graph,
+                                const dsp_image_properties_t *recorded_image,
+                                const dsp_image_properties_t *image);
+
+/**
+ * Execute all the nodes of a compiled graph as a single DSP command, and wait for them to complete
+ * @param graph A ::dsp_graph object
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ */
+dsp_status dsp_graph_execute(dsp_graph graph);
+
+/**
+ *  @}
+ *
+ *  @defgroup plan Operation Plan API
+ *  @details A plan validates and encodes a single operation once, for operations that are executed repeatedly with
+ *           the same image sizes, formats and parameters. Executing a plan only replaces the data of the image planes
+ *           and sends the pre-encoded operation to the DSP.
+ *           The planes passed to ::dsp_plan_execute are the planes of all the images of the operation, in the order
+ *           the images are passed to the plan creation function. Images that are NULL are skipped. For example, a
+ *           resize plan of NV12 images takes 4 planes: src Y, src UV, dst Y, dst UV.
+ *           All other parameters (ROIs, interpolation, kernel size, overlay offsets...) are fixed when the plan is
+ *           created. Data that is referenced rather than copied (dewarp mesh table, privacy mask bitmask) must remain
+ *           valid while the plan is used.
+ *           Blur plans of more than 80 ROIs hold chained requests, like ::dsp_blur. Other operations that
+ *           exceed the limits of a single request (more than 50 blend overlays) cannot be planned. Use a ::dsp_cmdbuf
+ *           for them instead.
+ *  @{
+ */
+
+/** Opaque pointer to dsp_plan object. The plan holds a single pre-encoded operation */
+typedef struct _dsp_plan *dsp_plan;
+
+/**
+ * @brief Create a resize plan. See ::dsp_resize
+ * @param device A ::dsp_device object. The plan is executed on this device
+ * @param resize_params Pointer to ::dsp_resize_params_t with the required resize parameters
+ * @param[out] plan A pointer to a ::dsp_plan that receives the created plan
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ * @note To release a plan, call the ::dsp_release_plan function with the returned ::dsp_plan
+ */
+dsp_status dsp_plan_create_resize(dsp_device device, const dsp_resize_params_t *resize_params, dsp_plan *plan);
+
+/**
+ * @brief Create a crop&resize plan. See ::dsp_crop_and_resize
+ * @param device A ::dsp_device object. The plan is executed on this device
+ * @param resize_params Pointer to ::dsp_resize_params_t with the required resize parameters
+ * @param crop_params Pointer to ::dsp_roi_t with the required crop parameters
+ * @param[out] plan A pointer to a ::dsp_plan that receives the created plan
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ */
+dsp_status dsp_plan_create_crop_and_resize(dsp_device device,
+                                           const dsp_resize_params_t *resize_params,
+                                           const dsp_roi_t *crop_params,
+                                           dsp_plan *plan);
+
+/**
+ * @brief Create a privacy mask and crop&resize plan. See ::dsp_crop_and_resize_privacy_mask
+ * @param device A ::dsp_device object. The plan is executed on this device
+ * @param resize_params Pointer to ::dsp_resize_params_t with the required resize parameters
+ * @param crop_params Pointer to ::dsp_roi_t with the required crop parameters
+ * @param privacy_mask_params Pointer to ::dsp_privacy_mask_t with the required privacy mask parameters
+ * @param[out] plan A pointer to a ::dsp_plan that receives the created plan
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ */
+dsp_status dsp_plan_create_crop_and_resize_privacy_mask(dsp_device device,
+                                                        const dsp_resize_params_t *resize_params,
+                                                        const dsp_roi_t *crop_params,
+                                                        const dsp_privacy_mask_t *privacy_mask_params,
+                                                        dsp_plan *plan);
+
+/**
+ * @brief Create a privacy mask plan. See ::dsp_apply_privacy_mask
+ * @param device A ::dsp_device object. The plan is executed on this device
+ * @param image Pointer to ::dsp_image_properties_t with the image to mask
+ * @param privacy_mask_params Pointer to ::dsp_privacy_mask_t with the required privacy mask parameters
+ * @param[out] plan A pointer to a ::dsp_plan that receives the created plan
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ */
+dsp_status dsp_plan_create_apply_privacy_mask(dsp_device device,
+                                              dsp_image_properties_t *image,
+                                              const dsp_privacy_mask_t *privacy_mask_params,
+                                              dsp_plan *plan);
+
+/**
+ * @brief Create a multi crop&resize plan. See ::dsp_multi_crop_and_resize
+ * @param device A ::dsp_device object. The plan is executed on this device
+ * @param resize_params Pointer to ::dsp_multi_resize_params_t with the required resize parameters
+ * @param crop_params Pointer to ::dsp_roi_t with the required crop parameters
+ * @param[out] plan A pointer to a ::dsp_plan that receives the created plan
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ */
+dsp_status dsp_plan_create_multi_crop_and_resize(dsp_device device,
+                                                 const dsp_multi_resize_params_t *resize_params,
+                                                 const dsp_roi_t *crop_params,
+                                                 dsp_plan *plan);
+
+/**
+ * @brief Create a privacy mask and multi crop&resize plan. See ::dsp_multi_crop_and_resize_privacy_mask
+ * @param device A ::dsp_device object. The plan is executed on this device
+ * @param resize_params Pointer to ::dsp_multi_resize_params_t with the required resize parameters
+ * @param crop_params Pointer to ::dsp_roi_t with the required crop parameters
+ * @param privacy_mask_params Pointer to ::dsp_privacy_mask_t with the required privacy mask parameters
+ * @param[out] plan A pointer to a ::dsp_plan that receives the created plan
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ */
+dsp_status dsp_plan_create_multi_crop_and_resize_privacy_mask(dsp_device device,
+                                                              const dsp_multi_resize_params_t *resize_params,
+                                                              const dsp_roi_t *crop_params,
+                                                              const dsp_privacy_mask_t *privacy_mask_params,
+                                                              dsp_plan *plan);
+
+/**
+ * @brief Create an alpha blend plan. See ::dsp_blend
+ * @param device A ::dsp_device object. The plan is executed on this device
+ * @param image A base image to alpha blend the overlays into
+ * @param overlays An array of overlays to alpha blend into the base image
+ * @param overlays_count \p overlays array size
+ * @param[out] plan A pointer to a ::dsp_plan that receives the created plan
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ */
+dsp_status dsp_plan_create_blend(dsp_device device,
+                                 const dsp_image_properties_t *image,
+                                 const dsp_overlay_properties_t overlays[],
+                                 size_t overlays_count,
+                                 dsp_plan *plan);
+
+/**
+ * @brief Create an alpha blend plan with an overlay set. See ::dsp_blend_overlay_set
+ * @param device A ::dsp_device object. The plan is executed on this device, which must be the device of the overlays
+ * @param image A base image to alpha blend the overlays into. It is the only image of the plan
+ * @param overlay_set A ::dsp_overlay_set object, of up to 50 overlays
+ * @param[out] plan A pointer to a ::dsp_plan that receives the created plan
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ * @note The overlays must remain valid while the plan is used
+ */
+dsp_status dsp_plan_create_blend_overlay_set(dsp_device device,
+                                             const dsp_image_properties_t *image,
+                                             dsp_overlay_set overlay_set,
+                                             dsp_plan *plan);
+
+/**
+ * @brief Create a box blur plan. See ::dsp_blur
+ * @param device A ::dsp_device object. The plan is executed on this device
+ * @param image A base image to blur
+ * @param rois An array of ROIs to blur in the base image
+ * @param rois_count \p rois array size
+ * @param kernel_size blurring kernel (matrix) size
+ * @param[out] plan A pointer to a ::dsp_plan that receives the created plan
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ * @note As in ::dsp_blur, more than 80 \p ROIs are blurred by chained requests, which the plan executes together
+ */
+dsp_status dsp_plan_create_blur(dsp_device device,
+                                dsp_image_properties_t *image,
+                                const dsp_roi_t rois[],
+                                size_t rois_count,
+                                uint32_t kernel_size,
+                                dsp_plan *plan);
+
+/**
+ * @brief Create a plan of blur with a mode and a kernel size per ROI. See ::dsp_blur_rois
+ * @param device A ::dsp_device object. The plan is executed on this device
+ * @param image A base image to blur
+ * @param rois An array of ROI blur parameters
+ * @param rois_count \p rois array size
+ * @param[out] plan A pointer to a ::dsp_plan that receives the created plan
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ * @note As in ::dsp_blur_rois, more than 80 \p ROIs are blurred by chained requests, which the plan executes together
+ */
+dsp_status dsp_plan_create_blur_rois(dsp_device device,
+                                     dsp_image_properties_t *image,
+                                     const dsp_blur_roi_params_t rois[],
+                                     size_t rois_count,
+                                     dsp_plan *plan);
+
+/**
+ * @brief Create a format conversion plan. See ::dsp_convert_format
+ * @param device A ::dsp_device object. The plan is executed on this device
+ * @param src Source image metadata - holds the image to convert
+ * @param dst Destination image metadata - will hold the converted image
+ * @param[out] plan A pointer to a ::dsp_plan that receives the created plan
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ */
+dsp_status dsp_plan_create_convert_format(dsp_device device,
+                                          const dsp_image_properties_t *src,
+                                          dsp_image_properties_t *dst,
+                                          dsp_plan *plan);
+
+/**
+ * @brief Create a dewarp plan. See ::dsp_dewarp
+ * @param device A ::dsp_device object. The plan is executed on this device
+ * @param src Image metadata for source image
+ * @param dst Image metadata for destination image
+ * @param mesh Mesh information. The mesh table is referenced, not copied
+ * @param interpolation Interpolation method to use
+ * @param[out] plan A pointer to a ::dsp_plan that receives the created plan
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ */
+dsp_status dsp_plan_create_dewarp(dsp_device device,
+                                  const dsp_image_properties_t *src,
+                                  const dsp_image_properties_t *dst,
+                                  const dsp_dewarp_mesh_t *mesh,
+                                  dsp_interpolation_type_t interpolation,
+                                  dsp_plan *plan);
+
+/**
+ * @brief Get the number of planes that ::dsp_plan_execute expects
+ * @param plan A ::dsp_plan object
+ * @param[out] planes_count Receives the number of planes
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ */
+dsp_status dsp_plan_get_planes_count(dsp_plan plan, size_t *planes_count);
+
+/**
+ * @brief Execute a plan with new image data, and wait for it to complete
+ * @param plan A ::dsp_plan object
+ * @param planes The planes of the plan images, in order. Only the data pointer (or dma-buf fd) may differ from the
+ *               planes the plan was created with: bytesperline and bytesused must be identical, and the memory type
+ *               of each image is the one it was created with
+ * @param planes_count \p planes array size. Must be equal to the count returned by ::dsp_plan_get_planes_count
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ * @note A plan may not be executed from several threads at the same time
+ */
+dsp_status dsp_plan_execute(dsp_plan plan, const dsp_data_plane_t planes[], size_t planes_count);
+
+/**
+ * Release dsp_plan object
+ *
+ * @param plan A ::dsp_plan to be released
+ * @return Upon success, returns ::DSP_SUCCESS. Otherwise, returns a ::dsp_status error
+ */
+dsp_status dsp_release_plan(dsp_plan plan);
+
 /**
  *  @}
  */
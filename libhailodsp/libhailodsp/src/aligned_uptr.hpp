@@ -21,6 +21,10 @@
  * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
+#pragma once
+
+#include "host_stats.hpp"
+
 #include <cstdlib>
 #include <memory>
 
@@ -32,5 +36,15 @@ using unique_ptr_aligned = std::unique_ptr<T, decltype(&free)>;
 template <class T>
 unique_ptr_aligned<T> make_aligned_uptr(size_t align = getpagesize())
 {
+    host_stats_count_allocation();
     return unique_ptr_aligned<T>(static_cast<T *>(aligned_alloc(align, sizeof(T))), &free);
-}
\ No newline at end of file
+}
+
+template <class T>
+unique_ptr_aligned<T> make_aligned_array_uptr(size_t count, size_t align = getpagesize())
+{
+    // aligned_alloc requires the size to be a multiple of the alignment
+    size_t size = ((count * sizeof(T) + align - 1) / align) * align;
+    host_stats_count_allocation();
+    return unique_ptr_aligned<T>(static_cast<T *>(aligned_alloc(align, size)), &free);
+}
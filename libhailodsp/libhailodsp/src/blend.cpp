@@ -21,16 +21,26 @@
  * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
-#include "aligned_uptr.hpp"
 #include "blend_perf.h"
+#include "cmdbuf.hpp"
+#include "device.hpp"
 #include "hailo/hailodsp.h"
+#include "hailodsp_driver.hpp"
 #include "image_utils.hpp"
+#include "inline_vector.hpp"
+#include "job.hpp"
 #include "logger_macros.hpp"
+#include "plan.hpp"
+#include "rgba_to_a420.hpp"
 #include "send_command.hpp"
 #include "user_dsp_interface.h"
 
+#include <cstdint>
 #include <cstdio>
+#include <cstring>
+#include <memory>
 #include <utils.h>
+#include <vector>
 
 static dsp_status verify_overlay_params(const dsp_image_properties_t *image, const dsp_overlay_properties_t *overlay)
 {
@@ -53,42 +63,43 @@ static dsp_status verify_overlay_params(const dsp_image_properties_t *image, con
     return DSP_SUCCESS;
 }
 
-dsp_status dsp_blend_perf(dsp_device device,
-                          const dsp_image_properties_t *image,
-                          const dsp_overlay_properties_t overlays[],
-                          size_t overlays_count,
-                          perf_info_t *perf_info)
+static dsp_status verify_background_image(const dsp_image_properties_t *image)
 {
-    if ((!device) || (!image) || (!overlays)) {
-        LOGGER__ERROR("Error: One of the parameters provided is NULL (device={}, image={}, overlays={})\n",
-                      fmt::ptr(device), fmt::ptr(image), fmt::ptr(overlays));
+    auto status = verify_image_properties(image);
+    if (status != DSP_SUCCESS) {
+        LOGGER__ERROR("Error: Image properties check failed for \"image\"\n");
+        return status;
+    }
+
+    if (image->format != DSP_IMAGE_FORMAT_NV12) {
+        LOGGER__ERROR("Error: Image format ({}) is not supported\n", format_arg_to_string(image->format));
         return DSP_INVALID_ARGUMENT;
     }
 
+    return DSP_SUCCESS;
+}
+
+static dsp_status build_blend_command(const dsp_image_properties_t *image,
+                                      const dsp_overlay_properties_t overlays[],
+                                      size_t overlays_count,
+                                      imaging_request_t *in_data,
+                                      BufferList &buffer_list)
+{
     if (overlays_count > MAX_BLEND_OVERLAYS) {
         LOGGER__ERROR("Error: Too many overlays. The operation supports up to {} overlays\n", MAX_BLEND_OVERLAYS);
         return DSP_INVALID_ARGUMENT;
     }
 
-    auto status = verify_image_properties(image);
+    auto status = verify_background_image(image);
     if (status != DSP_SUCCESS) {
-        LOGGER__ERROR("Error: Image properties check failed for \"image\"\n");
         return status;
     }
 
-    if (image->format != DSP_IMAGE_FORMAT_NV12) {
-        LOGGER__ERROR("Error: Image format ({}) is not supported\n", format_arg_to_string(image->format));
-        return DSP_INVALID_ARGUMENT;
-    }
-
-    auto in_data = make_aligned_uptr<imaging_request_t>();
     in_data->operation = IMAGING_OP_BLEND;
     in_data->blend_args.overlays_count = overlays_count;
 
-    std::vector<command_image_t> images;
-    images.reserve(overlays_count + 1);
-
-    images.emplace_back(command_image_t{
+    InlineVector<command_image_t, 1 + MAX_BLEND_OVERLAYS> images;
+    images.push_back(command_image_t{
         .user_api_image = image,
         .dsp_api_image = &in_data->blend_args.background,
         .access_type = BufferAccessType::ReadWrite,
@@ -112,7 +123,7 @@ dsp_status dsp_blend_perf(dsp_device device,
             return DSP_INVALID_ARGUMENT;
         }
 
-        images.emplace_back(command_image_t{
+        images.push_back(command_image_t{
             .user_api_image = &overlays[i].overlay,
             .dsp_api_image = &in_data->blend_args.overlays[i].overlay,
             .access_type = BufferAccessType::Read,
@@ -122,8 +133,44 @@ dsp_status dsp_blend_perf(dsp_device device,
         in_data->blend_args.overlays[i].y_offset = overlays[i].y_offset;
     }
 
-    size_t perf_info_size = perf_info ? sizeof(*perf_info) : 0;
-    status = send_command(device, images, in_data.get(), sizeof(imaging_request_t), perf_info, perf_info_size);
+    return add_images_to_buffer_list(buffer_list, images);
+}
+
+// Overlays beyond the limit of a single request are blended by chained requests, in order, so overlays that are later
+// in the array are still blended on top of earlier ones
+static dsp_status build_chained_blend_command(const dsp_image_properties_t *image,
+                                              const dsp_overlay_properties_t overlays[],
+                                              size_t overlays_count,
+                                              ImagingCommand &command)
+{
+    size_t requests_count = MAX(DIV_ROUND_UP(overlays_count, (size_t)MAX_BLEND_OVERLAYS), (size_t)1);
+    return build_chained_command(command, requests_count,
+                                 [&](size_t index, imaging_request_t *request, BufferList &buffer_list) {
+                                     size_t first = index * MAX_BLEND_OVERLAYS;
+                                     size_t count = MIN(overlays_count - first, (size_t)MAX_BLEND_OVERLAYS);
+                                     return build_blend_command(image, &overlays[first], count, request, buffer_list);
+                                 });
+}
+
+dsp_status dsp_blend_perf(dsp_device device,
+                          const dsp_image_properties_t *image,
+                          const dsp_overlay_properties_t overlays[],
+                          size_t overlays_count,
+                          perf_info_t *perf_info)
+{
+    if ((!device) || (!image) || (!overlays)) {
+        LOGGER__ERROR("Error: One of the parameters provided is NULL (device={}, image={}, overlays={})\n",
+                      fmt::ptr(device), fmt::ptr(image), fmt::ptr(overlays));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    ImagingCommand command;
+    auto status = build_chained_blend_command(image, overlays, overlays_count, command);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    status = send_command(device, command, perf_info);
     if (status != DSP_SUCCESS) {
         LOGGER__ERROR("Error: Failed executing blend operation. Error code: {}\n", status);
     }
@@ -138,3 +185,1062 @@ dsp_status dsp_blend(dsp_device device,
 {
     return dsp_blend_perf(device, image, overlays, overlays_count, NULL);
 }
+
+dsp_status dsp_blend_async(dsp_device device,
+                           const dsp_image_properties_t *image,
+                           const dsp_overlay_properties_t overlays[],
+                           size_t overlays_count,
+                           dsp_job *job)
+{
+    if ((!device) || (!image) || (!overlays) || (!job)) {
+        LOGGER__ERROR("Error: One of the parameters provided is NULL (device={}, image={}, overlays={}, job={})\n",
+                      fmt::ptr(device), fmt::ptr(image), fmt::ptr(overlays), fmt::ptr(job));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    ImagingCommand command;
+    auto status = build_chained_blend_command(image, overlays, overlays_count, command);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    return submit_command_async(device, std::move(command), NULL, job);
+}
+
+dsp_status dsp_cmdbuf_record_blend(dsp_cmdbuf cmdbuf,
+                                   const dsp_image_properties_t *image,
+                                   const dsp_overlay_properties_t overlays[],
+                                   size_t overlays_count)
+{
+    if ((!cmdbuf) || (!image) || (!overlays)) {
+        LOGGER__ERROR("Error: One of the parameters provided is NULL (cmdbuf={}, image={}, overlays={})\n",
+                      fmt::ptr(cmdbuf), fmt::ptr(image), fmt::ptr(overlays));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    std::vector<const dsp_image_properties_t *> images = {image};
+    for (size_t i = 0; i < overlays_count; ++i) {
+        images.push_back(&overlays[i].overlay);
+    }
+
+    size_t requests_count = MAX(DIV_ROUND_UP(overlays_count, (size_t)MAX_BLEND_OVERLAYS), (size_t)1);
+    return cmdbuf_record_chain(cmdbuf, images, requests_count,
+                               [&](size_t index, imaging_request_t *request, BufferList &buffer_list) {
+                                   size_t first = index * MAX_BLEND_OVERLAYS;
+                                   size_t count = MIN(overlays_count - first, (size_t)MAX_BLEND_OVERLAYS);
+                                   return build_blend_command(image, &overlays[first], count, request, buffer_list);
+                               });
+}
+
+dsp_status dsp_plan_create_blend(dsp_device device,
+                                 const dsp_image_properties_t *image,
+                                 const dsp_overlay_properties_t overlays[],
+                                 size_t overlays_count,
+                                 dsp_plan *plan)
+{
+    if ((!image) || (!overlays)) {
+        LOGGER__ERROR("Error: One of the parameters provided is NULL (image={}, overlays={})\n", fmt::ptr(image),
+                      fmt::ptr(overlays));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    std::vector<const dsp_image_properties_t *> images = {image};
+    for (size_t i = 0; i < MIN(overlays_count, (size_t)MAX_BLEND_OVERLAYS); ++i) {
+        images.push_back(&overlays[i].overlay);
+    }
+
+    return plan_create(device, images, plan, [&](imaging_request_t *request, BufferList &buffer_list) {
+        return build_blend_command(image, overlays, overlays_count, request, buffer_list);
+    });
+}
+
+static dsp_status verify_atlas_label(const dsp_image_properties_t *image,
+                                     const dsp_image_properties_t *atlas,
+                                     const dsp_atlas_label_t &label)
+{
+    const auto &rect = label.rect;
+    if ((rect.start_x >= rect.end_x) || (rect.start_y >= rect.end_y) || (rect.end_x > atlas->width) ||
+        (rect.end_y > atlas->height) || ((rect.start_x | rect.start_y | rect.end_x | rect.end_y) & 1)) {
+        LOGGER__ERROR("Error: Invalid label rect ({}, {}) - ({}, {}) for atlas of size {}x{}. Coordinates must be "
+                      "even\n",
+                      rect.start_x, rect.start_y, rect.end_x, rect.end_y, atlas->width, atlas->height);
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    // Compared without adding the offsets, which may be large enough to overflow
+    size_t width = rect.end_x - rect.start_x;
+    size_t height = rect.end_y - rect.start_y;
+    if ((width > image->width) || (label.x_offset > image->width - width) || (height > image->height) ||
+        (label.y_offset > image->height - height)) {
+        LOGGER__ERROR("Error: Label at ({}, {}) of size {}x{} is beyond image dimensions ({}x{})\n", label.x_offset,
+                      label.y_offset, width, height, image->width, image->height);
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    return DSP_SUCCESS;
+}
+
+static dsp_status build_blend_atlas_command(const dsp_image_properties_t *image,
+                                            const dsp_image_properties_t *atlas,
+                                            const dsp_atlas_label_t labels[],
+                                            size_t labels_count,
+                                            ImagingCommand &command)
+{
+    if ((labels_count == 0) || (labels_count > DSP_BLEND_ATLAS_MAX_LABELS)) {
+        LOGGER__ERROR("Error: Labels count ({}) must be between 1 and {}\n", labels_count, DSP_BLEND_ATLAS_MAX_LABELS);
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    auto status = verify_background_image(image);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    status = verify_image_properties(atlas);
+    if (status != DSP_SUCCESS) {
+        LOGGER__ERROR("Error: Image properties check failed for \"atlas\"\n");
+        return status;
+    }
+
+    if (atlas->format != DSP_IMAGE_FORMAT_A420) {
+        LOGGER__ERROR("Error: Atlas format ({}) is not supported\n", format_arg_to_string(atlas->format));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    for (size_t i = 0; i < labels_count; ++i) {
+        status = verify_atlas_label(image, atlas, labels[i]);
+        if (status != DSP_SUCCESS) {
+            LOGGER__ERROR("Error: Label parameters check failed for \"labels[{}]\"\n", i);
+            return status;
+        }
+    }
+
+    // The entries are passed to the DSP in a buffer of their own, owned by the command
+    size_t entries_size = labels_count * sizeof(blend_atlas_entry_t);
+    {
+        HOST_STATS_STAGE(DSP_HOST_STAGE_REQUEST_ALLOC);
+        command.payload = make_aligned_array_uptr<uint8_t>(entries_size);
+    }
+    if (!command.payload) {
+        LOGGER__ERROR("Failed to allocate memory for {} blend atlas entries", labels_count);
+        return DSP_OUT_OF_HOST_MEMORY;
+    }
+    auto entries = reinterpret_cast<blend_atlas_entry_t *>(command.payload.get());
+
+    auto &args = command.request->blend_atlas_args;
+    command.request->operation = IMAGING_OP_BLEND_ATLAS;
+    args.entries_count = labels_count;
+    args.entries.line_stride = sizeof(blend_atlas_entry_t);
+    args.entries.plane_size = entries_size;
+    status =
+        command.buffer_list.add_buffer(entries, entries_size, BufferAccessType::Read, args.entries.xrp_buffer_index);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    for (size_t i = 0; i < labels_count; ++i) {
+        entries[i] = {
+            .src =
+                {
+                    .start_x = static_cast<uint32_t>(labels[i].rect.start_x),
+                    .start_y = static_cast<uint32_t>(labels[i].rect.start_y),
+                    .end_x = static_cast<uint32_t>(labels[i].rect.end_x),
+                    .end_y = static_cast<uint32_t>(labels[i].rect.end_y),
+                },
+            .x_offset = static_cast<uint32_t>(labels[i].x_offset),
+            .y_offset = static_cast<uint32_t>(labels[i].y_offset),
+        };
+    }
+
+    command_image_t images[] = {
+        {image, &args.background, BufferAccessType::ReadWrite},
+        {atlas, &args.atlas, BufferAccessType::Read},
+    };
+    return add_images_to_buffer_list(command.buffer_list, images);
+}
+
+dsp_status dsp_blend_atlas(dsp_device device,
+                           const dsp_image_properties_t *image,
+                           const dsp_image_properties_t *atlas,
+                           const dsp_atlas_label_t labels[],
+                           size_t labels_count)
+{
+    if ((!device) || (!image) || (!atlas) || (!labels)) {
+        LOGGER__ERROR("Error: One of the parameters provided is NULL (device={}, image={}, atlas={}, labels={})\n",
+                      fmt::ptr(device), fmt::ptr(image), fmt::ptr(atlas), fmt::ptr(labels));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    ImagingCommand command;
+    auto status = build_blend_atlas_command(image, atlas, labels, labels_count, command);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    status = send_command(device, command, NULL);
+    if (status != DSP_SUCCESS) {
+        LOGGER__ERROR("Error: Failed executing blend atlas operation. Error code: {}\n", status);
+    }
+
+    return status;
+}
+
+dsp_status dsp_blend_atlas_async(dsp_device device,
+                                 const dsp_image_properties_t *image,
+                                 const dsp_image_properties_t *atlas,
+                                 const dsp_atlas_label_t labels[],
+                                 size_t labels_count,
+                                 dsp_job *job)
+{
+    if ((!device) || (!image) || (!atlas) || (!labels) || (!job)) {
+        LOGGER__ERROR(
+            "Error: One of the parameters provided is NULL (device={}, image={}, atlas={}, labels={}, job={})\n",
+            fmt::ptr(device), fmt::ptr(image), fmt::ptr(atlas), fmt::ptr(labels), fmt::ptr(job));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    ImagingCommand command;
+    auto status = build_blend_atlas_command(image, atlas, labels, labels_count, command);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    return submit_command_async(device, std::move(command), NULL, job);
+}
+
+/*
+ * Persistent overlays
+ */
+
+// Lines per hashed band of RGBA overlays. Bands are even, so that they cover whole chroma lines
+#define OVERLAY_RGBA_BAND_LINES (16)
+
+struct _dsp_overlay {
+    dsp_device device;
+    // DSP buffer holding the tightly packed planes, registered so that blends reference it by handle
+    uint8_t *buffer;
+    size_t buffer_size;
+    dsp_data_plane_t planes[MAX_PLANES];
+    dsp_image_properties_t image;
+    // Overlay image in the DSP interface format, without the xrp buffer indexes that are assigned per command
+    image_properties_t encoded;
+    // Hashes of the RGBA bands that the content was converted from. Empty when the content was not converted from RGBA
+    std::vector<uint64_t> band_hashes;
+};
+
+struct _dsp_overlay_set {
+    dsp_device device;
+    std::vector<dsp_overlay_placement_t> placements;
+    // Smallest background that all the overlays fit in, so that a blend verifies the placements by a single check
+    size_t min_width;
+    size_t min_height;
+};
+
+// The U and V planes of A420 are subsampled by 2 on both axes
+static size_t a420_plane_ratio(size_t plane_index)
+{
+    return ((plane_index == 1) || (plane_index == 2)) ? 2 : 1;
+}
+
+static dsp_status verify_overlay_source(dsp_overlay overlay, const dsp_image_properties_t *image)
+{
+    auto status = verify_image_properties(image);
+    if (status != DSP_SUCCESS) {
+        LOGGER__ERROR("Error: Image properties check failed for \"image\"\n");
+        return status;
+    }
+
+    if ((image->format != DSP_IMAGE_FORMAT_A420) || (image->memory != DSP_MEMORY_TYPE_USERPTR)) {
+        LOGGER__ERROR("Error: Overlay format ({}) or memory type ({}) is not supported\n",
+                      format_arg_to_string(image->format), image->memory);
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    if (overlay && ((image->width != overlay->image.width) || (image->height != overlay->image.height))) {
+        LOGGER__ERROR("Error: Image size ({}x{}) differs from the overlay size ({}x{})\n", image->width,
+                      image->height, overlay->image.width, overlay->image.height);
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    return DSP_SUCCESS;
+}
+
+// Copies "rect" of every plane of "image" into the DSP buffer of the overlay, at (dst_x, dst_y). Each plane is written
+// between its own cache synchronization, which covers the lines of the rect only. All the coordinates are even
+static dsp_status copy_overlay_rect(dsp_overlay overlay,
+                                    const dsp_image_properties_t *image,
+                                    const dsp_roi_t &rect,
+                                    size_t dst_x,
+                                    size_t dst_y)
+{
+    auto &driver = *overlay->device->driver;
+    for (size_t i = 0; i < overlay->image.planes_count; ++i) {
+        size_t ratio = a420_plane_ratio(i);
+        size_t start_x = rect.start_x / ratio;
+        size_t start_y = rect.start_y / ratio;
+        size_t width = rect.end_x / ratio - start_x;
+        size_t height = rect.end_y / ratio - start_y;
+
+        const auto &src = image->planes[i];
+        const auto &dst = overlay->planes[i];
+        auto src_line = static_cast<const uint8_t *>(src.userptr) + start_y * src.bytesperline + start_x;
+        auto dst_line = static_cast<uint8_t *>(dst.userptr) + dst_y / ratio * dst.bytesperline + dst_x / ratio;
+        size_t dirty_size = (height - 1) * dst.bytesperline + width;
+
+        auto status = driver_sync_buffer_start(driver, dst_line, dirty_size, DSP_BUFFER_SYNC_WRITE);
+        if (status != DSP_SUCCESS) {
+            return status;
+        }
+
+        if ((width == dst.bytesperline) && (src.bytesperline == dst.bytesperline)) {
+            memcpy(dst_line, src_line, dirty_size);
+        } else {
+            for (size_t y = 0; y < height; ++y) {
+                memcpy(dst_line + y * dst.bytesperline, src_line + y * src.bytesperline, width);
+            }
+        }
+
+        status = driver_sync_buffer_end(driver, dst_line, dirty_size, DSP_BUFFER_SYNC_WRITE);
+        if (status != DSP_SUCCESS) {
+            return status;
+        }
+    }
+
+    return DSP_SUCCESS;
+}
+
+// Allocates an A420 overlay of the given size, with undefined content
+static dsp_status allocate_overlay(dsp_device device, size_t width, size_t height, dsp_overlay *overlay)
+{
+    auto local_overlay = std::unique_ptr<_dsp_overlay>(new (std::nothrow) _dsp_overlay{
+        .device = device,
+        .buffer = nullptr,
+        .buffer_size = 0,
+        .planes = {},
+        .image = {},
+        .encoded = {},
+        .band_hashes = {},
+    });
+    if (!local_overlay) {
+        LOGGER__ERROR("Failed to allocate memory for overlay");
+        return DSP_OUT_OF_HOST_MEMORY;
+    }
+
+    size_t planes_count;
+    auto status = get_packed_image_layout(DSP_IMAGE_FORMAT_A420, width, height, local_overlay->planes, planes_count);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    for (size_t i = 0; i < planes_count; ++i) {
+        local_overlay->buffer_size += local_overlay->planes[i].bytesused;
+    }
+
+    void *buffer;
+    status = dsp_create_buffer(device, local_overlay->buffer_size, &buffer);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    // Pinned once, so the driver does not map the overlay again on every blend
+    status = dsp_register_buffer(device, buffer, local_overlay->buffer_size);
+    if (status != DSP_SUCCESS) {
+        (void)dsp_release_buffer(device, buffer);
+        return status;
+    }
+
+    local_overlay->buffer = static_cast<uint8_t *>(buffer);
+    size_t offset = 0;
+    for (size_t i = 0; i < planes_count; ++i) {
+        local_overlay->planes[i].userptr = local_overlay->buffer + offset;
+        offset += local_overlay->planes[i].bytesused;
+    }
+
+    local_overlay->image = dsp_image_properties_t{
+        .width = width,
+        .height = height,
+        .planes = local_overlay->planes,
+        .planes_count = planes_count,
+        .format = DSP_IMAGE_FORMAT_A420,
+        .memory = DSP_MEMORY_TYPE_USERPTR,
+    };
+    status = convert_image(&local_overlay->image, &local_overlay->encoded);
+    if (status != DSP_SUCCESS) {
+        (void)dsp_release_overlay(local_overlay.release());
+        return status;
+    }
+
+    *overlay = local_overlay.release();
+    return DSP_SUCCESS;
+}
+
+dsp_status dsp_create_overlay(dsp_device device, const dsp_image_properties_t *image, dsp_overlay *overlay)
+{
+    if ((!device) || (!image) || (!overlay)) {
+        LOGGER__ERROR("Error: NULL argument (device={}, image={}, overlay={})\n", fmt::ptr(device), fmt::ptr(image),
+                      fmt::ptr(overlay));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    auto status = verify_overlay_source(NULL, image);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    dsp_overlay local_overlay;
+    status = allocate_overlay(device, image->width, image->height, &local_overlay);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    status = copy_overlay_rect(local_overlay, image, {0, 0, image->width, image->height}, 0, 0);
+    if (status != DSP_SUCCESS) {
+        (void)dsp_release_overlay(local_overlay);
+        return status;
+    }
+
+    *overlay = local_overlay;
+    return DSP_SUCCESS;
+}
+
+// Synchronizes lines [start_y, end_y) of all the planes of the overlay, for writing by the CPU. "start_y" and "end_y"
+// are even
+static dsp_status sync_overlay_lines(dsp_overlay overlay,
+                                     size_t start_y,
+                                     size_t end_y,
+                                     decltype(&driver_sync_buffer_start) sync)
+{
+    for (size_t i = 0; i < overlay->image.planes_count; ++i) {
+        size_t ratio = a420_plane_ratio(i);
+        const auto &plane = overlay->planes[i];
+        auto first_line = static_cast<uint8_t *>(plane.userptr) + start_y / ratio * plane.bytesperline;
+        auto status = sync(*overlay->device->driver, first_line, (end_y - start_y) / ratio * plane.bytesperline,
+                           DSP_BUFFER_SYNC_WRITE);
+        if (status != DSP_SUCCESS) {
+            return status;
+        }
+    }
+
+    return DSP_SUCCESS;
+}
+
+// Converts lines [start_y, end_y) of "rgba" into the overlay, between a single cache synchronization
+static dsp_status convert_overlay_lines(dsp_overlay overlay, const dsp_data_plane_t &rgba, size_t start_y, size_t end_y)
+{
+    if (start_y == end_y) {
+        return DSP_SUCCESS;
+    }
+
+    auto status = sync_overlay_lines(overlay, start_y, end_y, driver_sync_buffer_start);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    convert_rgba_to_a420(rgba, overlay->image.width, start_y, end_y, overlay->planes);
+    return sync_overlay_lines(overlay, start_y, end_y, driver_sync_buffer_end);
+}
+
+// Converts the bands of "rgba" whose hash differs from the hash of the content that the overlay was last converted
+// from. Consecutive dirty bands are converted together, so an unchanged image costs hashing only
+static dsp_status commit_rgba(dsp_overlay overlay, const dsp_data_plane_t &rgba)
+{
+    size_t height = overlay->image.height;
+    size_t bands_count = DIV_ROUND_UP(height, OVERLAY_RGBA_BAND_LINES);
+    bool had_hashes = !overlay->band_hashes.empty();
+    overlay->band_hashes.resize(bands_count);
+
+    // Lines of the pending run of dirty bands
+    size_t dirty_start_y = 0;
+    size_t dirty_end_y = 0;
+    auto status = DSP_SUCCESS;
+    for (size_t band = 0; (band < bands_count) && (status == DSP_SUCCESS); ++band) {
+        size_t start_y = band * OVERLAY_RGBA_BAND_LINES;
+        size_t end_y = MIN(height, start_y + OVERLAY_RGBA_BAND_LINES);
+        uint64_t hash = hash_rgba_lines(rgba, overlay->image.width, start_y, end_y);
+        bool dirty = (!had_hashes) || (hash != overlay->band_hashes[band]);
+        overlay->band_hashes[band] = hash;
+
+        if (dirty) {
+            dirty_start_y = (dirty_start_y == dirty_end_y) ? start_y : dirty_start_y;
+            dirty_end_y = end_y;
+        } else {
+            status = convert_overlay_lines(overlay, rgba, dirty_start_y, dirty_end_y);
+            dirty_start_y = dirty_end_y;
+        }
+    }
+
+    if (status == DSP_SUCCESS) {
+        status = convert_overlay_lines(overlay, rgba, dirty_start_y, dirty_end_y);
+    }
+    if (status != DSP_SUCCESS) {
+        // The content is unknown, so the next update converts every band
+        overlay->band_hashes.clear();
+    }
+
+    return status;
+}
+
+dsp_status dsp_create_overlay_rgba(dsp_device device,
+                                   const dsp_data_plane_t *rgba,
+                                   size_t width,
+                                   size_t height,
+                                   dsp_overlay *overlay)
+{
+    if ((!device) || (!rgba) || (!overlay)) {
+        LOGGER__ERROR("Error: NULL argument (device={}, rgba={}, overlay={})\n", fmt::ptr(device), fmt::ptr(rgba),
+                      fmt::ptr(overlay));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    auto status = verify_rgba_plane(rgba, width, height);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    dsp_overlay local_overlay;
+    status = allocate_overlay(device, width, height, &local_overlay);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    status = commit_rgba(local_overlay, *rgba);
+    if (status != DSP_SUCCESS) {
+        (void)dsp_release_overlay(local_overlay);
+        return status;
+    }
+
+    *overlay = local_overlay;
+    return DSP_SUCCESS;
+}
+
+dsp_status dsp_overlay_update_rgba(dsp_overlay overlay, const dsp_data_plane_t *rgba)
+{
+    if ((!overlay) || (!rgba)) {
+        LOGGER__ERROR("Error: NULL argument (overlay={}, rgba={})\n", fmt::ptr(overlay), fmt::ptr(rgba));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    auto status = verify_rgba_plane(rgba, overlay->image.width, overlay->image.height);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    return commit_rgba(overlay, *rgba);
+}
+
+dsp_status dsp_release_overlay(dsp_overlay overlay)
+{
+    if (!overlay) {
+        LOGGER__ERROR("Error: overlay is NULL\n");
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    if (overlay->buffer) {
+        (void)dsp_unregister_buffer(overlay->device, overlay->buffer);
+        (void)dsp_release_buffer(overlay->device, overlay->buffer);
+    }
+
+    delete overlay;
+    return DSP_SUCCESS;
+}
+
+dsp_status dsp_overlay_update(dsp_overlay overlay, const dsp_image_properties_t *image, const dsp_roi_t *dirty_rect)
+{
+    if ((!overlay) || (!image)) {
+        LOGGER__ERROR("Error: NULL argument (overlay={}, image={})\n", fmt::ptr(overlay), fmt::ptr(image));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    auto status = verify_overlay_source(overlay, image);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    dsp_roi_t rect = {0, 0, image->width, image->height};
+    if (dirty_rect) {
+        if ((dirty_rect->start_x >= dirty_rect->end_x) || (dirty_rect->start_y >= dirty_rect->end_y) ||
+            (dirty_rect->end_x > image->width) || (dirty_rect->end_y > image->height)) {
+            LOGGER__ERROR("Error: Invalid dirty rect ({}, {}) - ({}, {}) for overlay of size {}x{}\n",
+                          dirty_rect->start_x, dirty_rect->start_y, dirty_rect->end_x, dirty_rect->end_y,
+                          image->width, image->height);
+            return DSP_INVALID_ARGUMENT;
+        }
+
+        // Widened to even coordinates, so that the rect covers whole chroma samples. The overlay size is even
+        rect = {
+            .start_x = dirty_rect->start_x & ~(size_t)1,
+            .start_y = dirty_rect->start_y & ~(size_t)1,
+            .end_x = ROUND_UP(dirty_rect->end_x, 2),
+            .end_y = ROUND_UP(dirty_rect->end_y, 2),
+        };
+    }
+
+    // The content no longer matches the RGBA it was converted from
+    overlay->band_hashes.clear();
+    return copy_overlay_rect(overlay, image, rect, rect.start_x, rect.start_y);
+}
+
+dsp_status dsp_overlay_get_image(dsp_overlay overlay, const dsp_image_properties_t **image)
+{
+    if ((!overlay) || (!image)) {
+        LOGGER__ERROR("Error: NULL argument (overlay={}, image={})\n", fmt::ptr(overlay), fmt::ptr(image));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    *image = &overlay->image;
+    return DSP_SUCCESS;
+}
+
+dsp_status dsp_create_overlay_set(const dsp_overlay_placement_t placements[],
+                                  size_t placements_count,
+                                  dsp_overlay_set *overlay_set)
+{
+    if ((!placements) || (!overlay_set)) {
+        LOGGER__ERROR("Error: NULL argument (placements={}, overlay_set={})\n", fmt::ptr(placements),
+                      fmt::ptr(overlay_set));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    if (placements_count == 0) {
+        LOGGER__ERROR("Error: An overlay set must contain at least one overlay\n");
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    size_t min_width = 0;
+    size_t min_height = 0;
+    for (size_t i = 0; i < placements_count; ++i) {
+        auto overlay = placements[i].overlay;
+        if (!overlay) {
+            LOGGER__ERROR("Error: placements[{}].overlay is NULL\n", i);
+            return DSP_INVALID_ARGUMENT;
+        }
+
+        // Overlays are referenced by the handles of their device
+        if (overlay->device != placements[0].overlay->device) {
+            LOGGER__ERROR("Error: The overlays of a set must be created on the same device\n");
+            return DSP_INVALID_ARGUMENT;
+        }
+
+        // The offsets may be large enough for the overlay end to overflow
+        if ((placements[i].x_offset > SIZE_MAX - overlay->image.width) ||
+            (placements[i].y_offset > SIZE_MAX - overlay->image.height)) {
+            LOGGER__ERROR("Error: Offset ({}, {}) of placements[{}] is out of range\n", placements[i].x_offset,
+                          placements[i].y_offset, i);
+            return DSP_INVALID_ARGUMENT;
+        }
+
+        min_width = MAX(min_width, placements[i].x_offset + overlay->image.width);
+        min_height = MAX(min_height, placements[i].y_offset + overlay->image.height);
+    }
+
+    auto local_set = std::unique_ptr<_dsp_overlay_set>(new (std::nothrow) _dsp_overlay_set{
+        .device = placements[0].overlay->device,
+        .placements = std::vector<dsp_overlay_placement_t>(placements, placements + placements_count),
+        .min_width = min_width,
+        .min_height = min_height,
+    });
+    if (!local_set) {
+        LOGGER__ERROR("Failed to allocate memory for overlay set");
+        return DSP_OUT_OF_HOST_MEMORY;
+    }
+
+    *overlay_set = local_set.release();
+    return DSP_SUCCESS;
+}
+
+dsp_status dsp_release_overlay_set(dsp_overlay_set overlay_set)
+{
+    if (!overlay_set) {
+        LOGGER__ERROR("Error: overlay_set is NULL\n");
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    delete overlay_set;
+    return DSP_SUCCESS;
+}
+
+// Blends part "index" of an overlay set. The overlays were verified when they were created, so only the background
+// image is verified, and the overlay images are copied from their pre-encoded form
+static dsp_status build_blend_overlay_set_command(const dsp_image_properties_t *image,
+                                                  dsp_overlay_set overlay_set,
+                                                  size_t index,
+                                                  imaging_request_t *in_data,
+                                                  BufferList &buffer_list)
+{
+    auto status = verify_background_image(image);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    if ((overlay_set->min_width > image->width) || (overlay_set->min_height > image->height)) {
+        LOGGER__ERROR("Error: Overlay set requires an image of at least {}x{} (image size: {}x{})\n",
+                      overlay_set->min_width, overlay_set->min_height, image->width, image->height);
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    size_t first = index * MAX_BLEND_OVERLAYS;
+    size_t count = MIN(overlay_set->placements.size() - first, (size_t)MAX_BLEND_OVERLAYS);
+    in_data->operation = IMAGING_OP_BLEND;
+    in_data->blend_args.overlays_count = count;
+
+    command_image_t images[] = {{image, &in_data->blend_args.background, BufferAccessType::ReadWrite}};
+    status = add_images_to_buffer_list(buffer_list, images);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        const auto &placement = overlay_set->placements[first + i];
+        const auto overlay = placement.overlay;
+        auto &overlay_args = in_data->blend_args.overlays[i];
+        overlay_args.overlay = overlay->encoded;
+        for (size_t j = 0; j < overlay->encoded.planes_count; ++j) {
+            status = buffer_list.add_plane(overlay->planes[j], BufferAccessType::Read, DSP_MEMORY_TYPE_USERPTR,
+                                           overlay_args.overlay.planes[j].xrp_buffer_index);
+            if (status != DSP_SUCCESS) {
+                return status;
+            }
+        }
+        overlay_args.x_offset = placement.x_offset;
+        overlay_args.y_offset = placement.y_offset;
+    }
+
+    return DSP_SUCCESS;
+}
+
+static size_t overlay_set_requests_count(dsp_overlay_set overlay_set)
+{
+    return DIV_ROUND_UP(overlay_set->placements.size(), (size_t)MAX_BLEND_OVERLAYS);
+}
+
+static dsp_status verify_overlay_set_device(dsp_device device, dsp_overlay_set overlay_set)
+{
+    if (device != overlay_set->device) {
+        LOGGER__ERROR("Error: The overlay set was created on a different device\n");
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    return DSP_SUCCESS;
+}
+
+static dsp_status build_chained_blend_overlay_set_command(const dsp_image_properties_t *image,
+                                                          dsp_overlay_set overlay_set,
+                                                          ImagingCommand &command)
+{
+    return build_chained_command(command, overlay_set_requests_count(overlay_set),
+                                 [&](size_t index, imaging_request_t *request, BufferList &buffer_list) {
+                                     return build_blend_overlay_set_command(image, overlay_set, index, request,
+                                                                            buffer_list);
+                                 });
+}
+
+dsp_status dsp_blend_overlay_set(dsp_device device, const dsp_image_properties_t *image, dsp_overlay_set overlay_set)
+{
+    if ((!device) || (!image) || (!overlay_set)) {
+        LOGGER__ERROR("Error: One of the parameters provided is NULL (device={}, image={}, overlay_set={})\n",
+                      fmt::ptr(device), fmt::ptr(image), fmt::ptr(overlay_set));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    auto status = verify_overlay_set_device(device, overlay_set);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    ImagingCommand command;
+    status = build_chained_blend_overlay_set_command(image, overlay_set, command);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    status = send_command(device, command, NULL);
+    if (status != DSP_SUCCESS) {
+        LOGGER__ERROR("Error: Failed executing blend operation. Error code: {}\n", status);
+    }
+
+    return status;
+}
+
+dsp_status dsp_blend_overlay_set_async(dsp_device device,
+                                       const dsp_image_properties_t *image,
+                                       dsp_overlay_set overlay_set,
+                                       dsp_job *job)
+{
+    if ((!device) || (!image) || (!overlay_set) || (!job)) {
+        LOGGER__ERROR("Error: One of the parameters provided is NULL (device={}, image={}, overlay_set={}, job={})\n",
+                      fmt::ptr(device), fmt::ptr(image), fmt::ptr(overlay_set), fmt::ptr(job));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    auto status = verify_overlay_set_device(device, overlay_set);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    ImagingCommand command;
+    status = build_chained_blend_overlay_set_command(image, overlay_set, command);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    return submit_command_async(device, std::move(command), NULL, job);
+}
+
+dsp_status dsp_cmdbuf_record_blend_overlay_set(dsp_cmdbuf cmdbuf,
+                                               const dsp_image_properties_t *image,
+                                               dsp_overlay_set overlay_set)
+{
+    if ((!cmdbuf) || (!image) || (!overlay_set)) {
+        LOGGER__ERROR("Error: One of the parameters provided is NULL (cmdbuf={}, image={}, overlay_set={})\n",
+                      fmt::ptr(cmdbuf), fmt::ptr(image), fmt::ptr(overlay_set));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    auto status = verify_overlay_set_device(cmdbuf->device, overlay_set);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    // Only the background can be re-bound, the overlays are referenced by their DSP buffers
+    return cmdbuf_record_chain(cmdbuf, {image}, overlay_set_requests_count(overlay_set),
+                               [&](size_t index, imaging_request_t *request, BufferList &buffer_list) {
+                                   return build_blend_overlay_set_command(image, overlay_set, index, request,
+                                                                          buffer_list);
+                               });
+}
+
+dsp_status dsp_plan_create_blend_overlay_set(dsp_device device,
+                                             const dsp_image_properties_t *image,
+                                             dsp_overlay_set overlay_set,
+                                             dsp_plan *plan)
+{
+    if ((!image) || (!overlay_set)) {
+        LOGGER__ERROR("Error: One of the parameters provided is NULL (image={}, overlay_set={})\n", fmt::ptr(image),
+                      fmt::ptr(overlay_set));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    auto status = verify_overlay_set_device(device, overlay_set);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    if (overlay_set_requests_count(overlay_set) > 1) {
+        LOGGER__ERROR("Error: Too many overlays. A plan supports up to {} overlays\n", MAX_BLEND_OVERLAYS);
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    return plan_create(device, {image}, plan, [&](imaging_request_t *request, BufferList &buffer_list) {
+        return build_blend_overlay_set_command(image, overlay_set, 0, request, buffer_list);
+    });
+}
+
+/*
+ * Overlay atlas
+ */
+
+// A row of the atlas. Images are packed left to right, and the row is as high as the first image packed into it
+struct atlas_shelf_t {
+    size_t y;
+    size_t height;
+    size_t used_width;
+};
+
+struct _dsp_overlay_atlas {
+    dsp_overlay overlay;
+    std::vector<atlas_shelf_t> shelves;
+    // Height of all the shelves, below which the atlas is free
+    size_t used_height;
+};
+
+dsp_status dsp_create_overlay_atlas(dsp_device device, size_t width, size_t height, dsp_overlay_atlas *atlas)
+{
+    if ((!device) || (!atlas)) {
+        LOGGER__ERROR("Error: NULL argument (device={}, atlas={})\n", fmt::ptr(device), fmt::ptr(atlas));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    if ((width == 0) || (height == 0) || (width % 2) || (height % 2)) {
+        LOGGER__ERROR("Error: Atlas size ({}x{}) must be even and not 0\n", width, height);
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    auto local_atlas = std::unique_ptr<_dsp_overlay_atlas>(new (std::nothrow) _dsp_overlay_atlas{
+        .overlay = nullptr,
+        .shelves = {},
+        .used_height = 0,
+    });
+    if (!local_atlas) {
+        LOGGER__ERROR("Failed to allocate memory for overlay atlas");
+        return DSP_OUT_OF_HOST_MEMORY;
+    }
+
+    auto status = allocate_overlay(device, width, height, &local_atlas->overlay);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    *atlas = local_atlas.release();
+    return DSP_SUCCESS;
+}
+
+dsp_status dsp_release_overlay_atlas(dsp_overlay_atlas atlas)
+{
+    if (!atlas) {
+        LOGGER__ERROR("Error: atlas is NULL\n");
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    (void)dsp_release_overlay(atlas->overlay);
+    delete atlas;
+    return DSP_SUCCESS;
+}
+
+// Finds room for an image of even size. The image is placed in the lowest shelf that fits it, so that small images
+// do not waste the height of tall shelves, or in a new shelf at the bottom of the atlas
+static dsp_status pack_atlas_image(dsp_overlay_atlas atlas, size_t width, size_t height, dsp_roi_t &rect)
+{
+    const auto &image = atlas->overlay->image;
+    atlas_shelf_t *best = nullptr;
+    for (auto &shelf : atlas->shelves) {
+        if ((shelf.height >= height) && (image.width - shelf.used_width >= width) &&
+            ((!best) || (shelf.height < best->height))) {
+            best = &shelf;
+        }
+    }
+
+    if (!best) {
+        if ((width > image.width) || (height > image.height - atlas->used_height)) {
+            LOGGER__ERROR("Error: No room for an image of size {}x{} in the atlas\n", width, height);
+            return DSP_OUT_OF_ATLAS_SPACE;
+        }
+
+        atlas->shelves.push_back({atlas->used_height, height, 0});
+        atlas->used_height += height;
+        best = &atlas->shelves.back();
+    }
+
+    rect = {best->used_width, best->y, best->used_width + width, best->y + height};
+    best->used_width += width;
+    return DSP_SUCCESS;
+}
+
+// Gives back the room of the last packed image, when it could not be written to the atlas
+static void unpack_atlas_image(dsp_overlay_atlas atlas, const dsp_roi_t &rect)
+{
+    for (auto &shelf : atlas->shelves) {
+        if (shelf.y != rect.start_y) {
+            continue;
+        }
+
+        shelf.used_width = rect.start_x;
+        // A shelf that was created for the image is the last one
+        if (shelf.used_width == 0) {
+            atlas->used_height = shelf.y;
+            atlas->shelves.pop_back();
+        }
+        return;
+    }
+}
+
+dsp_status dsp_overlay_atlas_add(dsp_overlay_atlas atlas, const dsp_image_properties_t *image, dsp_roi_t *rect)
+{
+    if ((!atlas) || (!image) || (!rect)) {
+        LOGGER__ERROR("Error: NULL argument (atlas={}, image={}, rect={})\n", fmt::ptr(atlas), fmt::ptr(image),
+                      fmt::ptr(rect));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    auto status = verify_overlay_source(NULL, image);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    dsp_roi_t packed_rect;
+    status = pack_atlas_image(atlas, image->width, image->height, packed_rect);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    status = copy_overlay_rect(atlas->overlay, image, {0, 0, image->width, image->height}, packed_rect.start_x,
+                               packed_rect.start_y);
+    if (status != DSP_SUCCESS) {
+        unpack_atlas_image(atlas, packed_rect);
+        return status;
+    }
+
+    *rect = packed_rect;
+    return DSP_SUCCESS;
+}
+
+dsp_status dsp_overlay_atlas_add_rgba(dsp_overlay_atlas atlas,
+                                      const dsp_data_plane_t *rgba,
+                                      size_t width,
+                                      size_t height,
+                                      dsp_roi_t *rect)
+{
+    if ((!atlas) || (!rgba) || (!rect)) {
+        LOGGER__ERROR("Error: NULL argument (atlas={}, rgba={}, rect={})\n", fmt::ptr(atlas), fmt::ptr(rgba),
+                      fmt::ptr(rect));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    auto status = verify_rgba_plane(rgba, width, height);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    dsp_roi_t packed_rect;
+    status = pack_atlas_image(atlas, width, height, packed_rect);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    // The planes of the packed region, so that the image is converted in place
+    auto overlay = atlas->overlay;
+    dsp_data_plane_t planes[MAX_PLANES];
+    for (size_t i = 0; i < overlay->image.planes_count; ++i) {
+        size_t ratio = a420_plane_ratio(i);
+        planes[i] = overlay->planes[i];
+        planes[i].userptr = static_cast<uint8_t *>(planes[i].userptr) +
+                            packed_rect.start_y / ratio * planes[i].bytesperline + packed_rect.start_x / ratio;
+    }
+
+    status = sync_overlay_lines(overlay, packed_rect.start_y, packed_rect.end_y, driver_sync_buffer_start);
+    if (status != DSP_SUCCESS) {
+        unpack_atlas_image(atlas, packed_rect);
+        return status;
+    }
+
+    convert_rgba_to_a420(*rgba, width, 0, height, planes);
+    status = sync_overlay_lines(overlay, packed_rect.start_y, packed_rect.end_y, driver_sync_buffer_end);
+    if (status != DSP_SUCCESS) {
+        unpack_atlas_image(atlas, packed_rect);
+        return status;
+    }
+
+    *rect = packed_rect;
+    return DSP_SUCCESS;
+}
+
+dsp_status dsp_overlay_atlas_reset(dsp_overlay_atlas atlas)
+{
+    if (!atlas) {
+        LOGGER__ERROR("Error: atlas is NULL\n");
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    atlas->shelves.clear();
+    atlas->used_height = 0;
+    return DSP_SUCCESS;
+}
+
+dsp_status dsp_overlay_atlas_get_image(dsp_overlay_atlas atlas, const dsp_image_properties_t **image)
+{
+    if ((!atlas) || (!image)) {
+        LOGGER__ERROR("Error: NULL argument (atlas={}, image={})\n", fmt::ptr(atlas), fmt::ptr(image));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    return dsp_overlay_get_image(atlas->overlay, image);
+}
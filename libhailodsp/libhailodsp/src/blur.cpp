@@ -21,11 +21,13 @@
  * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
-#include "aligned_uptr.hpp"
 #include "blur_perf.h"
+#include "cmdbuf.hpp"
 #include "hailo/hailodsp.h"
 #include "image_utils.hpp"
+#include "job.hpp"
 #include "logger_macros.hpp"
+#include "plan.hpp"
 #include "send_command.hpp"
 #include "user_dsp_interface.h"
 
@@ -33,8 +35,6 @@
 #include <cstdio>
 #include <utils.h>
 
-#define KERNEL_MAX_SIZE (33)
-
 // This function assumes that "image" params is already checked for correctness
 static dsp_status verify_roi_params(const dsp_image_properties_t *image, const dsp_roi_t *roi_params)
 {
@@ -70,26 +70,39 @@ static dsp_status verify_roi_params(const dsp_image_properties_t *image, const d
     return DSP_SUCCESS;
 }
 
-dsp_status dsp_blur_perf(dsp_device device,
-                         dsp_image_properties_t *image,
-                         const dsp_roi_t rois[],
-                         size_t rois_count,
-                         uint32_t kernel_size,
-                         perf_info_t *perf_info)
+static dsp_status verify_blur_image(const dsp_image_properties_t *image)
 {
-    if ((!device) || (!image) || (!rois)) {
-        LOGGER__ERROR("Error: One of the parameters provided is NULL (device={}, image={}, rois={})\n",
-                      fmt::ptr(device), fmt::ptr(image), fmt::ptr(rois));
-        return DSP_INVALID_ARGUMENT;
+    auto status = verify_image_properties(image);
+    if (status != DSP_SUCCESS) {
+        LOGGER__ERROR("Error: Image properties check failed for \"image\"\n");
+        return status;
+    }
+
+    switch (image->format) {
+        case DSP_IMAGE_FORMAT_GRAY8:
+        case DSP_IMAGE_FORMAT_NV12:
+            return DSP_SUCCESS;
+
+        default:
+            LOGGER__ERROR("Error: Image format ({}) is not supported\n", format_arg_to_string(image->format));
+            return DSP_INVALID_ARGUMENT;
     }
+}
 
+static dsp_status build_blur_command(const dsp_image_properties_t *image,
+                                     const dsp_roi_t rois[],
+                                     size_t rois_count,
+                                     uint32_t kernel_size,
+                                     imaging_request_t *in_data,
+                                     BufferList &buffer_list)
+{
     if (kernel_size % 2 == 0) {
         LOGGER__ERROR("Error: Kernel size should be odd\n");
         return DSP_INVALID_ARGUMENT;
     }
 
-    if (kernel_size > KERNEL_MAX_SIZE) {
-        LOGGER__ERROR("Error: Kernel size cannot exceed {}\n", KERNEL_MAX_SIZE);
+    if (kernel_size > DSP_BLUR_MAX_KERNEL_SIZE) {
+        LOGGER__ERROR("Error: Kernel size cannot exceed {}\n", DSP_BLUR_MAX_KERNEL_SIZE);
         return DSP_INVALID_ARGUMENT;
     }
 
@@ -98,23 +111,11 @@ dsp_status dsp_blur_perf(dsp_device device,
         return DSP_INVALID_ARGUMENT;
     }
 
-    auto status = verify_image_properties(image);
+    auto status = verify_blur_image(image);
     if (status != DSP_SUCCESS) {
-        LOGGER__ERROR("Error: Image properties check failed for \"image\"\n");
         return status;
     }
 
-    switch (image->format) {
-        case DSP_IMAGE_FORMAT_GRAY8:
-        case DSP_IMAGE_FORMAT_NV12:
-            break;
-
-        default:
-            LOGGER__ERROR("Error: Image format ({}) is not supported\n", format_arg_to_string(image->format));
-            return DSP_INVALID_ARGUMENT;
-    }
-
-    auto in_data = make_aligned_uptr<imaging_request_t>();
     in_data->operation = IMAGING_OP_BLUR;
     in_data->blur_args.rois_count = rois_count;
     in_data->blur_args.kernel_size = kernel_size;
@@ -132,10 +133,48 @@ dsp_status dsp_blur_perf(dsp_device device,
         in_data->blur_args.rois[i].end_y = rois[i].end_y;
     }
 
-    std::vector<command_image_t> images = {{image, &in_data->blur_args.image, BufferAccessType::ReadWrite}};
+    command_image_t images[] = {{image, &in_data->blur_args.image, BufferAccessType::ReadWrite}};
 
-    size_t perf_info_size = perf_info ? sizeof(*perf_info) : 0;
-    status = send_command(device, images, in_data.get(), sizeof(imaging_request_t), perf_info, perf_info_size);
+    return add_images_to_buffer_list(buffer_list, images);
+}
+
+// ROIs beyond the limit of a single request are blurred by chained requests
+static dsp_status build_chained_blur_command(const dsp_image_properties_t *image,
+                                             const dsp_roi_t rois[],
+                                             size_t rois_count,
+                                             uint32_t kernel_size,
+                                             ImagingCommand &command)
+{
+    size_t requests_count = MAX(DIV_ROUND_UP(rois_count, (size_t)MAX_BLUR_ROIS), (size_t)1);
+    return build_chained_command(command, requests_count,
+                                 [&](size_t index, imaging_request_t *request, BufferList &buffer_list) {
+                                     size_t first = index * MAX_BLUR_ROIS;
+                                     size_t count = MIN(rois_count - first, (size_t)MAX_BLUR_ROIS);
+                                     return build_blur_command(image, &rois[first], count, kernel_size, request,
+                                                               buffer_list);
+                                 });
+}
+
+dsp_status dsp_blur_perf(dsp_device device,
+                         dsp_image_properties_t *image,
+                         const dsp_roi_t rois[],
+                         size_t rois_count,
+                         uint32_t kernel_size,
+                         perf_info_t *perf_info)
+{
+    if ((!device) || (!image) || (!rois)) {
+        LOGGER__ERROR("Error: One of the parameters provided is NULL (device={}, image={}, rois={})\n",
+                      fmt::ptr(device), fmt::ptr(image), fmt::ptr(rois));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    ImagingCommand command;
+    auto status = build_chained_blur_command(image, rois, rois_count, kernel_size, command);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    status = send_command(device, command, perf_info);
     if (status != DSP_SUCCESS) {
         LOGGER__ERROR("Error: Failed executing blur operation. Error code: {}\n", status);
     }
@@ -151,3 +190,245 @@ dsp_status dsp_blur(dsp_device device,
 {
     return dsp_blur_perf(device, image, rois, rois_count, kernel_size, NULL);
 }
+
+dsp_status dsp_blur_async(dsp_device device,
+                          dsp_image_properties_t *image,
+                          const dsp_roi_t rois[],
+                          size_t rois_count,
+                          uint32_t kernel_size,
+                          dsp_job *job)
+{
+    if ((!device) || (!image) || (!rois) || (!job)) {
+        LOGGER__ERROR("Error: One of the parameters provided is NULL (device={}, image={}, rois={}, job={})\n",
+                      fmt::ptr(device), fmt::ptr(image), fmt::ptr(rois), fmt::ptr(job));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    ImagingCommand command;
+    auto status = build_chained_blur_command(image, rois, rois_count, kernel_size, command);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    return submit_command_async(device, std::move(command), NULL, job);
+}
+
+dsp_status dsp_cmdbuf_record_blur(dsp_cmdbuf cmdbuf,
+                                  dsp_image_properties_t *image,
+                                  const dsp_roi_t rois[],
+                                  size_t rois_count,
+                                  uint32_t kernel_size)
+{
+    if ((!cmdbuf) || (!image) || (!rois)) {
+        LOGGER__ERROR("Error: One of the parameters provided is NULL (cmdbuf={}, image={}, rois={})\n",
+                      fmt::ptr(cmdbuf), fmt::ptr(image), fmt::ptr(rois));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    size_t requests_count = MAX(DIV_ROUND_UP(rois_count, (size_t)MAX_BLUR_ROIS), (size_t)1);
+    return cmdbuf_record_chain(cmdbuf, {image}, requests_count,
+                               [&](size_t index, imaging_request_t *request, BufferList &buffer_list) {
+                                   size_t first = index * MAX_BLUR_ROIS;
+                                   size_t count = MIN(rois_count - first, (size_t)MAX_BLUR_ROIS);
+                                   return build_blur_command(image, &rois[first], count, kernel_size, request,
+                                                             buffer_list);
+                               });
+}
+
+dsp_status dsp_plan_create_blur(dsp_device device,
+                                dsp_image_properties_t *image,
+                                const dsp_roi_t rois[],
+                                size_t rois_count,
+                                uint32_t kernel_size,
+                                dsp_plan *plan)
+{
+    if ((!image) || (!rois)) {
+        LOGGER__ERROR("Error: One of the parameters provided is NULL (image={}, rois={})\n", fmt::ptr(image),
+                      fmt::ptr(rois));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    return plan_create_command(device, {image}, plan, [&](ImagingCommand &command) {
+        return build_chained_blur_command(image, rois, rois_count, kernel_size, command);
+    });
+}
+
+static dsp_status verify_blur_roi_mode(const dsp_blur_roi_params_t *roi)
+{
+    switch (roi->mode) {
+        case DSP_BLUR_MODE_BOX:
+        case DSP_BLUR_MODE_GAUSSIAN:
+            if ((roi->kernel_size % 2 == 0) || (roi->kernel_size > DSP_BLUR_MAX_KERNEL_SIZE)) {
+                LOGGER__ERROR("Error: Kernel size ({}) should be odd and cannot exceed {}\n", roi->kernel_size,
+                              DSP_BLUR_MAX_KERNEL_SIZE);
+                return DSP_INVALID_ARGUMENT;
+            }
+
+            if ((roi->downscale == 0) || (roi->downscale > DSP_BLUR_MAX_DOWNSCALE) ||
+                (roi->downscale & (roi->downscale - 1))) {
+                LOGGER__ERROR("Error: Downscale ({}) should be a power of 2 up to {}\n", roi->downscale,
+                              DSP_BLUR_MAX_DOWNSCALE);
+                return DSP_INVALID_ARGUMENT;
+            }
+            return DSP_SUCCESS;
+
+        case DSP_BLUR_MODE_PIXELATE:
+            if ((roi->kernel_size == 0) || (roi->kernel_size > DSP_BLUR_MAX_PIXELATE_BLOCK)) {
+                LOGGER__ERROR("Error: Block size ({}) should be between 1 and {}\n", roi->kernel_size,
+                              DSP_BLUR_MAX_PIXELATE_BLOCK);
+                return DSP_INVALID_ARGUMENT;
+            }
+
+            if (roi->downscale != 1) {
+                LOGGER__ERROR("Error: Pixelation does not support downscale ({})\n", roi->downscale);
+                return DSP_INVALID_ARGUMENT;
+            }
+            return DSP_SUCCESS;
+
+        default:
+            LOGGER__ERROR("Error: Unknown blur mode {}\n", roi->mode);
+            return DSP_INVALID_ARGUMENT;
+    }
+}
+
+static dsp_status build_blur_rois_command(dsp_image_properties_t *image,
+                                          const dsp_blur_roi_params_t rois[],
+                                          size_t rois_count,
+                                          imaging_request_t *in_data,
+                                          BufferList &buffer_list)
+{
+    if (rois_count > MAX_BLUR_ROIS) {
+        LOGGER__ERROR("Error: Too many ROIs. The operation supports up to {} ROIs\n", MAX_BLUR_ROIS);
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    auto status = verify_blur_image(image);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    in_data->operation = IMAGING_OP_BLUR_ROIS;
+    in_data->blur_rois_args.rois_count = rois_count;
+
+    for (size_t i = 0; i < rois_count; ++i) {
+        status = verify_roi_params(image, &rois[i].roi);
+        if (status == DSP_SUCCESS) {
+            status = verify_blur_roi_mode(&rois[i]);
+        }
+        if (status != DSP_SUCCESS) {
+            LOGGER__ERROR("Error: ROI properties check failed for \"roi[{}]\"\n", i);
+            return status;
+        }
+
+        auto &roi_args = in_data->blur_rois_args.rois[i];
+        roi_args.roi.start_x = rois[i].roi.start_x;
+        roi_args.roi.start_y = rois[i].roi.start_y;
+        roi_args.roi.end_x = rois[i].roi.end_x;
+        roi_args.roi.end_y = rois[i].roi.end_y;
+        roi_args.kernel_size = rois[i].kernel_size;
+        roi_args.mode = rois[i].mode;
+        roi_args.downscale = rois[i].downscale;
+    }
+
+    command_image_t images[] = {{image, &in_data->blur_rois_args.image, BufferAccessType::ReadWrite}};
+
+    return add_images_to_buffer_list(buffer_list, images);
+}
+
+// ROIs beyond the limit of a single request are blurred by chained requests
+static dsp_status build_chained_blur_rois_command(dsp_image_properties_t *image,
+                                                  const dsp_blur_roi_params_t rois[],
+                                                  size_t rois_count,
+                                                  ImagingCommand &command)
+{
+    size_t requests_count = MAX(DIV_ROUND_UP(rois_count, (size_t)MAX_BLUR_ROIS), (size_t)1);
+    return build_chained_command(command, requests_count,
+                                 [&](size_t index, imaging_request_t *request, BufferList &buffer_list) {
+                                     size_t first = index * MAX_BLUR_ROIS;
+                                     size_t count = MIN(rois_count - first, (size_t)MAX_BLUR_ROIS);
+                                     return build_blur_rois_command(image, &rois[first], count, request, buffer_list);
+                                 });
+}
+
+dsp_status dsp_blur_rois(dsp_device device,
+                         dsp_image_properties_t *image,
+                         const dsp_blur_roi_params_t rois[],
+                         size_t rois_count)
+{
+    if ((!device) || (!image) || (!rois)) {
+        LOGGER__ERROR("Error: One of the parameters provided is NULL (device={}, image={}, rois={})\n",
+                      fmt::ptr(device), fmt::ptr(image), fmt::ptr(rois));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    ImagingCommand command;
+    auto status = build_chained_blur_rois_command(image, rois, rois_count, command);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    status = send_command(device, command, NULL);
+    if (status != DSP_SUCCESS) {
+        LOGGER__ERROR("Error: Failed executing blur operation. Error code: {}\n", status);
+    }
+
+    return status;
+}
+
+dsp_status dsp_blur_rois_async(dsp_device device,
+                               dsp_image_properties_t *image,
+                               const dsp_blur_roi_params_t rois[],
+                               size_t rois_count,
+                               dsp_job *job)
+{
+    if ((!device) || (!image) || (!rois) || (!job)) {
+        LOGGER__ERROR("Error: One of the parameters provided is NULL (device={}, image={}, rois={}, job={})\n",
+                      fmt::ptr(device), fmt::ptr(image), fmt::ptr(rois), fmt::ptr(job));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    ImagingCommand command;
+    auto status = build_chained_blur_rois_command(image, rois, rois_count, command);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    return submit_command_async(device, std::move(command), NULL, job);
+}
+
+dsp_status dsp_cmdbuf_record_blur_rois(dsp_cmdbuf cmdbuf,
+                                       dsp_image_properties_t *image,
+                                       const dsp_blur_roi_params_t rois[],
+                                       size_t rois_count)
+{
+    if ((!cmdbuf) || (!image) || (!rois)) {
+        LOGGER__ERROR("Error: One of the parameters provided is NULL (cmdbuf={}, image={}, rois={})\n",
+                      fmt::ptr(cmdbuf), fmt::ptr(image), fmt::ptr(rois));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    size_t requests_count = MAX(DIV_ROUND_UP(rois_count, (size_t)MAX_BLUR_ROIS), (size_t)1);
+    return cmdbuf_record_chain(cmdbuf, {image}, requests_count,
+                               [&](size_t index, imaging_request_t *request, BufferList &buffer_list) {
+                                   size_t first = index * MAX_BLUR_ROIS;
+                                   size_t count = MIN(rois_count - first, (size_t)MAX_BLUR_ROIS);
+                                   return build_blur_rois_command(image, &rois[first], count, request, buffer_list);
+                               });
+}
+
+dsp_status dsp_plan_create_blur_rois(dsp_device device,
+                                     dsp_image_properties_t *image,
+                                     const dsp_blur_roi_params_t rois[],
+                                     size_t rois_count,
+                                     dsp_plan *plan)
+{
+    if ((!image) || (!rois)) {
+        LOGGER__ERROR("Error: One of the parameters provided is NULL (image={}, rois={})\n", fmt::ptr(image),
+                      fmt::ptr(rois));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    return plan_create_command(device, {image}, plan, [&](ImagingCommand &command) {
+        return build_chained_blur_rois_command(image, rois, rois_count, command);
+    });
+}
@@ -30,6 +30,9 @@
 
 typedef struct {
     dsp_device device;
+    // Size requested by the user, including the metadata
+    size_t size;
+    // Size allocated by the buffer pool
     size_t allocated_size;
 } buffer_metadata_t;
 
@@ -53,14 +56,14 @@ dsp_status dsp_create_buffer(dsp_device device, size_t size, void **buffer)
         return DSP_INVALID_ARGUMENT;
     }
 
-    size_t allocated_size = sizeof(*dsp_buffer) + size;
-
-    auto status = driver_allocate_buffer(device->fd, allocated_size, (void **)&dsp_buffer);
+    size_t allocated_size;
+    auto status = device->buffer_pool->allocate(sizeof(*dsp_buffer) + size, (void **)&dsp_buffer, allocated_size);
     if (status != DSP_SUCCESS) {
         return status;
     }
 
     dsp_buffer->metadata.device = device;
+    dsp_buffer->metadata.size = sizeof(*dsp_buffer) + size;
     dsp_buffer->metadata.allocated_size = allocated_size;
     *buffer = dsp_buffer->data;
 
@@ -73,8 +76,56 @@ dsp_status dsp_release_buffer(dsp_device device, void *buffer)
         return DSP_INVALID_ARGUMENT;
     }
 
+    // The buffer may be released through another device of its group, but belongs to the pool it was allocated from
     dsp_buffer_t *dsp_buffer = dsp_buffer_from_ptr(buffer);
-    return driver_release_buffer(device->fd, dsp_buffer, dsp_buffer->metadata.allocated_size);
+    return dsp_buffer->metadata.device->buffer_pool->release(dsp_buffer, dsp_buffer->metadata.allocated_size);
+}
+
+dsp_status dsp_configure_buffer_pool(dsp_device device, const dsp_buffer_pool_params_t *params)
+{
+    if (!device || !params) {
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    return device->buffer_pool->configure(*params);
+}
+
+dsp_status dsp_trim_buffer_pool(dsp_device device)
+{
+    if (!device) {
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    device->buffer_pool->trim();
+    return DSP_SUCCESS;
+}
+
+dsp_status dsp_get_buffer_pool_stats(dsp_device device, dsp_buffer_pool_stats_t *stats)
+{
+    if (!device || !stats) {
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    device->buffer_pool->get_stats(*stats);
+    return DSP_SUCCESS;
+}
+
+dsp_status dsp_register_buffer(dsp_device device, void *buffer, size_t size)
+{
+    if (!device || !buffer) {
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    return device->buffer_registry->register_buffer(buffer, size);
+}
+
+dsp_status dsp_unregister_buffer(dsp_device device, void *buffer)
+{
+    if (!device || !buffer) {
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    return device->buffer_registry->unregister_buffer(buffer);
 }
 
 dsp_status dsp_buffer_sync_start(void *buffer, dsp_sync_direction_t direction)
@@ -84,7 +135,7 @@ dsp_status dsp_buffer_sync_start(void *buffer, dsp_sync_direction_t direction)
     }
 
     auto dsp_buffer = dsp_buffer_from_ptr(buffer);
-    return driver_sync_buffer_start(dsp_buffer->metadata.device->fd, buffer, dsp_buffer->metadata.allocated_size,
+    return driver_sync_buffer_start(*dsp_buffer->metadata.device->driver, buffer, dsp_buffer->metadata.size,
                                     direction);
 }
 
@@ -95,6 +146,6 @@ dsp_status dsp_buffer_sync_end(void *buffer, dsp_sync_direction_t direction)
     }
 
     auto dsp_buffer = dsp_buffer_from_ptr(buffer);
-    return driver_sync_buffer_end(dsp_buffer->metadata.device->fd, buffer, dsp_buffer->metadata.allocated_size,
+    return driver_sync_buffer_end(*dsp_buffer->metadata.device->driver, buffer, dsp_buffer->metadata.size,
                                   direction);
 }
@@ -23,9 +23,15 @@
 
 #pragma once
 
+#include "logger_macros.hpp"
+#include "user_dsp_interface.h"
 #include "xrp_types.h"
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <hailo/hailodsp.h>
+#include <span>
 #include <vector>
 
 #include "xrp_kernel_defs.h"
@@ -48,9 +54,69 @@ static_assert((int)XRP_MEMORY_TYPE_USERPTR == (int)DSP_MEMORY_TYPE_USERPTR,
 static_assert((int)XRP_MEMORY_TYPE_DMABUF == (int)DSP_MEMORY_TYPE_DMABUF,
               "ioctl_memory_type must be identical to dsp_memory_type_t");
 
+// Whether "buffer" is the entry that BufferList::add_plane creates for "plane"
+static inline bool plane_matches_buffer(const dsp_data_plane_t &plane,
+                                        dsp_memory_type_t memory,
+                                        const struct xrp_ioctl_buffer &buffer)
+{
+    if ((buffer.memory_type != static_cast<__u32>(memory)) || (buffer.size != plane.bytesused)) {
+        return false;
+    }
+
+    if (memory == DSP_MEMORY_TYPE_USERPTR) {
+        return buffer.addr == reinterpret_cast<uintptr_t>(plane.userptr);
+    }
+    return buffer.fd == plane.fd;
+}
+
+// Maximal number of buffers of a single operation (blend background and overlays)
+#define BUFFER_LIST_INLINE_CAPACITY (MAX_PLANES * (MAX_BLEND_OVERLAYS + 1))
+
+// The driver receives the size of the list in bytes as a __u32
+#define BUFFER_LIST_MAX_SIZE (UINT32_MAX / sizeof(struct xrp_ioctl_buffer))
+
+// List of the buffers referenced by a command. Buffers of a single operation are stored inline, so building a
+// command does not allocate. Longer lists (command buffers) spill to the heap, up to max_size buffers
 class BufferList {
    public:
-    int add_plane(const dsp_data_plane_t &plane, BufferAccessType access_type, dsp_memory_type_t memory_type)
+    BufferList() = default;
+    explicit BufferList(size_t max_size) : m_max_size(max_size) {}
+    BufferList(const BufferList &other) { *this = other; }
+    BufferList(BufferList &&other) { *this = std::move(other); }
+
+    BufferList &operator=(const BufferList &other)
+    {
+        if (other.spilled()) {
+            m_heap = other.m_heap;
+        } else {
+            m_heap.clear();
+            std::copy(other.m_inline.begin(), other.m_inline.begin() + other.m_count, m_inline.begin());
+        }
+        m_count = other.m_count;
+        m_max_size = other.m_max_size;
+        return *this;
+    }
+
+    BufferList &operator=(BufferList &&other)
+    {
+        if (other.spilled()) {
+            m_heap = std::move(other.m_heap);
+        } else {
+            m_heap.clear();
+            std::copy(other.m_inline.begin(), other.m_inline.begin() + other.m_count, m_inline.begin());
+        }
+        m_count = other.m_count;
+        m_max_size = other.m_max_size;
+        other.m_heap.clear();
+        other.m_count = 0;
+        return *this;
+    }
+
+    // Adds the buffer and returns its index in "index". Fails when the list is full
+    dsp_status add_plane(const dsp_data_plane_t &plane,
+                         BufferAccessType access_type,
+                         dsp_memory_type_t memory_type,
+                         uint32_t &index)
     {
         struct xrp_ioctl_buffer buffer = {
             .flags = static_cast<__u32>(access_type),
@@ -64,34 +130,80 @@ class BufferList {
             buffer.fd = plane.fd;
         }
 
-        buffers.push_back(buffer);
-        return buffers.size() - 1;
+        return push(buffer, index);
     }
 
-    int add_buffer(void *buffer, size_t size, BufferAccessType access_type)
+    dsp_status add_buffer(void *buffer, size_t size, BufferAccessType access_type, uint32_t &index)
     {
-        buffers.emplace_back((struct xrp_ioctl_buffer){
-            .flags = static_cast<__u32>(access_type),
-            .size = static_cast<__u32>(size),
-            .memory_type = XRP_MEMORY_TYPE_USERPTR,
-            .addr = reinterpret_cast<uintptr_t>(buffer),
-        });
-        return buffers.size() - 1;
+        return push(
+            (struct xrp_ioctl_buffer){
+                .flags = static_cast<__u32>(access_type),
+                .size = static_cast<__u32>(size),
+                .memory_type = XRP_MEMORY_TYPE_USERPTR,
+                .addr = reinterpret_cast<uintptr_t>(buffer),
+            },
+            index);
     }
 
-    int add_buffer(int fd, size_t size, BufferAccessType access_type)
+    dsp_status add_buffer(int fd, size_t size, BufferAccessType access_type, uint32_t &index)
     {
-        buffers.emplace_back((struct xrp_ioctl_buffer){
-            .flags = static_cast<__u32>(access_type),
-            .size = static_cast<__u32>(size),
-            .memory_type = XRP_MEMORY_TYPE_DMABUF,
-            .fd = fd,
-        });
-        return buffers.size() - 1;
+        return push(
+            (struct xrp_ioctl_buffer){
+                .flags = static_cast<__u32>(access_type),
+                .size = static_cast<__u32>(size),
+                .memory_type = XRP_MEMORY_TYPE_DMABUF,
+                .fd = fd,
+            },
+            index);
     }
 
-    std::vector<struct xrp_ioctl_buffer> &get_buffers() { return buffers; }
+    std::span<struct xrp_ioctl_buffer> get_buffers()
+    {
+        return {spilled() ? m_heap.data() : m_inline.data(), m_count};
+    }
+
+    // Removes the buffers from index "count" on
+    void truncate(size_t count)
+    {
+        if (count >= m_count) {
+            return;
+        }
+
+        if (spilled() && (count <= BUFFER_LIST_INLINE_CAPACITY)) {
+            std::copy(m_heap.begin(), m_heap.begin() + count, m_inline.begin());
+            m_heap.clear();
+        } else if (spilled()) {
+            m_heap.resize(count);
+        }
+        m_count = count;
+    }
 
    private:
-    std::vector<struct xrp_ioctl_buffer> buffers;
-};
\ No newline at end of file
+    bool spilled() const { return !m_heap.empty(); }
+
+    dsp_status push(const struct xrp_ioctl_buffer &buffer, uint32_t &index)
+    {
+        if (m_count >= m_max_size) {
+            LOGGER__ERROR("Error: Command references more than {} buffers\n", m_max_size);
+            return DSP_INVALID_ARGUMENT;
+        }
+
+        if (spilled()) {
+            m_heap.push_back(buffer);
+        } else if (m_count < BUFFER_LIST_INLINE_CAPACITY) {
+            m_inline[m_count] = buffer;
+        } else {
+            m_heap.reserve(2 * BUFFER_LIST_INLINE_CAPACITY);
+            m_heap.assign(m_inline.begin(), m_inline.end());
+            m_heap.push_back(buffer);
+        }
+        index = static_cast<uint32_t>(m_count++);
+        return DSP_SUCCESS;
+    }
+
+    std::array<struct xrp_ioctl_buffer, BUFFER_LIST_INLINE_CAPACITY> m_inline;
+    // Holds all the buffers once the inline storage is exhausted
+    std::vector<struct xrp_ioctl_buffer> m_heap;
+    size_t m_count = 0;
+    size_t m_max_size = BUFFER_LIST_MAX_SIZE;
+};
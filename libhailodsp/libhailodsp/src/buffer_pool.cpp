@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) 2017-2024 Hailo Technologies Ltd. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "buffer_pool.hpp"
+#include "logger_macros.hpp"
+
+#include <algorithm>
+#include <unistd.h>
+
+#define MIN_CLASS_SHIFT (12)
+#define MAX_CLASS_SHIFT (28)
+#define CLASSES_PER_POWER_OF_TWO (4)
+#define DEFAULT_MAX_CACHED_BYTES (64 * 1024 * 1024)
+
+BufferPool::BufferPool(Driver &driver) :
+    m_driver(driver),
+    m_max_cached_bytes(DEFAULT_MAX_CACHED_BYTES),
+    m_cached_bytes(0),
+    m_cached_buffers(0),
+    m_in_use_bytes(0),
+    m_in_use_buffers(0),
+    m_peak_in_use_bytes(0),
+    m_hits(0),
+    m_misses(0),
+    m_trimmed(0)
+{
+    // Classes are page multiples, since the driver allocates whole pages anyway
+    size_t page_size = getpagesize();
+    for (size_t shift = MIN_CLASS_SHIFT; shift <= MAX_CLASS_SHIFT; shift++) {
+        for (size_t step = CLASSES_PER_POWER_OF_TWO; step < 2 * CLASSES_PER_POWER_OF_TWO; step++) {
+            size_t size = ((size_t)1 << shift) / CLASSES_PER_POWER_OF_TWO * step;
+            size = ((size + page_size - 1) / page_size) * page_size;
+            if (m_classes.empty() || (size > m_classes.back()->size)) {
+                auto size_class = std::make_unique<SizeClass>();
+                size_class->size = size;
+                m_classes.push_back(std::move(size_class));
+            }
+        }
+    }
+}
+
+BufferPool::~BufferPool()
+{
+    trim();
+}
+
+BufferPool::SizeClass *BufferPool::find_class(size_t size)
+{
+    auto size_class = std::lower_bound(m_classes.begin(), m_classes.end(), size,
+                                       [](const auto &size_class, size_t size) { return size_class->size < size; });
+    return size_class != m_classes.end() ? size_class->get() : nullptr;
+}
+
+void BufferPool::release_to_driver(void *buffer, size_t size)
+{
+    auto status = driver_release_buffer(m_driver, buffer, size);
+    if (status != DSP_SUCCESS) {
+        LOGGER__ERROR("Error: Failed releasing cached buffer {} of size {}\n", fmt::ptr(buffer), size);
+    }
+}
+
+void BufferPool::trim_to(size_t max_cached_bytes)
+{
+    // Largest buffers are released first, as they are the least likely to be reused
+    for (auto size_class = m_classes.rbegin(); size_class != m_classes.rend(); size_class++) {
+        while (m_cached_bytes > max_cached_bytes) {
+            void *buffer;
+            {
+                std::lock_guard<std::mutex> lock((*size_class)->mutex);
+                if ((*size_class)->free_list.empty()) {
+                    break;
+                }
+                buffer = (*size_class)->free_list.back();
+                (*size_class)->free_list.pop_back();
+            }
+
+            m_cached_bytes -= (*size_class)->size;
+            m_cached_buffers--;
+            m_trimmed++;
+            release_to_driver(buffer, (*size_class)->size);
+        }
+    }
+}
+
+void BufferPool::trim()
+{
+    trim_to(0);
+}
+
+dsp_status BufferPool::configure(const dsp_buffer_pool_params_t &params)
+{
+    if ((params.preallocations_count > 0) && (!params.preallocations)) {
+        LOGGER__ERROR("Error: preallocations is NULL\n");
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    size_t preallocated_bytes = 0;
+    for (size_t i = 0; i < params.preallocations_count; i++) {
+        auto size_class = find_class(params.preallocations[i].size);
+        if ((params.preallocations[i].size == 0) || (!size_class)) {
+            LOGGER__ERROR("Error: Invalid preallocation size {} for \"preallocations[{}]\"\n",
+                          params.preallocations[i].size, i);
+            return DSP_INVALID_ARGUMENT;
+        }
+        preallocated_bytes += size_class->size * params.preallocations[i].count;
+    }
+
+    if (preallocated_bytes > params.max_cached_bytes) {
+        LOGGER__ERROR("Error: Preallocated size ({}) exceeds max_cached_bytes ({})\n", preallocated_bytes,
+                      params.max_cached_bytes);
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    m_max_cached_bytes = params.max_cached_bytes;
+    trim_to(params.max_cached_bytes);
+
+    for (size_t i = 0; i < params.preallocations_count; i++) {
+        auto size_class = find_class(params.preallocations[i].size);
+        for (size_t j = 0; j < params.preallocations[i].count; j++) {
+            void *buffer;
+            auto status = driver_allocate_buffer(m_driver, size_class->size, &buffer);
+            if (status != DSP_SUCCESS) {
+                LOGGER__ERROR("Error: Failed preallocating buffer of size {}\n", size_class->size);
+                return status;
+            }
+
+            std::lock_guard<std::mutex> lock(size_class->mutex);
+            size_class->free_list.push_back(buffer);
+            m_cached_bytes += size_class->size;
+            m_cached_buffers++;
+        }
+    }
+
+    return DSP_SUCCESS;
+}
+
+dsp_status BufferPool::allocate(size_t size, void **buffer, size_t &allocated_size)
+{
+    void *local_buffer = nullptr;
+
+    auto size_class = find_class(size);
+    if ((m_max_cached_bytes == 0) || (!size_class)) {
+        // Not pooled
+        allocated_size = size;
+    } else {
+        allocated_size = size_class->size;
+
+        std::lock_guard<std::mutex> lock(size_class->mutex);
+        if (!size_class->free_list.empty()) {
+            local_buffer = size_class->free_list.back();
+            size_class->free_list.pop_back();
+        }
+    }
+
+    if (local_buffer) {
+        m_cached_bytes -= allocated_size;
+        m_cached_buffers--;
+        m_hits++;
+    } else {
+        auto status = driver_allocate_buffer(m_driver, allocated_size, &local_buffer);
+        if (status != DSP_SUCCESS) {
+            return status;
+        }
+        m_misses++;
+    }
+
+    m_in_use_buffers++;
+    size_t in_use_bytes = m_in_use_bytes += allocated_size;
+    size_t peak = m_peak_in_use_bytes;
+    while ((in_use_bytes > peak) && (!m_peak_in_use_bytes.compare_exchange_weak(peak, in_use_bytes))) {
+    }
+
+    *buffer = local_buffer;
+    return DSP_SUCCESS;
+}
+
+dsp_status BufferPool::release(void *buffer, size_t allocated_size)
+{
+    m_in_use_buffers--;
+    m_in_use_bytes -= allocated_size;
+
+    // Buffers allocated while pooling was disabled can be cached too, if their size happens to match a class
+    auto size_class = find_class(allocated_size);
+    if (size_class && (size_class->size == allocated_size)) {
+        if (m_cached_bytes.fetch_add(allocated_size) + allocated_size <= m_max_cached_bytes) {
+            std::lock_guard<std::mutex> lock(size_class->mutex);
+            size_class->free_list.push_back(buffer);
+            m_cached_buffers++;
+            return DSP_SUCCESS;
+        }
+
+        // The pool is full
+        m_cached_bytes -= allocated_size;
+        m_trimmed++;
+    }
+
+    return driver_release_buffer(m_driver, buffer, allocated_size);
+}
+
+void BufferPool::get_stats(dsp_buffer_pool_stats_t &stats) const
+{
+    stats = {
+        .hits = m_hits,
+        .misses = m_misses,
+        .trimmed = m_trimmed,
+        .cached_buffers = m_cached_buffers,
+        .cached_bytes = m_cached_bytes,
+        .in_use_buffers = m_in_use_buffers,
+        .in_use_bytes = m_in_use_bytes,
+        .peak_in_use_bytes = m_peak_in_use_bytes,
+    };
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2017-2024 Hailo Technologies Ltd. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "hailo/hailodsp.h"
+#include "hailodsp_driver.hpp"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Caches buffers allocated from the driver, so that steady state allocations do not reach the kernel.
+// Allocation sizes are rounded up to size classes, four per power of two (at most 25% overhead). Released buffers
+// are kept in the free list of their class as long as the total cached size stays below the high-water mark, and
+// are released to the driver otherwise. Allocations larger than the largest class bypass the pool
+class BufferPool {
+   public:
+    explicit BufferPool(Driver &driver);
+    ~BufferPool();
+
+    dsp_status configure(const dsp_buffer_pool_params_t &params);
+    // Returns the size actually allocated, which must be passed back to release
+    dsp_status allocate(size_t size, void **buffer, size_t &allocated_size);
+    dsp_status release(void *buffer, size_t allocated_size);
+    // Releases all the cached buffers to the driver
+    void trim();
+    void get_stats(dsp_buffer_pool_stats_t &stats) const;
+
+   private:
+    struct SizeClass {
+        size_t size;
+        std::mutex mutex;
+        std::vector<void *> free_list;
+    };
+
+    SizeClass *find_class(size_t size);
+    // Releases cached buffers until the cached size is at most max_cached_bytes
+    void trim_to(size_t max_cached_bytes);
+    void release_to_driver(void *buffer, size_t size);
+
+    Driver &m_driver;
+    std::vector<std::unique_ptr<SizeClass>> m_classes;
+    std::atomic<size_t> m_max_cached_bytes;
+
+    std::atomic<size_t> m_cached_bytes;
+    std::atomic<size_t> m_cached_buffers;
+    std::atomic<size_t> m_in_use_bytes;
+    std::atomic<size_t> m_in_use_buffers;
+    std::atomic<size_t> m_peak_in_use_bytes;
+    std::atomic<uint64_t> m_hits;
+    std::atomic<uint64_t> m_misses;
+    std::atomic<uint64_t> m_trimmed;
+};
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2017-2024 Hailo Technologies Ltd. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "buffer_registry.hpp"
+#include "logger_macros.hpp"
+
+#include <iterator>
+#include <mutex>
+
+BufferRegistry::BufferRegistry(Driver &driver) : m_driver(driver), m_count(0) {}
+
+BufferRegistry::~BufferRegistry()
+{
+    for (const auto &[addr, registration] : m_registrations) {
+        LOGGER__WARN("Registered buffer {:#x} was not unregistered", addr);
+        if (registration.handle.has_value()) {
+            (void)driver_unregister_buffer(m_driver, registration.handle.value());
+        }
+    }
+}
+
+dsp_status BufferRegistry::register_buffer(void *buffer, size_t size)
+{
+    uintptr_t addr = reinterpret_cast<uintptr_t>(buffer);
+    if ((size == 0) || (size > UINT32_MAX)) {
+        LOGGER__ERROR("Error: Invalid registered buffer size {}\n", size);
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+
+    // Registered buffers may not overlap, so that every address resolves to a single handle
+    auto next = m_registrations.lower_bound(addr);
+    bool overlaps_next = (next != m_registrations.end()) && (next->first < addr + size);
+    bool overlaps_previous =
+        (next != m_registrations.begin()) && (std::prev(next)->first + std::prev(next)->second.size > addr);
+    if (overlaps_next || overlaps_previous) {
+        LOGGER__ERROR("Error: Buffer {} of size {} overlaps an already registered buffer\n", buffer, size);
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    if (!m_supported.has_value()) {
+        m_supported = driver_supports_buffer_registration(m_driver);
+    }
+
+    registration_t registration = {
+        .size = size,
+        .handle = std::nullopt,
+    };
+    if (m_supported.value()) {
+        uint32_t handle;
+        auto status = driver_register_buffer(m_driver, buffer, size, handle);
+        if (status != DSP_SUCCESS) {
+            return status;
+        }
+        registration.handle = handle;
+    }
+
+    m_registrations.emplace(addr, registration);
+    m_count++;
+    return DSP_SUCCESS;
+}
+
+dsp_status BufferRegistry::unregister_buffer(void *buffer)
+{
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+
+    auto registration = m_registrations.find(reinterpret_cast<uintptr_t>(buffer));
+    if (registration == m_registrations.end()) {
+        LOGGER__ERROR("Error: Buffer {} is not registered\n", buffer);
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    dsp_status status = DSP_SUCCESS;
+    if (registration->second.handle.has_value()) {
+        status = driver_unregister_buffer(m_driver, registration->second.handle.value());
+    }
+
+    m_registrations.erase(registration);
+    m_count--;
+    return status;
+}
+
+void BufferRegistry::translate(BufferList &buffer_list) const
+{
+    if (empty()) {
+        return;
+    }
+
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    for (auto &buffer : buffer_list.get_buffers()) {
+        if (buffer.memory_type != XRP_MEMORY_TYPE_USERPTR) {
+            continue;
+        }
+
+        auto registration = m_registrations.upper_bound(buffer.addr);
+        if (registration == m_registrations.begin()) {
+            continue;
+        }
+        registration--;
+
+        const auto &[start, entry] = *registration;
+        if ((!entry.handle.has_value()) || (buffer.addr + buffer.size > start + entry.size)) {
+            continue;
+        }
+
+        uint32_t offset = static_cast<uint32_t>(buffer.addr - start);
+        buffer.memory_type = XRP_MEMORY_TYPE_REGISTERED;
+        buffer.registered.handle = entry.handle.value();
+        buffer.registered.offset = offset;
+    }
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2017-2024 Hailo Technologies Ltd. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "buffer_list.hpp"
+#include "hailo/hailodsp.h"
+#include "hailodsp_driver.hpp"
+
+#include <atomic>
+#include <map>
+#include <optional>
+#include <shared_mutex>
+
+// Userspace buffers registered with the driver. Registered buffers are pinned once, and commands reference them by
+// handle instead of having the driver pin and map them again on every command
+class BufferRegistry {
+   public:
+    explicit BufferRegistry(Driver &driver);
+    ~BufferRegistry();
+
+    dsp_status register_buffer(void *buffer, size_t size);
+    dsp_status unregister_buffer(void *buffer);
+
+    // Replaces USERPTR buffers that lie within a registered buffer with a reference to the registered handle
+    void translate(BufferList &buffer_list) const;
+
+    bool empty() const { return m_count == 0; }
+
+   private:
+    typedef struct {
+        size_t size;
+        // Empty when the driver does not support registration
+        std::optional<uint32_t> handle;
+    } registration_t;
+
+    Driver &m_driver;
+    mutable std::shared_mutex m_mutex;
+    // Queried from the driver on the first registration
+    std::optional<bool> m_supported;
+    // Start address to registration
+    std::map<uintptr_t, registration_t> m_registrations;
+    std::atomic<size_t> m_count;
+};
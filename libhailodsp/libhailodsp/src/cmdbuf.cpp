@@ -0,0 +1,271 @@
+/*
+ * Copyright (c) 2017-2024 Hailo Technologies Ltd. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "cmdbuf.hpp"
+#include "device.hpp"
+#include "hailo/hailodsp.h"
+#include "logger_macros.hpp"
+#include "send_command.hpp"
+
+#include <cstring>
+
+#define CMDBUF_INITIAL_CAPACITY (8)
+#define REQUESTS_BUFFER_INDEX (0)
+
+dsp_status dsp_create_cmdbuf(dsp_device device, dsp_cmdbuf *cmdbuf)
+{
+    if ((!device) || (!cmdbuf)) {
+        LOGGER__ERROR("Error: NULL argument (device={}, cmdbuf={})\n", fmt::ptr(device), fmt::ptr(cmdbuf));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    auto local_cmdbuf = new (std::nothrow) _dsp_cmdbuf{
+        .device = device,
+        .requests = make_aligned_array_uptr<imaging_request_t>(CMDBUF_INITIAL_CAPACITY),
+        .requests_count = 0,
+        .requests_capacity = CMDBUF_INITIAL_CAPACITY,
+        .buffer_list = {},
+        .bindings = {},
+        .submit_buffer_list = {},
+        .batch_request = make_aligned_uptr<imaging_request_t>(),
+    };
+    if ((!local_cmdbuf) || (!local_cmdbuf->requests) || (!local_cmdbuf->batch_request)) {
+        LOGGER__ERROR("Failed to allocate memory for command buffer");
+        delete local_cmdbuf;
+        return DSP_OUT_OF_HOST_MEMORY;
+    }
+
+    // Address and size are set on submission, since the requests array may be reallocated while recording
+    uint32_t requests_buffer_index;
+    (void)local_cmdbuf->buffer_list.add_buffer(nullptr, 0, BufferAccessType::Read, requests_buffer_index);
+
+    *cmdbuf = local_cmdbuf;
+    return DSP_SUCCESS;
+}
+
+dsp_status dsp_release_cmdbuf(dsp_cmdbuf cmdbuf)
+{
+    if (!cmdbuf) {
+        LOGGER__ERROR("Error: cmdbuf is NULL\n");
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    delete cmdbuf;
+    return DSP_SUCCESS;
+}
+
+dsp_status dsp_cmdbuf_reset(dsp_cmdbuf cmdbuf)
+{
+    if (!cmdbuf) {
+        LOGGER__ERROR("Error: cmdbuf is NULL\n");
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    cmdbuf->requests_count = 0;
+    cmdbuf->buffer_list.truncate(REQUESTS_BUFFER_INDEX + 1);
+    cmdbuf->bindings.clear();
+    return DSP_SUCCESS;
+}
+
+imaging_request_t *cmdbuf_reserve_request(dsp_cmdbuf cmdbuf)
+{
+    if (cmdbuf->requests_count == cmdbuf->requests_capacity) {
+        size_t new_capacity = cmdbuf->requests_capacity * 2;
+        auto new_requests = make_aligned_array_uptr<imaging_request_t>(new_capacity);
+        if (!new_requests) {
+            LOGGER__ERROR("Failed to allocate memory for {} command buffer requests", new_capacity);
+            return nullptr;
+        }
+
+        memcpy(new_requests.get(), cmdbuf->requests.get(), cmdbuf->requests_count * sizeof(imaging_request_t));
+        cmdbuf->requests = std::move(new_requests);
+        cmdbuf->requests_capacity = new_capacity;
+    }
+
+    return &cmdbuf->requests.get()[cmdbuf->requests_count];
+}
+
+static bool same_image_layout(const cmdbuf_binding_t *binding, const dsp_image_properties_t *image)
+{
+    auto recorded = &binding->properties;
+    if ((recorded->width != image->width) || (recorded->height != image->height) ||
+        (recorded->format != image->format) || (recorded->memory != image->memory) ||
+        (recorded->planes_count != image->planes_count)) {
+        return false;
+    }
+
+    for (size_t i = 0; i < recorded->planes_count; ++i) {
+        if ((binding->planes[i].bytesperline != image->planes[i].bytesperline) ||
+            (binding->planes[i].bytesused != image->planes[i].bytesused)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static cmdbuf_binding_t *find_binding(dsp_cmdbuf cmdbuf, const dsp_image_properties_t *recorded_image)
+{
+    for (auto &binding : cmdbuf->bindings) {
+        if (binding.recorded_image == recorded_image) {
+            return &binding;
+        }
+    }
+    return nullptr;
+}
+
+dsp_status cmdbuf_commit_request(dsp_cmdbuf cmdbuf,
+                                 size_t first_buffer_index,
+                                 const std::vector<const dsp_image_properties_t *> &images)
+{
+    auto buffers = cmdbuf->buffer_list.get_buffers();
+
+    for (auto image : images) {
+        if (!image) {
+            continue;
+        }
+
+        auto binding = find_binding(cmdbuf, image);
+        if (!binding) {
+            cmdbuf->bindings.emplace_back(cmdbuf_binding_t{
+                .recorded_image = image,
+                .properties = *image,
+                .planes = {},
+                .buffer_refs = {},
+            });
+            binding = &cmdbuf->bindings.back();
+            std::copy(image->planes, image->planes + image->planes_count, binding->planes);
+        } else if (!same_image_layout(binding, image)) {
+            LOGGER__ERROR("Error: Image was already recorded with different properties\n");
+            return DSP_INVALID_ARGUMENT;
+        }
+
+        for (size_t plane_index = 0; plane_index < image->planes_count; ++plane_index) {
+            for (size_t buffer_index = first_buffer_index; buffer_index < buffers.size(); ++buffer_index) {
+                if (plane_matches_buffer(image->planes[plane_index], image->memory, buffers[buffer_index])) {
+                    binding->buffer_refs.emplace_back(plane_index, buffer_index);
+                }
+            }
+        }
+    }
+
+    cmdbuf->requests_count++;
+    return DSP_SUCCESS;
+}
+
+void cmdbuf_rollback_request(dsp_cmdbuf cmdbuf, size_t first_buffer_index)
+{
+    cmdbuf->buffer_list.truncate(first_buffer_index);
+
+    // Drop references to the discarded buffers, and bindings that were created for the discarded request only
+    for (auto &binding : cmdbuf->bindings) {
+        std::erase_if(binding.buffer_refs,
+                      [first_buffer_index](const auto &buffer_ref) { return buffer_ref.second >= first_buffer_index; });
+    }
+    std::erase_if(cmdbuf->bindings, [](const auto &binding) { return binding.buffer_refs.empty(); });
+}
+
+dsp_status dsp_cmdbuf_bind_image(dsp_cmdbuf cmdbuf,
+                                 const dsp_image_properties_t *recorded_image,
+                                 const dsp_image_properties_t *image)
+{
+    if ((!cmdbuf) || (!recorded_image) || (!image) || (!image->planes)) {
+        LOGGER__ERROR("Error: NULL argument (cmdbuf={}, recorded_image={}, image={})\n", fmt::ptr(cmdbuf),
+                      fmt::ptr(recorded_image), fmt::ptr(image));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    auto binding = find_binding(cmdbuf, recorded_image);
+    if (!binding) {
+        LOGGER__ERROR("Error: Image {} was not recorded in the command buffer\n", fmt::ptr(recorded_image));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    // The recorded requests already encode the image layout, so only the plane data may change
+    if (!same_image_layout(binding, image)) {
+        LOGGER__ERROR("Error: Bound image properties differ from the recorded image properties\n");
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    for (size_t i = 0; i < image->planes_count; ++i) {
+        if ((image->memory == DSP_MEMORY_TYPE_USERPTR) && (image->planes[i].userptr == NULL)) {
+            LOGGER__ERROR("Error: Plane[{}] data pointer is NULL\n", i);
+            return DSP_INVALID_ARGUMENT;
+        }
+        if ((image->memory == DSP_MEMORY_TYPE_DMABUF) && (image->planes[i].fd < 0)) {
+            LOGGER__ERROR("Error: Plane[{}] fd {} is invalid\n", i, image->planes[i].fd);
+            return DSP_INVALID_ARGUMENT;
+        }
+    }
+
+    auto buffers = cmdbuf->buffer_list.get_buffers();
+    for (const auto &[plane_index, buffer_index] : binding->buffer_refs) {
+        if (image->memory == DSP_MEMORY_TYPE_USERPTR) {
+            buffers[buffer_index].addr = reinterpret_cast<uintptr_t>(image->planes[plane_index].userptr);
+        } else {
+            buffers[buffer_index].fd = image->planes[plane_index].fd;
+        }
+    }
+
+    return DSP_SUCCESS;
+}
+
+dsp_status dsp_cmdbuf_submit(dsp_cmdbuf cmdbuf)
+{
+    if (!cmdbuf) {
+        LOGGER__ERROR("Error: cmdbuf is NULL\n");
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    if (cmdbuf->requests_count == 0) {
+        LOGGER__ERROR("Error: Command buffer is empty\n");
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    size_t requests_size = cmdbuf->requests_count * sizeof(imaging_request_t);
+    auto &requests_buffer = cmdbuf->buffer_list.get_buffers()[REQUESTS_BUFFER_INDEX];
+    requests_buffer.addr = reinterpret_cast<uintptr_t>(cmdbuf->requests.get());
+    requests_buffer.size = static_cast<__u32>(requests_size);
+
+    auto batch_request = cmdbuf->batch_request.get();
+    batch_request->operation = IMAGING_OP_BATCH;
+    batch_request->batch_args.requests_count = cmdbuf->requests_count;
+    batch_request->batch_args.requests.xrp_buffer_index = REQUESTS_BUFFER_INDEX;
+    batch_request->batch_args.requests.line_stride = sizeof(imaging_request_t);
+    batch_request->batch_args.requests.plane_size = requests_size;
+
+    host_sample_t host_sample = {};
+    dsp_status status;
+    {
+        HOST_STATS_STAGE(DSP_HOST_STAGE_DRIVER_CALL, &host_sample);
+        cmdbuf->submit_buffer_list = cmdbuf->buffer_list;
+        status = send_command(cmdbuf->device, cmdbuf->submit_buffer_list, batch_request, sizeof(imaging_request_t),
+                              NULL, 0);
+    }
+    host_stats_commit(IMAGING_OP_BATCH, host_sample);
+    if (status != DSP_SUCCESS) {
+        LOGGER__ERROR("Error: Failed executing command buffer. Error code: {}\n", status);
+    }
+
+    return status;
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2017-2024 Hailo Technologies Ltd. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "aligned_uptr.hpp"
+#include "buffer_list.hpp"
+#include "hailo/hailodsp.h"
+#include "host_stats.hpp"
+#include "user_dsp_interface.h"
+
+#include <utility>
+#include <vector>
+
+// A user image referenced by recorded requests, and the buffer list entries that hold its planes
+typedef struct {
+    // Used as a key only, never dereferenced after recording
+    const dsp_image_properties_t *recorded_image;
+    // properties.planes is not used, the recorded planes are held in "planes" so that bindings can be moved
+    dsp_image_properties_t properties;
+    dsp_data_plane_t planes[MAX_PLANES];
+    // Pairs of (plane index, buffer list index)
+    std::vector<std::pair<size_t, size_t>> buffer_refs;
+} cmdbuf_binding_t;
+
+struct _dsp_cmdbuf {
+    dsp_device device;
+
+    // Recorded requests are stored contiguously, since they are passed to the DSP as a single buffer
+    unique_ptr_aligned<imaging_request_t> requests;
+    size_t requests_count;
+    size_t requests_capacity;
+
+    // Buffers of all recorded requests. Entry 0 is reserved for the requests array itself
+    BufferList buffer_list;
+    std::vector<cmdbuf_binding_t> bindings;
+    // Copy of buffer_list that is sent to the driver. Registered buffers are translated in the copy, so the recorded
+    // addresses remain available for re-binding
+    BufferList submit_buffer_list;
+
+    unique_ptr_aligned<imaging_request_t> batch_request;
+};
+
+imaging_request_t *cmdbuf_reserve_request(dsp_cmdbuf cmdbuf);
+dsp_status cmdbuf_commit_request(dsp_cmdbuf cmdbuf,
+                                 size_t first_buffer_index,
+                                 const std::vector<const dsp_image_properties_t *> &images);
+void cmdbuf_rollback_request(dsp_cmdbuf cmdbuf, size_t first_buffer_index);
+
+// Records an operation as "count" chained requests, for operations that exceed the limits of a single request.
+// "build" encodes part "index" of the operation into a request slot and the command buffer's buffer list. "images" are
+// the user images referenced by the operation, which can later be re-bound using dsp_cmdbuf_bind_image. Either all
+// the parts are recorded, or none of them
+template <typename Build>
+dsp_status cmdbuf_record_chain(dsp_cmdbuf cmdbuf,
+                               const std::vector<const dsp_image_properties_t *> &images,
+                               size_t count,
+                               Build build)
+{
+    size_t first_request_index = cmdbuf->requests_count;
+    size_t first_buffer_index = cmdbuf->buffer_list.get_buffers().size();
+    dsp_status status = DSP_SUCCESS;
+    for (size_t i = 0; (i < count) && (status == DSP_SUCCESS); ++i) {
+        host_stats_begin_command();
+        auto request = cmdbuf_reserve_request(cmdbuf);
+        if (!request) {
+            status = DSP_OUT_OF_HOST_MEMORY;
+            break;
+        }
+
+        size_t request_buffer_index = cmdbuf->buffer_list.get_buffers().size();
+        status = build(i, request, cmdbuf->buffer_list);
+        if (status == DSP_SUCCESS) {
+            status = cmdbuf_commit_request(cmdbuf, request_buffer_index, images);
+        }
+
+        if (status == DSP_SUCCESS) {
+            // Recorded requests have no driver call of their own, it is accounted to the batch on submission
+            host_stats_commit(static_cast<imaging_operation_t>(request->operation), host_stats_take_pending());
+        }
+    }
+
+    if (status != DSP_SUCCESS) {
+        cmdbuf->requests_count = first_request_index;
+        cmdbuf_rollback_request(cmdbuf, first_buffer_index);
+    }
+
+    return status;
+}
+
+// Records a single operation. "build" encodes the operation into a request slot and the command buffer's buffer list.
+// "images" are the user images referenced by the operation, which can later be re-bound using dsp_cmdbuf_bind_image
+template <typename Build>
+dsp_status cmdbuf_record(dsp_cmdbuf cmdbuf, const std::vector<const dsp_image_properties_t *> &images, Build build)
+{
+    return cmdbuf_record_chain(cmdbuf, images, 1,
+                               [&](size_t, imaging_request_t *request, BufferList &buffer_list) {
+                                   return build(request, buffer_list);
+                               });
+}
@@ -21,11 +21,13 @@
  * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
-#include "aligned_uptr.hpp"
+#include "cmdbuf.hpp"
 #include "convert_format_perf.h"
 #include "hailo/hailodsp.h"
 #include "image_utils.hpp"
+#include "job.hpp"
 #include "logger_macros.hpp"
+#include "plan.hpp"
 #include "send_command.hpp"
 #include "user_dsp_interface.h"
 
@@ -33,17 +35,11 @@
 #include <memory>
 #include <utils.h>
 
-dsp_status dsp_convert_format_perf(dsp_device device,
-                                   const dsp_image_properties_t *src,
-                                   dsp_image_properties_t *dst,
-                                   perf_info_t *perf_info)
+static dsp_status build_convert_format_command(const dsp_image_properties_t *src,
+                                               const dsp_image_properties_t *dst,
+                                               imaging_request_t *in_data,
+                                               BufferList &buffer_list)
 {
-    if (!device) {
-        LOGGER__ERROR("Error: One of the parameters provided is NULL (device={}, src={}, dst={})\n", fmt::ptr(device),
-                      fmt::ptr(src), fmt::ptr(dst));
-        return DSP_INVALID_ARGUMENT;
-    }
-
     auto status = verify_image_properties(src);
     if (status != DSP_SUCCESS) {
         LOGGER__ERROR("Error: Image properties check failed for \"src\"\n");
@@ -71,10 +67,9 @@ dsp_status dsp_convert_format_perf(dsp_device device,
         return DSP_INVALID_ARGUMENT;
     }
 
-    auto in_data = make_aligned_uptr<imaging_request_t>();
     in_data->operation = IMAGING_OP_CONVERT_FORMAT;
 
-    std::vector<command_image_t> images = {
+    command_image_t images[] = {
         {
             .user_api_image = src,
             .dsp_api_image = &in_data->convert_format_args.src,
@@ -87,8 +82,27 @@ dsp_status dsp_convert_format_perf(dsp_device device,
         },
     };
 
-    size_t perf_info_size = perf_info ? sizeof(*perf_info) : 0;
-    status = send_command(device, images, in_data.get(), sizeof(imaging_request_t), perf_info, perf_info_size);
+    return add_images_to_buffer_list(buffer_list, images);
+}
+
+dsp_status dsp_convert_format_perf(dsp_device device,
+                                   const dsp_image_properties_t *src,
+                                   dsp_image_properties_t *dst,
+                                   perf_info_t *perf_info)
+{
+    if (!device) {
+        LOGGER__ERROR("Error: One of the parameters provided is NULL (device={}, src={}, dst={})\n", fmt::ptr(device),
+                      fmt::ptr(src), fmt::ptr(dst));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    ImagingCommand command;
+    auto status = build_convert_format_command(src, dst, command.request.get(), command.buffer_list);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    status = send_command(device, command, perf_info);
     if (status != DSP_SUCCESS) {
         LOGGER__ERROR("Error: Failed executing format conversion operation. Error code: {}\n", status);
     }
@@ -100,3 +114,47 @@ dsp_status dsp_convert_format(dsp_device device, const dsp_image_properties_t *s
 {
     return dsp_convert_format_perf(device, src, dst, NULL);
 }
+
+dsp_status dsp_convert_format_async(dsp_device device,
+                                    const dsp_image_properties_t *src,
+                                    dsp_image_properties_t *dst,
+                                    dsp_job *job)
+{
+    if ((!device) || (!job)) {
+        LOGGER__ERROR("Error: One of the parameters provided is NULL (device={}, job={})\n", fmt::ptr(device),
+                      fmt::ptr(job));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    ImagingCommand command;
+    auto status = build_convert_format_command(src, dst, command.request.get(), command.buffer_list);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    return submit_command_async(device, std::move(command), NULL, job);
+}
+
+dsp_status dsp_cmdbuf_record_convert_format(dsp_cmdbuf cmdbuf,
+                                            const dsp_image_properties_t *src,
+                                            dsp_image_properties_t *dst)
+{
+    if (!cmdbuf) {
+        LOGGER__ERROR("Error: cmdbuf is NULL\n");
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    return cmdbuf_record(cmdbuf, {src, dst}, [&](imaging_request_t *request, BufferList &buffer_list) {
+        return build_convert_format_command(src, dst, request, buffer_list);
+    });
+}
+
+dsp_status dsp_plan_create_convert_format(dsp_device device,
+                                          const dsp_image_properties_t *src,
+                                          dsp_image_properties_t *dst,
+                                          dsp_plan *plan)
+{
+    return plan_create(device, {src, dst}, plan, [&](imaging_request_t *request, BufferList &buffer_list) {
+        return build_convert_format_command(src, dst, request, buffer_list);
+    });
+}
@@ -27,15 +27,48 @@
 #include "user_dsp_interface.h"
 
 #include <stdio.h>
+#include <unistd.h>
+#include <utility>
 
-dsp_status dsp_create_device(dsp_device *device)
+static std::atomic<uint64_t> next_device_id = 0;
+
+// Slots of the released devices, reused by new ones. The per-thread tables indexed by slot then stay as long as the
+// largest number of devices alive at once
+static std::mutex device_slots_mutex;
+static std::vector<size_t> free_device_slots;
+static size_t device_slots_count = 0;
+
+static size_t acquire_device_slot()
+{
+    std::lock_guard<std::mutex> lock(device_slots_mutex);
+    if (free_device_slots.empty()) {
+        return device_slots_count++;
+    }
+
+    auto slot = free_device_slots.back();
+    free_device_slots.pop_back();
+    return slot;
+}
+
+static void release_device_slot(size_t slot)
+{
+    std::lock_guard<std::mutex> lock(device_slots_mutex);
+    free_device_slots.push_back(slot);
+}
+
+dsp_status dsp_create_device_ex(const dsp_device_params_t *params, dsp_device *device)
 {
     dsp_status status = DSP_UNINITIALIZED;
 
     dsp_device local_device = NULL;
-    int fd = -1;
 
-    if (device == NULL) {
+    if ((params == NULL) || (device == NULL)) {
+        status = DSP_INVALID_ARGUMENT;
+        goto l_exit;
+    }
+
+    if (params->driver >= DSP_DRIVER_TYPE_COUNT) {
+        LOGGER__ERROR("Error: Unknown driver type {}\n", params->driver);
         status = DSP_INVALID_ARGUMENT;
         goto l_exit;
     }
@@ -47,12 +80,34 @@ dsp_status dsp_create_device(dsp_device *device)
         goto l_exit;
     }
 
-    status = driver_open_device(fd);
+    local_device->slot = acquire_device_slot();
+
+    status = driver_open_device(*params, local_device->driver);
+    if (status != DSP_SUCCESS) {
+        goto l_exit;
+    }
+
+    local_device->id = next_device_id.fetch_add(1, std::memory_order_relaxed);
+
+    status = dsp_set_device_priority(local_device, params->priority);
     if (status != DSP_SUCCESS) {
         goto l_exit;
     }
 
-    local_device->fd = fd;
+    local_device->buffer_pool.reset(new (std::nothrow) BufferPool(*local_device->driver));
+    if (!local_device->buffer_pool) {
+        LOGGER__ERROR("Failed to allocate memory for buffer pool");
+        status = DSP_OUT_OF_HOST_MEMORY;
+        goto l_exit;
+    }
+
+    local_device->buffer_registry.reset(new (std::nothrow) BufferRegistry(*local_device->driver));
+    if (!local_device->buffer_registry) {
+        LOGGER__ERROR("Failed to allocate memory for buffer registry");
+        status = DSP_OUT_OF_HOST_MEMORY;
+        goto l_exit;
+    }
+
     *device = local_device;
 
     local_device = NULL;
@@ -61,11 +116,36 @@ dsp_status dsp_create_device(dsp_device *device)
 
 l_exit:
     if (local_device != NULL) {
+        release_device_slot(local_device->slot);
         delete local_device;
     }
     return status;
 }
 
+dsp_status dsp_get_devices_count(dsp_driver_type_t driver, size_t *count)
+{
+    if (!count) {
+        LOGGER__ERROR("Error: count is NULL\n");
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    if (driver >= DSP_DRIVER_TYPE_COUNT) {
+        LOGGER__ERROR("Error: Unknown driver type {}\n", driver);
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    return driver_get_devices_count(driver, *count);
+}
+
+dsp_status dsp_create_device(dsp_device *device)
+{
+    dsp_device_params_t params = {
+        .driver = DSP_DRIVER_TYPE_DEFAULT,
+    };
+
+    return dsp_create_device_ex(&params, device);
+}
+
 dsp_status dsp_release_device(dsp_device device)
 {
     dsp_status status = DSP_UNINITIALIZED;
@@ -75,14 +155,117 @@ dsp_status dsp_release_device(dsp_device device)
         goto l_exit;
     }
 
-    status = driver_close_device(device->fd);
+    // Completes all outstanding jobs before the device goes away, and cancels the ones waiting for fences
+    device->job_queue.reset();
+    // Returns the cached buffers to the driver
+    device->buffer_pool.reset();
+    device->buffer_registry.reset();
+
+    status = driver_close_device(device->driver);
     if (status != DSP_SUCCESS) {
         goto l_exit;
     }
 
+    release_device_slot(device->slot);
     delete device;
     status = DSP_SUCCESS;
 
 l_exit:
     return status;
 }
+
+SubmissionContext::~SubmissionContext()
+{
+    for (auto fence : pending_fences) {
+        close(fence);
+    }
+}
+
+static thread_local dsp_priority_t thread_priority = DSP_PRIORITY_DEFAULT;
+
+dsp_status dsp_set_device_priority(dsp_device device, dsp_priority_t priority)
+{
+    if (!device) {
+        LOGGER__ERROR("Error: device is NULL\n");
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    if (priority >= DSP_PRIORITY_COUNT) {
+        LOGGER__ERROR("Error: Unknown priority {}\n", priority);
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    device->priority = (priority == DSP_PRIORITY_DEFAULT) ? DSP_PRIORITY_NORMAL : priority;
+    return DSP_SUCCESS;
+}
+
+dsp_status dsp_set_thread_priority(dsp_priority_t priority)
+{
+    if (priority >= DSP_PRIORITY_COUNT) {
+        LOGGER__ERROR("Error: Unknown priority {}\n", priority);
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    thread_priority = priority;
+    return DSP_SUCCESS;
+}
+
+dsp_priority_t get_command_priority(dsp_device device, dsp_priority_t priority)
+{
+    if (priority != DSP_PRIORITY_DEFAULT) {
+        return priority;
+    }
+    if (thread_priority != DSP_PRIORITY_DEFAULT) {
+        return thread_priority;
+    }
+    return device->priority.load(std::memory_order_relaxed);
+}
+
+uint32_t get_queue_priority(dsp_priority_t priority)
+{
+    if (priority <= DSP_PRIORITY_NORMAL) {
+        return 0;
+    }
+    return static_cast<uint32_t>(priority - DSP_PRIORITY_NORMAL);
+}
+
+SubmissionContext &get_submission_context(dsp_device device)
+{
+    // Contexts of the devices this thread submitted to, indexed by device slot. The entry of a released device is
+    // replaced by the next device of its slot the thread submits to
+    static thread_local std::vector<std::pair<uint64_t, SubmissionContext *>> thread_contexts;
+
+    if (device->slot < thread_contexts.size()) {
+        const auto &[device_id, context] = thread_contexts[device->slot];
+        if (context && (device_id == device->id)) {
+            return *context;
+        }
+    }
+
+    auto context = new (std::nothrow) SubmissionContext;
+    if (!context) {
+        return device->fallback_submission_context;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(device->submission_contexts_mutex);
+        device->submission_contexts.emplace_back(context);
+    }
+    if (device->slot >= thread_contexts.size()) {
+        thread_contexts.resize(device->slot + 1, {0, nullptr});
+    }
+    thread_contexts[device->slot] = {device->id, context};
+    return *context;
+}
+
+uint32_t get_outstanding_commands(dsp_device device)
+{
+    std::lock_guard<std::mutex> lock(device->submission_contexts_mutex);
+
+    int32_t outstanding_commands = device->fallback_submission_context.outstanding_commands.load(
+        std::memory_order_relaxed);
+    for (const auto &context : device->submission_contexts) {
+        outstanding_commands += context->outstanding_commands.load(std::memory_order_relaxed);
+    }
+    return static_cast<uint32_t>(outstanding_commands);
+}
@@ -23,6 +23,59 @@
 
 #pragma once
 
+#include "buffer_pool.hpp"
+#include "buffer_registry.hpp"
+#include "hailodsp_driver.hpp"
+#include "job.hpp"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Size of a cache line, to keep the submission contexts of different threads apart
+#define SUBMISSION_CONTEXT_ALIGNMENT (64)
+
+// State of the submissions of one thread on one device, so that concurrent submissions on the same device do not
+// share mutable state. Only its thread and the device's worker thread write it
+struct alignas(SUBMISSION_CONTEXT_ALIGNMENT) SubmissionContext {
+    ~SubmissionContext();
+
+    // Commands of the thread in the driver, and its queued asynchronous jobs. The worker thread discounts a job from
+    // the context it was submitted from when it sends it
+    std::atomic<int32_t> outstanding_commands = 0;
+    // Fences queued by dsp_queue_fence_wait, handed over to the next asynchronous job of the thread
+    std::vector<int> pending_fences;
+};
+
 struct _dsp_device {
-    int fd;
-};
\ No newline at end of file
+    std::unique_ptr<Driver> driver;
+    std::unique_ptr<BufferPool> buffer_pool;
+    std::unique_ptr<BufferRegistry> buffer_registry;
+
+    std::atomic<dsp_priority_t> priority = DSP_PRIORITY_NORMAL;
+
+    // Unique for the lifetime of the process, unlike the address of the device
+    uint64_t id;
+    // Index of the device among the live devices. Reused once the device is released
+    size_t slot;
+    std::mutex submission_contexts_mutex;
+    std::vector<std::unique_ptr<SubmissionContext>> submission_contexts;
+    // Shared by the threads whose context could not be allocated
+    SubmissionContext fallback_submission_context;
+
+    // Created on the first asynchronous submission
+    std::once_flag job_queue_once;
+    std::unique_ptr<JobQueue> job_queue;
+};
+
+// Resolves the priority of a command issued now by the calling thread. A priority other than DSP_PRIORITY_DEFAULT is
+// returned as is, which allows asynchronous commands to keep the priority they were submitted with
+dsp_priority_t get_command_priority(dsp_device device, dsp_priority_t priority = DSP_PRIORITY_DEFAULT);
+// XRP queue of a resolved command priority. DSP_PRIORITY_NORMAL is queue 0, the only queue of a driver configured with
+// a single one. There is no queue below it, so DSP_PRIORITY_LOW shares it
+uint32_t get_queue_priority(dsp_priority_t priority);
+
+SubmissionContext &get_submission_context(dsp_device device);
+// Outstanding commands of all the threads of this process. Used by device groups to balance the load
+uint32_t get_outstanding_commands(dsp_device device);
@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2017-2024 Hailo Technologies Ltd. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "device.hpp"
+#include "hailo/hailodsp.h"
+#include "logger_macros.hpp"
+#include "utilization.hpp"
+
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+// How long a utilization sample is used before the device is queried again
+#define UTILIZATION_SAMPLE_PERIOD (std::chrono::milliseconds(100))
+
+typedef struct {
+    dsp_device device;
+    uint32_t utilization;
+    std::chrono::steady_clock::time_point sampled_at;
+} group_member_t;
+
+struct _dsp_device_group {
+    std::mutex mutex;
+    std::vector<group_member_t> members;
+    // Member to start the search from, so that devices with equal load are selected in turns
+    size_t next_member;
+};
+
+dsp_status dsp_create_device_group(const dsp_device devices[], size_t devices_count, dsp_device_group *group)
+{
+    if ((!devices) || (devices_count == 0) || (!group)) {
+        LOGGER__ERROR("Error: Invalid argument (devices={}, devices_count={}, group={})\n", fmt::ptr(devices),
+                      devices_count, fmt::ptr(group));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    for (size_t i = 0; i < devices_count; i++) {
+        if (!devices[i]) {
+            LOGGER__ERROR("Error: devices[{}] is NULL\n", i);
+            return DSP_INVALID_ARGUMENT;
+        }
+    }
+
+    auto local_group = new (std::nothrow) _dsp_device_group;
+    if (!local_group) {
+        LOGGER__ERROR("Failed to allocate memory for device group");
+        return DSP_OUT_OF_HOST_MEMORY;
+    }
+
+    local_group->next_member = 0;
+    local_group->members.reserve(devices_count);
+    for (size_t i = 0; i < devices_count; i++) {
+        local_group->members.push_back({
+            .device = devices[i],
+            .utilization = 0,
+            .sampled_at = {},
+        });
+    }
+
+    *group = local_group;
+    return DSP_SUCCESS;
+}
+
+// The utilization covers the work of all processes, and is used to break ties between devices with no
+// outstanding work of this process. Busy devices are not queried, so the query does not wait behind their commands.
+// The stale samples are claimed under the lock, so that each device is queried by a single thread, and the devices
+// are queried without it, so that other selections don't wait for the DSP meanwhile
+static void refresh_utilization(dsp_device_group group)
+{
+    std::vector<size_t> stale_members;
+    {
+        std::lock_guard<std::mutex> lock(group->mutex);
+        auto now = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < group->members.size(); i++) {
+            auto &member = group->members[i];
+            if ((now - member.sampled_at >= UTILIZATION_SAMPLE_PERIOD) &&
+                (get_outstanding_commands(member.device) == 0)) {
+                member.sampled_at = now;
+                stale_members.push_back(i);
+            }
+        }
+    }
+
+    for (auto index : stale_members) {
+        // The members are fixed when the group is created, so they can be read without the lock
+        uint32_t utilization = 0;
+        if (dsp_get_utilization(group->members[index].device, utilization) != DSP_SUCCESS) {
+            utilization = 0;
+        }
+
+        std::lock_guard<std::mutex> lock(group->mutex);
+        group->members[index].utilization = utilization;
+    }
+}
+
+dsp_status dsp_device_group_select(dsp_device_group group, dsp_device *device)
+{
+    if ((!group) || (!device)) {
+        LOGGER__ERROR("Error: NULL argument (group={}, device={})\n", fmt::ptr(group), fmt::ptr(device));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    refresh_utilization(group);
+
+    std::lock_guard<std::mutex> lock(group->mutex);
+
+    size_t members_count = group->members.size();
+    size_t best = members_count;
+    uint32_t best_load = 0;
+    uint32_t best_utilization = 0;
+
+    for (size_t i = 0; i < members_count; i++) {
+        size_t index = (group->next_member + i) % members_count;
+        const auto &member = group->members[index];
+
+        uint32_t load = get_outstanding_commands(member.device);
+        if ((best != members_count) && (load > best_load)) {
+            continue;
+        }
+
+        if ((best == members_count) || (load < best_load) || (member.utilization < best_utilization)) {
+            best = index;
+            best_load = load;
+            best_utilization = member.utilization;
+        }
+    }
+
+    group->next_member = (best + 1) % members_count;
+    *device = group->members[best].device;
+    return DSP_SUCCESS;
+}
+
+dsp_status dsp_release_device_group(dsp_device_group group)
+{
+    if (!group) {
+        LOGGER__ERROR("Error: group is NULL\n");
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    delete group;
+    return DSP_SUCCESS;
+}
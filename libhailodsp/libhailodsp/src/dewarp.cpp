@@ -21,11 +21,13 @@
  * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
-#include "aligned_uptr.hpp"
+#include "cmdbuf.hpp"
 #include "dewarp_perf.h"
 #include "hailo/hailodsp.h"
 #include "image_utils.hpp"
+#include "job.hpp"
 #include "logger_macros.hpp"
+#include "plan.hpp"
 #include "send_command.hpp"
 #include "user_dsp_interface.h"
 #include "utils.h"
@@ -67,19 +69,13 @@ static dsp_status verify_mesh_properties(const dsp_dewarp_mesh_t *mesh, const ds
     return DSP_SUCCESS;
 }
 
-dsp_status dsp_dewarp_perf(dsp_device device,
-                           const dsp_image_properties_t *src,
-                           const dsp_image_properties_t *dst,
-                           const dsp_dewarp_mesh_t *mesh,
-                           dsp_interpolation_type_t interpolation,
-                           perf_info_t *perf_info)
+static dsp_status build_dewarp_command(const dsp_image_properties_t *src,
+                                       const dsp_image_properties_t *dst,
+                                       const dsp_dewarp_mesh_t *mesh,
+                                       dsp_interpolation_type_t interpolation,
+                                       imaging_request_t *in_data,
+                                       BufferList &buffer_list)
 {
-    if ((!device) || (!src) || (!dst) || (!mesh)) {
-        LOGGER__ERROR("Error: One of the parameters provided is NULL (device={}, src={}, dst={}, mesh={})\n",
-                      fmt::ptr(device), fmt::ptr(src), fmt::ptr(dst), fmt::ptr(mesh));
-        return DSP_INVALID_ARGUMENT;
-    }
-
     auto status = verify_image_properties(src);
     if (status != DSP_SUCCESS) {
         LOGGER__ERROR("Error: Image properties check failed for \"src\"\n");
@@ -116,7 +112,6 @@ dsp_status dsp_dewarp_perf(dsp_device device,
     size_t mesh_line_stride = mesh->mesh_width * 2 * 4;
     size_t mesh_size = mesh_line_stride * mesh->mesh_height;
 
-    auto in_data = make_aligned_uptr<imaging_request_t>();
     in_data->operation = IMAGING_OP_DEWARP;
     in_data->dewarp_args.interpolation = interpolation;
     in_data->dewarp_args.mesh_width = mesh->mesh_width;
@@ -124,7 +119,7 @@ dsp_status dsp_dewarp_perf(dsp_device device,
     in_data->dewarp_args.mesh.plane_size = mesh_size;
     in_data->dewarp_args.mesh.line_stride = mesh_line_stride;
 
-    std::vector<command_image_t> images = {
+    command_image_t images[] = {
         {
             .user_api_image = src,
             .dsp_api_image = &in_data->dewarp_args.src,
@@ -137,18 +132,40 @@ dsp_status dsp_dewarp_perf(dsp_device device,
         },
     };
 
-    BufferList buffer_list;
-    in_data->dewarp_args.mesh.xrp_buffer_index =
-        buffer_list.add_buffer(mesh->mesh_table, mesh_size, BufferAccessType::Read);
+    status = buffer_list.add_buffer(mesh->mesh_table, mesh_size, BufferAccessType::Read,
+                                    in_data->dewarp_args.mesh.xrp_buffer_index);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
     status = add_images_to_buffer_list(buffer_list, images);
     if (status != DSP_SUCCESS) {
         LOGGER__ERROR("Error: Failed adding images to buffer list. Error code: {}\n", status);
         return status;
     }
 
-    size_t perf_info_size = perf_info ? sizeof(*perf_info) : 0;
+    return DSP_SUCCESS;
+}
 
-    status = send_command(device, buffer_list, in_data.get(), sizeof(imaging_request_t), perf_info, perf_info_size);
+dsp_status dsp_dewarp_perf(dsp_device device,
+                           const dsp_image_properties_t *src,
+                           const dsp_image_properties_t *dst,
+                           const dsp_dewarp_mesh_t *mesh,
+                           dsp_interpolation_type_t interpolation,
+                           perf_info_t *perf_info)
+{
+    if ((!device) || (!src) || (!dst) || (!mesh)) {
+        LOGGER__ERROR("Error: One of the parameters provided is NULL (device={}, src={}, dst={}, mesh={})\n",
+                      fmt::ptr(device), fmt::ptr(src), fmt::ptr(dst), fmt::ptr(mesh));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    ImagingCommand command;
+    auto status = build_dewarp_command(src, dst, mesh, interpolation, command.request.get(), command.buffer_list);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    status = send_command(device, command, perf_info);
     if (status != DSP_SUCCESS) {
         LOGGER__ERROR("Error: Failed executing dewarp operation. Error code: {}\n", status);
     }
@@ -163,4 +180,61 @@ dsp_status dsp_dewarp(dsp_device device,
                       dsp_interpolation_type_t interpolation)
 {
     return dsp_dewarp_perf(device, src, dst, mesh, interpolation, NULL);
-}
\ No newline at end of file
+}
+
+dsp_status dsp_dewarp_async(dsp_device device,
+                            const dsp_image_properties_t *src,
+                            const dsp_image_properties_t *dst,
+                            const dsp_dewarp_mesh_t *mesh,
+                            dsp_interpolation_type_t interpolation,
+                            dsp_job *job)
+{
+    if ((!device) || (!src) || (!dst) || (!mesh) || (!job)) {
+        LOGGER__ERROR("Error: One of the parameters provided is NULL (device={}, src={}, dst={}, mesh={}, job={})\n",
+                      fmt::ptr(device), fmt::ptr(src), fmt::ptr(dst), fmt::ptr(mesh), fmt::ptr(job));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    ImagingCommand command;
+    auto status = build_dewarp_command(src, dst, mesh, interpolation, command.request.get(), command.buffer_list);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    return submit_command_async(device, std::move(command), NULL, job);
+}
+
+dsp_status dsp_cmdbuf_record_dewarp(dsp_cmdbuf cmdbuf,
+                                    const dsp_image_properties_t *src,
+                                    const dsp_image_properties_t *dst,
+                                    const dsp_dewarp_mesh_t *mesh,
+                                    dsp_interpolation_type_t interpolation)
+{
+    if ((!cmdbuf) || (!src) || (!dst) || (!mesh)) {
+        LOGGER__ERROR("Error: One of the parameters provided is NULL (cmdbuf={}, src={}, dst={}, mesh={})\n",
+                      fmt::ptr(cmdbuf), fmt::ptr(src), fmt::ptr(dst), fmt::ptr(mesh));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    return cmdbuf_record(cmdbuf, {src, dst}, [&](imaging_request_t *request, BufferList &buffer_list) {
+        return build_dewarp_command(src, dst, mesh, interpolation, request, buffer_list);
+    });
+}
+
+dsp_status dsp_plan_create_dewarp(dsp_device device,
+                                  const dsp_image_properties_t *src,
+                                  const dsp_image_properties_t *dst,
+                                  const dsp_dewarp_mesh_t *mesh,
+                                  dsp_interpolation_type_t interpolation,
+                                  dsp_plan *plan)
+{
+    if ((!src) || (!dst) || (!mesh)) {
+        LOGGER__ERROR("Error: One of the parameters provided is NULL (src={}, dst={}, mesh={})\n", fmt::ptr(src),
+                      fmt::ptr(dst), fmt::ptr(mesh));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    return plan_create(device, {src, dst}, plan, [&](imaging_request_t *request, BufferList &buffer_list) {
+        return build_dewarp_command(src, dst, mesh, interpolation, request, buffer_list);
+    });
+}
@@ -0,0 +1,362 @@
+/*
+ * Copyright (c) 2017-2024 Hailo Technologies Ltd. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "emulated_driver.hpp"
+#include "emulated_imaging.hpp"
+#include "logger_macros.hpp"
+#include "user_dsp_interface.h"
+#include "xrp_types.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <thread>
+#include <unistd.h>
+
+#include "xrp_kernel_defs.h"
+
+#define LATENCY_ENV_NAME ("HAILODSP_EMULATOR_LATENCY_US")
+#define NOOP_ENV_NAME ("HAILODSP_EMULATOR_NOOP")
+#define FAILING_SYNC_ENV_NAME ("HAILODSP_EMULATOR_FAILING_SYNC")
+#define NSID_SIZE (16)
+
+static std::chrono::microseconds get_latency()
+{
+    const char *latency = std::getenv(LATENCY_ENV_NAME);
+    if (latency == nullptr) {
+        return std::chrono::microseconds(0);
+    }
+    return std::chrono::microseconds(strtoul(latency, nullptr, 0));
+}
+
+static bool get_noop()
+{
+    const char *noop = std::getenv(NOOP_ENV_NAME);
+    return (noop != nullptr) && (strcmp(noop, "1") == 0);
+}
+
+// 1-based index of the buffer sync that fails, 0 when no sync fails
+static uint32_t get_failing_sync()
+{
+    const char *failing_sync = std::getenv(FAILING_SYNC_ENV_NAME);
+    if (failing_sync == nullptr) {
+        return 0;
+    }
+    return strtoul(failing_sync, nullptr, 0);
+}
+
+EmulatedDriver::EmulatedDriver() :
+    m_next_handle(1),
+    m_executing(false),
+    m_waiting_commands({}),
+    m_noop(get_noop()),
+    m_latency(get_latency()),
+    m_syncs_until_failure(get_failing_sync()),
+    m_utilization_period_start(std::chrono::steady_clock::now()),
+    m_busy_time(0)
+{}
+
+EmulatedDriver::~EmulatedDriver()
+{
+    for (const auto &[addr, size] : m_allocations) {
+        LOGGER__WARN("Emulated buffer {:#x} of size {} was not released", addr, size);
+        free(reinterpret_cast<void *>(addr));
+    }
+}
+
+int EmulatedDriver::ioctl(unsigned long request, void *arg)
+{
+    if (!arg) {
+        errno = EFAULT;
+        return -1;
+    }
+
+    int ret;
+    switch (request) {
+        case XRP_IOCTL_ALLOC:
+            ret = allocate_buffer(static_cast<struct xrp_ioctl_alloc *>(arg));
+            break;
+        case XRP_IOCTL_FREE:
+            ret = release_buffer(static_cast<struct xrp_ioctl_alloc *>(arg));
+            break;
+        case XRP_IOCTL_DMA_SYNC:
+            ret = sync_buffer(static_cast<struct xrp_ioctl_sync_buffer *>(arg));
+            break;
+        case XRP_IOCTL_QUEUE:
+            ret = queue_command(static_cast<struct xrp_ioctl_queue *>(arg));
+            break;
+        case XRP_IOCTL_REGISTER:
+            ret = register_buffer(static_cast<struct xrp_ioctl_register *>(arg));
+            break;
+        case XRP_IOCTL_UNREGISTER:
+            ret = unregister_buffer(static_cast<struct xrp_ioctl_register *>(arg));
+            break;
+        default:
+            ret = -ENOTTY;
+            break;
+    }
+
+    if (ret < 0) {
+        errno = -ret;
+        return -1;
+    }
+    return 0;
+}
+
+int EmulatedDriver::allocate_buffer(struct xrp_ioctl_alloc *ioctl_alloc)
+{
+    size_t page_size = getpagesize();
+    size_t size = ((ioctl_alloc->size + page_size - 1) / page_size) * page_size;
+    if (size == 0) {
+        return -EINVAL;
+    }
+
+    void *buffer = aligned_alloc(page_size, size);
+    if (!buffer) {
+        return -ENOMEM;
+    }
+
+    std::lock_guard<std::mutex> lock(m_allocations_mutex);
+    m_allocations[reinterpret_cast<uintptr_t>(buffer)] = ioctl_alloc->size;
+    ioctl_alloc->addr = reinterpret_cast<uintptr_t>(buffer);
+    return 0;
+}
+
+int EmulatedDriver::release_buffer(struct xrp_ioctl_alloc *ioctl_alloc)
+{
+    std::lock_guard<std::mutex> lock(m_allocations_mutex);
+    auto allocation = m_allocations.find(ioctl_alloc->addr);
+    if (allocation == m_allocations.end()) {
+        return -EINVAL;
+    }
+
+    free(reinterpret_cast<void *>(allocation->first));
+    m_allocations.erase(allocation);
+    return 0;
+}
+
+int EmulatedDriver::sync_buffer(struct xrp_ioctl_sync_buffer *ioctl_sync)
+{
+    // Host memory is coherent, there is nothing to do besides validating the request
+    if ((ioctl_sync->addr == 0) || (ioctl_sync->direction < DSP_BUFFER_SYNC_READ) ||
+        (ioctl_sync->direction > DSP_BUFFER_SYNC_RW)) {
+        return -EINVAL;
+    }
+
+    uint32_t syncs_until_failure = m_syncs_until_failure.load();
+    while ((syncs_until_failure != 0) &&
+           !m_syncs_until_failure.compare_exchange_weak(syncs_until_failure, syncs_until_failure - 1)) {
+    }
+    if (syncs_until_failure == 1) {
+        return -EIO;
+    }
+    return 0;
+}
+
+int EmulatedDriver::register_buffer(struct xrp_ioctl_register *ioctl_register)
+{
+    if ((ioctl_register->addr == 0) || (ioctl_register->size == 0)) {
+        return -EINVAL;
+    }
+
+    // Host memory needs no pinning, the range is only remembered
+    std::lock_guard<std::mutex> lock(m_registrations_mutex);
+    ioctl_register->handle = m_next_handle++;
+    m_registrations[ioctl_register->handle] = {
+        .data = reinterpret_cast<uint8_t *>(ioctl_register->addr),
+        .size = ioctl_register->size,
+    };
+    return 0;
+}
+
+int EmulatedDriver::unregister_buffer(struct xrp_ioctl_register *ioctl_register)
+{
+    std::lock_guard<std::mutex> lock(m_registrations_mutex);
+    return m_registrations.erase(ioctl_register->handle) == 1 ? 0 : -EINVAL;
+}
+
+// Maps the buffers of a command for the duration of its execution
+class MappedBuffers {
+   public:
+    ~MappedBuffers()
+    {
+        for (const auto &mapping : m_mappings) {
+            munmap(mapping.data, mapping.size);
+        }
+    }
+
+    int map(const struct xrp_ioctl_buffer *ioctl_buffers,
+            size_t count,
+            const std::map<uint32_t, emulated_buffer_t> &registrations)
+    {
+        m_table.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            const auto &ioctl_buffer = ioctl_buffers[i];
+            if (ioctl_buffer.memory_type == XRP_MEMORY_TYPE_USERPTR) {
+                m_table.push_back({reinterpret_cast<uint8_t *>(ioctl_buffer.addr), ioctl_buffer.size});
+            } else if (ioctl_buffer.memory_type == XRP_MEMORY_TYPE_DMABUF) {
+                void *data = mmap(NULL, ioctl_buffer.size, PROT_READ | PROT_WRITE, MAP_SHARED, ioctl_buffer.fd, 0);
+                if (data == MAP_FAILED) {
+                    LOGGER__ERROR("Emulator: Failed to map dma-buf fd {}, errno={}", ioctl_buffer.fd, errno);
+                    return -EINVAL;
+                }
+                m_mappings.push_back({static_cast<uint8_t *>(data), ioctl_buffer.size});
+                m_table.push_back(m_mappings.back());
+            } else if (ioctl_buffer.memory_type == XRP_MEMORY_TYPE_REGISTERED) {
+                auto registration = registrations.find(ioctl_buffer.registered.handle);
+                if ((registration == registrations.end()) ||
+                    (static_cast<size_t>(ioctl_buffer.registered.offset) + ioctl_buffer.size >
+                     registration->second.size)) {
+                    LOGGER__ERROR("Emulator: Invalid registered buffer handle {} offset {} size {}",
+                                  ioctl_buffer.registered.handle, ioctl_buffer.registered.offset, ioctl_buffer.size);
+                    return -EINVAL;
+                }
+                m_table.push_back({registration->second.data + ioctl_buffer.registered.offset, ioctl_buffer.size});
+            } else {
+                return -EINVAL;
+            }
+        }
+        return 0;
+    }
+
+    const EmulatedBufferTable &table() const { return m_table; }
+
+   private:
+    EmulatedBufferTable m_table;
+    std::vector<emulated_buffer_t> m_mappings;
+};
+
+int EmulatedDriver::run_imaging_command(struct xrp_ioctl_queue *ioctl_queue)
+{
+    if ((ioctl_queue->in_data_size < sizeof(imaging_request_t)) || (ioctl_queue->in_data_addr == 0) ||
+        (ioctl_queue->buffer_size % sizeof(struct xrp_ioctl_buffer) != 0)) {
+        return -EINVAL;
+    }
+
+    MappedBuffers buffers;
+    int ret;
+    {
+        std::lock_guard<std::mutex> lock(m_registrations_mutex);
+        ret = buffers.map(reinterpret_cast<const struct xrp_ioctl_buffer *>(ioctl_queue->buffer_addr),
+                          ioctl_queue->buffer_size / sizeof(struct xrp_ioctl_buffer), m_registrations);
+    }
+    if (ret < 0) {
+        return ret;
+    }
+
+    ret = emulate_imaging_request(reinterpret_cast<const imaging_request_t *>(ioctl_queue->in_data_addr),
+                                  buffers.table());
+    if (ret < 0) {
+        LOGGER__ERROR("Emulator: Imaging request failed, err={}", ret);
+        return ret;
+    }
+
+    // No performance counters are emulated
+    if ((ioctl_queue->out_data_size > 0) && (ioctl_queue->out_data_addr != 0)) {
+        memset(reinterpret_cast<void *>(ioctl_queue->out_data_addr), 0, ioctl_queue->out_data_size);
+    }
+
+    return 0;
+}
+
+int EmulatedDriver::run_utilization_command(struct xrp_ioctl_queue *ioctl_queue)
+{
+    if ((ioctl_queue->out_data_size < sizeof(utilization_response_t)) || (ioctl_queue->out_data_addr == 0)) {
+        return -EINVAL;
+    }
+
+    // Percentage of time spent executing commands since the previous query
+    auto now = std::chrono::steady_clock::now();
+    auto period = now - m_utilization_period_start;
+    auto response = reinterpret_cast<utilization_response_t *>(ioctl_queue->out_data_addr);
+    response->utilization = period.count() > 0 ? static_cast<uint32_t>((100 * m_busy_time) / period) : 0;
+
+    m_utilization_period_start = now;
+    m_busy_time = std::chrono::steady_clock::duration(0);
+    return 0;
+}
+
+void EmulatedDriver::begin_execution(uint32_t queue_priority)
+{
+    std::unique_lock<std::mutex> lock(m_execution_mutex);
+    m_waiting_commands[queue_priority]++;
+    m_execution_cv.wait(lock, [this, queue_priority] {
+        return !m_executing && std::all_of(m_waiting_commands.begin() + queue_priority + 1, m_waiting_commands.end(),
+                                           [](uint32_t waiting) { return waiting == 0; });
+    });
+    m_waiting_commands[queue_priority]--;
+    m_executing = true;
+}
+
+void EmulatedDriver::end_execution(std::chrono::steady_clock::duration elapsed)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_execution_mutex);
+        m_executing = false;
+        m_busy_time += elapsed;
+    }
+    m_execution_cv.notify_all();
+}
+
+int EmulatedDriver::queue_command(struct xrp_ioctl_queue *ioctl_queue)
+{
+    if ((ioctl_queue->flags & ~XRP_QUEUE_VALID_FLAGS) || !(ioctl_queue->flags & XRP_QUEUE_FLAG_NSID) ||
+        (ioctl_queue->nsid_addr == 0)) {
+        return -EINVAL;
+    }
+
+    auto nsid = reinterpret_cast<const char *>(ioctl_queue->nsid_addr);
+
+    if (memcmp(nsid, UTILIZATION_NSID, NSID_SIZE) == 0) {
+        std::lock_guard<std::mutex> lock(m_execution_mutex);
+        return run_utilization_command(ioctl_queue);
+    }
+
+    if (memcmp(nsid, IMAGING_NSID, NSID_SIZE) != 0) {
+        LOGGER__ERROR("Emulator: Unsupported namespace \"{}\"", std::string(nsid, NSID_SIZE));
+        return -ENOENT;
+    }
+
+    // Without a simulated latency, no-op commands take no DSP time. Not serializing them lets the host side of
+    // concurrent submission be measured on its own
+    if (m_noop && (m_latency.count() == 0)) {
+        return 0;
+    }
+
+    begin_execution((ioctl_queue->flags & XRP_QUEUE_FLAG_PRIO) >> XRP_QUEUE_FLAG_PRIO_SHIFT);
+
+    auto start = std::chrono::steady_clock::now();
+    int ret = m_noop ? 0 : run_imaging_command(ioctl_queue);
+
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    if (elapsed < m_latency) {
+        std::this_thread::sleep_for(m_latency - elapsed);
+        elapsed = m_latency;
+    }
+    end_execution(elapsed);
+
+    return ret;
+}
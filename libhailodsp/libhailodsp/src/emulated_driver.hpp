@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2017-2024 Hailo Technologies Ltd. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "emulated_imaging.hpp"
+#include "hailodsp_driver.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+
+#include "xrp_kernel_defs.h"
+
+// In-process emulation of the XRP kernel driver and the DSP firmware.
+// Buffers are allocated from host memory, and imaging requests are executed on the CPU by a reference
+// implementation of every imaging operation. Commands are executed one at a time, like on a single DSP core, and
+// waiting commands are executed in queue priority order.
+// In no-op mode, imaging commands complete immediately without being executed.
+// A single buffer sync may be set to fail, to exercise the error paths of host side writes
+class EmulatedDriver : public Driver {
+   public:
+    EmulatedDriver();
+    ~EmulatedDriver() override;
+
+    int ioctl(unsigned long request, void *arg) override;
+
+   private:
+    int allocate_buffer(struct xrp_ioctl_alloc *ioctl_alloc);
+    int release_buffer(struct xrp_ioctl_alloc *ioctl_alloc);
+    int sync_buffer(struct xrp_ioctl_sync_buffer *ioctl_sync);
+    int register_buffer(struct xrp_ioctl_register *ioctl_register);
+    int unregister_buffer(struct xrp_ioctl_register *ioctl_register);
+    int queue_command(struct xrp_ioctl_queue *ioctl_queue);
+    int run_imaging_command(struct xrp_ioctl_queue *ioctl_queue);
+    int run_utilization_command(struct xrp_ioctl_queue *ioctl_queue);
+    // Waits until no command is executing and no command of higher priority is waiting
+    void begin_execution(uint32_t queue_priority);
+    void end_execution(std::chrono::steady_clock::duration elapsed);
+
+    std::mutex m_allocations_mutex;
+    // Buffers allocated by XRP_IOCTL_ALLOC, address to size
+    std::map<uintptr_t, size_t> m_allocations;
+
+    std::mutex m_registrations_mutex;
+    // Buffers registered by XRP_IOCTL_REGISTER, handle to buffer
+    std::map<uint32_t, emulated_buffer_t> m_registrations;
+    uint32_t m_next_handle;
+
+    // Serializes command execution
+    std::mutex m_execution_mutex;
+    std::condition_variable m_execution_cv;
+    bool m_executing;
+    // Number of waiting commands of every queue priority
+    std::array<uint32_t, (XRP_QUEUE_FLAG_PRIO >> XRP_QUEUE_FLAG_PRIO_SHIFT) + 1> m_waiting_commands;
+    // Complete imaging commands without executing them
+    bool m_noop;
+    std::chrono::microseconds m_latency;
+    // Number of buffer syncs until the failing one, 0 when no sync fails
+    std::atomic<uint32_t> m_syncs_until_failure;
+    std::chrono::steady_clock::time_point m_utilization_period_start;
+    std::chrono::steady_clock::duration m_busy_time;
+};
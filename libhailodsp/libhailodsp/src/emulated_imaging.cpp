@@ -0,0 +1,1373 @@
+/*
+ * Copyright (c) 2017-2024 Hailo Technologies Ltd. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "emulated_imaging.hpp"
+#include "hailo/hailodsp.h"
+#include "resize_perf.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <optional>
+
+#define MESH_SQ_SIZE (64)
+
+// View of a single plane. Pixels of interleaved planes (RGB, NV12 UV) have several channels
+typedef struct {
+    uint8_t *data;
+    size_t stride;
+    size_t width;
+    size_t height;
+    size_t channels;
+} plane_view_t;
+
+typedef struct {
+    uint32_t format;
+    size_t width;
+    size_t height;
+    plane_view_t planes[MAX_PLANES];
+    size_t planes_count;
+} image_view_t;
+
+typedef struct {
+    size_t start_x;
+    size_t start_y;
+    size_t end_x;
+    size_t end_y;
+} region_t;
+
+static uint8_t clamp_to_u8(float value)
+{
+    return static_cast<uint8_t>(std::clamp(std::lround(value), 0L, 255L));
+}
+
+static int resolve_plane(const data_plane_t &plane,
+                         const EmulatedBufferTable &buffers,
+                         size_t width,
+                         size_t height,
+                         size_t channels,
+                         plane_view_t &view)
+{
+    if (plane.xrp_buffer_index >= buffers.size()) {
+        return -EINVAL;
+    }
+
+    const auto &buffer = buffers[plane.xrp_buffer_index];
+    if ((buffer.data == nullptr) || (plane.plane_size > buffer.size) || (plane.line_stride < width * channels) ||
+        (static_cast<size_t>(plane.line_stride) * (height - 1) + width * channels > plane.plane_size)) {
+        return -EINVAL;
+    }
+
+    view = {
+        .data = buffer.data,
+        .stride = plane.line_stride,
+        .width = width,
+        .height = height,
+        .channels = channels,
+    };
+    return 0;
+}
+
+static int resolve_image(const image_properties_t &image, const EmulatedBufferTable &buffers, image_view_t &view)
+{
+    size_t width = image.width;
+    size_t height = image.height;
+    size_t half_width = (width + 1) / 2;
+    size_t half_height = (height + 1) / 2;
+
+    // Plane dimensions and channels for every format
+    struct {
+        size_t width;
+        size_t height;
+        size_t channels;
+    } layout[MAX_PLANES];
+    size_t planes_count;
+
+    switch (image.format) {
+        case INTERFACE_IMAGE_FORMAT_GRAY8:
+            layout[0] = {width, height, 1};
+            planes_count = 1;
+            break;
+        case INTERFACE_IMAGE_FORMAT_RGB:
+            layout[0] = {width, height, 3};
+            planes_count = 1;
+            break;
+        case INTERFACE_IMAGE_FORMAT_NV12:
+            layout[0] = {width, height, 1};
+            layout[1] = {half_width, half_height, 2};
+            planes_count = 2;
+            break;
+        case INTERFACE_IMAGE_FORMAT_A420:
+            layout[0] = {width, height, 1};
+            layout[1] = {half_width, half_height, 1};
+            layout[2] = {half_width, half_height, 1};
+            layout[3] = {width, height, 1};
+            planes_count = 4;
+            break;
+        default:
+            return -EINVAL;
+    }
+
+    if ((width == 0) || (height == 0) || (image.planes_count != planes_count)) {
+        return -EINVAL;
+    }
+
+    view.format = image.format;
+    view.width = width;
+    view.height = height;
+    view.planes_count = planes_count;
+    for (size_t i = 0; i < planes_count; ++i) {
+        int ret = resolve_plane(image.planes[i], buffers, layout[i].width, layout[i].height, layout[i].channels,
+                                view.planes[i]);
+        if (ret < 0) {
+            return ret;
+        }
+    }
+
+    return 0;
+}
+
+static uint8_t *pixel(const plane_view_t &plane, size_t x, size_t y)
+{
+    return plane.data + y * plane.stride + x * plane.channels;
+}
+
+// A private copy of a plane, used when an operation reads pixels that it also overwrites
+class PlaneCopy {
+   public:
+    explicit PlaneCopy(const plane_view_t &plane) :
+        m_data(plane.stride * plane.height), m_view(plane)
+    {
+        memcpy(m_data.data(), plane.data, plane.stride * (plane.height - 1) + plane.width * plane.channels);
+        m_view.data = m_data.data();
+    }
+
+    const plane_view_t &view() const { return m_view; }
+
+   private:
+    std::vector<uint8_t> m_data;
+    plane_view_t m_view;
+};
+
+/*
+ * Resampling
+ */
+
+// Source pixels and weights contributing to each destination pixel, along one axis
+class AxisTaps {
+   public:
+    AxisTaps(size_t src_start, size_t src_length, size_t dst_length, uint8_t interpolation)
+    {
+        double scale = static_cast<double>(src_length) / dst_length;
+        if ((interpolation == INTERPOLATION_TYPE_AREA) && (scale < 1.0)) {
+            interpolation = INTERPOLATION_TYPE_BILINEAR;
+        }
+
+        for (size_t dst = 0; dst < dst_length; ++dst) {
+            m_first.push_back(m_index.size());
+            double center = (dst + 0.5) * scale - 0.5;
+
+            switch (interpolation) {
+                case INTERPOLATION_TYPE_NEAREST_NEIGHBOR:
+                    add_tap(src_start, src_length, static_cast<long>(std::floor((dst + 0.5) * scale)), 1.0);
+                    break;
+
+                case INTERPOLATION_TYPE_BILINEAR: {
+                    center = std::clamp(center, 0.0, static_cast<double>(src_length - 1));
+                    long left = static_cast<long>(std::floor(center));
+                    double fraction = center - left;
+                    add_tap(src_start, src_length, left, 1.0 - fraction);
+                    add_tap(src_start, src_length, left + 1, fraction);
+                    break;
+                }
+
+                case INTERPOLATION_TYPE_BICUBIC: {
+                    long left = static_cast<long>(std::floor(center));
+                    double fraction = center - left;
+                    for (long i = -1; i <= 2; ++i) {
+                        add_tap(src_start, src_length, left + i, cubic_weight(i - fraction));
+                    }
+                    break;
+                }
+
+                case INTERPOLATION_TYPE_AREA: {
+                    // Average of the source pixels covered by the destination pixel, with partial coverage at the
+                    // edges
+                    double begin = dst * scale;
+                    double end = (dst + 1) * scale;
+                    for (long i = static_cast<long>(std::floor(begin)); i < end; ++i) {
+                        double coverage = std::min<double>(i + 1, end) - std::max<double>(i, begin);
+                        if (coverage > 0) {
+                            add_tap(src_start, src_length, i, coverage / scale);
+                        }
+                    }
+                    break;
+                }
+
+                default:
+                    break;
+            }
+            m_count.push_back(m_index.size() - m_first.back());
+        }
+    }
+
+    size_t first(size_t dst) const { return m_first[dst]; }
+    size_t count(size_t dst) const { return m_count[dst]; }
+    size_t index(size_t tap) const { return m_index[tap]; }
+    float weight(size_t tap) const { return m_weight[tap]; }
+
+   private:
+    // Keys cubic convolution kernel, with the same coefficient as OpenCV
+    static double cubic_weight(double x)
+    {
+        const double a = -0.75;
+        x = std::fabs(x);
+        if (x <= 1.0) {
+            return ((a + 2) * x - (a + 3)) * x * x + 1;
+        }
+        if (x < 2.0) {
+            return ((a * x - 5 * a) * x + 8 * a) * x - 4 * a;
+        }
+        return 0.0;
+    }
+
+    void add_tap(size_t src_start, size_t src_length, long index, double weight)
+    {
+        index = std::clamp(index, 0L, static_cast<long>(src_length) - 1);
+        m_index.push_back(src_start + index);
+        m_weight.push_back(static_cast<float>(weight));
+    }
+
+    std::vector<size_t> m_first;
+    std::vector<size_t> m_count;
+    std::vector<size_t> m_index;
+    std::vector<float> m_weight;
+};
+
+static void resize_plane(const plane_view_t &src, const region_t &crop, const plane_view_t &dst, uint8_t interpolation)
+{
+    AxisTaps x_taps(crop.start_x, crop.end_x - crop.start_x, dst.width, interpolation);
+    AxisTaps y_taps(crop.start_y, crop.end_y - crop.start_y, dst.height, interpolation);
+    std::vector<float> row(src.width * src.channels);
+
+    for (size_t dy = 0; dy < dst.height; ++dy) {
+        // Vertical pass into a single row, then a horizontal pass into the destination
+        std::fill(row.begin() + crop.start_x * src.channels, row.begin() + crop.end_x * src.channels, 0.0f);
+        for (size_t t = y_taps.first(dy); t < y_taps.first(dy) + y_taps.count(dy); ++t) {
+            const uint8_t *src_row = pixel(src, 0, y_taps.index(t));
+            float weight = y_taps.weight(t);
+            for (size_t i = crop.start_x * src.channels; i < crop.end_x * src.channels; ++i) {
+                row[i] += weight * src_row[i];
+            }
+        }
+
+        uint8_t *dst_row = pixel(dst, 0, dy);
+        for (size_t dx = 0; dx < dst.width; ++dx) {
+            for (size_t c = 0; c < dst.channels; ++c) {
+                float value = 0.0f;
+                for (size_t t = x_taps.first(dx); t < x_taps.first(dx) + x_taps.count(dx); ++t) {
+                    value += x_taps.weight(t) * row[x_taps.index(t) * src.channels + c];
+                }
+                dst_row[dx * dst.channels + c] = clamp_to_u8(value);
+            }
+        }
+    }
+}
+
+// Chroma planes of YUV 4:2:0 formats are cropped at half resolution
+static region_t chroma_region(const region_t &region)
+{
+    return {
+        .start_x = region.start_x / 2,
+        .start_y = region.start_y / 2,
+        .end_x = (region.end_x + 1) / 2,
+        .end_y = (region.end_y + 1) / 2,
+    };
+}
+
+static int crop_and_resize_image(const image_view_t &src,
+                                 const region_t &crop,
+                                 const image_view_t &dst,
+                                 uint8_t interpolation)
+{
+    if ((src.format != dst.format) || (crop.start_x >= crop.end_x) || (crop.start_y >= crop.end_y) ||
+        (crop.end_x > src.width) || (crop.end_y > src.height) || (interpolation >= INTERPOLATION_TYPE_COUNT)) {
+        return -EINVAL;
+    }
+
+    switch (src.format) {
+        case INTERFACE_IMAGE_FORMAT_GRAY8:
+        case INTERFACE_IMAGE_FORMAT_RGB:
+            resize_plane(src.planes[0], crop, dst.planes[0], interpolation);
+            return 0;
+        case INTERFACE_IMAGE_FORMAT_NV12:
+            resize_plane(src.planes[0], crop, dst.planes[0], interpolation);
+            resize_plane(src.planes[1], chroma_region(crop), dst.planes[1], interpolation);
+            return 0;
+        default:
+            return -EINVAL;
+    }
+}
+
+static int emulate_crop_and_resize(const crop_resize_in_data_t &args, const EmulatedBufferTable &buffers)
+{
+    image_view_t src, dst;
+    if ((resolve_image(args.src, buffers, src) < 0) || (resolve_image(args.dst, buffers, dst) < 0)) {
+        return -EINVAL;
+    }
+
+    region_t crop = {args.crop_start_x, args.crop_start_y, args.crop_end_x, args.crop_end_y};
+    return crop_and_resize_image(src, crop, dst, args.interpolation);
+}
+
+/*
+ * Privacy mask
+ */
+
+// Each bit of the bitmask covers PRIVACY_MASK_QUANTIZATION x PRIVACY_MASK_QUANTIZATION pixels. Bit (x % 8) of byte
+// (x / 8) in a bitmask line covers the pixels of quantized column x
+static bool privacy_mask_bit(const plane_view_t &bitmask, size_t x, size_t y)
+{
+    return (bitmask.data[y * bitmask.stride + x / 8] >> (x % 8)) & 1;
+}
+
+static int apply_privacy_mask(const privacy_mask_in_data_t &privacy_mask,
+                              const EmulatedBufferTable &buffers,
+                              const image_view_t &image)
+{
+    size_t bitmask_width = (image.width + PRIVACY_MASK_QUANTIZATION - 1) / PRIVACY_MASK_QUANTIZATION;
+    size_t bitmask_height = (image.height + PRIVACY_MASK_QUANTIZATION - 1) / PRIVACY_MASK_QUANTIZATION;
+    plane_view_t bitmask;
+    int ret = resolve_plane(privacy_mask.bitmask, buffers, (bitmask_width + 7) / 8, bitmask_height, 1, bitmask);
+    if ((ret < 0) || (privacy_mask.rois_count > MAX_PRIVACY_MASK_ROIS)) {
+        return -EINVAL;
+    }
+
+    const auto &y_plane = image.planes[0];
+    const auto &uv_plane = image.planes[1];
+    for (size_t r = 0; r < privacy_mask.rois_count; ++r) {
+        const auto &roi = privacy_mask.rois[r];
+        size_t end_x = std::min<size_t>(roi.end_x, bitmask_width);
+        size_t end_y = std::min<size_t>(roi.end_y, bitmask_height);
+
+        for (size_t qy = roi.start_y; qy < end_y; ++qy) {
+            for (size_t qx = roi.start_x; qx < end_x; ++qx) {
+                if (!privacy_mask_bit(bitmask, qx, qy)) {
+                    continue;
+                }
+
+                size_t x0 = qx * PRIVACY_MASK_QUANTIZATION;
+                size_t y0 = qy * PRIVACY_MASK_QUANTIZATION;
+                size_t x1 = std::min(x0 + PRIVACY_MASK_QUANTIZATION, image.width);
+                size_t y1 = std::min(y0 + PRIVACY_MASK_QUANTIZATION, image.height);
+                for (size_t y = y0; y < y1; ++y) {
+                    memset(pixel(y_plane, x0, y), privacy_mask.y_color, x1 - x0);
+                }
+                for (size_t y = y0 / 2; y < (y1 + 1) / 2; ++y) {
+                    for (size_t x = x0 / 2; x < (x1 + 1) / 2; ++x) {
+                        pixel(uv_plane, x, y)[0] = privacy_mask.u_color;
+                        pixel(uv_plane, x, y)[1] = privacy_mask.v_color;
+                    }
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+
+// Defined with the format conversions
+static int crop_resize_convert_image(const image_view_t &src,
+                                     const region_t &crop,
+                                     const image_view_t &dst,
+                                     uint8_t interpolation);
+
+static int emulate_multi_crop_and_resize(const multi_crop_resize_in_data_t &args,
+                                         const EmulatedBufferTable &buffers,
+                                         bool privacy_mask,
+                                         bool convert)
+{
+    image_view_t src;
+    if ((resolve_image(args.src, buffers, src) < 0) || (args.dst_count > INTERFACE_MULTI_RESIZE_OUTPUTS_COUNT)) {
+        return -EINVAL;
+    }
+
+    switch (src.format) {
+        case INTERFACE_IMAGE_FORMAT_NV12:
+            break;
+        case INTERFACE_IMAGE_FORMAT_GRAY8:
+        case INTERFACE_IMAGE_FORMAT_RGB:
+            // Like the firmware, only the converting operation accepts non-NV12 sources. The privacy mask colors are
+            // YUV, so it is applied to NV12 sources only
+            if ((!convert) || privacy_mask) {
+                return -EINVAL;
+            }
+            break;
+        default:
+            return -EINVAL;
+    }
+
+    // The source image is not modified, so the mask is applied to a copy
+    std::optional<PlaneCopy> y_copy, uv_copy;
+    if (privacy_mask) {
+        y_copy.emplace(src.planes[0]);
+        uv_copy.emplace(src.planes[1]);
+        src.planes[0] = y_copy->view();
+        src.planes[1] = uv_copy->view();
+        int ret = apply_privacy_mask(args.privacy_mask, buffers, src);
+        if (ret < 0) {
+            return ret;
+        }
+    }
+
+    region_t crop = {args.crop_start_x, args.crop_start_y, args.crop_end_x, args.crop_end_y};
+    for (size_t i = 0; i < args.dst_count; ++i) {
+        image_view_t dst;
+        if (resolve_image(args.dst[i], buffers, dst) < 0) {
+            return -EINVAL;
+        }
+
+        int ret = convert ? crop_resize_convert_image(src, crop, dst, args.interpolation)
+                          : crop_and_resize_image(src, crop, dst, args.interpolation);
+        if (ret < 0) {
+            return ret;
+        }
+    }
+
+    return 0;
+}
+
+static int emulate_privacy_mask(const privacy_mask_op_in_data_t &args, const EmulatedBufferTable &buffers)
+{
+    image_view_t image;
+    if ((resolve_image(args.image, buffers, image) < 0) || (image.format != INTERFACE_IMAGE_FORMAT_NV12)) {
+        return -EINVAL;
+    }
+
+    return apply_privacy_mask(args.privacy_mask, buffers, image);
+}
+
+static int emulate_crop_resize_privacy_mask(const crop_resize_privacy_mask_in_data_t &args,
+                                            const EmulatedBufferTable &buffers)
+{
+    const auto &resize = args.resize;
+    image_view_t src, dst;
+    if ((resolve_image(resize.src, buffers, src) < 0) || (resolve_image(resize.dst, buffers, dst) < 0) ||
+        (src.format != INTERFACE_IMAGE_FORMAT_NV12)) {
+        return -EINVAL;
+    }
+
+    // The source image is not modified, so the mask is applied to a copy
+    PlaneCopy y_copy(src.planes[0]), uv_copy(src.planes[1]);
+    src.planes[0] = y_copy.view();
+    src.planes[1] = uv_copy.view();
+    int ret = apply_privacy_mask(args.privacy_mask, buffers, src);
+    if (ret < 0) {
+        return ret;
+    }
+
+    region_t crop = {resize.crop_start_x, resize.crop_start_y, resize.crop_end_x, resize.crop_end_y};
+    return crop_resize_convert_image(src, crop, dst, resize.interpolation);
+}
+
+/*
+ * Blend
+ */
+
+static uint8_t alpha_blend(uint8_t foreground, uint8_t background, uint32_t alpha)
+{
+    return static_cast<uint8_t>((alpha * foreground + (255 - alpha) * background + 127) / 255);
+}
+
+// Blends "region" of an A420 overlay into the background at the offsets. The region has even coordinates
+static void blend_overlay_region(const image_view_t &background,
+                                 const image_view_t &overlay,
+                                 const region_t &region,
+                                 size_t x_offset,
+                                 size_t y_offset)
+{
+    const auto &alpha = overlay.planes[3];
+    for (size_t y = 0; y < region.end_y - region.start_y; ++y) {
+        for (size_t x = 0; x < region.end_x - region.start_x; ++x) {
+            size_t src_x = region.start_x + x;
+            size_t src_y = region.start_y + y;
+            uint8_t *dst = pixel(background.planes[0], x_offset + x, y_offset + y);
+            *dst = alpha_blend(*pixel(overlay.planes[0], src_x, src_y), *dst, *pixel(alpha, src_x, src_y));
+        }
+    }
+
+    // Chroma is blended with the average alpha of the 2x2 pixels it covers
+    auto chroma = chroma_region(region);
+    for (size_t y = 0; y < chroma.end_y - chroma.start_y; ++y) {
+        for (size_t x = 0; x < chroma.end_x - chroma.start_x; ++x) {
+            size_t src_x = chroma.start_x + x;
+            size_t src_y = chroma.start_y + y;
+            uint32_t chroma_alpha =
+                (*pixel(alpha, 2 * src_x, 2 * src_y) + *pixel(alpha, 2 * src_x + 1, 2 * src_y) +
+                 *pixel(alpha, 2 * src_x, 2 * src_y + 1) + *pixel(alpha, 2 * src_x + 1, 2 * src_y + 1) + 2) /
+                4;
+            uint8_t *dst = pixel(background.planes[1], x_offset / 2 + x, y_offset / 2 + y);
+            dst[0] = alpha_blend(*pixel(overlay.planes[1], src_x, src_y), dst[0], chroma_alpha);
+            dst[1] = alpha_blend(*pixel(overlay.planes[2], src_x, src_y), dst[1], chroma_alpha);
+        }
+    }
+}
+
+static int emulate_blend(const blend_in_data_t &args, const EmulatedBufferTable &buffers)
+{
+    image_view_t background;
+    if ((resolve_image(args.background, buffers, background) < 0) ||
+        (background.format != INTERFACE_IMAGE_FORMAT_NV12) || (args.overlays_count > MAX_BLEND_OVERLAYS)) {
+        return -EINVAL;
+    }
+
+    // Overlays are blended in order, so later overlays are drawn on top of earlier ones
+    for (size_t i = 0; i < args.overlays_count; ++i) {
+        const auto &overlay_args = args.overlays[i];
+        image_view_t overlay;
+        if ((resolve_image(overlay_args.overlay, buffers, overlay) < 0) ||
+            (overlay.format != INTERFACE_IMAGE_FORMAT_A420) ||
+            (overlay_args.x_offset + overlay.width > background.width) ||
+            (overlay_args.y_offset + overlay.height > background.height)) {
+            return -EINVAL;
+        }
+
+        blend_overlay_region(background, overlay, {0, 0, overlay.width, overlay.height}, overlay_args.x_offset,
+                             overlay_args.y_offset);
+    }
+
+    return 0;
+}
+
+static int emulate_blend_atlas(const blend_atlas_in_data_t &args, const EmulatedBufferTable &buffers)
+{
+    image_view_t background;
+    image_view_t atlas;
+    plane_view_t entries;
+    if ((args.entries_count == 0) || (args.entries_count > MAX_BLEND_ATLAS_ENTRIES) ||
+        (args.entries.line_stride != sizeof(blend_atlas_entry_t)) ||
+        (resolve_plane(args.entries, buffers, sizeof(blend_atlas_entry_t), args.entries_count, 1, entries) < 0) ||
+        (resolve_image(args.background, buffers, background) < 0) ||
+        (background.format != INTERFACE_IMAGE_FORMAT_NV12) || (resolve_image(args.atlas, buffers, atlas) < 0) ||
+        (atlas.format != INTERFACE_IMAGE_FORMAT_A420)) {
+        return -EINVAL;
+    }
+
+    for (size_t i = 0; i < args.entries_count; ++i) {
+        auto entry = reinterpret_cast<const blend_atlas_entry_t *>(pixel(entries, 0, i));
+        region_t src = {entry->src.start_x, entry->src.start_y, entry->src.end_x, entry->src.end_y};
+        if ((src.start_x >= src.end_x) || (src.start_y >= src.end_y) || (src.end_x > atlas.width) ||
+            (src.end_y > atlas.height) || ((src.start_x | src.start_y | src.end_x | src.end_y) & 1) ||
+            (entry->x_offset + (src.end_x - src.start_x) > background.width) ||
+            (entry->y_offset + (src.end_y - src.start_y) > background.height)) {
+            return -EINVAL;
+        }
+
+        blend_overlay_region(background, atlas, src, entry->x_offset, entry->y_offset);
+    }
+
+    return 0;
+}
+
+/*
+ * Blur
+ */
+
+// Box filter of the region, reading from an unmodified copy of the plane. Pixels outside the plane are replicated
+// from its edges
+static void box_blur_region(const plane_view_t &plane, const region_t &region, size_t kernel_size)
+{
+    PlaneCopy copy(plane);
+    const auto &src = copy.view();
+    long radius = kernel_size / 2;
+    float normalization = 1.0f / (kernel_size * kernel_size);
+
+    for (size_t y = region.start_y; y < region.end_y; ++y) {
+        for (size_t x = region.start_x; x < region.end_x; ++x) {
+            for (size_t c = 0; c < plane.channels; ++c) {
+                uint32_t sum = 0;
+                for (long ky = -radius; ky <= radius; ++ky) {
+                    size_t sy = std::clamp<long>(y + ky, 0, plane.height - 1);
+                    for (long kx = -radius; kx <= radius; ++kx) {
+                        size_t sx = std::clamp<long>(x + kx, 0, plane.width - 1);
+                        sum += pixel(src, sx, sy)[c];
+                    }
+                }
+                pixel(plane, x, y)[c] = clamp_to_u8(sum * normalization);
+            }
+        }
+    }
+}
+
+static int emulate_blur(const blur_in_data_t &args, const EmulatedBufferTable &buffers)
+{
+    image_view_t image;
+    if ((resolve_image(args.image, buffers, image) < 0) || (args.rois_count > MAX_BLUR_ROIS) ||
+        (args.kernel_size % 2 == 0)) {
+        return -EINVAL;
+    }
+
+    if ((image.format != INTERFACE_IMAGE_FORMAT_GRAY8) && (image.format != INTERFACE_IMAGE_FORMAT_NV12)) {
+        return -EINVAL;
+    }
+
+    for (size_t i = 0; i < args.rois_count; ++i) {
+        region_t roi = {args.rois[i].start_x, args.rois[i].start_y, args.rois[i].end_x, args.rois[i].end_y};
+        if ((roi.start_x >= roi.end_x) || (roi.start_y >= roi.end_y) || (roi.end_x > image.width) ||
+            (roi.end_y > image.height)) {
+            return -EINVAL;
+        }
+
+        box_blur_region(image.planes[0], roi, args.kernel_size);
+        if (image.format == INTERFACE_IMAGE_FORMAT_NV12) {
+            // The chroma kernel covers the same area as the luma kernel, rounded to an odd size
+            box_blur_region(image.planes[1], chroma_region(roi), (args.kernel_size / 2) | 1);
+        }
+    }
+
+    return 0;
+}
+
+/*
+ * Format conversion (BT.601, limited range)
+ */
+
+static void rgb_to_yuv(const uint8_t *rgb, uint8_t &y, int &u, int &v)
+{
+    int r = rgb[0], g = rgb[1], b = rgb[2];
+    y = static_cast<uint8_t>(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+    u = ((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128;
+    v = ((112 * r - 94 * g - 18 * b + 128) >> 8) + 128;
+}
+
+static void yuv_to_rgb(int y, int u, int v, uint8_t *rgb)
+{
+    int c = y - 16, d = u - 128, e = v - 128;
+    rgb[0] = static_cast<uint8_t>(std::clamp((298 * c + 409 * e + 128) >> 8, 0, 255));
+    rgb[1] = static_cast<uint8_t>(std::clamp((298 * c - 100 * d - 208 * e + 128) >> 8, 0, 255));
+    rgb[2] = static_cast<uint8_t>(std::clamp((298 * c + 516 * d + 128) >> 8, 0, 255));
+}
+
+static void convert_rgb_to_nv12(const image_view_t &src, const image_view_t &dst)
+{
+    for (size_t y = 0; y < dst.height; y += 2) {
+        for (size_t x = 0; x < dst.width; x += 2) {
+            // Chroma is the average of the 2x2 pixels it covers
+            int u_sum = 0, v_sum = 0;
+            for (size_t dy = 0; dy < 2; ++dy) {
+                for (size_t dx = 0; dx < 2; ++dx) {
+                    int u, v;
+                    rgb_to_yuv(pixel(src.planes[0], x + dx, y + dy), *pixel(dst.planes[0], x + dx, y + dy), u, v);
+                    u_sum += u;
+                    v_sum += v;
+                }
+            }
+            uint8_t *uv = pixel(dst.planes[1], x / 2, y / 2);
+            uv[0] = static_cast<uint8_t>(std::clamp((u_sum + 2) / 4, 0, 255));
+            uv[1] = static_cast<uint8_t>(std::clamp((v_sum + 2) / 4, 0, 255));
+        }
+    }
+}
+
+static void convert_nv12_to_rgb(const image_view_t &src, const image_view_t &dst)
+{
+    for (size_t y = 0; y < dst.height; ++y) {
+        for (size_t x = 0; x < dst.width; ++x) {
+            const uint8_t *uv = pixel(src.planes[1], x / 2, y / 2);
+            yuv_to_rgb(*pixel(src.planes[0], x, y), uv[0], uv[1], pixel(dst.planes[0], x, y));
+        }
+    }
+}
+
+static int emulate_convert_format(const convert_format_in_data_t &args, const EmulatedBufferTable &buffers)
+{
+    image_view_t src, dst;
+    if ((resolve_image(args.src, buffers, src) < 0) || (resolve_image(args.dst, buffers, dst) < 0) ||
+        (src.width != dst.width) || (src.height != dst.height)) {
+        return -EINVAL;
+    }
+
+    if ((src.format == INTERFACE_IMAGE_FORMAT_RGB) && (dst.format == INTERFACE_IMAGE_FORMAT_NV12)) {
+        convert_rgb_to_nv12(src, dst);
+        return 0;
+    }
+    if ((src.format == INTERFACE_IMAGE_FORMAT_NV12) && (dst.format == INTERFACE_IMAGE_FORMAT_RGB)) {
+        convert_nv12_to_rgb(src, dst);
+        return 0;
+    }
+
+    return -EINVAL;
+}
+
+/*
+ * Crop&resize with format conversion
+ */
+
+// An image owned by the emulator, holding intermediate results
+class ScratchImage {
+   public:
+    ScratchImage(uint32_t format, size_t width, size_t height)
+    {
+        m_view = {.format = format, .width = width, .height = height, .planes = {}, .planes_count = 0};
+        switch (format) {
+            case INTERFACE_IMAGE_FORMAT_RGB:
+                add_plane(width, height, 3);
+                break;
+            case INTERFACE_IMAGE_FORMAT_NV12:
+                add_plane(width, height, 1);
+                add_plane((width + 1) / 2, (height + 1) / 2, 2);
+                break;
+            default:
+                break;
+        }
+    }
+
+    const image_view_t &view() const { return m_view; }
+
+   private:
+    void add_plane(size_t width, size_t height, size_t channels)
+    {
+        auto &data = m_data[m_view.planes_count];
+        data.resize(width * height * channels);
+        m_view.planes[m_view.planes_count++] = {
+            .data = data.data(),
+            .stride = width * channels,
+            .width = width,
+            .height = height,
+            .channels = channels,
+        };
+    }
+
+    std::vector<uint8_t> m_data[MAX_PLANES];
+    image_view_t m_view;
+};
+
+// The source is resampled in its own format and then converted, so the result is identical to a crop&resize
+// followed by a format conversion
+static int crop_resize_convert_image(const image_view_t &src,
+                                     const region_t &crop,
+                                     const image_view_t &dst,
+                                     uint8_t interpolation)
+{
+    if (src.format == dst.format) {
+        return crop_and_resize_image(src, crop, dst, interpolation);
+    }
+
+    bool nv12_to_rgb = (src.format == INTERFACE_IMAGE_FORMAT_NV12) && (dst.format == INTERFACE_IMAGE_FORMAT_RGB);
+    bool rgb_to_nv12 = (src.format == INTERFACE_IMAGE_FORMAT_RGB) && (dst.format == INTERFACE_IMAGE_FORMAT_NV12);
+    if (!nv12_to_rgb && !rgb_to_nv12) {
+        return -EINVAL;
+    }
+
+    ScratchImage resized(src.format, dst.width, dst.height);
+    int ret = crop_and_resize_image(src, crop, resized.view(), interpolation);
+    if (ret < 0) {
+        return ret;
+    }
+
+    if (nv12_to_rgb) {
+        convert_nv12_to_rgb(resized.view(), dst);
+    } else {
+        convert_rgb_to_nv12(resized.view(), dst);
+    }
+
+    return 0;
+}
+
+static int emulate_crop_resize_convert(const crop_resize_in_data_t &args, const EmulatedBufferTable &buffers)
+{
+    image_view_t src, dst;
+    if ((resolve_image(args.src, buffers, src) < 0) || (resolve_image(args.dst, buffers, dst) < 0)) {
+        return -EINVAL;
+    }
+
+    region_t crop = {args.crop_start_x, args.crop_start_y, args.crop_end_x, args.crop_end_y};
+    return crop_resize_convert_image(src, crop, dst, args.interpolation);
+}
+
+/*
+ * Crop&resize into a tensor
+ */
+
+// IEEE 754 single to half precision, rounding to nearest even
+static uint16_t float_to_half(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+    uint32_t float_exponent = (bits >> 23) & 0xff;
+    uint32_t mantissa = bits & 0x7fffff;
+
+    if (float_exponent == 0xff) {
+        return sign | 0x7c00 | (mantissa ? 0x200 : 0);
+    }
+
+    int32_t exponent = static_cast<int32_t>(float_exponent) - 127 + 15;
+    if (exponent >= 31) {
+        return sign | 0x7c00;
+    }
+
+    uint32_t shift = 13;
+    uint32_t half = (static_cast<uint32_t>(std::max(exponent, 0)) << 10);
+    if (exponent <= 0) {
+        // Subnormal, the implicit leading bit becomes explicit
+        if (exponent < -10) {
+            return sign;
+        }
+        mantissa |= 0x800000;
+        shift = 14 - exponent;
+    }
+
+    half |= mantissa >> shift;
+    uint32_t remainder = mantissa & ((1u << shift) - 1);
+    uint32_t halfway = 1u << (shift - 1);
+    if ((remainder > halfway) || ((remainder == halfway) && (half & 1))) {
+        // A carry into the exponent is the correctly rounded result
+        half++;
+    }
+
+    return sign | static_cast<uint16_t>(half);
+}
+
+// Plane view of the tensor data, "count" tensors of a batch that are "stride" bytes apart
+static int resolve_tensor(const tensor_in_data_t &tensor,
+                          const EmulatedBufferTable &buffers,
+                          size_t count,
+                          size_t stride,
+                          plane_view_t &view)
+{
+    bool nhwc = (tensor.layout == INTERFACE_TENSOR_LAYOUT_NHWC);
+    size_t element_size = (tensor.data_type == INTERFACE_TENSOR_DATA_TYPE_FLOAT16) ? 2 : 1;
+    if ((tensor.layout > INTERFACE_TENSOR_LAYOUT_NCHW) || (tensor.data_type > INTERFACE_TENSOR_DATA_TYPE_FLOAT16) ||
+        (tensor.width == 0) || (tensor.height == 0)) {
+        return -EINVAL;
+    }
+
+    size_t row_size = tensor.width * element_size * (nhwc ? 3 : 1);
+    size_t rows_count = tensor.height * (nhwc ? 1 : 3);
+    int ret = resolve_plane(tensor.data, buffers, row_size, rows_count, 1, view);
+    if ((ret < 0) || (stride * (count - 1) + view.stride * (rows_count - 1) + row_size > tensor.data.plane_size)) {
+        return -EINVAL;
+    }
+
+    return 0;
+}
+
+static int crop_resize_tensor(const image_view_t &src,
+                              const region_t &crop,
+                              const tensor_in_data_t &tensor,
+                              const plane_view_t &data,
+                              uint8_t interpolation)
+{
+    bool nhwc = (tensor.layout == INTERFACE_TENSOR_LAYOUT_NHWC);
+    size_t element_size = (tensor.data_type == INTERFACE_TENSOR_DATA_TYPE_FLOAT16) ? 2 : 1;
+
+    ScratchImage rgb(INTERFACE_IMAGE_FORMAT_RGB, tensor.width, tensor.height);
+    int ret = crop_resize_convert_image(src, crop, rgb.view(), interpolation);
+    if (ret < 0) {
+        return ret;
+    }
+
+    for (size_t y = 0; y < tensor.height; ++y) {
+        for (size_t x = 0; x < tensor.width; ++x) {
+            const uint8_t *rgb_pixel = pixel(rgb.view().planes[0], x, y);
+            for (size_t c = 0; c < 3; ++c) {
+                float value = rgb_pixel[tensor.bgr ? 2 - c : c] * tensor.gain[c] + tensor.offset[c];
+                uint8_t *element = nhwc ? pixel(data, (x * 3 + c) * element_size, y)
+                                        : pixel(data, x * element_size, c * tensor.height + y);
+
+                switch (tensor.data_type) {
+                    case INTERFACE_TENSOR_DATA_TYPE_UINT8:
+                        *element = clamp_to_u8(value);
+                        break;
+                    case INTERFACE_TENSOR_DATA_TYPE_INT8:
+                        *reinterpret_cast<int8_t *>(element) =
+                            static_cast<int8_t>(std::clamp(std::lround(value), -128L, 127L));
+                        break;
+                    default: {
+                        uint16_t half = float_to_half(value);
+                        memcpy(element, &half, sizeof(half));
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+
+static int emulate_crop_resize_tensor(const crop_resize_tensor_in_data_t &args, const EmulatedBufferTable &buffers)
+{
+    image_view_t src;
+    plane_view_t data;
+    if ((resolve_image(args.src, buffers, src) < 0) || (resolve_tensor(args.dst, buffers, 1, 0, data) < 0)) {
+        return -EINVAL;
+    }
+
+    region_t crop = {args.crop_start_x, args.crop_start_y, args.crop_end_x, args.crop_end_y};
+    return crop_resize_tensor(src, crop, args.dst, data, args.interpolation);
+}
+
+static int emulate_batch_crop_resize(const batch_crop_resize_in_data_t &args, const EmulatedBufferTable &buffers)
+{
+    image_view_t src;
+    plane_view_t entries;
+    if ((args.entries_count == 0) || (args.entries_count > MAX_BATCH_CROP_RESIZE_ENTRIES) ||
+        (args.entries.line_stride != sizeof(batch_crop_resize_entry_t)) ||
+        (resolve_plane(args.entries, buffers, sizeof(batch_crop_resize_entry_t), args.entries_count, 1, entries) < 0) ||
+        (resolve_image(args.src, buffers, src) < 0)) {
+        return -EINVAL;
+    }
+
+    plane_view_t tensor_data;
+    if (args.tensor_output &&
+        (resolve_tensor(args.dst_tensor, buffers, args.entries_count, args.tensor_stride, tensor_data) < 0)) {
+        return -EINVAL;
+    }
+
+    for (size_t i = 0; i < args.entries_count; ++i) {
+        auto entry = reinterpret_cast<const batch_crop_resize_entry_t *>(pixel(entries, 0, i));
+        region_t crop = {entry->crop.start_x, entry->crop.start_y, entry->crop.end_x, entry->crop.end_y};
+
+        int ret;
+        if (args.tensor_output) {
+            plane_view_t item = tensor_data;
+            item.data += i * args.tensor_stride;
+            ret = crop_resize_tensor(src, crop, args.dst_tensor, item, args.interpolation);
+        } else {
+            image_view_t dst;
+            ret = resolve_image(entry->dst, buffers, dst);
+            if (ret == 0) {
+                ret = crop_resize_convert_image(src, crop, dst, args.interpolation);
+            }
+        }
+
+        if (ret < 0) {
+            return ret;
+        }
+    }
+
+    return 0;
+}
+
+/*
+ * Dewarp
+ */
+
+static float sample_bilinear(const plane_view_t &plane, size_t channel, float x, float y)
+{
+    x = std::clamp(x, 0.0f, static_cast<float>(plane.width - 1));
+    y = std::clamp(y, 0.0f, static_cast<float>(plane.height - 1));
+    size_t x0 = static_cast<size_t>(x), y0 = static_cast<size_t>(y);
+    size_t x1 = std::min(x0 + 1, plane.width - 1), y1 = std::min(y0 + 1, plane.height - 1);
+    float fx = x - x0, fy = y - y0;
+
+    float top = pixel(plane, x0, y0)[channel] * (1 - fx) + pixel(plane, x1, y0)[channel] * fx;
+    float bottom = pixel(plane, x0, y1)[channel] * (1 - fx) + pixel(plane, x1, y1)[channel] * fx;
+    return top * (1 - fy) + bottom * fy;
+}
+
+static float sample_bicubic(const plane_view_t &plane, size_t channel, float x, float y)
+{
+    auto weight = [](float t) {
+        const float a = -0.75f;
+        t = std::fabs(t);
+        if (t <= 1.0f) {
+            return ((a + 2) * t - (a + 3)) * t * t + 1;
+        }
+        if (t < 2.0f) {
+            return ((a * t - 5 * a) * t + 8 * a) * t - 4 * a;
+        }
+        return 0.0f;
+    };
+
+    long x0 = static_cast<long>(std::floor(x)), y0 = static_cast<long>(std::floor(y));
+    float value = 0.0f;
+    for (long j = -1; j <= 2; ++j) {
+        size_t sy = std::clamp<long>(y0 + j, 0, plane.height - 1);
+        float wy = weight(y - (y0 + j));
+        for (long i = -1; i <= 2; ++i) {
+            size_t sx = std::clamp<long>(x0 + i, 0, plane.width - 1);
+            value += wy * weight(x - (x0 + i)) * pixel(plane, sx, sy)[channel];
+        }
+    }
+    return value;
+}
+
+static int emulate_dewarp(const dewarp_in_data_t &args, const EmulatedBufferTable &buffers)
+{
+    image_view_t src, dst;
+    plane_view_t mesh;
+    if ((resolve_image(args.src, buffers, src) < 0) || (resolve_image(args.dst, buffers, dst) < 0) ||
+        (src.format != INTERFACE_IMAGE_FORMAT_NV12) || (dst.format != INTERFACE_IMAGE_FORMAT_NV12) ||
+        (args.mesh_width == 0) || (args.mesh_height == 0) ||
+        (resolve_plane(args.mesh, buffers, args.mesh_width, args.mesh_height, 2 * sizeof(int32_t), mesh) < 0)) {
+        return -EINVAL;
+    }
+
+    // Source coordinates of a destination pixel, bilinearly interpolated between the mesh vertices.
+    // Vertices are (x, y) pairs in Q15.16, placed every MESH_SQ_SIZE destination pixels
+    auto source_coordinates = [&](float x, float y, float &src_x, float &src_y) {
+        float gx = std::min(x / MESH_SQ_SIZE, static_cast<float>(args.mesh_width - 1));
+        float gy = std::min(y / MESH_SQ_SIZE, static_cast<float>(args.mesh_height - 1));
+        size_t x0 = static_cast<size_t>(gx), y0 = static_cast<size_t>(gy);
+        size_t x1 = std::min<size_t>(x0 + 1, args.mesh_width - 1), y1 = std::min<size_t>(y0 + 1, args.mesh_height - 1);
+        float fx = gx - x0, fy = gy - y0;
+
+        auto vertex = [&](size_t vx, size_t vy, size_t coordinate) {
+            int32_t value;
+            memcpy(&value, pixel(mesh, vx, vy) + coordinate * sizeof(int32_t), sizeof(value));
+            return value / 65536.0f;
+        };
+        for (size_t coordinate = 0; coordinate < 2; ++coordinate) {
+            float top = vertex(x0, y0, coordinate) * (1 - fx) + vertex(x1, y0, coordinate) * fx;
+            float bottom = vertex(x0, y1, coordinate) * (1 - fx) + vertex(x1, y1, coordinate) * fx;
+            (coordinate == 0 ? src_x : src_y) = top * (1 - fy) + bottom * fy;
+        }
+    };
+
+    auto sample = args.interpolation == INTERPOLATION_TYPE_BICUBIC ? sample_bicubic : sample_bilinear;
+
+    for (size_t y = 0; y < dst.height; ++y) {
+        for (size_t x = 0; x < dst.width; ++x) {
+            float src_x, src_y;
+            source_coordinates(x, y, src_x, src_y);
+            *pixel(dst.planes[0], x, y) = clamp_to_u8(sample(src.planes[0], 0, src_x, src_y));
+        }
+    }
+
+    for (size_t y = 0; y < dst.planes[1].height; ++y) {
+        for (size_t x = 0; x < dst.planes[1].width; ++x) {
+            float src_x, src_y;
+            source_coordinates(2 * x + 0.5f, 2 * y + 0.5f, src_x, src_y);
+            for (size_t c = 0; c < 2; ++c) {
+                pixel(dst.planes[1], x, y)[c] =
+                    clamp_to_u8(sample(src.planes[1], c, (src_x - 0.5f) / 2, (src_y - 0.5f) / 2));
+            }
+        }
+    }
+
+    return 0;
+}
+
+/*
+ * Blur modes
+ */
+
+// Normalized Gaussian weights, with the sigma that OpenCV derives from the kernel size
+static std::vector<float> gaussian_weights(size_t kernel_size)
+{
+    float sigma = 0.3f * ((kernel_size - 1) * 0.5f - 1) + 0.8f;
+    long radius = kernel_size / 2;
+    std::vector<float> weights(kernel_size);
+    float sum = 0.0f;
+    for (long i = -radius; i <= radius; ++i) {
+        weights[i + radius] = std::exp(-(i * i) / (2 * sigma * sigma));
+        sum += weights[i + radius];
+    }
+    for (auto &weight : weights) {
+        weight /= sum;
+    }
+    return weights;
+}
+
+// Separable Gaussian filter of the region. Pixels outside the plane are replicated from its edges
+static void gaussian_blur_region(const plane_view_t &plane, const region_t &region, size_t kernel_size)
+{
+    auto weights = gaussian_weights(kernel_size);
+    long radius = kernel_size / 2;
+    size_t width = region.end_x - region.start_x;
+    size_t rows_count = region.end_y - region.start_y + 2 * radius;
+
+    // Horizontal pass over all the lines that the vertical pass reads, so the plane is read before it is written
+    std::vector<float> rows(rows_count * width * plane.channels);
+    for (size_t row = 0; row < rows_count; ++row) {
+        size_t sy = std::clamp<long>(region.start_y + row - radius, 0, plane.height - 1);
+        for (size_t x = 0; x < width; ++x) {
+            for (size_t c = 0; c < plane.channels; ++c) {
+                float sum = 0.0f;
+                for (long kx = -radius; kx <= radius; ++kx) {
+                    size_t sx = std::clamp<long>(region.start_x + x + kx, 0, plane.width - 1);
+                    sum += weights[kx + radius] * pixel(plane, sx, sy)[c];
+                }
+                rows[(row * width + x) * plane.channels + c] = sum;
+            }
+        }
+    }
+
+    for (size_t y = 0; y < region.end_y - region.start_y; ++y) {
+        for (size_t x = 0; x < width; ++x) {
+            for (size_t c = 0; c < plane.channels; ++c) {
+                float sum = 0.0f;
+                for (size_t k = 0; k < kernel_size; ++k) {
+                    sum += weights[k] * rows[((y + k) * width + x) * plane.channels + c];
+                }
+                pixel(plane, region.start_x + x, region.start_y + y)[c] = clamp_to_u8(sum);
+            }
+        }
+    }
+}
+
+// Fills every block of the region with its rounded mean. "region" and "block_size" are in luma pixels. Blocks are
+// aligned to the region start, and the last blocks of a line or a column are cut at the region end. A plane
+// subsampled by "subsampling" fills, for every luma block, the pixels from start / subsampling to
+// ceil(end / subsampling), so that its tiles line up with the luma tiles. Means are taken from the original pixels,
+// since such tiles may share their edge pixels
+static void pixelate_region(const plane_view_t &plane, const region_t &region, size_t block_size, size_t subsampling)
+{
+    size_t start_x = region.start_x / subsampling;
+    size_t start_y = region.start_y / subsampling;
+    size_t end_x = (region.end_x + subsampling - 1) / subsampling;
+    size_t end_y = (region.end_y + subsampling - 1) / subsampling;
+    size_t line_size = (end_x - start_x) * plane.channels;
+    std::vector<uint8_t> original((end_y - start_y) * line_size);
+    for (size_t y = start_y; y < end_y; ++y) {
+        memcpy(&original[(y - start_y) * line_size], pixel(plane, start_x, y), line_size);
+    }
+
+    for (size_t luma_y = region.start_y; luma_y < region.end_y; luma_y += block_size) {
+        size_t block_start_y = luma_y / subsampling;
+        size_t block_end_y = (std::min(luma_y + block_size, region.end_y) + subsampling - 1) / subsampling;
+        for (size_t luma_x = region.start_x; luma_x < region.end_x; luma_x += block_size) {
+            size_t block_start_x = luma_x / subsampling;
+            size_t block_end_x = (std::min(luma_x + block_size, region.end_x) + subsampling - 1) / subsampling;
+            size_t count = (block_end_x - block_start_x) * (block_end_y - block_start_y);
+            for (size_t c = 0; c < plane.channels; ++c) {
+                uint32_t sum = 0;
+                for (size_t y = block_start_y; y < block_end_y; ++y) {
+                    for (size_t x = block_start_x; x < block_end_x; ++x) {
+                        sum += original[(y - start_y) * line_size + (x - start_x) * plane.channels + c];
+                    }
+                }
+                auto mean = static_cast<uint8_t>((sum + count / 2) / count);
+                for (size_t y = block_start_y; y < block_end_y; ++y) {
+                    for (size_t x = block_start_x; x < block_end_x; ++x) {
+                        pixel(plane, x, y)[c] = mean;
+                    }
+                }
+            }
+        }
+    }
+}
+
+static void filter_region(const plane_view_t &plane, const region_t &region, uint8_t mode, size_t kernel_size)
+{
+    if (mode == DSP_BLUR_MODE_GAUSSIAN) {
+        gaussian_blur_region(plane, region, kernel_size);
+    } else {
+        box_blur_region(plane, region, kernel_size);
+    }
+}
+
+// Blurs the region at 1/factor of its resolution, for an effective kernel of kernel_size * factor. The region is
+// downscaled with its surroundings (area average), so that its edges are blurred with the pixels around it, and it is
+// upscaled back bilinearly
+static void downscaled_blur_region(const plane_view_t &plane,
+                                   const region_t &region,
+                                   uint8_t mode,
+                                   size_t kernel_size,
+                                   size_t factor)
+{
+    size_t margin = kernel_size / 2 * factor;
+    region_t work = {
+        .start_x = region.start_x - std::min(region.start_x, margin),
+        .start_y = region.start_y - std::min(region.start_y, margin),
+        .end_x = std::min(region.end_x + margin, plane.width),
+        .end_y = std::min(region.end_y + margin, plane.height),
+    };
+
+    size_t small_width = (work.end_x - work.start_x + factor - 1) / factor;
+    size_t small_height = (work.end_y - work.start_y + factor - 1) / factor;
+    std::vector<uint8_t> small_data(small_width * small_height * plane.channels);
+    plane_view_t small = {
+        .data = small_data.data(),
+        .stride = small_width * plane.channels,
+        .width = small_width,
+        .height = small_height,
+        .channels = plane.channels,
+    };
+
+    for (size_t y = 0; y < small_height; ++y) {
+        size_t start_y = work.start_y + y * factor;
+        size_t end_y = std::min(start_y + factor, work.end_y);
+        for (size_t x = 0; x < small_width; ++x) {
+            size_t start_x = work.start_x + x * factor;
+            size_t end_x = std::min(start_x + factor, work.end_x);
+            size_t count = (end_x - start_x) * (end_y - start_y);
+            for (size_t c = 0; c < plane.channels; ++c) {
+                uint32_t sum = 0;
+                for (size_t sy = start_y; sy < end_y; ++sy) {
+                    for (size_t sx = start_x; sx < end_x; ++sx) {
+                        sum += pixel(plane, sx, sy)[c];
+                    }
+                }
+                pixel(small, x, y)[c] = static_cast<uint8_t>((sum + count / 2) / count);
+            }
+        }
+    }
+
+    filter_region(small, {0, 0, small_width, small_height}, mode, kernel_size);
+
+    for (size_t y = region.start_y; y < region.end_y; ++y) {
+        float small_y = (y - work.start_y + 0.5f) / factor - 0.5f;
+        for (size_t x = region.start_x; x < region.end_x; ++x) {
+            float small_x = (x - work.start_x + 0.5f) / factor - 0.5f;
+            for (size_t c = 0; c < plane.channels; ++c) {
+                pixel(plane, x, y)[c] = clamp_to_u8(sample_bilinear(small, c, small_x, small_y));
+            }
+        }
+    }
+}
+
+static void blur_roi_plane(const plane_view_t &plane,
+                           const region_t &region,
+                           uint8_t mode,
+                           size_t kernel_size,
+                           size_t downscale)
+{
+    if (downscale > 1) {
+        downscaled_blur_region(plane, region, mode, kernel_size, downscale);
+    } else {
+        filter_region(plane, region, mode, kernel_size);
+    }
+}
+
+static bool is_valid_blur_roi(const blur_roi_in_data_t &roi)
+{
+    if (roi.mode == DSP_BLUR_MODE_PIXELATE) {
+        return (roi.kernel_size >= 1) && (roi.kernel_size <= DSP_BLUR_MAX_PIXELATE_BLOCK) && (roi.downscale == 1);
+    }
+
+    return (roi.mode < DSP_BLUR_MODE_COUNT) && (roi.kernel_size % 2 == 1) && (roi.downscale >= 1) &&
+           (roi.downscale <= DSP_BLUR_MAX_DOWNSCALE) && ((roi.downscale & (roi.downscale - 1)) == 0);
+}
+
+static int emulate_blur_rois(const blur_rois_in_data_t &args, const EmulatedBufferTable &buffers)
+{
+    image_view_t image;
+    if ((resolve_image(args.image, buffers, image) < 0) || (args.rois_count > MAX_BLUR_ROIS)) {
+        return -EINVAL;
+    }
+
+    if ((image.format != INTERFACE_IMAGE_FORMAT_GRAY8) && (image.format != INTERFACE_IMAGE_FORMAT_NV12)) {
+        return -EINVAL;
+    }
+
+    // ROIs are blurred in order, so overlapping ROIs blur the result of earlier ones
+    for (size_t i = 0; i < args.rois_count; ++i) {
+        const auto &roi_args = args.rois[i];
+        region_t roi = {roi_args.roi.start_x, roi_args.roi.start_y, roi_args.roi.end_x, roi_args.roi.end_y};
+        if ((roi.start_x >= roi.end_x) || (roi.start_y >= roi.end_y) || (roi.end_x > image.width) ||
+            (roi.end_y > image.height) || (!is_valid_blur_roi(roi_args))) {
+            return -EINVAL;
+        }
+
+        if (roi_args.mode == DSP_BLUR_MODE_PIXELATE) {
+            // The chroma tiles are derived from the luma tiles, so that colors don't cross the tile edges
+            pixelate_region(image.planes[0], roi, roi_args.kernel_size, 1);
+            if (image.format == INTERFACE_IMAGE_FORMAT_NV12) {
+                pixelate_region(image.planes[1], roi, roi_args.kernel_size, 2);
+            }
+        } else {
+            blur_roi_plane(image.planes[0], roi, roi_args.mode, roi_args.kernel_size, roi_args.downscale);
+            if (image.format == INTERFACE_IMAGE_FORMAT_NV12) {
+                // The chroma kernel covers the same area as the luma kernel, rounded to an odd size
+                blur_roi_plane(image.planes[1], chroma_region(roi), roi_args.mode, (roi_args.kernel_size / 2) | 1,
+                               roi_args.downscale);
+            }
+        }
+    }
+
+    return 0;
+}
+
+/*
+ * Requests
+ */
+
+static int emulate_batch(const batch_in_data_t &args, const EmulatedBufferTable &buffers)
+{
+    plane_view_t requests;
+    if ((args.requests_count == 0) || (args.requests.line_stride != sizeof(imaging_request_t)) ||
+        (resolve_plane(args.requests, buffers, sizeof(imaging_request_t), args.requests_count, 1, requests) < 0)) {
+        return -EINVAL;
+    }
+
+    for (size_t i = 0; i < args.requests_count; ++i) {
+        auto request = reinterpret_cast<const imaging_request_t *>(pixel(requests, 0, i));
+        if (request->operation == IMAGING_OP_BATCH) {
+            return -EINVAL;
+        }
+
+        int ret = emulate_imaging_request(request, buffers);
+        if (ret < 0) {
+            return ret;
+        }
+    }
+
+    return 0;
+}
+
+int emulate_imaging_request(const imaging_request_t *request, const EmulatedBufferTable &buffers)
+{
+    switch (request->operation) {
+        case IMAGING_OP_CROP_AND_RESIZE:
+            return emulate_crop_and_resize(request->crop_and_resize_args, buffers);
+        case IMAGING_OP_BLEND:
+            return emulate_blend(request->blend_args, buffers);
+        case IMAGING_OP_BLUR:
+            return emulate_blur(request->blur_args, buffers);
+        case IMAGING_OP_CONVERT_FORMAT:
+            return emulate_convert_format(request->convert_format_args, buffers);
+        case IMAGING_OP_DEWARP:
+            return emulate_dewarp(request->dewarp_args, buffers);
+        case IMAGING_OP_MULTI_CROP_AND_RESIZE:
+            return emulate_multi_crop_and_resize(request->multi_crop_and_resize_args, buffers, false, false);
+        case IMAGING_OP_MULTI_CROP_AND_RESIZE_PRIVACY_MASK:
+            return emulate_multi_crop_and_resize(request->multi_crop_and_resize_args, buffers, true, false);
+        case IMAGING_OP_BATCH:
+            return emulate_batch(request->batch_args, buffers);
+        case IMAGING_OP_CROP_RESIZE_CONVERT:
+            return emulate_crop_resize_convert(request->crop_and_resize_args, buffers);
+        case IMAGING_OP_MULTI_CROP_RESIZE_CONVERT: {
+            const auto &args = request->multi_crop_and_resize_args;
+            return emulate_multi_crop_and_resize(args, buffers, args.privacy_mask.rois_count != 0, true);
+        }
+        case IMAGING_OP_CROP_RESIZE_TENSOR:
+            return emulate_crop_resize_tensor(request->crop_resize_tensor_args, buffers);
+        case IMAGING_OP_BATCH_CROP_RESIZE:
+            return emulate_batch_crop_resize(request->batch_crop_resize_args, buffers);
+        case IMAGING_OP_PRIVACY_MASK:
+            return emulate_privacy_mask(request->privacy_mask_args, buffers);
+        case IMAGING_OP_CROP_RESIZE_PRIVACY_MASK:
+            return emulate_crop_resize_privacy_mask(request->crop_resize_privacy_mask_args, buffers);
+        case IMAGING_OP_BLEND_ATLAS:
+            return emulate_blend_atlas(request->blend_atlas_args, buffers);
+        case IMAGING_OP_BLUR_ROIS:
+            return emulate_blur_rois(request->blur_rois_args, buffers);
+        default:
+            return -EINVAL;
+    }
+}
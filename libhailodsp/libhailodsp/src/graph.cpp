@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2017-2024 Hailo Technologies Ltd. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "cmdbuf.hpp"
+#include "hailo/hailodsp.h"
+#include "image_utils.hpp"
+#include "logger_macros.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+// An intermediate image, allocated as a single buffer holding all of its planes
+typedef struct {
+    dsp_image_properties_t properties;
+    dsp_data_plane_t planes[MAX_PLANES];
+    void *buffer;
+    size_t size;
+} graph_image_t;
+
+struct _dsp_graph {
+    dsp_device device;
+    dsp_cmdbuf cmdbuf;
+    // Handed out to the user, so their addresses must be stable
+    std::vector<std::unique_ptr<graph_image_t>> images;
+    // Number of recorded requests when the graph was compiled, or 0 if it was not compiled
+    size_t compiled_requests_count;
+};
+
+static void release_graph_image(dsp_device device, graph_image_t &image)
+{
+    (void)dsp_unregister_buffer(device, image.buffer);
+    (void)dsp_release_buffer(device, image.buffer);
+}
+
+static const graph_image_t *find_graph_image(dsp_graph graph, const dsp_image_properties_t *image)
+{
+    for (const auto &graph_image : graph->images) {
+        if (&graph_image->properties == image) {
+            return graph_image.get();
+        }
+    }
+    return nullptr;
+}
+
+dsp_status dsp_create_graph(dsp_device device, dsp_graph *graph)
+{
+    if ((!device) || (!graph)) {
+        LOGGER__ERROR("Error: NULL argument (device={}, graph={})\n", fmt::ptr(device), fmt::ptr(graph));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    auto local_graph = new (std::nothrow) _dsp_graph{
+        .device = device,
+        .cmdbuf = nullptr,
+        .images = {},
+        .compiled_requests_count = 0,
+    };
+    if (!local_graph) {
+        LOGGER__ERROR("Failed to allocate memory for graph");
+        return DSP_OUT_OF_HOST_MEMORY;
+    }
+
+    auto status = dsp_create_cmdbuf(device, &local_graph->cmdbuf);
+    if (status != DSP_SUCCESS) {
+        delete local_graph;
+        return status;
+    }
+
+    *graph = local_graph;
+    return DSP_SUCCESS;
+}
+
+dsp_status dsp_release_graph(dsp_graph graph)
+{
+    if (!graph) {
+        LOGGER__ERROR("Error: graph is NULL\n");
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    (void)dsp_release_cmdbuf(graph->cmdbuf);
+    for (auto &image : graph->images) {
+        release_graph_image(graph->device, *image);
+    }
+
+    delete graph;
+    return DSP_SUCCESS;
+}
+
+dsp_status dsp_graph_create_image(dsp_graph graph,
+                                  size_t width,
+                                  size_t height,
+                                  dsp_image_format_t format,
+                                  dsp_image_properties_t **image)
+{
+    if ((!graph) || (!image)) {
+        LOGGER__ERROR("Error: NULL argument (graph={}, image={})\n", fmt::ptr(graph), fmt::ptr(image));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    auto local_image = std::unique_ptr<graph_image_t>(new (std::nothrow) graph_image_t{});
+    if (!local_image) {
+        LOGGER__ERROR("Failed to allocate memory for graph image");
+        return DSP_OUT_OF_HOST_MEMORY;
+    }
+
+    local_image->properties = {
+        .width = width,
+        .height = height,
+        .planes = local_image->planes,
+        .planes_count = 0,
+        .format = format,
+        .memory = DSP_MEMORY_TYPE_USERPTR,
+    };
+
+    auto status = get_packed_image_layout(format, width, height, local_image->planes,
+                                          local_image->properties.planes_count);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    for (size_t i = 0; i < local_image->properties.planes_count; i++) {
+        local_image->size += local_image->planes[i].bytesused;
+    }
+
+    status = dsp_create_buffer(graph->device, local_image->size, &local_image->buffer);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    // Pinned once, so the driver does not map the image again on every execution
+    status = dsp_register_buffer(graph->device, local_image->buffer, local_image->size);
+    if (status != DSP_SUCCESS) {
+        (void)dsp_release_buffer(graph->device, local_image->buffer);
+        return status;
+    }
+
+    auto data = static_cast<uint8_t *>(local_image->buffer);
+    for (size_t i = 0; i < local_image->properties.planes_count; i++) {
+        local_image->planes[i].userptr = data;
+        data += local_image->planes[i].bytesused;
+    }
+
+    status = verify_image_properties(&local_image->properties);
+    if (status != DSP_SUCCESS) {
+        release_graph_image(graph->device, *local_image);
+        return status;
+    }
+
+    *image = &local_image->properties;
+    graph->images.push_back(std::move(local_image));
+    return DSP_SUCCESS;
+}
+
+dsp_status dsp_graph_get_cmdbuf(dsp_graph graph, dsp_cmdbuf *cmdbuf)
+{
+    if ((!graph) || (!cmdbuf)) {
+        LOGGER__ERROR("Error: NULL argument (graph={}, cmdbuf={})\n", fmt::ptr(graph), fmt::ptr(cmdbuf));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    *cmdbuf = graph->cmdbuf;
+    return DSP_SUCCESS;
+}
+
+dsp_status dsp_graph_compile(dsp_graph graph)
+{
+    if (!graph) {
+        LOGGER__ERROR("Error: graph is NULL\n");
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    auto cmdbuf = graph->cmdbuf;
+    graph->compiled_requests_count = 0;
+    if (cmdbuf->requests_count == 0) {
+        LOGGER__ERROR("Error: Graph has no nodes\n");
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    // Buffer list entries are added in recording order, so the first entry of an image belongs to the first node
+    // that accesses it
+    auto buffers = cmdbuf->buffer_list.get_buffers();
+    for (const auto &binding : cmdbuf->bindings) {
+        auto graph_image = find_graph_image(graph, binding.recorded_image);
+        if ((!graph_image) || binding.buffer_refs.empty()) {
+            continue;
+        }
+
+        auto first_ref = std::min_element(binding.buffer_refs.begin(), binding.buffer_refs.end(),
+                                           [](const auto &a, const auto &b) { return a.second < b.second; });
+        if (buffers[first_ref->second].flags != static_cast<__u32>(BufferAccessType::Write)) {
+            LOGGER__ERROR("Error: Intermediate image {} is read before it is written. Nodes must be recorded in "
+                          "dependency order\n",
+                          fmt::ptr(binding.recorded_image));
+            return DSP_INVALID_ARGUMENT;
+        }
+    }
+
+    for (const auto &image : graph->images) {
+        auto recorded = std::any_of(cmdbuf->bindings.begin(), cmdbuf->bindings.end(), [&image](const auto &binding) {
+            return binding.recorded_image == &image->properties;
+        });
+        if (!recorded) {
+            LOGGER__WARN("Intermediate image {} is not used by any node", fmt::ptr(&image->properties));
+        }
+    }
+
+    graph->compiled_requests_count = cmdbuf->requests_count;
+    return DSP_SUCCESS;
+}
+
+dsp_status dsp_graph_bind_image(dsp_graph graph,
+                                const dsp_image_properties_t *recorded_image,
+                                const dsp_image_properties_t *image)
+{
+    if (!graph) {
+        LOGGER__ERROR("Error: graph is NULL\n");
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    if (find_graph_image(graph, recorded_image)) {
+        LOGGER__ERROR("Error: Intermediate image {} can't be re-bound\n", fmt::ptr(recorded_image));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    return dsp_cmdbuf_bind_image(graph->cmdbuf, recorded_image, image);
+}
+
+dsp_status dsp_graph_execute(dsp_graph graph)
+{
+    if (!graph) {
+        LOGGER__ERROR("Error: graph is NULL\n");
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    if ((graph->compiled_requests_count == 0) ||
+        (graph->compiled_requests_count != graph->cmdbuf->requests_count)) {
+        LOGGER__ERROR("Error: Graph was modified or not compiled. Call dsp_graph_compile before executing it\n");
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    return dsp_cmdbuf_submit(graph->cmdbuf);
+}
@@ -22,41 +22,140 @@
  */
 
 #include "fcntl.h"
+#include "emulated_driver.hpp"
 #include "hailodsp_driver.hpp"
 #include "logger_macros.hpp"
 #include "xrp_types.h"
 
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
 #include <sys/ioctl.h>
 #include <unistd.h>
 
 #include "xrp_kernel_defs.h"
 
-dsp_status driver_open_device(int &fd)
+#define DRIVER_TYPE_ENV_NAME ("HAILODSP_DRIVER")
+#define EMULATOR_DEVICES_ENV_NAME ("HAILODSP_EMULATOR_DEVICES")
+#define KERNEL_DEVICE_PATH_PREFIX ("/dev/xvp")
+
+class KernelDriver : public Driver {
+   public:
+    explicit KernelDriver(int fd) : m_fd(fd) {}
+    ~KernelDriver() override { close(m_fd); }
+
+    int ioctl(unsigned long request, void *arg) override { return ::ioctl(m_fd, request, arg); }
+
+   private:
+    int m_fd;
+};
+
+static dsp_driver_type_t get_default_driver_type()
 {
-    const char *device_path = "/dev/xvp0";
-    fd = open(device_path, O_RDWR);
+    const char *driver_type = std::getenv(DRIVER_TYPE_ENV_NAME);
+    if ((driver_type == nullptr) || (strcmp(driver_type, "kernel") == 0)) {
+        return DSP_DRIVER_TYPE_KERNEL;
+    }
+    if (strcmp(driver_type, "emulator") == 0) {
+        return DSP_DRIVER_TYPE_EMULATOR;
+    }
+
+    LOGGER__WARN("Unknown {} value \"{}\", using the kernel driver", DRIVER_TYPE_ENV_NAME, driver_type);
+    return DSP_DRIVER_TYPE_KERNEL;
+}
+
+static size_t get_emulator_devices_count()
+{
+    const char *devices = std::getenv(EMULATOR_DEVICES_ENV_NAME);
+    if (devices == nullptr) {
+        return 1;
+    }
+
+    char *end = nullptr;
+    unsigned long count = strtoul(devices, &end, 10);
+    if ((*end != '\0') || (count == 0)) {
+        LOGGER__WARN("Invalid {} value \"{}\", using a single device", EMULATOR_DEVICES_ENV_NAME, devices);
+        return 1;
+    }
+    return count;
+}
+
+static std::string get_kernel_device_path(uint32_t index)
+{
+    return KERNEL_DEVICE_PATH_PREFIX + std::to_string(index);
+}
+
+dsp_status driver_get_devices_count(dsp_driver_type_t type, size_t &count)
+{
+    if (type == DSP_DRIVER_TYPE_DEFAULT) {
+        type = get_default_driver_type();
+    }
+
+    if (type == DSP_DRIVER_TYPE_EMULATOR) {
+        count = get_emulator_devices_count();
+        return DSP_SUCCESS;
+    }
+
+    // The kernel driver numbers its devices consecutively
+    count = 0;
+    while (access(get_kernel_device_path(count).c_str(), F_OK) == 0) {
+        count++;
+    }
+    return DSP_SUCCESS;
+}
+
+dsp_status driver_open_device(const dsp_device_params_t &params, std::unique_ptr<Driver> &driver)
+{
+    dsp_driver_type_t type = params.driver;
+    if (type == DSP_DRIVER_TYPE_DEFAULT) {
+        type = get_default_driver_type();
+    }
+
+    if (type == DSP_DRIVER_TYPE_EMULATOR) {
+        if (params.index >= get_emulator_devices_count()) {
+            LOGGER__ERROR("Error: Emulated device index {} is out of range. Set {} to emulate more devices",
+                          params.index, EMULATOR_DEVICES_ENV_NAME);
+            return DSP_OPEN_DEVICE_FAILED;
+        }
+
+        driver.reset(new (std::nothrow) EmulatedDriver());
+        if (!driver) {
+            LOGGER__ERROR("Failed to allocate memory for emulated driver");
+            return DSP_OUT_OF_HOST_MEMORY;
+        }
+        LOGGER__INFO("Using emulated DSP driver (device {})", params.index);
+        return DSP_SUCCESS;
+    }
+
+    std::string device_path = params.path ? params.path : get_kernel_device_path(params.index);
+    int fd = open(device_path.c_str(), O_RDWR);
     if (fd == -1) {
         LOGGER__ERROR("Error: Failed to open device \"{}\"", device_path);
         return DSP_OPEN_DEVICE_FAILED;
     }
+
+    driver.reset(new (std::nothrow) KernelDriver(fd));
+    if (!driver) {
+        LOGGER__ERROR("Failed to allocate memory for driver");
+        close(fd);
+        return DSP_OUT_OF_HOST_MEMORY;
+    }
     return DSP_SUCCESS;
 }
 
-dsp_status driver_close_device(int fd)
+dsp_status driver_close_device(std::unique_ptr<Driver> &driver)
 {
-    if (fd != -1) {
-        close(fd);
-    }
+    driver.reset();
     return DSP_SUCCESS;
 }
 
-dsp_status driver_allocate_buffer(int fd, size_t size, void **buffer)
+dsp_status driver_allocate_buffer(Driver &driver, size_t size, void **buffer)
 {
     struct xrp_ioctl_alloc ioctl_alloc = {
         .size = static_cast<__u32>(size),
     };
 
-    int ret = ioctl(fd, XRP_IOCTL_ALLOC, &ioctl_alloc);
+    int ret = driver.ioctl(XRP_IOCTL_ALLOC, &ioctl_alloc);
     if (ret < 0) {
         LOGGER__ERROR("Error: Failed to allocate buffer of size {}, err={}", size, ret);
         return DSP_CREATE_BUFFER_FAILED;
@@ -67,13 +166,13 @@ dsp_status driver_allocate_buffer(int fd, size_t size, void **buffer)
     return DSP_SUCCESS;
 }
 
-dsp_status driver_release_buffer(int fd, void *buffer, size_t size)
+dsp_status driver_release_buffer(Driver &driver, void *buffer, size_t size)
 {
     struct xrp_ioctl_alloc ioctl_alloc = {
         .size = static_cast<__u32>(size),
         .addr = reinterpret_cast<uintptr_t>(buffer),
     };
-    int ret = ioctl(fd, XRP_IOCTL_FREE, &ioctl_alloc);
+    int ret = driver.ioctl(XRP_IOCTL_FREE, &ioctl_alloc);
     if (ret < 0) {
         LOGGER__ERROR("Error: Failed to free buffer {}, err={}", buffer, ret);
         return DSP_UNMAP_BUFFER_FAILED;
@@ -81,7 +180,7 @@ dsp_status driver_release_buffer(int fd, void *buffer, size_t size)
     return DSP_SUCCESS;
 }
 
-static dsp_status driver_sync_buffer(int fd,
+static dsp_status driver_sync_buffer(Driver &driver,
                                      void *buffer,
                                      size_t size,
                                      dsp_sync_direction_t direction,
@@ -98,7 +197,7 @@ static dsp_status driver_sync_buffer(int fd,
         .addr = reinterpret_cast<uintptr_t>(buffer),
     };
 
-    int ret = ioctl(fd, XRP_IOCTL_DMA_SYNC, &ioctl_sync);
+    int ret = driver.ioctl(XRP_IOCTL_DMA_SYNC, &ioctl_sync);
     if (ret < 0) {
         LOGGER__ERROR("Error: Failed to sync buffer {}, err={}", buffer, ret);
         return DSP_SYNC_BUFFER_FAILED;
@@ -106,36 +205,83 @@ static dsp_status driver_sync_buffer(int fd,
     return DSP_SUCCESS;
 }
 
-dsp_status driver_sync_buffer_start(int fd, void *buffer, size_t size, dsp_sync_direction_t direction)
+dsp_status driver_sync_buffer_start(Driver &driver, void *buffer, size_t size, dsp_sync_direction_t direction)
+{
+    return driver_sync_buffer(driver, buffer, size, direction, XRP_FLAG_BUFFER_SYNC_START);
+}
+
+dsp_status driver_sync_buffer_end(Driver &driver, void *buffer, size_t size, dsp_sync_direction_t direction)
+{
+    return driver_sync_buffer(driver, buffer, size, direction, XRP_FLAG_BUFFER_SYNC_END);
+}
+
+bool driver_supports_buffer_registration(Driver &driver)
+{
+    struct xrp_ioctl_register ioctl_register = {
+        .handle = XRP_REGISTER_INVALID_HANDLE,
+    };
+
+    int ret = driver.ioctl(XRP_IOCTL_UNREGISTER, &ioctl_register);
+    if ((ret < 0) && (errno == ENOTTY)) {
+        LOGGER__DEBUG("Buffer registration is not supported by the driver, buffers are passed by address");
+        return false;
+    }
+    return true;
+}
+
+dsp_status driver_register_buffer(Driver &driver, void *buffer, size_t size, uint32_t &handle)
 {
-    return driver_sync_buffer(fd, buffer, size, direction, XRP_FLAG_BUFFER_SYNC_START);
+    struct xrp_ioctl_register ioctl_register = {
+        .addr = reinterpret_cast<uintptr_t>(buffer),
+        .size = static_cast<__u32>(size),
+    };
+
+    int ret = driver.ioctl(XRP_IOCTL_REGISTER, &ioctl_register);
+    if (ret < 0) {
+        LOGGER__ERROR("Error: Failed to register buffer {} of size {}, err={}", buffer, size, ret);
+        return DSP_MAP_BUFFER_FAILED;
+    }
+
+    handle = ioctl_register.handle;
+    return DSP_SUCCESS;
 }
 
-dsp_status driver_sync_buffer_end(int fd, void *buffer, size_t size, dsp_sync_direction_t direction)
+dsp_status driver_unregister_buffer(Driver &driver, uint32_t handle)
 {
-    return driver_sync_buffer(fd, buffer, size, direction, XRP_FLAG_BUFFER_SYNC_END);
+    struct xrp_ioctl_register ioctl_register = {
+        .handle = handle,
+    };
+
+    int ret = driver.ioctl(XRP_IOCTL_UNREGISTER, &ioctl_register);
+    if (ret < 0) {
+        LOGGER__ERROR("Error: Failed to unregister buffer handle {}, err={}", handle, ret);
+        return DSP_UNMAP_BUFFER_FAILED;
+    }
+    return DSP_SUCCESS;
 }
 
-dsp_status driver_send_command(int fd,
-                               std::optional<std::string> nsid,
+dsp_status driver_send_command(Driver &driver,
+                               const char *nsid,
                                BufferList &buffer_list,
                                const void *in_data,
                                size_t in_data_size,
                                void *out_data,
-                               size_t out_data_size)
+                               size_t out_data_size,
+                               uint32_t queue_priority)
 {
     struct xrp_ioctl_queue ioctl_queue = {
-        .flags = static_cast<__u32>(nsid.has_value() ? XRP_QUEUE_FLAG_NSID : 0),
+        .flags = static_cast<__u32>((nsid ? XRP_QUEUE_FLAG_NSID : 0) |
+                                    ((queue_priority << XRP_QUEUE_FLAG_PRIO_SHIFT) & XRP_QUEUE_FLAG_PRIO)),
         .in_data_size = static_cast<__u32>(in_data_size),
         .out_data_size = static_cast<__u32>(out_data_size),
         .buffer_size = static_cast<__u32>(buffer_list.get_buffers().size() * sizeof(struct xrp_ioctl_buffer)),
         .in_data_addr = reinterpret_cast<__u64>(in_data),
         .out_data_addr = reinterpret_cast<__u64>(out_data),
         .buffer_addr = reinterpret_cast<__u64>(buffer_list.get_buffers().data()),
-        .nsid_addr = reinterpret_cast<__u64>(nsid.has_value() ? nsid.value().c_str() : nullptr),
+        .nsid_addr = reinterpret_cast<__u64>(nsid),
     };
 
-    int ret = ioctl(fd, XRP_IOCTL_QUEUE, &ioctl_queue);
+    int ret = driver.ioctl(XRP_IOCTL_QUEUE, &ioctl_queue);
     if (ret < 0) {
         LOGGER__ERROR(
             "Error: Failed to send command. For more information check Kernel log (dmesg) and DSP firmware log (cat "
@@ -146,13 +292,13 @@ dsp_status driver_send_command(int fd,
     return DSP_SUCCESS;
 }
 
-dsp_status driver_send_command(int fd,
-                               std::optional<std::string> nsid,
+dsp_status driver_send_command(Driver &driver,
+                               const char *nsid,
                                const void *in_data,
                                size_t in_data_size,
                                void *out_data,
                                size_t out_data_size)
 {
     BufferList buffer_list;
-    return driver_send_command(fd, nsid, buffer_list, in_data, in_data_size, out_data, out_data_size);
+    return driver_send_command(driver, nsid, buffer_list, in_data, in_data_size, out_data, out_data_size);
 }
\ No newline at end of file
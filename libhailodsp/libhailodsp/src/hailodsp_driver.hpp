@@ -26,27 +26,45 @@
 #include "buffer_list.hpp"
 
 #include <hailo/hailodsp.h>
-#include <optional>
+#include <memory>
 #include <string>
 
-dsp_status driver_open_device(int &fd);
-dsp_status driver_close_device(int fd);
+// Transport for the XRP ioctl interface. On target this is the XRP kernel driver. On hosts without a DSP, an
+// in-process emulation of the driver and the DSP firmware can be used instead
+class Driver {
+   public:
+    virtual ~Driver() = default;
 
-dsp_status driver_allocate_buffer(int fd, size_t size, void **buffer);
-dsp_status driver_release_buffer(int fd, void *buffer, size_t size);
-dsp_status driver_sync_buffer_start(int fd, void *buffer, size_t size, dsp_sync_direction_t direction);
-dsp_status driver_sync_buffer_end(int fd, void *buffer, size_t size, dsp_sync_direction_t direction);
+    // Same semantics as ioctl(2) on the XRP device: returns a negative value and sets errno on failure
+    virtual int ioctl(unsigned long request, void *arg) = 0;
+};
 
-dsp_status driver_send_command(int fd,
-                               std::optional<std::string> nsid,
+dsp_status driver_get_devices_count(dsp_driver_type_t type, size_t &count);
+dsp_status driver_open_device(const dsp_device_params_t &params, std::unique_ptr<Driver> &driver);
+dsp_status driver_close_device(std::unique_ptr<Driver> &driver);
+
+dsp_status driver_allocate_buffer(Driver &driver, size_t size, void **buffer);
+dsp_status driver_release_buffer(Driver &driver, void *buffer, size_t size);
+dsp_status driver_sync_buffer_start(Driver &driver, void *buffer, size_t size, dsp_sync_direction_t direction);
+dsp_status driver_sync_buffer_end(Driver &driver, void *buffer, size_t size, dsp_sync_direction_t direction);
+// Whether the driver implements buffer registration. Drivers older than the registration ioctls do not
+bool driver_supports_buffer_registration(Driver &driver);
+dsp_status driver_register_buffer(Driver &driver, void *buffer, size_t size, uint32_t &handle);
+dsp_status driver_unregister_buffer(Driver &driver, uint32_t handle);
+
+// "nsid" is a NULL terminated namespace id, or NULL to send the command to the default namespace.
+// "queue_priority" selects the XRP queue, higher values are of higher priority
+dsp_status driver_send_command(Driver &driver,
+                               const char *nsid,
                                BufferList &buffer_list,
                                const void *in_data = nullptr,
                                size_t in_data_size = 0,
                                void *out_data = nullptr,
-                               size_t out_data_size = 0);
+                               size_t out_data_size = 0,
+                               uint32_t queue_priority = 0);
 
-dsp_status driver_send_command(int fd,
-                               std::optional<std::string> nsid = std::nullopt,
+dsp_status driver_send_command(Driver &driver,
+                               const char *nsid = nullptr,
                                const void *in_data = nullptr,
                                size_t in_data_size = 0,
                                void *out_data = nullptr,
@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2017-2024 Hailo Technologies Ltd. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "host_stats.hpp"
+#include "logger_macros.hpp"
+
+#include <mutex>
+
+#define IMAGING_OP_COUNT (IMAGING_OP_BLUR_ROIS + 1)
+
+static const char *operation_names[IMAGING_OP_COUNT] = {
+    "crop_and_resize", "blend", "blur", "convert_format", "dewarp", "multi_crop_and_resize",
+    "multi_crop_and_resize_privacy_mask", "batch", "crop_resize_convert", "multi_crop_resize_convert",
+    "crop_resize_tensor", "batch_crop_resize", "privacy_mask", "crop_resize_privacy_mask", "blend_atlas", "blur_rois",
+};
+
+static const char *stage_names[DSP_HOST_STAGE_COUNT] = {"verify", "convert", "request_alloc", "driver_call"};
+
+static std::mutex stats_mutex;
+static dsp_host_op_stats_t stats[IMAGING_OP_COUNT];
+
+dsp_status dsp_get_host_stats(imaging_operation_t operation, dsp_host_op_stats_t *op_stats)
+{
+    if ((operation >= IMAGING_OP_COUNT) || (!op_stats)) {
+        LOGGER__ERROR("Error: Invalid argument (operation={}, stats={})\n", static_cast<int>(operation),
+                      fmt::ptr(op_stats));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    std::lock_guard<std::mutex> lock(stats_mutex);
+    *op_stats = stats[operation];
+    return DSP_SUCCESS;
+}
+
+void dsp_reset_host_stats(void)
+{
+    std::lock_guard<std::mutex> lock(stats_mutex);
+    for (auto &op_stats : stats) {
+        op_stats = {};
+    }
+}
+
+void dsp_log_host_stats(void)
+{
+#ifndef DSP_HOST_STATS
+    LOGGER__WARN("Host overhead statistics are not collected. Build the library with DSP_HOST_STATS");
+#endif
+
+    std::lock_guard<std::mutex> lock(stats_mutex);
+    for (size_t op = 0; op < IMAGING_OP_COUNT; op++) {
+        const auto &op_stats = stats[op];
+        if (op_stats.commands == 0) {
+            continue;
+        }
+
+        for (size_t stage = 0; stage < DSP_HOST_STAGE_COUNT; stage++) {
+            LOGGER__INFO("{} ({} commands): {}: {} ns/op, {:.2f} allocations/op", operation_names[op],
+                         op_stats.commands, stage_names[stage], op_stats.stages[stage].total_ns / op_stats.commands,
+                         static_cast<double>(op_stats.stages[stage].allocations) / op_stats.commands);
+        }
+    }
+}
+
+#ifndef DSP_HOST_STATS
+
+void dsp_host_stats_count_allocation(void) {}
+
+#else
+
+static thread_local host_sample_t pending_sample;
+static thread_local uint64_t thread_allocations;
+
+void host_stats_begin_command()
+{
+    pending_sample = {};
+}
+
+host_sample_t host_stats_take_pending()
+{
+    host_sample_t sample = pending_sample;
+    pending_sample = {};
+    return sample;
+}
+
+void host_stats_commit(imaging_operation_t operation, const host_sample_t &sample)
+{
+    if (operation >= IMAGING_OP_COUNT) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(stats_mutex);
+    auto &op_stats = stats[operation];
+    op_stats.commands++;
+    for (size_t i = 0; i < DSP_HOST_STAGE_COUNT; i++) {
+        op_stats.stages[i].total_ns += sample.stages[i].total_ns;
+        op_stats.stages[i].allocations += sample.stages[i].allocations;
+    }
+}
+
+void host_stats_count_allocation()
+{
+    thread_allocations++;
+}
+
+void dsp_host_stats_count_allocation(void)
+{
+    host_stats_count_allocation();
+}
+
+HostStageTimer::HostStageTimer(dsp_host_stage_t stage, host_sample_t *sample) :
+    m_stage(stage),
+    m_sample(sample ? sample : &pending_sample),
+    m_start(std::chrono::steady_clock::now()),
+    m_start_allocations(thread_allocations)
+{}
+
+HostStageTimer::~HostStageTimer()
+{
+    auto elapsed = std::chrono::steady_clock::now() - m_start;
+    auto &stage = m_sample->stages[m_stage];
+    stage.total_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    stage.allocations += thread_allocations - m_start_allocations;
+}
+
+#endif
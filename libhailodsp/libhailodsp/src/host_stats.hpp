@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2017-2024 Hailo Technologies Ltd. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "host_stats_perf.h"
+
+#include <chrono>
+
+// Host cost of a single imaging command
+struct host_sample_t {
+    dsp_host_stage_stats_t stages[DSP_HOST_STAGE_COUNT];
+
+    host_sample_t &operator+=(const host_sample_t &other)
+    {
+        for (size_t i = 0; i < DSP_HOST_STAGE_COUNT; i++) {
+            stages[i].total_ns += other.stages[i].total_ns;
+            stages[i].allocations += other.stages[i].allocations;
+        }
+        return *this;
+    }
+};
+
+#ifdef DSP_HOST_STATS
+
+// Stages measured on the calling thread are accumulated into a per-thread pending sample, which is attached to the
+// command when it is sent. Stages measured elsewhere (e.g. the driver call of an asynchronous job) are recorded
+// directly into the command's sample
+void host_stats_begin_command();
+host_sample_t host_stats_take_pending();
+void host_stats_commit(imaging_operation_t operation, const host_sample_t &sample);
+void host_stats_count_allocation();
+
+class HostStageTimer {
+   public:
+    explicit HostStageTimer(dsp_host_stage_t stage, host_sample_t *sample = nullptr);
+    ~HostStageTimer();
+
+   private:
+    dsp_host_stage_t m_stage;
+    host_sample_t *m_sample;
+    std::chrono::steady_clock::time_point m_start;
+    uint64_t m_start_allocations;
+};
+
+#define HOST_STATS_CONCAT_(a, b) a##b
+#define HOST_STATS_CONCAT(a, b) HOST_STATS_CONCAT_(a, b)
+#define HOST_STATS_STAGE(...) HostStageTimer HOST_STATS_CONCAT(host_stage_timer_, __LINE__)(__VA_ARGS__)
+
+#else
+
+inline void host_stats_begin_command() {}
+inline host_sample_t host_stats_take_pending()
+{
+    return {};
+}
+inline void host_stats_commit(imaging_operation_t, const host_sample_t &) {}
+inline void host_stats_count_allocation() {}
+
+#define HOST_STATS_STAGE(...)
+
+#endif
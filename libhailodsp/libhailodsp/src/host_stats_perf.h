@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2017-2024 Hailo Technologies Ltd. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "hailo/hailodsp.h"
+#include "user_dsp_interface.h"
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Host side stages of sending an imaging command to the DSP
+typedef enum {
+    DSP_HOST_STAGE_VERIFY,        // verify_image_properties
+    DSP_HOST_STAGE_CONVERT,       // add_images_to_buffer_list (convert_image and buffer list construction)
+    DSP_HOST_STAGE_REQUEST_ALLOC, // Allocation of the request, and of the job for asynchronous operations
+    DSP_HOST_STAGE_DRIVER_CALL,   // The driver ioctl, including the time the DSP spends executing the command
+    DSP_HOST_STAGE_COUNT,
+} dsp_host_stage_t;
+
+typedef struct {
+    uint64_t total_ns;
+    uint64_t allocations;
+} dsp_host_stage_stats_t;
+
+typedef struct {
+    // Number of commands sent (or recorded into a command buffer) for the operation
+    uint64_t commands;
+    dsp_host_stage_stats_t stages[DSP_HOST_STAGE_COUNT];
+} dsp_host_op_stats_t;
+
+/*
+ * Host overhead statistics are collected only when the library is built with DSP_HOST_STATS. Otherwise all the
+ * statistics stay zero.
+ * Divide the stage totals by the number of commands to get ns/op and allocations/op
+ */
+dsp_status dsp_get_host_stats(imaging_operation_t operation, dsp_host_op_stats_t *stats);
+
+void dsp_reset_host_stats(void);
+
+// Logs ns/op and allocations/op of every stage, for every operation that was used
+void dsp_log_host_stats(void);
+
+/*
+ * Counts an allocation of the calling thread towards the stage being measured. The library counts its own aligned
+ * allocations. Allocations through operator new are counted only when the process replaces the global allocation
+ * functions and calls this from the replacements, as the host overhead benchmark (tests/bench_host_overhead.cpp) does
+ */
+void dsp_host_stats_count_allocation(void);
+
+#ifdef __cplusplus
+}
+#endif
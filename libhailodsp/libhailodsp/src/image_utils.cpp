@@ -22,6 +22,7 @@
  */
 
 #include "hailo/hailodsp.h"
+#include "host_stats.hpp"
 #include "logger_macros.hpp"
 #include "user_dsp_interface.h"
 
@@ -243,6 +244,7 @@ static dsp_status verify_a420_image(const dsp_image_properties_t *image)
 
 dsp_status verify_image_properties(const dsp_image_properties_t *image)
 {
+    HOST_STATS_STAGE(DSP_HOST_STAGE_VERIFY);
     dsp_status status = DSP_UNINITIALIZED;
 
     if (image == NULL) {
@@ -296,3 +298,163 @@ dsp_status verify_image_properties(const dsp_image_properties_t *image)
 
     return status;
 }
+
+static size_t tensor_element_size(dsp_tensor_data_type_t data_type)
+{
+    return (data_type == DSP_TENSOR_DATA_TYPE_FLOAT16) ? 2 : 1;
+}
+
+// Channels of NCHW tensors are stored as consecutive rows
+static size_t tensor_rows_count(const dsp_tensor_t *tensor)
+{
+    return tensor->height * ((tensor->layout == DSP_TENSOR_LAYOUT_NCHW) ? 3 : 1);
+}
+
+dsp_status verify_tensor_properties(const dsp_tensor_t *tensor)
+{
+    HOST_STATS_STAGE(DSP_HOST_STAGE_VERIFY);
+
+    if (tensor == NULL) {
+        LOGGER__ERROR("Error: Pointer to dsp_tensor_t struct is NULL\n");
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    if ((tensor->width == 0) || (tensor->height == 0)) {
+        LOGGER__ERROR("Error: Tensor width ({}) and height ({}) must not be 0\n", tensor->width, tensor->height);
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    if ((tensor->layout >= DSP_TENSOR_LAYOUT_COUNT) || (tensor->channel_order >= DSP_TENSOR_CHANNEL_ORDER_COUNT) ||
+        (tensor->data_type >= DSP_TENSOR_DATA_TYPE_COUNT) || (tensor->memory >= DSP_MEMORY_TYPE_COUNT)) {
+        LOGGER__ERROR("Error: Unknown tensor layout ({}), channel order ({}), data type ({}) or memory type ({})\n",
+                      tensor->layout, tensor->channel_order, tensor->data_type, tensor->memory);
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    for (size_t c = 0; c < 3; ++c) {
+        if (!std::isfinite(tensor->mean[c]) || !std::isfinite(tensor->std[c]) || (tensor->std[c] == 0.0f)) {
+            LOGGER__ERROR("Error: Invalid normalization of channel {} (mean={}, std={})\n", c, tensor->mean[c],
+                          tensor->std[c]);
+            return DSP_INVALID_ARGUMENT;
+        }
+    }
+
+    if ((tensor->data_type != DSP_TENSOR_DATA_TYPE_FLOAT16) &&
+        (!std::isfinite(tensor->quant_scale) || (tensor->quant_scale <= 0.0f))) {
+        LOGGER__ERROR("Error: Quantization scale ({}) must be positive\n", tensor->quant_scale);
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    if ((tensor->memory == DSP_MEMORY_TYPE_USERPTR) && (tensor->plane.userptr == NULL)) {
+        LOGGER__ERROR("Error: Tensor data pointer is NULL\n");
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    size_t element_size = tensor_element_size(tensor->data_type);
+    size_t row_size = tensor->width * element_size * ((tensor->layout == DSP_TENSOR_LAYOUT_NHWC) ? 3 : 1);
+    size_t rows_count = tensor_rows_count(tensor);
+
+    if (tensor->plane.bytesperline < row_size) {
+        LOGGER__ERROR("Error: Tensor line stride ({}) is too small for the tensor width and data type specified\n",
+                      tensor->plane.bytesperline);
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    if (tensor->plane.bytesused < tensor->plane.bytesperline * (rows_count - 1) + row_size) {
+        LOGGER__ERROR("Error: Tensor size ({}) is too small based on the tensor line stride and height specified\n",
+                      tensor->plane.bytesused);
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    return DSP_SUCCESS;
+}
+
+void convert_tensor(const dsp_tensor_t *tensor_src, tensor_in_data_t *tensor_dst)
+{
+    tensor_dst->data.line_stride = tensor_src->plane.bytesperline;
+    tensor_dst->data.plane_size = tensor_src->plane.bytesused;
+    tensor_dst->width = tensor_src->width;
+    tensor_dst->height = tensor_src->height;
+    tensor_dst->layout =
+        (tensor_src->layout == DSP_TENSOR_LAYOUT_NHWC) ? INTERFACE_TENSOR_LAYOUT_NHWC : INTERFACE_TENSOR_LAYOUT_NCHW;
+    tensor_dst->bgr = (tensor_src->channel_order == DSP_TENSOR_CHANNEL_ORDER_BGR);
+
+    switch (tensor_src->data_type) {
+        case DSP_TENSOR_DATA_TYPE_UINT8:
+            tensor_dst->data_type = INTERFACE_TENSOR_DATA_TYPE_UINT8;
+            break;
+        case DSP_TENSOR_DATA_TYPE_INT8:
+            tensor_dst->data_type = INTERFACE_TENSOR_DATA_TYPE_INT8;
+            break;
+        default:
+            tensor_dst->data_type = INTERFACE_TENSOR_DATA_TYPE_FLOAT16;
+            break;
+    }
+
+    // Normalization and quantization are folded into a single multiply-add per element
+    bool quantized = (tensor_src->data_type != DSP_TENSOR_DATA_TYPE_FLOAT16);
+    float quant_scale = quantized ? tensor_src->quant_scale : 1.0f;
+    float zero_point = quantized ? static_cast<float>(tensor_src->quant_zero_point) : 0.0f;
+    for (size_t c = 0; c < 3; ++c) {
+        tensor_dst->gain[c] = 1.0f / (tensor_src->std[c] * quant_scale);
+        tensor_dst->offset[c] = zero_point - tensor_src->mean[c] * tensor_dst->gain[c];
+    }
+}
+
+size_t get_tensor_batch_stride(const dsp_tensor_t *tensor)
+{
+    return tensor->plane.bytesperline * tensor_rows_count(tensor);
+}
+
+dsp_status get_packed_image_layout(dsp_image_format_t format,
+                                   size_t width,
+                                   size_t height,
+                                   dsp_data_plane_t planes[MAX_PLANES],
+                                   size_t &planes_count)
+{
+    // Bytes per pixel, width ratio and height ratio of every plane, as verified by verify_image_properties
+    typedef struct {
+        size_t bytes_per_pixel;
+        size_t width_ratio;
+        size_t height_ratio;
+    } plane_layout_t;
+
+    static const plane_layout_t gray8_layout[] = {{1, 1, 1}};
+    static const plane_layout_t rgb_layout[] = {{3, 1, 1}};
+    static const plane_layout_t nv12_layout[] = {{1, 1, 1}, {2, 2, 2}};
+    static const plane_layout_t a420_layout[] = {{1, 1, 1}, {1, 2, 2}, {1, 2, 2}, {1, 1, 1}};
+
+    const plane_layout_t *layout = nullptr;
+    switch (format) {
+        case DSP_IMAGE_FORMAT_GRAY8:
+            layout = gray8_layout;
+            planes_count = ARRAY_LENGTH(gray8_layout);
+            break;
+        case DSP_IMAGE_FORMAT_RGB:
+            layout = rgb_layout;
+            planes_count = ARRAY_LENGTH(rgb_layout);
+            break;
+        case DSP_IMAGE_FORMAT_NV12:
+            layout = nv12_layout;
+            planes_count = ARRAY_LENGTH(nv12_layout);
+            break;
+        case DSP_IMAGE_FORMAT_A420:
+            layout = a420_layout;
+            planes_count = ARRAY_LENGTH(a420_layout);
+            break;
+        default:
+            LOGGER__ERROR("Error: Unknown image format {}\n", format);
+            return DSP_INVALID_ARGUMENT;
+    }
+
+    for (size_t i = 0; i < planes_count; i++) {
+        planes[i].userptr = nullptr;
+        const auto &plane_layout = layout[i];
+        planes[i].bytesperline =
+            (width * plane_layout.bytes_per_pixel + plane_layout.width_ratio - 1) / plane_layout.width_ratio;
+        planes[i].bytesused =
+            (planes[i].bytesperline * height + plane_layout.height_ratio - 1) / plane_layout.height_ratio;
+    }
+
+    return DSP_SUCCESS;
+}
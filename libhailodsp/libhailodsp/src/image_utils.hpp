@@ -27,4 +27,17 @@
 #include "user_dsp_interface.h"
 
 dsp_status verify_image_properties(const dsp_image_properties_t *image);
-dsp_status convert_image(const dsp_image_properties_t *img_src, image_properties_t *img_dst);
\ No newline at end of file
+dsp_status convert_image(const dsp_image_properties_t *img_src, image_properties_t *img_dst);
+
+dsp_status verify_tensor_properties(const dsp_tensor_t *tensor);
+// Fills everything but the xrp buffer index of the tensor data. This function assumes that the tensor is verified
+void convert_tensor(const dsp_tensor_t *tensor_src, tensor_in_data_t *tensor_dst);
+// Distance in bytes between consecutive tensors of a batch tensor
+size_t get_tensor_batch_stride(const dsp_tensor_t *tensor);
+
+// Fills the line strides and sizes of the planes of a tightly packed image. The plane data pointers are set to NULL
+dsp_status get_packed_image_layout(dsp_image_format_t format,
+                                   size_t width,
+                                   size_t height,
+                                   dsp_data_plane_t planes[MAX_PLANES],
+                                   size_t &planes_count);
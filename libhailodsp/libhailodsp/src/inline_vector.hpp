@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2017-2024 Hailo Technologies Ltd. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+
+// Fixed-capacity vector with inline storage, for per-command containers whose maximal size is known at compile time.
+// Callers must not exceed the capacity
+template <class T, size_t Capacity>
+class InlineVector {
+   public:
+    void push_back(const T &value)
+    {
+        assert(m_size < Capacity);
+        m_items[m_size++] = value;
+    }
+
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    T *data() { return m_items.data(); }
+    const T *data() const { return m_items.data(); }
+    T *begin() { return m_items.data(); }
+    T *end() { return m_items.data() + m_size; }
+    const T *begin() const { return m_items.data(); }
+    const T *end() const { return m_items.data() + m_size; }
+    T &operator[](size_t index) { return m_items[index]; }
+    const T &operator[](size_t index) const { return m_items[index]; }
+
+   private:
+    std::array<T, Capacity> m_items;
+    size_t m_size = 0;
+};
@@ -0,0 +1,430 @@
+/*
+ * Copyright (c) 2017-2024 Hailo Technologies Ltd. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "job.hpp"
+#include "device.hpp"
+#include "logger_macros.hpp"
+
+#include <algorithm>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+JobQueue::JobQueue(dsp_device device, int wake_fd) : m_device(device), m_exit(false), m_wake_fd(wake_fd)
+{
+    m_worker = std::thread(&JobQueue::worker_loop, this);
+}
+
+std::unique_ptr<JobQueue> JobQueue::create(dsp_device device)
+{
+    int wake_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (wake_fd == -1) {
+        LOGGER__ERROR("Error: Failed to create eventfd for job queue, errno={}\n", errno);
+        return nullptr;
+    }
+
+    auto queue = std::unique_ptr<JobQueue>(new (std::nothrow) JobQueue(device, wake_fd));
+    if (!queue) {
+        LOGGER__ERROR("Failed to allocate memory for job queue");
+        close(wake_fd);
+    }
+    return queue;
+}
+
+JobQueue::~JobQueue()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_exit = true;
+    }
+    (void)eventfd_write(m_wake_fd, 1);
+    m_worker.join();
+    close(m_wake_fd);
+}
+
+void JobQueue::push(dsp_job job, SubmissionContext *context)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobs.push_back({.job = job, .context = context, .fences = std::move(context->pending_fences)});
+        context->pending_fences.clear();
+    }
+    (void)eventfd_write(m_wake_fd, 1);
+}
+
+static void release_job(dsp_job job)
+{
+    if (job->event_fd != -1) {
+        close(job->event_fd);
+    }
+    delete job;
+}
+
+static void complete_job(dsp_job job, dsp_status status)
+{
+    bool detached;
+    {
+        std::lock_guard<std::mutex> lock(job->mutex);
+        job->status = status;
+        job->done = true;
+        if (job->event_fd != -1) {
+            (void)eventfd_write(job->event_fd, 1);
+        }
+        detached = job->detached;
+        // Notify while holding the lock, so the job can't be released before we are done touching it
+        job->done_cv.notify_all();
+    }
+
+    if (detached) {
+        release_job(job);
+    }
+}
+
+bool JobQueue::pop_runnable_job(entry_t &entry)
+{
+    // Threads whose first job was seen. Only the first job of a thread may start, so its jobs keep their order
+    m_waiting_contexts.clear();
+    auto selected = m_jobs.end();
+    for (auto it = m_jobs.begin(); it != m_jobs.end(); ++it) {
+        bool thread_waiting =
+            std::find(m_waiting_contexts.begin(), m_waiting_contexts.end(), it->context) != m_waiting_contexts.end();
+        if (thread_waiting) {
+            continue;
+        }
+        m_waiting_contexts.push_back(it->context);
+
+        // The earliest job of the highest priority, so that high priority jobs overtake the queued ones
+        if (it->fences.empty() &&
+            ((selected == m_jobs.end()) || (it->job->command.priority > selected->job->command.priority))) {
+            selected = it;
+        }
+    }
+
+    if (selected == m_jobs.end()) {
+        return false;
+    }
+
+    entry = std::move(*selected);
+    m_jobs.erase(selected);
+    return true;
+}
+
+bool JobQueue::wait_for_fences(int timeout_ms)
+{
+    m_poll_fds.clear();
+    m_poll_fds.push_back({.fd = m_wake_fd, .events = POLLIN, .revents = 0});
+    {
+        // Only the worker thread closes the fences, so they can be polled without the lock
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const auto &entry : m_jobs) {
+            for (auto fence : entry.fences) {
+                m_poll_fds.push_back({.fd = fence, .events = POLLIN, .revents = 0});
+            }
+        }
+    }
+
+    int ret;
+    do {
+        ret = poll(m_poll_fds.data(), m_poll_fds.size(), timeout_ms);
+    } while ((ret < 0) && (errno == EINTR));
+
+    if (ret < 0) {
+        LOGGER__ERROR("Error: Failed waiting on fences, errno={}\n", errno);
+        return false;
+    }
+
+    if (m_poll_fds[0].revents & POLLIN) {
+        eventfd_t value;
+        (void)eventfd_read(m_wake_fd, &value);
+    }
+
+    bool signaled = false;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (size_t i = 1; i < m_poll_fds.size(); ++i) {
+        const auto &fence_poll = m_poll_fds[i];
+        if (fence_poll.revents == 0) {
+            continue;
+        }
+
+        // A fence in an error state is never signaled, so the job does not wait for it
+        if (fence_poll.revents & (POLLERR | POLLNVAL)) {
+            LOGGER__ERROR("Error: Fence {} is in an error state (revents={:#x}). Continuing without it\n",
+                          fence_poll.fd, fence_poll.revents);
+        }
+
+        for (auto &entry : m_jobs) {
+            auto fence = std::find(entry.fences.begin(), entry.fences.end(), fence_poll.fd);
+            if (fence != entry.fences.end()) {
+                entry.fences.erase(fence);
+                break;
+            }
+        }
+        // POLLNVAL means the descriptor is not open, so there is nothing to close
+        if (!(fence_poll.revents & POLLNVAL)) {
+            close(fence_poll.fd);
+        }
+        signaled = true;
+    }
+
+    return signaled;
+}
+
+void JobQueue::cancel_waiting_jobs()
+{
+    std::deque<entry_t> jobs;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        jobs.swap(m_jobs);
+    }
+
+    for (auto &entry : jobs) {
+        for (auto fence : entry.fences) {
+            close(fence);
+        }
+
+        LOGGER__ERROR("Error: Canceling an asynchronous operation held back by an unsignaled fence\n");
+        entry.context->outstanding_commands.fetch_sub(1, std::memory_order_relaxed);
+        complete_job(entry.job, DSP_CANCELED);
+    }
+}
+
+void JobQueue::worker_loop()
+{
+    for (;;) {
+        entry_t entry;
+        bool found;
+        bool exit;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            found = pop_runnable_job(entry);
+            exit = m_exit;
+        }
+
+        if (!found) {
+            // On exit, fences that are already signaled still release their jobs. The jobs left waiting are canceled
+            if (!wait_for_fences(exit ? 0 : -1) && exit) {
+                cancel_waiting_jobs();
+                return;
+            }
+            continue;
+        }
+
+        // From here on the job is accounted for by send_command, in the context of the worker thread
+        auto job = entry.job;
+        entry.context->outstanding_commands.fetch_sub(1, std::memory_order_relaxed);
+
+        auto status = send_command(m_device, job->command, job->perf_info);
+        if (status != DSP_SUCCESS) {
+            LOGGER__ERROR("Error: Failed executing asynchronous operation. Error code: {}\n", status);
+        }
+        complete_job(job, status);
+    }
+}
+
+static dsp_status get_job_queue(dsp_device device, JobQueue *&job_queue)
+{
+    std::call_once(device->job_queue_once, [device] { device->job_queue = JobQueue::create(device); });
+    if (!device->job_queue) {
+        LOGGER__ERROR("Error: The job queue of the device could not be created\n");
+        return DSP_CREATE_QUEUE_FAILED;
+    }
+
+    job_queue = device->job_queue.get();
+    return DSP_SUCCESS;
+}
+
+dsp_status submit_command_async(dsp_device device, ImagingCommand &&command, perf_info_t *perf_info, dsp_job *job)
+{
+    JobQueue *job_queue;
+    auto status = get_job_queue(device, job_queue);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    dsp_job local_job;
+    {
+        HOST_STATS_STAGE(DSP_HOST_STAGE_REQUEST_ALLOC);
+        local_job = new (std::nothrow) _dsp_job{
+            .device = device,
+            .command = std::move(command),
+            .perf_info = perf_info,
+        };
+    }
+    if (!local_job) {
+        LOGGER__ERROR("Failed to allocate memory for job");
+        return DSP_OUT_OF_HOST_MEMORY;
+    }
+
+    // The worker thread has its own thread priority
+    local_job->command.priority = get_command_priority(device, local_job->command.priority);
+
+    // The driver call is measured by the worker thread, into the sample of the job
+    local_job->command.host_sample += host_stats_take_pending();
+
+    auto &context = get_submission_context(device);
+    context.outstanding_commands.fetch_add(1, std::memory_order_relaxed);
+    job_queue->push(local_job, &context);
+
+    *job = local_job;
+    return DSP_SUCCESS;
+}
+
+dsp_status dsp_job_wait(dsp_job job)
+{
+    if (!job) {
+        LOGGER__ERROR("Error: job is NULL\n");
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    std::unique_lock<std::mutex> lock(job->mutex);
+    job->done_cv.wait(lock, [job] { return job->done; });
+    return job->status;
+}
+
+dsp_status dsp_job_poll(dsp_job job)
+{
+    if (!job) {
+        LOGGER__ERROR("Error: job is NULL\n");
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    std::lock_guard<std::mutex> lock(job->mutex);
+    return job->done ? job->status : DSP_IN_PROGRESS;
+}
+
+// Must be called with the job mutex held
+static dsp_status create_event_fd(dsp_job job)
+{
+    if (job->event_fd != -1) {
+        return DSP_SUCCESS;
+    }
+
+    job->event_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (job->event_fd == -1) {
+        LOGGER__ERROR("Error: Failed to create eventfd for job, errno={}\n", errno);
+        return DSP_OUT_OF_HOST_MEMORY;
+    }
+    if (job->done) {
+        (void)eventfd_write(job->event_fd, 1);
+    }
+    return DSP_SUCCESS;
+}
+
+dsp_status dsp_job_get_fd(dsp_job job, int *fd)
+{
+    if ((!job) || (!fd)) {
+        LOGGER__ERROR("Error: NULL argument (job={}, fd={})\n", fmt::ptr(job), fmt::ptr(fd));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    std::lock_guard<std::mutex> lock(job->mutex);
+    auto status = create_event_fd(job);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    *fd = job->event_fd;
+    return DSP_SUCCESS;
+}
+
+dsp_status dsp_job_get_fence(dsp_job job, int *fence)
+{
+    if ((!job) || (!fence)) {
+        LOGGER__ERROR("Error: NULL argument (job={}, fence={})\n", fmt::ptr(job), fmt::ptr(fence));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    std::lock_guard<std::mutex> lock(job->mutex);
+    auto status = create_event_fd(job);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    // A duplicate outlives the job, so the fence can be handed over to a consumer
+    int local_fence = fcntl(job->event_fd, F_DUPFD_CLOEXEC, 0);
+    if (local_fence == -1) {
+        LOGGER__ERROR("Error: Failed to duplicate the job eventfd, errno={}\n", errno);
+        return DSP_OUT_OF_HOST_MEMORY;
+    }
+
+    *fence = local_fence;
+    return DSP_SUCCESS;
+}
+
+dsp_status dsp_queue_fence_wait(dsp_device device, int fence)
+{
+    if ((!device) || (fence < 0)) {
+        LOGGER__ERROR("Error: Invalid argument (device={}, fence={})\n", fmt::ptr(device), fence);
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    // The fences are kept by the thread until its next job, and the shared fallback context can't hold them
+    auto &context = get_submission_context(device);
+    if (&context == &device->fallback_submission_context) {
+        LOGGER__ERROR("Failed to allocate memory for the submission context of the thread");
+        return DSP_OUT_OF_HOST_MEMORY;
+    }
+
+    int local_fence = fcntl(fence, F_DUPFD_CLOEXEC, 0);
+    if (local_fence == -1) {
+        LOGGER__ERROR("Error: Failed to duplicate fence {}, errno={}\n", fence, errno);
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    context.pending_fences.push_back(local_fence);
+    return DSP_SUCCESS;
+}
+
+dsp_status dsp_job_release(dsp_job job)
+{
+    if (!job) {
+        LOGGER__ERROR("Error: job is NULL\n");
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    // The job is owned by the device's queue until it completes
+    (void)dsp_job_wait(job);
+
+    release_job(job);
+    return DSP_SUCCESS;
+}
+
+dsp_status dsp_job_detach(dsp_job job)
+{
+    if (!job) {
+        LOGGER__ERROR("Error: job is NULL\n");
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(job->mutex);
+        if (!job->done) {
+            job->detached = true;
+            return DSP_SUCCESS;
+        }
+    }
+
+    release_job(job);
+    return DSP_SUCCESS;
+}
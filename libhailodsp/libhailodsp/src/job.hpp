@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2017-2024 Hailo Technologies Ltd. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "hailo/hailodsp.h"
+#include "send_command.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <poll.h>
+#include <thread>
+#include <vector>
+
+struct SubmissionContext;
+
+struct _dsp_job {
+    dsp_device device;
+    ImagingCommand command;
+    perf_info_t *perf_info;
+
+    std::mutex mutex;
+    std::condition_variable done_cv;
+    bool done = false;
+    dsp_status status = DSP_UNINITIALIZED;
+    // eventfd signaled on completion. Created on demand by dsp_job_get_fd and dsp_job_get_fence
+    int event_fd = -1;
+    // Released by the worker thread on completion
+    bool detached = false;
+};
+
+// Executes submitted jobs on a worker thread, which blocks in the driver on behalf of the submitting thread. The jobs
+// of a thread run in submission order. A job waiting for a fence holds back the later jobs of its thread only
+class JobQueue {
+   public:
+    // Returns NULL on failure
+    static std::unique_ptr<JobQueue> create(dsp_device device);
+    // Runs the jobs that can still start, and cancels the ones whose fences are not signaled
+    ~JobQueue();
+
+    // "context" is the submission context of the submitting thread. It accounts for the job until it is sent, and
+    // hands over the fences queued by dsp_queue_fence_wait, which the job waits for
+    void push(dsp_job job, SubmissionContext *context);
+
+   private:
+    typedef struct {
+        dsp_job job;
+        SubmissionContext *context;
+        // Fences that are not signaled yet. Owned by the entry
+        std::vector<int> fences;
+    } entry_t;
+
+    JobQueue(dsp_device device, int wake_fd);
+
+    void worker_loop();
+    // Must be called with the mutex held. Among the jobs whose fences are signaled and that no earlier job of their
+    // thread is waiting in front of, takes the first one of the highest priority
+    bool pop_runnable_job(entry_t &entry);
+    // Polls the wake eventfd and the fences of the waiting jobs, and drops the fences that were signaled. Returns
+    // whether any fence was signaled
+    bool wait_for_fences(int timeout_ms);
+    void cancel_waiting_jobs();
+
+    dsp_device m_device;
+    std::mutex m_mutex;
+    std::deque<entry_t> m_jobs;
+    bool m_exit;
+    // eventfd signaled when a job is pushed, and on exit
+    int m_wake_fd;
+    // Scratch space of the worker thread, kept to not allocate on every iteration
+    std::vector<struct pollfd> m_poll_fds;
+    std::vector<SubmissionContext *> m_waiting_contexts;
+    std::thread m_worker;
+};
+
+dsp_status submit_command_async(dsp_device device, ImagingCommand &&command, perf_info_t *perf_info, dsp_job *job);
@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2017-2024 Hailo Technologies Ltd. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plan.hpp"
+#include "device.hpp"
+#include "hailo/hailodsp.h"
+#include "host_stats.hpp"
+#include "logger_macros.hpp"
+#include "plan_perf.h"
+
+dsp_status plan_create_from_command(dsp_device device,
+                                    ImagingCommand &&command,
+                                    const std::vector<const dsp_image_properties_t *> &images,
+                                    dsp_plan *plan)
+{
+    auto local_plan = new (std::nothrow) _dsp_plan{
+        .device = device,
+        .request = std::move(command.request),
+        .payload = std::move(command.payload),
+        .buffer_list = std::move(command.buffer_list),
+        .submit_buffer_list = {},
+        .planes = {},
+        .buffer_refs = {},
+    };
+    if (!local_plan) {
+        LOGGER__ERROR("Failed to allocate memory for plan");
+        return DSP_OUT_OF_HOST_MEMORY;
+    }
+
+    for (auto image : images) {
+        if (!image) {
+            continue;
+        }
+        for (size_t plane_index = 0; plane_index < image->planes_count; ++plane_index) {
+            const auto &plane = image->planes[plane_index];
+            local_plan->planes.push_back({
+                .memory = image->memory,
+                .bytesperline = plane.bytesperline,
+                .bytesused = plane.bytesused,
+            });
+        }
+    }
+
+    // The images' planes were added to the buffer list in order, once by every chained request. So each pass over
+    // the planes claims, for every plane, the first unclaimed entry that matches it
+    const auto buffers = local_plan->buffer_list.get_buffers();
+    std::vector<bool> claimed(buffers.size(), false);
+    for (bool first_pass = true;; first_pass = false) {
+        size_t claimed_count = 0;
+        size_t plan_plane_index = 0;
+        for (auto image : images) {
+            if (!image) {
+                continue;
+            }
+
+            for (size_t plane_index = 0; plane_index < image->planes_count; ++plane_index, ++plan_plane_index) {
+                const auto &plane = image->planes[plane_index];
+                size_t buffer_index = 0;
+                while ((buffer_index < buffers.size()) &&
+                       (claimed[buffer_index] || !plane_matches_buffer(plane, image->memory, buffers[buffer_index]))) {
+                    buffer_index++;
+                }
+                if (buffer_index == buffers.size()) {
+                    continue;
+                }
+
+                claimed[buffer_index] = true;
+                local_plan->buffer_refs.emplace_back(plan_plane_index, buffer_index);
+                claimed_count++;
+            }
+        }
+
+        if (first_pass && (claimed_count != local_plan->planes.size())) {
+            LOGGER__ERROR("Error: Failed to locate the planes of the images in the plan\n");
+            delete local_plan;
+            return DSP_INVALID_ARGUMENT;
+        }
+        if (claimed_count == 0) {
+            break;
+        }
+    }
+
+    // Sized once, so executions do not allocate
+    local_plan->submit_buffer_list = local_plan->buffer_list;
+
+    *plan = local_plan;
+    return DSP_SUCCESS;
+}
+
+dsp_status dsp_plan_execute_perf(dsp_plan plan,
+                                 const dsp_data_plane_t planes[],
+                                 size_t planes_count,
+                                 perf_info_t *perf_info)
+{
+    if ((!plan) || (!planes)) {
+        LOGGER__ERROR("Error: NULL argument (plan={}, planes={})\n", fmt::ptr(plan), fmt::ptr(planes));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    if (planes_count != plan->planes.size()) {
+        LOGGER__ERROR("Error: Plan expects {} planes, got {}\n", plan->planes.size(), planes_count);
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    for (size_t i = 0; i < planes_count; ++i) {
+        const auto &plan_plane = plan->planes[i];
+        if ((planes[i].bytesperline != plan_plane.bytesperline) || (planes[i].bytesused != plan_plane.bytesused)) {
+            LOGGER__ERROR("Error: Plane[{}] layout differs from the plan\n", i);
+            return DSP_INVALID_ARGUMENT;
+        }
+
+        if ((plan_plane.memory == DSP_MEMORY_TYPE_USERPTR) && (planes[i].userptr == NULL)) {
+            LOGGER__ERROR("Error: Plane[{}] data pointer is NULL\n", i);
+            return DSP_INVALID_ARGUMENT;
+        }
+        if ((plan_plane.memory == DSP_MEMORY_TYPE_DMABUF) && (planes[i].fd < 0)) {
+            LOGGER__ERROR("Error: Plane[{}] fd {} is invalid\n", i, planes[i].fd);
+            return DSP_INVALID_ARGUMENT;
+        }
+    }
+
+    auto buffers = plan->buffer_list.get_buffers();
+    for (const auto &[plane_index, buffer_index] : plan->buffer_refs) {
+        if (plan->planes[plane_index].memory == DSP_MEMORY_TYPE_USERPTR) {
+            buffers[buffer_index].addr = reinterpret_cast<uintptr_t>(planes[plane_index].userptr);
+        } else {
+            buffers[buffer_index].fd = planes[plane_index].fd;
+        }
+    }
+
+    plan->submit_buffer_list = plan->buffer_list;
+
+    host_sample_t host_sample = {};
+    size_t perf_info_size = perf_info ? sizeof(*perf_info) : 0;
+    dsp_status status;
+    {
+        HOST_STATS_STAGE(DSP_HOST_STAGE_DRIVER_CALL, &host_sample);
+        status = send_command(plan->device, plan->submit_buffer_list, plan->request.get(), sizeof(imaging_request_t),
+                              perf_info, perf_info_size);
+    }
+    host_stats_commit(static_cast<imaging_operation_t>(plan->request->operation), host_sample);
+
+    if (status != DSP_SUCCESS) {
+        LOGGER__ERROR("Error: Failed executing plan. Error code: {}\n", status);
+    }
+
+    return status;
+}
+
+dsp_status dsp_plan_execute(dsp_plan plan, const dsp_data_plane_t planes[], size_t planes_count)
+{
+    return dsp_plan_execute_perf(plan, planes, planes_count, NULL);
+}
+
+dsp_status dsp_plan_get_planes_count(dsp_plan plan, size_t *planes_count)
+{
+    if ((!plan) || (!planes_count)) {
+        LOGGER__ERROR("Error: NULL argument (plan={}, planes_count={})\n", fmt::ptr(plan), fmt::ptr(planes_count));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    *planes_count = plan->planes.size();
+    return DSP_SUCCESS;
+}
+
+dsp_status dsp_release_plan(dsp_plan plan)
+{
+    if (!plan) {
+        LOGGER__ERROR("Error: plan is NULL\n");
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    delete plan;
+    return DSP_SUCCESS;
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2017-2024 Hailo Technologies Ltd. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "aligned_uptr.hpp"
+#include "buffer_list.hpp"
+#include "hailo/hailodsp.h"
+#include "logger_macros.hpp"
+#include "send_command.hpp"
+#include "user_dsp_interface.h"
+
+#include <utility>
+#include <vector>
+
+typedef struct {
+    dsp_memory_type_t memory;
+    size_t bytesperline;
+    size_t bytesused;
+} plan_plane_t;
+
+struct _dsp_plan {
+    dsp_device device;
+    unique_ptr_aligned<imaging_request_t> request;
+    // Operation data that the request references through the buffer list (e.g. chained requests)
+    unique_ptr_aligned<uint8_t> payload;
+    BufferList buffer_list;
+    // Copy of buffer_list that is sent to the driver, since registered buffers are translated in place
+    BufferList submit_buffer_list;
+    // Planes of the plan images, in the order they are passed to dsp_plan_execute
+    std::vector<plan_plane_t> planes;
+    // Pairs of (plane index, buffer index). A plane is referenced once by every chained request
+    std::vector<std::pair<size_t, size_t>> buffer_refs;
+};
+
+dsp_status plan_create_from_command(dsp_device device,
+                                    ImagingCommand &&command,
+                                    const std::vector<const dsp_image_properties_t *> &images,
+                                    dsp_plan *plan);
+
+// Validates and encodes an operation into a new plan. "build" encodes the operation into a command, like for a regular
+// command (possibly as chained requests), and "images" are the user images referenced by the operation, in the order
+// of dsp_plan_execute planes
+template <typename Build>
+dsp_status plan_create_command(dsp_device device,
+                               const std::vector<const dsp_image_properties_t *> &images,
+                               dsp_plan *plan,
+                               Build build)
+{
+    if ((!device) || (!plan)) {
+        LOGGER__ERROR("Error: NULL argument (device={}, plan={})\n", fmt::ptr(device), fmt::ptr(plan));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    ImagingCommand command;
+    auto status = build(command);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    return plan_create_from_command(device, std::move(command), images, plan);
+}
+
+// Same as plan_create_command, for operations that are encoded into a single request
+template <typename Build>
+dsp_status plan_create(dsp_device device,
+                       const std::vector<const dsp_image_properties_t *> &images,
+                       dsp_plan *plan,
+                       Build build)
+{
+    return plan_create_command(device, images, plan, [&](ImagingCommand &command) {
+        return build(command.request.get(), command.buffer_list);
+    });
+}
@@ -0,0 +1,952 @@
+/*
+ * Copyright (c) 2017-2024 Hailo Technologies Ltd. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "cmdbuf.hpp"
+#include "device.hpp"
+#include "hailo/hailodsp.h"
+#include "hailodsp_driver.hpp"
+#include "image_utils.hpp"
+#include "job.hpp"
+#include "logger_macros.hpp"
+#include "plan.hpp"
+#include "privacy_mask.hpp"
+#include "resize_perf.h"
+#include "send_command.hpp"
+#include "user_dsp_interface.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <utils.h>
+#include <vector>
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+static_assert(DSP_PRIVACY_MASK_MAX_ROIS == MAX_PRIVACY_MASK_ROIS);
+
+// Above this count, ROIs are first merged in pairs of raster order neighbours, since the least-area merge is cubic
+#define MAX_LEAST_AREA_MERGE_ROIS (64)
+
+// Number of pixels packed into a bitmask byte along a line
+#define PIXELS_PER_BITMASK_BYTE (PRIVACY_MASK_QUANTIZATION * 8)
+
+typedef struct {
+    // Bytes per line that hold bits of the image
+    size_t width;
+    size_t height;
+    size_t stride;
+    // Bits per line that cover the image. The bits of the last byte beyond them are padding
+    size_t columns;
+} bitmask_layout_t;
+
+static bitmask_layout_t get_bitmask_layout(size_t image_width, size_t image_height)
+{
+    // Same layout as the one sent by the privacy mask operations
+    size_t width = DIV_ROUND_UP(image_width, PIXELS_PER_BITMASK_BYTE);
+    return bitmask_layout_t{
+        .width = width,
+        .height = DIV_ROUND_UP(image_height, PRIVACY_MASK_QUANTIZATION),
+        .stride = ROUND_UP(width, 8),
+        .columns = DIV_ROUND_UP(image_width, PRIVACY_MASK_QUANTIZATION),
+    };
+}
+
+static size_t roi_area(const dsp_roi_t &roi)
+{
+    return (roi.end_x - roi.start_x) * (roi.end_y - roi.start_y);
+}
+
+static dsp_roi_t bounding_box(const dsp_roi_t &a, const dsp_roi_t &b)
+{
+    return dsp_roi_t{
+        .start_x = std::min(a.start_x, b.start_x),
+        .start_y = std::min(a.start_y, b.start_y),
+        .end_x = std::max(a.end_x, b.end_x),
+        .end_y = std::max(a.end_y, b.end_y),
+    };
+}
+
+// Merges ROIs into their bounding boxes until at most "max_count" ROIs remain, choosing each time the merge that adds
+// the least area
+static void merge_rois(std::vector<dsp_roi_t> &rois, size_t max_count)
+{
+    while (rois.size() > MAX(max_count, (size_t)MAX_LEAST_AREA_MERGE_ROIS)) {
+        std::sort(rois.begin(), rois.end(), [](const dsp_roi_t &a, const dsp_roi_t &b) {
+            return (a.start_y != b.start_y) ? (a.start_y < b.start_y) : (a.start_x < b.start_x);
+        });
+        for (size_t i = 0; i < rois.size() / 2; ++i) {
+            rois[i] = bounding_box(rois[2 * i], rois[2 * i + 1]);
+        }
+        if (rois.size() % 2) {
+            rois[rois.size() / 2] = rois.back();
+        }
+        rois.resize(DIV_ROUND_UP(rois.size(), 2));
+    }
+
+    while (rois.size() > max_count) {
+        size_t best_i = 0;
+        size_t best_j = 1;
+        int64_t best_cost = INT64_MAX;
+        for (size_t i = 0; i < rois.size(); ++i) {
+            for (size_t j = i + 1; j < rois.size(); ++j) {
+                int64_t cost = static_cast<int64_t>(roi_area(bounding_box(rois[i], rois[j]))) -
+                               static_cast<int64_t>(roi_area(rois[i])) - static_cast<int64_t>(roi_area(rois[j]));
+                if (cost < best_cost) {
+                    best_cost = cost;
+                    best_i = i;
+                    best_j = j;
+                }
+            }
+        }
+
+        rois[best_i] = bounding_box(rois[best_i], rois[best_j]);
+        rois.erase(rois.begin() + best_j);
+    }
+}
+
+// The ROIs only limit the area in which the DSP looks for set bitmask bits, so ROIs beyond the limit of a single
+// request are merged into bounding boxes
+static size_t merge_privacy_mask_rois(const dsp_roi_t rois[],
+                                      size_t rois_count,
+                                      roi_in_data_t merged[MAX_PRIVACY_MASK_ROIS])
+{
+    std::vector<dsp_roi_t> boxes(rois, rois + rois_count);
+    merge_rois(boxes, MAX_PRIVACY_MASK_ROIS);
+    std::transform(boxes.begin(), boxes.end(), merged, [](const dsp_roi_t &roi) {
+        return roi_in_data_t{
+            .start_x = static_cast<uint32_t>(roi.start_x),
+            .start_y = static_cast<uint32_t>(roi.start_y),
+            .end_x = static_cast<uint32_t>(roi.end_x),
+            .end_y = static_cast<uint32_t>(roi.end_y),
+        };
+    });
+    return boxes.size();
+}
+
+dsp_status verify_privacy_mask_params(const dsp_image_properties_t *image,
+                                      const dsp_privacy_mask_t *privacy_mask_params)
+{
+    // privacy mask is optional
+    if (!privacy_mask_params) {
+        return DSP_SUCCESS;
+    }
+
+    if (!image || !privacy_mask_params->bitmask) {
+        LOGGER__ERROR("Error: NULL argument (image={}, privacy_mask_params->bitmask={})\n", fmt::ptr(image),
+                      fmt::ptr(privacy_mask_params->bitmask));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    if (privacy_mask_params->rois_count == 0) {
+        LOGGER__ERROR("Error: Must have at least 1 ROI\n");
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    for (size_t i = 0; i < privacy_mask_params->rois_count; ++i) {
+        dsp_roi_t *roi_params = &privacy_mask_params->rois[i];
+        bool invalid_roi = false;
+
+        if (roi_params->start_x >= roi_params->end_x) {
+            LOGGER__ERROR("Error: ROI start_x ({}) must be smaller then end_x ({})\n", roi_params->start_x,
+                          roi_params->end_x);
+            invalid_roi = true;
+        }
+
+        if (roi_params->start_y >= roi_params->end_y) {
+            LOGGER__ERROR("Error: ROI start_y ({}) must be smaller then end_y ({})\n", roi_params->start_y,
+                          roi_params->end_y);
+            invalid_roi = true;
+        }
+
+        const size_t bitmask_width = ceil(image->width / (float)PRIVACY_MASK_QUANTIZATION);
+        if (roi_params->end_x > bitmask_width) {
+            LOGGER__ERROR("Error: ROI end_x ({}) must be smaller or equal to quantized bitmask width ({})\n",
+                          roi_params->end_x, bitmask_width);
+            invalid_roi = true;
+        }
+
+        const size_t bitmask_height = ceil(image->height / (float)PRIVACY_MASK_QUANTIZATION);
+        if (roi_params->end_y > bitmask_height) {
+            LOGGER__ERROR("Error: ROI end_y ({}) must be smaller or equal to quantized bitmask height ({})\n",
+                          roi_params->end_y, bitmask_height);
+            invalid_roi = true;
+        }
+
+        if (invalid_roi) {
+            LOGGER__ERROR("Error: ROI properties check failed for \"roi[{}]\"\n", i);
+            return DSP_INVALID_ARGUMENT;
+        }
+    }
+
+    return DSP_SUCCESS;
+}
+
+dsp_status build_privacy_mask_in_data(const dsp_image_properties_t *image,
+                                      const dsp_privacy_mask_t *privacy_mask_params,
+                                      privacy_mask_in_data_t &privacy_mask,
+                                      BufferList &buffer_list)
+{
+    auto layout = get_bitmask_layout(image->width, image->height);
+    privacy_mask.bitmask.line_stride = layout.stride;
+    privacy_mask.bitmask.plane_size = layout.stride * layout.height;
+    auto status = buffer_list.add_buffer(privacy_mask_params->bitmask, layout.stride * layout.height,
+                                         BufferAccessType::Read, privacy_mask.bitmask.xrp_buffer_index);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    privacy_mask.y_color = privacy_mask_params->y_color;
+    privacy_mask.u_color = privacy_mask_params->u_color;
+    privacy_mask.v_color = privacy_mask_params->v_color;
+
+    privacy_mask.rois_count =
+        merge_privacy_mask_rois(privacy_mask_params->rois, privacy_mask_params->rois_count, privacy_mask.rois);
+    return DSP_SUCCESS;
+}
+
+static bool bitmask_bit(const uint8_t *line, size_t x)
+{
+    return (line[x / 8] >> (x % 8)) & 1;
+}
+
+// Sets bits [start_x, end_x) of a bitmask line
+static void set_bitmask_bits(uint8_t *line, size_t start_x, size_t end_x)
+{
+    for (size_t x = start_x; x < end_x;) {
+        if ((x % 8 == 0) && (x + 8 <= end_x)) {
+            line[x / 8] = 0xff;
+            x += 8;
+        } else {
+            line[x / 8] |= 1 << (x % 8);
+            x++;
+        }
+    }
+}
+
+// Computes the bounding boxes of the 8-connected regions of set bits, by labeling the runs of set bits in each line
+static std::vector<dsp_roi_t> find_bitmask_regions(const uint8_t *bitmask, const bitmask_layout_t &layout)
+{
+    typedef struct {
+        size_t start_x;
+        size_t end_x;
+        size_t label;
+    } run_t;
+
+    std::vector<size_t> parents;
+    std::vector<dsp_roi_t> boxes;
+    auto find_root = [&parents](size_t label) {
+        while (parents[label] != label) {
+            parents[label] = parents[parents[label]];
+            label = parents[label];
+        }
+        return label;
+    };
+
+    // Padding bits may be set in bitmasks written by the application, and must not extend the regions
+    size_t width = layout.columns;
+    std::vector<run_t> previous_runs;
+    std::vector<run_t> runs;
+    for (size_t y = 0; y < layout.height; ++y) {
+        const uint8_t *line = bitmask + y * layout.stride;
+        runs.clear();
+        for (size_t x = 0; x < width;) {
+            uint64_t word = 0;
+            if ((x % 64 == 0) && (x + 64 <= width)) {
+                memcpy(&word, &line[x / 8], sizeof(word));
+                if (word == 0) {
+                    x += 64;
+                    continue;
+                }
+            }
+            if (!bitmask_bit(line, x)) {
+                x++;
+                continue;
+            }
+
+            size_t start_x = x;
+            while ((x < width) && bitmask_bit(line, x)) {
+                x++;
+            }
+            runs.push_back(run_t{.start_x = start_x, .end_x = x, .label = SIZE_MAX});
+        }
+
+        // Both run lists are sorted, so every run is compared only with the runs of the previous line around it
+        size_t first_previous = 0;
+        for (auto &run : runs) {
+            while ((first_previous < previous_runs.size()) && (previous_runs[first_previous].end_x < run.start_x)) {
+                first_previous++;
+            }
+            for (size_t i = first_previous; (i < previous_runs.size()) && (previous_runs[i].start_x <= run.end_x);
+                 ++i) {
+                size_t root = find_root(previous_runs[i].label);
+                if (run.label == SIZE_MAX) {
+                    run.label = root;
+                } else if (root != run.label) {
+                    parents[root] = run.label;
+                    boxes[run.label] = bounding_box(boxes[run.label], boxes[root]);
+                }
+            }
+
+            dsp_roi_t run_box = {.start_x = run.start_x, .start_y = y, .end_x = run.end_x, .end_y = y + 1};
+            if (run.label == SIZE_MAX) {
+                run.label = parents.size();
+                parents.push_back(run.label);
+                boxes.push_back(run_box);
+            } else {
+                boxes[run.label] = bounding_box(boxes[run.label], run_box);
+            }
+        }
+
+        std::swap(runs, previous_runs);
+    }
+
+    std::vector<dsp_roi_t> regions;
+    for (size_t label = 0; label < parents.size(); ++label) {
+        if (parents[label] == label) {
+            regions.push_back(boxes[label]);
+        }
+    }
+
+    return regions;
+}
+
+static void build_rois(const uint8_t *bitmask, const bitmask_layout_t &layout, dsp_roi_t rois[], size_t *rois_count)
+{
+    auto regions = find_bitmask_regions(bitmask, layout);
+    merge_rois(regions, DSP_PRIVACY_MASK_MAX_ROIS);
+
+    // An empty mask still gets an ROI, since the privacy mask operations require at least one
+    if (regions.empty()) {
+        regions.push_back(dsp_roi_t{.start_x = 0, .start_y = 0, .end_x = 1, .end_y = 1});
+    }
+
+    std::copy(regions.begin(), regions.end(), rois);
+    *rois_count = regions.size();
+}
+
+static dsp_status verify_bitmask_params(size_t image_width,
+                                        size_t image_height,
+                                        uint8_t *bitmask,
+                                        size_t bitmask_size,
+                                        dsp_roi_t rois[],
+                                        size_t *rois_count)
+{
+    if (!bitmask || !rois || !rois_count) {
+        LOGGER__ERROR("Error: NULL argument (bitmask={}, rois={}, rois_count={})\n", fmt::ptr(bitmask), fmt::ptr(rois),
+                      fmt::ptr(rois_count));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    if ((image_width == 0) || (image_height == 0)) {
+        LOGGER__ERROR("Error: Invalid image size ({}x{})\n", image_width, image_height);
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    auto layout = get_bitmask_layout(image_width, image_height);
+    if (bitmask_size < layout.stride * layout.height) {
+        LOGGER__ERROR("Error: Bitmask size ({}) is smaller than the required size ({})\n", bitmask_size,
+                      layout.stride * layout.height);
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    return DSP_SUCCESS;
+}
+
+dsp_status dsp_privacy_mask_get_bitmask_size(size_t image_width, size_t image_height, size_t *bitmask_size)
+{
+    if (!bitmask_size) {
+        LOGGER__ERROR("Error: NULL argument (bitmask_size={})\n", fmt::ptr(bitmask_size));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    auto layout = get_bitmask_layout(image_width, image_height);
+    *bitmask_size = layout.stride * layout.height;
+    return DSP_SUCCESS;
+}
+
+/*
+ * Polygons
+ */
+
+static dsp_status verify_polygons(const dsp_polygon_t polygons[], size_t polygons_count)
+{
+    if (!polygons && (polygons_count > 0)) {
+        LOGGER__ERROR("Error: NULL argument (polygons={})\n", fmt::ptr(polygons));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    for (size_t i = 0; i < polygons_count; ++i) {
+        if (!polygons[i].points || (polygons[i].points_count < 3)) {
+            LOGGER__ERROR("Error: Invalid polygon (points={}, points_count={}) in \"polygons[{}]\"\n",
+                          fmt::ptr(polygons[i].points), polygons[i].points_count, i);
+            return DSP_INVALID_ARGUMENT;
+        }
+    }
+
+    return DSP_SUCCESS;
+}
+
+// Sets the bits of every bitmask cell that contains the center of a pixel inside the polygon
+static void rasterize_polygon(const dsp_polygon_t &polygon,
+                              size_t image_width,
+                              size_t image_height,
+                              uint8_t *bitmask,
+                              const bitmask_layout_t &layout,
+                              std::vector<double> &crossings)
+{
+    auto points = polygon.points;
+    auto [min_point, max_point] = std::minmax_element(
+        points, points + polygon.points_count, [](const dsp_point_t &a, const dsp_point_t &b) { return a.y < b.y; });
+    size_t end_y = std::min(max_point->y, image_height);
+
+    for (size_t y = min_point->y; y < end_y; ++y) {
+        double center_y = y + 0.5;
+        crossings.clear();
+        for (size_t i = 0; i < polygon.points_count; ++i) {
+            const auto &p0 = points[i];
+            const auto &p1 = points[(i + 1) % polygon.points_count];
+            if ((center_y < std::min(p0.y, p1.y)) || (center_y >= std::max(p0.y, p1.y))) {
+                continue;
+            }
+
+            double t = (center_y - p0.y) / ((double)p1.y - p0.y);
+            crossings.push_back(p0.x + t * ((double)p1.x - p0.x));
+        }
+
+        // Even-odd rule: the pixels between every pair of crossings are inside the polygon
+        std::sort(crossings.begin(), crossings.end());
+        uint8_t *line = bitmask + (y / PRIVACY_MASK_QUANTIZATION) * layout.stride;
+        for (size_t i = 0; i + 1 < crossings.size(); i += 2) {
+            double first_x = std::max(std::ceil(crossings[i] - 0.5), 0.0);
+            double end_x = std::min(std::ceil(crossings[i + 1] - 0.5), (double)image_width);
+            if (first_x >= end_x) {
+                continue;
+            }
+
+            size_t last_x = static_cast<size_t>(end_x) - 1;
+            set_bitmask_bits(line, static_cast<size_t>(first_x) / PRIVACY_MASK_QUANTIZATION,
+                             last_x / PRIVACY_MASK_QUANTIZATION + 1);
+        }
+    }
+}
+
+// Writes the whole bitmask, including the line padding
+static void rasterize_polygons(const dsp_polygon_t polygons[],
+                               size_t polygons_count,
+                               size_t image_width,
+                               size_t image_height,
+                               uint8_t *bitmask,
+                               const bitmask_layout_t &layout)
+{
+    memset(bitmask, 0, layout.stride * layout.height);
+
+    std::vector<double> crossings;
+    for (size_t i = 0; i < polygons_count; ++i) {
+        rasterize_polygon(polygons[i], image_width, image_height, bitmask, layout, crossings);
+    }
+}
+
+dsp_status dsp_privacy_mask_build_from_polygons(size_t image_width,
+                                                size_t image_height,
+                                                const dsp_polygon_t polygons[],
+                                                size_t polygons_count,
+                                                uint8_t *bitmask,
+                                                size_t bitmask_size,
+                                                dsp_roi_t rois[DSP_PRIVACY_MASK_MAX_ROIS],
+                                                size_t *rois_count)
+{
+    auto status = verify_bitmask_params(image_width, image_height, bitmask, bitmask_size, rois, rois_count);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    status = verify_polygons(polygons, polygons_count);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    auto layout = get_bitmask_layout(image_width, image_height);
+    rasterize_polygons(polygons, polygons_count, image_width, image_height, bitmask, layout);
+    build_rois(bitmask, layout, rois, rois_count);
+    return DSP_SUCCESS;
+}
+
+/*
+ * Per-pixel masks
+ */
+
+// Packs PIXELS_PER_BITMASK_BYTE pixels of up to PRIVACY_MASK_QUANTIZATION lines into a bitmask byte. Bit i is set
+// when any of the pixels of cell i (4 consecutive bytes in each line) is not 0
+static uint8_t pack_bitmask_byte(const uint8_t *lines[], size_t lines_count, size_t x)
+{
+#if defined(__aarch64__)
+    uint8x16_t low = vld1q_u8(lines[0] + x);
+    uint8x16_t high = vld1q_u8(lines[0] + x + 16);
+    for (size_t i = 1; i < lines_count; ++i) {
+        low = vorrq_u8(low, vld1q_u8(lines[i] + x));
+        high = vorrq_u8(high, vld1q_u8(lines[i] + x + 16));
+    }
+
+    // Every 32 bit lane is a cell. Non-zero lanes become all ones, and are reduced to their bit weights
+    const uint32x4_t weights = {1, 2, 4, 8};
+    uint32x4_t low_cells = vtstq_u32(vreinterpretq_u32_u8(low), vreinterpretq_u32_u8(low));
+    uint32x4_t high_cells = vtstq_u32(vreinterpretq_u32_u8(high), vreinterpretq_u32_u8(high));
+    return static_cast<uint8_t>(vaddvq_u32(vandq_u32(low_cells, weights)) |
+                                (vaddvq_u32(vandq_u32(high_cells, weights)) << 4));
+#elif defined(__SSE2__)
+    __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i *>(lines[0] + x));
+    __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i *>(lines[0] + x + 16));
+    for (size_t i = 1; i < lines_count; ++i) {
+        low = _mm_or_si128(low, _mm_loadu_si128(reinterpret_cast<const __m128i *>(lines[i] + x)));
+        high = _mm_or_si128(high, _mm_loadu_si128(reinterpret_cast<const __m128i *>(lines[i] + x + 16)));
+    }
+
+    // Every 32 bit lane is a cell. The sign bits of the zero lanes are gathered, and inverted
+    const __m128i zero = _mm_setzero_si128();
+    int low_zero_cells = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(low, zero)));
+    int high_zero_cells = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(high, zero)));
+    return static_cast<uint8_t>(~(low_zero_cells | (high_zero_cells << 4)));
+#else
+    uint32_t cells[8];
+    memcpy(cells, lines[0] + x, sizeof(cells));
+    for (size_t i = 1; i < lines_count; ++i) {
+        uint32_t line_cells[8];
+        memcpy(line_cells, lines[i] + x, sizeof(line_cells));
+        for (size_t cell = 0; cell < 8; ++cell) {
+            cells[cell] |= line_cells[cell];
+        }
+    }
+
+    uint8_t bits = 0;
+    for (size_t cell = 0; cell < 8; ++cell) {
+        bits |= (cells[cell] != 0) << cell;
+    }
+    return bits;
+#endif
+}
+
+// Same as pack_bitmask_byte, for the last byte of a line, which may cover less than PIXELS_PER_BITMASK_BYTE pixels
+static uint8_t pack_partial_bitmask_byte(const uint8_t *lines[], size_t lines_count, size_t x, size_t width)
+{
+    uint8_t bits = 0;
+    for (size_t i = 0; i < lines_count; ++i) {
+        for (size_t pixel_x = x; pixel_x < width; ++pixel_x) {
+            if (lines[i][pixel_x]) {
+                bits |= 1 << ((pixel_x - x) / PRIVACY_MASK_QUANTIZATION);
+            }
+        }
+    }
+    return bits;
+}
+
+static dsp_status verify_mask_image(const dsp_image_properties_t *mask)
+{
+    auto status = verify_image_properties(mask);
+    if (status != DSP_SUCCESS) {
+        LOGGER__ERROR("Error: Image properties check failed for \"mask\"\n");
+        return status;
+    }
+
+    if ((mask->format != DSP_IMAGE_FORMAT_GRAY8) || (mask->memory != DSP_MEMORY_TYPE_USERPTR)) {
+        LOGGER__ERROR("Error: Mask format ({}) or memory type ({}) is not supported\n",
+                      format_arg_to_string(mask->format), mask->memory);
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    return DSP_SUCCESS;
+}
+
+// Writes the whole bitmask, including the line padding
+static void pack_mask(const dsp_image_properties_t *mask, uint8_t *bitmask, const bitmask_layout_t &layout)
+{
+    auto mask_data = static_cast<const uint8_t *>(mask->planes[0].userptr);
+    size_t full_bytes = mask->width / PIXELS_PER_BITMASK_BYTE;
+    for (size_t y = 0; y < layout.height; ++y) {
+        const uint8_t *lines[PRIVACY_MASK_QUANTIZATION];
+        size_t lines_count = MIN((size_t)PRIVACY_MASK_QUANTIZATION, mask->height - y * PRIVACY_MASK_QUANTIZATION);
+        for (size_t i = 0; i < lines_count; ++i) {
+            lines[i] = mask_data + (y * PRIVACY_MASK_QUANTIZATION + i) * mask->planes[0].bytesperline;
+        }
+
+        uint8_t *line = bitmask + y * layout.stride;
+        for (size_t i = 0; i < full_bytes; ++i) {
+            line[i] = pack_bitmask_byte(lines, lines_count, i * PIXELS_PER_BITMASK_BYTE);
+        }
+        if (full_bytes < layout.width) {
+            line[full_bytes] =
+                pack_partial_bitmask_byte(lines, lines_count, full_bytes * PIXELS_PER_BITMASK_BYTE, mask->width);
+        }
+        memset(line + layout.width, 0, layout.stride - layout.width);
+    }
+}
+
+dsp_status dsp_privacy_mask_build_from_mask(const dsp_image_properties_t *mask,
+                                            uint8_t *bitmask,
+                                            size_t bitmask_size,
+                                            dsp_roi_t rois[DSP_PRIVACY_MASK_MAX_ROIS],
+                                            size_t *rois_count)
+{
+    auto status = verify_mask_image(mask);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    status = verify_bitmask_params(mask->width, mask->height, bitmask, bitmask_size, rois, rois_count);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    auto layout = get_bitmask_layout(mask->width, mask->height);
+    pack_mask(mask, bitmask, layout);
+    build_rois(bitmask, layout, rois, rois_count);
+    return DSP_SUCCESS;
+}
+
+/*
+ * Persistent privacy masks
+ */
+
+struct _dsp_privacy_mask {
+    dsp_device device;
+    size_t image_width;
+    size_t image_height;
+    bitmask_layout_t layout;
+    // DSP buffer, registered so that operations reference it by handle. Only written through commit_bitmask
+    uint8_t *bitmask;
+    // Host copy that new masks are built into, and then compared with the DSP copy
+    std::vector<uint8_t> staging;
+    dsp_roi_t rois[DSP_PRIVACY_MASK_MAX_ROIS];
+    size_t rois_count;
+    uint8_t y_color;
+    uint8_t u_color;
+    uint8_t v_color;
+};
+
+// Copies the lines that differ from the DSP copy of the bitmask. Every range of consecutive dirty lines is written
+// between its own cache synchronization, so an unchanged mask costs a comparison only
+static dsp_status commit_bitmask(dsp_privacy_mask privacy_mask, const uint8_t *bitmask)
+{
+    auto &driver = *privacy_mask->device->driver;
+    size_t stride = privacy_mask->layout.stride;
+    size_t height = privacy_mask->layout.height;
+    for (size_t y = 0; y < height;) {
+        if (memcmp(privacy_mask->bitmask + y * stride, bitmask + y * stride, stride) == 0) {
+            y++;
+            continue;
+        }
+
+        size_t start_y = y;
+        while ((y < height) && (memcmp(privacy_mask->bitmask + y * stride, bitmask + y * stride, stride) != 0)) {
+            y++;
+        }
+
+        uint8_t *dirty = privacy_mask->bitmask + start_y * stride;
+        size_t dirty_size = (y - start_y) * stride;
+        auto status = driver_sync_buffer_start(driver, dirty, dirty_size, DSP_BUFFER_SYNC_WRITE);
+        if (status != DSP_SUCCESS) {
+            return status;
+        }
+
+        memcpy(dirty, bitmask + start_y * stride, dirty_size);
+
+        status = driver_sync_buffer_end(driver, dirty, dirty_size, DSP_BUFFER_SYNC_WRITE);
+        if (status != DSP_SUCCESS) {
+            return status;
+        }
+    }
+
+    build_rois(privacy_mask->bitmask, privacy_mask->layout, privacy_mask->rois, &privacy_mask->rois_count);
+    return DSP_SUCCESS;
+}
+
+dsp_status dsp_create_privacy_mask(dsp_device device,
+                                   size_t image_width,
+                                   size_t image_height,
+                                   uint8_t y_color,
+                                   uint8_t u_color,
+                                   uint8_t v_color,
+                                   dsp_privacy_mask *privacy_mask)
+{
+    if ((!device) || (!privacy_mask)) {
+        LOGGER__ERROR("Error: NULL argument (device={}, privacy_mask={})\n", fmt::ptr(device),
+                      fmt::ptr(privacy_mask));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    if ((image_width == 0) || (image_height == 0)) {
+        LOGGER__ERROR("Error: Invalid image size ({}x{})\n", image_width, image_height);
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    auto layout = get_bitmask_layout(image_width, image_height);
+    size_t bitmask_size = layout.stride * layout.height;
+    auto local_mask = std::unique_ptr<_dsp_privacy_mask>(new (std::nothrow) _dsp_privacy_mask{
+        .device = device,
+        .image_width = image_width,
+        .image_height = image_height,
+        .layout = layout,
+        .bitmask = nullptr,
+        .staging = std::vector<uint8_t>(bitmask_size),
+        .rois = {},
+        .rois_count = 0,
+        .y_color = y_color,
+        .u_color = u_color,
+        .v_color = v_color,
+    });
+    if (!local_mask) {
+        LOGGER__ERROR("Failed to allocate memory for privacy mask");
+        return DSP_OUT_OF_HOST_MEMORY;
+    }
+
+    void *bitmask;
+    auto status = dsp_create_buffer(device, bitmask_size, &bitmask);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    // Pinned once, so the driver does not map the bitmask again on every operation
+    status = dsp_register_buffer(device, bitmask, bitmask_size);
+    if (status != DSP_SUCCESS) {
+        (void)dsp_release_buffer(device, bitmask);
+        return status;
+    }
+
+    local_mask->bitmask = static_cast<uint8_t *>(bitmask);
+    status = driver_sync_buffer_start(*device->driver, bitmask, bitmask_size, DSP_BUFFER_SYNC_WRITE);
+    if (status == DSP_SUCCESS) {
+        memset(bitmask, 0, bitmask_size);
+        status = driver_sync_buffer_end(*device->driver, bitmask, bitmask_size, DSP_BUFFER_SYNC_WRITE);
+    }
+    if (status != DSP_SUCCESS) {
+        (void)dsp_release_privacy_mask(local_mask.release());
+        return status;
+    }
+
+    build_rois(local_mask->bitmask, local_mask->layout, local_mask->rois, &local_mask->rois_count);
+    *privacy_mask = local_mask.release();
+    return DSP_SUCCESS;
+}
+
+dsp_status dsp_release_privacy_mask(dsp_privacy_mask privacy_mask)
+{
+    if (!privacy_mask) {
+        LOGGER__ERROR("Error: privacy_mask is NULL\n");
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    if (privacy_mask->bitmask) {
+        (void)dsp_unregister_buffer(privacy_mask->device, privacy_mask->bitmask);
+        (void)dsp_release_buffer(privacy_mask->device, privacy_mask->bitmask);
+    }
+
+    delete privacy_mask;
+    return DSP_SUCCESS;
+}
+
+dsp_status dsp_privacy_mask_update_polygons(dsp_privacy_mask privacy_mask,
+                                            const dsp_polygon_t polygons[],
+                                            size_t polygons_count)
+{
+    if (!privacy_mask) {
+        LOGGER__ERROR("Error: privacy_mask is NULL\n");
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    auto status = verify_polygons(polygons, polygons_count);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    auto staging = privacy_mask->staging.data();
+    rasterize_polygons(polygons, polygons_count, privacy_mask->image_width, privacy_mask->image_height, staging,
+                       privacy_mask->layout);
+    return commit_bitmask(privacy_mask, staging);
+}
+
+dsp_status dsp_privacy_mask_update_mask(dsp_privacy_mask privacy_mask, const dsp_image_properties_t *mask)
+{
+    if (!privacy_mask) {
+        LOGGER__ERROR("Error: privacy_mask is NULL\n");
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    auto status = verify_mask_image(mask);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    if ((mask->width != privacy_mask->image_width) || (mask->height != privacy_mask->image_height)) {
+        LOGGER__ERROR("Error: Mask size ({}x{}) differs from the privacy mask image size ({}x{})\n", mask->width,
+                      mask->height, privacy_mask->image_width, privacy_mask->image_height);
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    auto staging = privacy_mask->staging.data();
+    pack_mask(mask, staging, privacy_mask->layout);
+    return commit_bitmask(privacy_mask, staging);
+}
+
+dsp_status dsp_privacy_mask_update_bitmask(dsp_privacy_mask privacy_mask, const uint8_t *bitmask)
+{
+    if ((!privacy_mask) || (!bitmask)) {
+        LOGGER__ERROR("Error: NULL argument (privacy_mask={}, bitmask={})\n", fmt::ptr(privacy_mask),
+                      fmt::ptr(bitmask));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    return commit_bitmask(privacy_mask, bitmask);
+}
+
+dsp_status dsp_privacy_mask_get_params(dsp_privacy_mask privacy_mask, dsp_privacy_mask_t *params)
+{
+    if ((!privacy_mask) || (!params)) {
+        LOGGER__ERROR("Error: NULL argument (privacy_mask={}, params={})\n", fmt::ptr(privacy_mask),
+                      fmt::ptr(params));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    *params = dsp_privacy_mask_t{
+        .bitmask = privacy_mask->bitmask,
+        .y_color = privacy_mask->y_color,
+        .u_color = privacy_mask->u_color,
+        .v_color = privacy_mask->v_color,
+        .rois = privacy_mask->rois,
+        .rois_count = privacy_mask->rois_count,
+    };
+    return DSP_SUCCESS;
+}
+
+static dsp_status build_privacy_mask_command(const dsp_image_properties_t *image,
+                                             const dsp_privacy_mask_t *privacy_mask_params,
+                                             imaging_request_t *in_data,
+                                             BufferList &buffer_list)
+{
+    auto status = verify_image_properties(image);
+    if (status != DSP_SUCCESS) {
+        LOGGER__ERROR("Error: Image properties check failed for \"image\"\n");
+        return status;
+    }
+
+    // The privacy mask colors are YUV, and are painted on the NV12 planes of the image
+    if (image->format != DSP_IMAGE_FORMAT_NV12) {
+        LOGGER__ERROR("Error: Image format ({}) is not supported\n", format_arg_to_string(image->format));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    status = verify_privacy_mask_params(image, privacy_mask_params);
+    if (status != DSP_SUCCESS) {
+        LOGGER__ERROR("Error: Privacy mask parameters check failed\n");
+        return status;
+    }
+
+    in_data->operation = IMAGING_OP_PRIVACY_MASK;
+
+    command_image_t images[] = {{image, &in_data->privacy_mask_args.image, BufferAccessType::ReadWrite}};
+    status = add_images_to_buffer_list(buffer_list, images);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    return build_privacy_mask_in_data(image, privacy_mask_params, in_data->privacy_mask_args.privacy_mask,
+                                      buffer_list);
+}
+
+dsp_status dsp_apply_privacy_mask(dsp_device device,
+                                  dsp_image_properties_t *image,
+                                  const dsp_privacy_mask_t *privacy_mask_params)
+{
+    if ((!device) || (!image) || (!privacy_mask_params)) {
+        LOGGER__ERROR("Error: NULL argument (device={}, image={}, privacy_mask_params={})\n", fmt::ptr(device),
+                      fmt::ptr(image), fmt::ptr(privacy_mask_params));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    ImagingCommand command;
+    auto status = build_privacy_mask_command(image, privacy_mask_params, command.request.get(), command.buffer_list);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    status = send_command(device, command, NULL);
+    if (status != DSP_SUCCESS) {
+        LOGGER__ERROR("Error: Failed executing privacy mask operation. Error code: {}\n", status);
+    }
+
+    return status;
+}
+
+dsp_status dsp_apply_privacy_mask_async(dsp_device device,
+                                        dsp_image_properties_t *image,
+                                        const dsp_privacy_mask_t *privacy_mask_params,
+                                        dsp_job *job)
+{
+    if ((!device) || (!image) || (!privacy_mask_params) || (!job)) {
+        LOGGER__ERROR("Error: NULL argument (device={}, image={}, privacy_mask_params={}, job={})\n",
+                      fmt::ptr(device), fmt::ptr(image), fmt::ptr(privacy_mask_params), fmt::ptr(job));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    ImagingCommand command;
+    auto status = build_privacy_mask_command(image, privacy_mask_params, command.request.get(), command.buffer_list);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    return submit_command_async(device, std::move(command), NULL, job);
+}
+
+dsp_status dsp_cmdbuf_record_apply_privacy_mask(dsp_cmdbuf cmdbuf,
+                                                dsp_image_properties_t *image,
+                                                const dsp_privacy_mask_t *privacy_mask_params)
+{
+    if ((!cmdbuf) || (!image) || (!privacy_mask_params)) {
+        LOGGER__ERROR("Error: NULL argument (cmdbuf={}, image={}, privacy_mask_params={})\n", fmt::ptr(cmdbuf),
+                      fmt::ptr(image), fmt::ptr(privacy_mask_params));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    return cmdbuf_record(cmdbuf, {image}, [&](imaging_request_t *request, BufferList &buffer_list) {
+        return build_privacy_mask_command(image, privacy_mask_params, request, buffer_list);
+    });
+}
+
+dsp_status dsp_plan_create_apply_privacy_mask(dsp_device device,
+                                              dsp_image_properties_t *image,
+                                              const dsp_privacy_mask_t *privacy_mask_params,
+                                              dsp_plan *plan)
+{
+    if ((!image) || (!privacy_mask_params)) {
+        LOGGER__ERROR("Error: NULL argument (image={}, privacy_mask_params={})\n", fmt::ptr(image),
+                      fmt::ptr(privacy_mask_params));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    return plan_create(device, {image}, plan, [&](imaging_request_t *request, BufferList &buffer_list) {
+        return build_privacy_mask_command(image, privacy_mask_params, request, buffer_list);
+    });
+}
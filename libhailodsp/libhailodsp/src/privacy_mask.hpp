@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2017-2024 Hailo Technologies Ltd. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "buffer_list.hpp"
+#include "hailo/hailodsp.h"
+#include "user_dsp_interface.h"
+
+// A NULL "privacy_mask_params" is valid, since the privacy mask is optional. This function assumes that "image"
+// params is already checked for correctness
+dsp_status verify_privacy_mask_params(const dsp_image_properties_t *image,
+                                      const dsp_privacy_mask_t *privacy_mask_params);
+// Encodes verified privacy mask parameters of "image". ROIs beyond MAX_PRIVACY_MASK_ROIS are merged
+dsp_status build_privacy_mask_in_data(const dsp_image_properties_t *image,
+                                      const dsp_privacy_mask_t *privacy_mask_params,
+                                      privacy_mask_in_data_t &privacy_mask,
+                                      BufferList &buffer_list);
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2017-2024 Hailo Technologies Ltd. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "request_pool.hpp"
+
+#include <array>
+#include <cstdlib>
+#include <mutex>
+
+#include <unistd.h>
+
+// Enough for the requests in flight of a few threads with deep async queues. Requests beyond it are freed
+#define REQUEST_POOL_CAPACITY (64)
+// Requests cached by every thread in front of the shared pool, so that synchronous submission does not touch shared
+// state. Asynchronous requests are released by the worker thread, and circulate through the shared pool
+#define THREAD_REQUEST_CACHE_CAPACITY (8)
+
+namespace {
+struct RequestPool {
+    ~RequestPool()
+    {
+        for (size_t i = 0; i < count; i++) {
+            free(requests[i]);
+        }
+    }
+
+    std::mutex mutex;
+    std::array<void *, REQUEST_POOL_CAPACITY> requests;
+    size_t count = 0;
+};
+
+RequestPool &get_pool()
+{
+    static RequestPool pool;
+    return pool;
+}
+
+struct ThreadRequestCache {
+    ~ThreadRequestCache();
+
+    std::array<void *, THREAD_REQUEST_CACHE_CAPACITY> requests;
+    size_t count = 0;
+};
+
+thread_local ThreadRequestCache thread_cache;
+
+void release_to_pool(void *request)
+{
+    auto &pool = get_pool();
+    {
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        if (pool.count < REQUEST_POOL_CAPACITY) {
+            pool.requests[pool.count++] = request;
+            return;
+        }
+    }
+
+    free(request);
+}
+
+// Hands the cached requests of an exiting thread to the other threads
+ThreadRequestCache::~ThreadRequestCache()
+{
+    for (size_t i = 0; i < count; i++) {
+        release_to_pool(requests[i]);
+    }
+}
+} // namespace
+
+imaging_request_t *acquire_request()
+{
+    if (thread_cache.count > 0) {
+        return static_cast<imaging_request_t *>(thread_cache.requests[--thread_cache.count]);
+    }
+
+    auto &pool = get_pool();
+    {
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        if (pool.count > 0) {
+            return static_cast<imaging_request_t *>(pool.requests[--pool.count]);
+        }
+    }
+
+    // aligned_alloc requires the size to be a multiple of the alignment
+    size_t align = getpagesize();
+    size_t size = ((sizeof(imaging_request_t) + align - 1) / align) * align;
+    host_stats_count_allocation();
+    return static_cast<imaging_request_t *>(aligned_alloc(align, size));
+}
+
+void release_request(void *request) noexcept
+{
+    if (!request) {
+        return;
+    }
+
+    if (thread_cache.count < THREAD_REQUEST_CACHE_CAPACITY) {
+        thread_cache.requests[thread_cache.count++] = request;
+        return;
+    }
+
+    release_to_pool(request);
+}
@@ -21,18 +21,31 @@
  * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
-#include "aligned_uptr.hpp"
+#include "cmdbuf.hpp"
 #include "hailo/hailodsp.h"
 #include "image_utils.hpp"
+#include "inline_vector.hpp"
+#include "job.hpp"
 #include "logger_macros.hpp"
+#include "plan.hpp"
+#include "privacy_mask.hpp"
 #include "resize_perf.h"
 #include "send_command.hpp"
 #include "user_dsp_interface.h"
 
+#include <algorithm>
 #include <cstdio>
 #include <memory>
+#include <vector>
 #include <utils.h>
 
+// Format conversions that the crop&resize operations can perform while resizing
+static bool is_crop_resize_conversion_supported(dsp_image_format_t src_format, dsp_image_format_t dst_format)
+{
+    return ((src_format == DSP_IMAGE_FORMAT_NV12) && (dst_format == DSP_IMAGE_FORMAT_RGB)) ||
+           ((src_format == DSP_IMAGE_FORMAT_RGB) && (dst_format == DSP_IMAGE_FORMAT_NV12));
+}
+
 // This function assumes that "image" params is already checked for correctness
 static dsp_status verify_crop_params(const dsp_image_properties_t *image, const dsp_roi_t *crop_params)
 {
@@ -68,68 +81,157 @@ static dsp_status verify_crop_params(const dsp_image_properties_t *image, const
     return DSP_SUCCESS;
 }
 
-// This function assumes that "image" params is already checked for correctness
-static dsp_status verify_privacy_mask_params(const dsp_image_properties_t *image,
-                                             const dsp_privacy_mask_t *privacy_mask_params)
+static dsp_status verify_crop_and_resize_params(const dsp_image_properties_t *src,
+                                                const dsp_image_properties_t *dst,
+                                                const dsp_roi_t *crop_params,
+                                                dsp_interpolation_type_t interpolation)
 {
-    // privacy mask is optional
-    if (!privacy_mask_params) {
-        return DSP_SUCCESS;
+    auto status = verify_crop_params(src, crop_params);
+    if (status != DSP_SUCCESS) {
+        LOGGER__ERROR("Error: Crop parameters check failed\n");
+        return status;
     }
 
-    if (!image || !privacy_mask_params->bitmask) {
-        LOGGER__ERROR("Error: NULL argument (image={}, privacy_mask_params->bitmask={})\n", fmt::ptr(image),
-                      fmt::ptr(privacy_mask_params->bitmask));
+    dsp_image_properties_t cropped_src = *src;
+    cropped_src.width = crop_params->end_x - crop_params->start_x;
+    cropped_src.height = crop_params->end_y - crop_params->start_y;
+
+    status = verify_image_properties(&cropped_src);
+    if (status != DSP_SUCCESS) {
+        LOGGER__ERROR("Error: Image properties check failed for \"src\" (after crop)\n");
+        return status;
+    }
+
+    status = verify_image_properties(dst);
+    if (status != DSP_SUCCESS) {
+        LOGGER__ERROR("Error: Image properties check failed for \"dst\"\n");
+        return status;
+    }
+
+    if (interpolation >= INTERPOLATION_TYPE_COUNT) {
+        LOGGER__ERROR("Error: Unknown interpolation type {}\n", interpolation);
         return DSP_INVALID_ARGUMENT;
     }
 
-    if (privacy_mask_params->rois_count == 0) {
-        LOGGER__ERROR("Error: Must have at least 1 ROI\n");
+    // Same format GRAY8, RGB or NV12, or a conversion between NV12 and RGB
+    bool convert = (src->format != dst->format);
+    if (convert) {
+        if (!is_crop_resize_conversion_supported(src->format, dst->format)) {
+            LOGGER__ERROR("Error: Conversion from {} to {} is not supported\n", format_arg_to_string(src->format),
+                          format_arg_to_string(dst->format));
+            return DSP_INVALID_ARGUMENT;
+        }
+    } else {
+        switch (src->format) {
+            case DSP_IMAGE_FORMAT_GRAY8:
+            case DSP_IMAGE_FORMAT_RGB:
+            case DSP_IMAGE_FORMAT_NV12:
+                break;
+
+            default:
+                LOGGER__ERROR("Error: The src/dst format ({}) is not supported\n", format_arg_to_string(src->format));
+                return DSP_INVALID_ARGUMENT;
+        }
+    }
+
+    if ((interpolation == INTERPOLATION_TYPE_AREA) &&
+        ((cropped_src.width < dst->width) || (cropped_src.height < dst->height))) {
+        LOGGER__ERROR("Error: Area interpolation does not support upscaling\n");
         return DSP_INVALID_ARGUMENT;
     }
 
-    if (privacy_mask_params->rois_count > MAX_PRIVACY_MASK_ROIS) {
-        LOGGER__ERROR("Error: Too many ROIs. The operation supports up to {} ROIs\n", MAX_PRIVACY_MASK_ROIS);
+    return DSP_SUCCESS;
+}
+
+// A NULL "privacy_mask_params" builds a plain crop&resize. Otherwise the mask is applied to the source before it is
+// resized, without modifying it
+static dsp_status build_crop_and_resize_command(const dsp_resize_params_t *resize_params,
+                                                const dsp_roi_t *crop_params,
+                                                const dsp_privacy_mask_t *privacy_mask_params,
+                                                imaging_request_t *in_data,
+                                                BufferList &buffer_list)
+{
+    auto status = verify_crop_and_resize_params(resize_params->src, resize_params->dst, crop_params,
+                                                resize_params->interpolation);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    status = verify_privacy_mask_params(resize_params->src, privacy_mask_params);
+    if (status != DSP_SUCCESS) {
+        LOGGER__ERROR("Error: Privacy mask parameters check failed\n");
+        return status;
+    }
+
+    auto src_format = resize_params->src->format;
+    if (privacy_mask_params && (src_format != DSP_IMAGE_FORMAT_NV12)) {
+        LOGGER__ERROR("Error: Privacy mask is not supported for src format ({})\n", format_arg_to_string(src_format));
         return DSP_INVALID_ARGUMENT;
     }
 
-    for (size_t i = 0; i < privacy_mask_params->rois_count; ++i) {
-        dsp_roi_t *roi_params = &privacy_mask_params->rois[i];
-        bool invalid_roi = false;
+    bool convert = (src_format != resize_params->dst->format);
+    crop_resize_in_data_t *args;
+    if (privacy_mask_params) {
+        in_data->operation = IMAGING_OP_CROP_RESIZE_PRIVACY_MASK;
+        args = &in_data->crop_resize_privacy_mask_args.resize;
+    } else {
+        in_data->operation = convert ? IMAGING_OP_CROP_RESIZE_CONVERT : IMAGING_OP_CROP_AND_RESIZE;
+        args = &in_data->crop_and_resize_args;
+    }
 
-        if (roi_params->start_x >= roi_params->end_x) {
-            LOGGER__ERROR("Error: ROI start_x ({}) must be smaller then end_x ({})\n", roi_params->start_x,
-                          roi_params->end_x);
-            invalid_roi = true;
-        }
+    args->interpolation = resize_params->interpolation;
+    args->crop_start_x = crop_params->start_x;
+    args->crop_start_y = crop_params->start_y;
+    args->crop_end_x = crop_params->end_x;
+    args->crop_end_y = crop_params->end_y;
 
-        if (roi_params->start_y >= roi_params->end_y) {
-            LOGGER__ERROR("Error: ROI start_y ({}) must be smaller then end_y ({})\n", roi_params->start_y,
-                          roi_params->end_y);
-            invalid_roi = true;
-        }
+    command_image_t images[] = {
+        {
+            .user_api_image = resize_params->src,
+            .dsp_api_image = &args->src,
+            .access_type = BufferAccessType::Read,
+        },
+        {
+            .user_api_image = resize_params->dst,
+            .dsp_api_image = &args->dst,
+            .access_type = BufferAccessType::Write,
+        },
+    };
 
-        const size_t bitmask_width = ceil(image->width / (float)PRIVACY_MASK_QUANTIZATION);
-        if (roi_params->end_x > bitmask_width) {
-            LOGGER__ERROR("Error: ROI end_x ({}) must be smaller or equal to quantized bitmask width ({})\n",
-                          roi_params->end_x, bitmask_width);
-            invalid_roi = true;
-        }
+    status = add_images_to_buffer_list(buffer_list, images);
+    if ((status != DSP_SUCCESS) || (!privacy_mask_params)) {
+        return status;
+    }
 
-        const size_t bitmask_height = ceil(image->height / (float)PRIVACY_MASK_QUANTIZATION);
-        if (roi_params->end_y > bitmask_height) {
-            LOGGER__ERROR("Error: ROI end_y ({}) must be smaller or equal to quantized bitmask height ({})\n",
-                          roi_params->end_y, bitmask_height);
-            invalid_roi = true;
-        }
+    return build_privacy_mask_in_data(resize_params->src, privacy_mask_params,
+                                      in_data->crop_resize_privacy_mask_args.privacy_mask, buffer_list);
+}
 
-        if (invalid_roi) {
-            LOGGER__ERROR("Error: ROI properties check failed for \"roi[{}]\"\n", i);
-            return DSP_INVALID_ARGUMENT;
-        }
+static dsp_status crop_and_resize(dsp_device device,
+                                  const dsp_resize_params_t *resize_params,
+                                  const dsp_roi_t *crop_params,
+                                  const dsp_privacy_mask_t *privacy_mask_params,
+                                  perf_info_t *perf_info)
+{
+    if ((!device) || (!resize_params)) {
+        LOGGER__ERROR("Error: NULL argument (device={}, resize_params={})\n", fmt::ptr(device),
+                      fmt::ptr(resize_params));
+        return DSP_INVALID_ARGUMENT;
     }
 
-    return DSP_SUCCESS;
+    ImagingCommand command;
+    auto status = build_crop_and_resize_command(resize_params, crop_params, privacy_mask_params, command.request.get(),
+                                                command.buffer_list);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    status = send_command(device, command, perf_info);
+    if (status != DSP_SUCCESS) {
+        LOGGER__ERROR("Error: Failed executing resize operation. Error code: {}\n", status);
+    }
+
+    return status;
 }
 
 dsp_status dsp_crop_and_resize_perf(dsp_device device,
@@ -137,19 +239,134 @@ dsp_status dsp_crop_and_resize_perf(dsp_device device,
                                     const dsp_roi_t *crop_params,
                                     perf_info_t *perf_info)
 {
-    if ((!device) || (!resize_params)) {
-        LOGGER__ERROR("Error: NULL argument (device={}, resize_params={})\n", fmt::ptr(device),
-                      fmt::ptr(resize_params));
+    return crop_and_resize(device, resize_params, crop_params, NULL, perf_info);
+}
+
+static dsp_status full_image_crop_params(const dsp_resize_params_t *resize_params, dsp_roi_t *crop_params)
+{
+    if (!resize_params) {
+        LOGGER__ERROR("Error: resize_params is NULL\n");
         return DSP_INVALID_ARGUMENT;
     }
 
-    auto status = verify_crop_params(resize_params->src, crop_params);
+    if (!resize_params->src) {
+        LOGGER__ERROR("Error: resize_params->src is NULL\n");
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    *crop_params = {
+        .start_x = 0,
+        .start_y = 0,
+        .end_x = resize_params->src->width,
+        .end_y = resize_params->src->height,
+    };
+
+    return DSP_SUCCESS;
+}
+
+dsp_status dsp_resize_perf(dsp_device device, const dsp_resize_params_t *resize_params, perf_info_t *perf_info)
+{
+    dsp_roi_t crop_params;
+    auto status = full_image_crop_params(resize_params, &crop_params);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    return dsp_crop_and_resize_perf(device, resize_params, &crop_params, perf_info);
+}
+
+dsp_status dsp_crop_and_resize(dsp_device device,
+                               const dsp_resize_params_t *resize_params,
+                               const dsp_roi_t *crop_params)
+{
+    return dsp_crop_and_resize_perf(device, resize_params, crop_params, NULL);
+}
+
+dsp_status dsp_crop_and_resize_privacy_mask(dsp_device device,
+                                            const dsp_resize_params_t *resize_params,
+                                            const dsp_roi_t *crop_params,
+                                            const dsp_privacy_mask_t *privacy_mask_params)
+{
+    if (!privacy_mask_params) {
+        LOGGER__ERROR("Error: privacy_mask_params is NULL\n");
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    return crop_and_resize(device, resize_params, crop_params, privacy_mask_params, NULL);
+}
+
+dsp_status dsp_resize(dsp_device device, const dsp_resize_params_t *resize_params)
+{
+    return dsp_resize_perf(device, resize_params, NULL);
+}
+
+static dsp_status crop_and_resize_async(dsp_device device,
+                                        const dsp_resize_params_t *resize_params,
+                                        const dsp_roi_t *crop_params,
+                                        const dsp_privacy_mask_t *privacy_mask_params,
+                                        dsp_job *job)
+{
+    if ((!device) || (!resize_params) || (!job)) {
+        LOGGER__ERROR("Error: NULL argument (device={}, resize_params={}, job={})\n", fmt::ptr(device),
+                      fmt::ptr(resize_params), fmt::ptr(job));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    ImagingCommand command;
+    auto status = build_crop_and_resize_command(resize_params, crop_params, privacy_mask_params, command.request.get(),
+                                                command.buffer_list);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    return submit_command_async(device, std::move(command), NULL, job);
+}
+
+dsp_status dsp_crop_and_resize_async(dsp_device device,
+                                     const dsp_resize_params_t *resize_params,
+                                     const dsp_roi_t *crop_params,
+                                     dsp_job *job)
+{
+    return crop_and_resize_async(device, resize_params, crop_params, NULL, job);
+}
+
+dsp_status dsp_crop_and_resize_privacy_mask_async(dsp_device device,
+                                                  const dsp_resize_params_t *resize_params,
+                                                  const dsp_roi_t *crop_params,
+                                                  const dsp_privacy_mask_t *privacy_mask_params,
+                                                  dsp_job *job)
+{
+    if (!privacy_mask_params) {
+        LOGGER__ERROR("Error: privacy_mask_params is NULL\n");
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    return crop_and_resize_async(device, resize_params, crop_params, privacy_mask_params, job);
+}
+
+dsp_status dsp_resize_async(dsp_device device, const dsp_resize_params_t *resize_params, dsp_job *job)
+{
+    dsp_roi_t crop_params;
+    auto status = full_image_crop_params(resize_params, &crop_params);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    return dsp_crop_and_resize_async(device, resize_params, &crop_params, job);
+}
+
+static dsp_status verify_crop_and_resize_to_tensor_params(const dsp_image_properties_t *src,
+                                                          const dsp_tensor_t *tensor,
+                                                          const dsp_roi_t *crop_params,
+                                                          dsp_interpolation_type_t interpolation)
+{
+    auto status = verify_crop_params(src, crop_params);
     if (status != DSP_SUCCESS) {
         LOGGER__ERROR("Error: Crop parameters check failed\n");
         return status;
     }
 
-    dsp_image_properties_t cropped_src = *resize_params->src;
+    dsp_image_properties_t cropped_src = *src;
     cropped_src.width = crop_params->end_x - crop_params->start_x;
     cropped_src.height = crop_params->end_y - crop_params->start_y;
 
@@ -159,110 +376,243 @@ dsp_status dsp_crop_and_resize_perf(dsp_device device,
         return status;
     }
 
-    status = verify_image_properties(resize_params->dst);
+    status = verify_tensor_properties(tensor);
     if (status != DSP_SUCCESS) {
-        LOGGER__ERROR("Error: Image properties check failed for \"dst\"\n");
+        LOGGER__ERROR("Error: Tensor properties check failed for \"dst\"\n");
         return status;
     }
 
-    if (resize_params->interpolation >= INTERPOLATION_TYPE_COUNT) {
-        LOGGER__ERROR("Error: Unknown interpolation type {}\n", resize_params->interpolation);
+    if ((src->format != DSP_IMAGE_FORMAT_RGB) && (src->format != DSP_IMAGE_FORMAT_NV12)) {
+        LOGGER__ERROR("Error: Src format ({}) is not supported\n", format_arg_to_string(src->format));
         return DSP_INVALID_ARGUMENT;
     }
 
-    // Only same format for src and dst is currently supported and only GRAY8, RGB or NV12
-    if (resize_params->src->format != resize_params->dst->format) {
-        LOGGER__ERROR("Error: The src and dst formats are not the same\n");
+    if (interpolation >= INTERPOLATION_TYPE_COUNT) {
+        LOGGER__ERROR("Error: Unknown interpolation type {}\n", interpolation);
         return DSP_INVALID_ARGUMENT;
     }
 
-    switch (resize_params->src->format) {
-        case DSP_IMAGE_FORMAT_GRAY8:
-        case DSP_IMAGE_FORMAT_RGB:
-        case DSP_IMAGE_FORMAT_NV12:
-            break;
-
-        default:
-            LOGGER__ERROR("Error: The src/dst format ({}) is not supported\n",
-                          format_arg_to_string(resize_params->src->format));
-            return DSP_INVALID_ARGUMENT;
-    }
-
-    if ((resize_params->interpolation == INTERPOLATION_TYPE_AREA) &&
-        ((cropped_src.width < resize_params->dst->width) || (cropped_src.height < resize_params->dst->height))) {
+    if ((interpolation == INTERPOLATION_TYPE_AREA) &&
+        ((cropped_src.width < tensor->width) || (cropped_src.height < tensor->height))) {
         LOGGER__ERROR("Error: Area interpolation does not support upscaling\n");
         return DSP_INVALID_ARGUMENT;
     }
 
-    auto in_data = make_aligned_uptr<imaging_request_t>();
-    in_data->operation = IMAGING_OP_CROP_AND_RESIZE;
-    in_data->crop_and_resize_args.interpolation = resize_params->interpolation;
-    in_data->crop_and_resize_args.crop_start_x = crop_params->start_x;
-    in_data->crop_and_resize_args.crop_start_y = crop_params->start_y;
-    in_data->crop_and_resize_args.crop_end_x = crop_params->end_x;
-    in_data->crop_and_resize_args.crop_end_y = crop_params->end_y;
+    return DSP_SUCCESS;
+}
+
+static dsp_status build_crop_and_resize_tensor_command(const dsp_tensor_resize_params_t *resize_params,
+                                                       const dsp_roi_t *crop_params,
+                                                       imaging_request_t *in_data,
+                                                       BufferList &buffer_list)
+{
+    auto status = verify_crop_and_resize_to_tensor_params(resize_params->src, resize_params->dst, crop_params,
+                                                          resize_params->interpolation);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    auto &args = in_data->crop_resize_tensor_args;
+    in_data->operation = IMAGING_OP_CROP_RESIZE_TENSOR;
+    args.interpolation = resize_params->interpolation;
+    args.crop_start_x = crop_params->start_x;
+    args.crop_start_y = crop_params->start_y;
+    args.crop_end_x = crop_params->end_x;
+    args.crop_end_y = crop_params->end_y;
 
-    std::vector<command_image_t> images = {
+    command_image_t images[] = {
         {
             .user_api_image = resize_params->src,
-            .dsp_api_image = &in_data->crop_and_resize_args.src,
+            .dsp_api_image = &args.src,
             .access_type = BufferAccessType::Read,
         },
-        {
-            .user_api_image = resize_params->dst,
-            .dsp_api_image = &in_data->crop_and_resize_args.dst,
-            .access_type = BufferAccessType::Write,
-        },
     };
 
-    size_t perf_info_size = perf_info ? sizeof(*perf_info) : 0;
-    status = send_command(device, images, in_data.get(), sizeof(imaging_request_t), perf_info, perf_info_size);
+    status = add_images_to_buffer_list(buffer_list, images);
     if (status != DSP_SUCCESS) {
-        LOGGER__ERROR("Error: Failed executing resize operation. Error code: {}\n", status);
+        return status;
     }
 
-    return status;
+    convert_tensor(resize_params->dst, &args.dst);
+    return buffer_list.add_plane(resize_params->dst->plane, BufferAccessType::Write, resize_params->dst->memory,
+                                 args.dst.data.xrp_buffer_index);
 }
 
-dsp_status dsp_resize_perf(dsp_device device, const dsp_resize_params_t *resize_params, perf_info_t *perf_info)
+dsp_status dsp_crop_and_resize_to_tensor(dsp_device device,
+                                         const dsp_tensor_resize_params_t *resize_params,
+                                         const dsp_roi_t *crop_params)
 {
-    if (!resize_params) {
-        LOGGER__ERROR("Error: resize_params is NULL\n");
+    if ((!device) || (!resize_params)) {
+        LOGGER__ERROR("Error: NULL argument (device={}, resize_params={})\n", fmt::ptr(device),
+                      fmt::ptr(resize_params));
         return DSP_INVALID_ARGUMENT;
     }
 
-    if (!resize_params->src) {
-        LOGGER__ERROR("Error: resize_params->src is NULL\n");
+    ImagingCommand command;
+    auto status =
+        build_crop_and_resize_tensor_command(resize_params, crop_params, command.request.get(), command.buffer_list);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    status = send_command(device, command, NULL);
+    if (status != DSP_SUCCESS) {
+        LOGGER__ERROR("Error: Failed executing resize to tensor operation. Error code: {}\n", status);
+    }
+
+    return status;
+}
+
+dsp_status dsp_crop_and_resize_to_tensor_async(dsp_device device,
+                                               const dsp_tensor_resize_params_t *resize_params,
+                                               const dsp_roi_t *crop_params,
+                                               dsp_job *job)
+{
+    if ((!device) || (!resize_params) || (!job)) {
+        LOGGER__ERROR("Error: NULL argument (device={}, resize_params={}, job={})\n", fmt::ptr(device),
+                      fmt::ptr(resize_params), fmt::ptr(job));
         return DSP_INVALID_ARGUMENT;
     }
 
-    dsp_roi_t crop_params = {
-        .start_x = 0,
-        .start_y = 0,
-        .end_x = resize_params->src->width,
-        .end_y = resize_params->src->height,
-    };
+    ImagingCommand command;
+    auto status =
+        build_crop_and_resize_tensor_command(resize_params, crop_params, command.request.get(), command.buffer_list);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
 
-    return dsp_crop_and_resize_perf(device, resize_params, &crop_params, perf_info);
+    return submit_command_async(device, std::move(command), NULL, job);
 }
 
-dsp_status dsp_crop_and_resize(dsp_device device,
-                               const dsp_resize_params_t *resize_params,
-                               const dsp_roi_t *crop_params)
+static dsp_status verify_batch_crop_and_resize_params(const dsp_batch_resize_params_t *resize_params)
 {
-    return dsp_crop_and_resize_perf(device, resize_params, crop_params, NULL);
+    if ((!resize_params->src) || (!resize_params->rois)) {
+        LOGGER__ERROR("Error: NULL argument (src={}, rois={})\n", fmt::ptr(resize_params->src),
+                      fmt::ptr(resize_params->rois));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    if ((resize_params->rois_count == 0) || (resize_params->rois_count > DSP_BATCH_RESIZE_MAX_ROIS)) {
+        LOGGER__ERROR("Error: ROIs count ({}) must be between 1 and {}\n", resize_params->rois_count,
+                      DSP_BATCH_RESIZE_MAX_ROIS);
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    if ((!resize_params->dst) == (!resize_params->dst_tensor)) {
+        LOGGER__ERROR("Error: Exactly one of dst ({}) and dst_tensor ({}) must be set\n", fmt::ptr(resize_params->dst),
+                      fmt::ptr(resize_params->dst_tensor));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    for (size_t i = 0; i < resize_params->rois_count; ++i) {
+        const auto &roi = resize_params->rois[i];
+        auto status = resize_params->dst_tensor
+                          ? verify_crop_and_resize_to_tensor_params(resize_params->src, resize_params->dst_tensor,
+                                                                    &roi, resize_params->interpolation)
+                          : verify_crop_and_resize_params(resize_params->src, resize_params->dst[i], &roi,
+                                                          resize_params->interpolation);
+        if (status != DSP_SUCCESS) {
+            LOGGER__ERROR("Error: Crop&resize parameters check failed for \"rois[{}]\"\n", i);
+            return status;
+        }
+    }
+
+    if (resize_params->dst_tensor) {
+        size_t batch_size = get_tensor_batch_stride(resize_params->dst_tensor) * resize_params->rois_count;
+        if (resize_params->dst_tensor->plane.bytesused < batch_size) {
+            LOGGER__ERROR("Error: Tensor size ({}) is too small for a batch of {} tensors ({} bytes)\n",
+                          resize_params->dst_tensor->plane.bytesused, resize_params->rois_count, batch_size);
+            return DSP_INVALID_ARGUMENT;
+        }
+    }
+
+    return DSP_SUCCESS;
 }
 
-dsp_status dsp_resize(dsp_device device, const dsp_resize_params_t *resize_params)
+static dsp_status build_batch_crop_and_resize_command(const dsp_batch_resize_params_t *resize_params,
+                                                      ImagingCommand &command)
 {
-    return dsp_resize_perf(device, resize_params, NULL);
+    auto status = verify_batch_crop_and_resize_params(resize_params);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    // The entries are passed to the DSP in a buffer of their own, owned by the command
+    size_t entries_size = resize_params->rois_count * sizeof(batch_crop_resize_entry_t);
+    {
+        HOST_STATS_STAGE(DSP_HOST_STAGE_REQUEST_ALLOC);
+        command.payload = make_aligned_array_uptr<uint8_t>(entries_size);
+    }
+    if (!command.payload) {
+        LOGGER__ERROR("Failed to allocate memory for {} batch crop&resize entries", resize_params->rois_count);
+        return DSP_OUT_OF_HOST_MEMORY;
+    }
+    auto entries = reinterpret_cast<batch_crop_resize_entry_t *>(command.payload.get());
+
+    auto &args = command.request->batch_crop_resize_args;
+    command.request->operation = IMAGING_OP_BATCH_CROP_RESIZE;
+    args.interpolation = resize_params->interpolation;
+    args.entries_count = resize_params->rois_count;
+    args.entries.line_stride = sizeof(batch_crop_resize_entry_t);
+    args.entries.plane_size = entries_size;
+    status =
+        command.buffer_list.add_buffer(entries, entries_size, BufferAccessType::Read, args.entries.xrp_buffer_index);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    command_image_t src_image[] = {
+        {
+            .user_api_image = resize_params->src,
+            .dsp_api_image = &args.src,
+            .access_type = BufferAccessType::Read,
+        },
+    };
+    status = add_images_to_buffer_list(command.buffer_list, src_image);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    for (size_t i = 0; i < resize_params->rois_count; ++i) {
+        entries[i].crop = {
+            .start_x = static_cast<uint32_t>(resize_params->rois[i].start_x),
+            .start_y = static_cast<uint32_t>(resize_params->rois[i].start_y),
+            .end_x = static_cast<uint32_t>(resize_params->rois[i].end_x),
+            .end_y = static_cast<uint32_t>(resize_params->rois[i].end_y),
+        };
+        if (resize_params->dst_tensor) {
+            continue;
+        }
+
+        command_image_t dst_image[] = {
+            {
+                .user_api_image = resize_params->dst[i],
+                .dsp_api_image = &entries[i].dst,
+                .access_type = BufferAccessType::Write,
+            },
+        };
+        status = add_images_to_buffer_list(command.buffer_list, dst_image);
+        if (status != DSP_SUCCESS) {
+            return status;
+        }
+    }
+
+    args.tensor_output = (resize_params->dst_tensor != NULL);
+    if (resize_params->dst_tensor) {
+        args.tensor_stride = get_tensor_batch_stride(resize_params->dst_tensor);
+        convert_tensor(resize_params->dst_tensor, &args.dst_tensor);
+        auto &dst_tensor = resize_params->dst_tensor;
+        status = command.buffer_list.add_plane(dst_tensor->plane, BufferAccessType::Write, dst_tensor->memory,
+                                               args.dst_tensor.data.xrp_buffer_index);
+        if (status != DSP_SUCCESS) {
+            return status;
+        }
+    }
+
+    return DSP_SUCCESS;
 }
 
-dsp_status dsp_multi_crop_and_resize_perf(dsp_device device,
-                                          const dsp_multi_resize_params_t *resize_params,
-                                          const dsp_roi_t *crop_params,
-                                          const dsp_privacy_mask_t *privacy_mask_params,
-                                          perf_info_t *perf_info)
+dsp_status dsp_batch_crop_and_resize(dsp_device device, const dsp_batch_resize_params_t *resize_params)
 {
     if ((!device) || (!resize_params)) {
         LOGGER__ERROR("Error: NULL argument (device={}, resize_params={})\n", fmt::ptr(device),
@@ -270,6 +620,45 @@ dsp_status dsp_multi_crop_and_resize_perf(dsp_device device,
         return DSP_INVALID_ARGUMENT;
     }
 
+    ImagingCommand command;
+    auto status = build_batch_crop_and_resize_command(resize_params, command);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    status = send_command(device, command, NULL);
+    if (status != DSP_SUCCESS) {
+        LOGGER__ERROR("Error: Failed executing batch resize operation. Error code: {}\n", status);
+    }
+
+    return status;
+}
+
+dsp_status dsp_batch_crop_and_resize_async(dsp_device device,
+                                           const dsp_batch_resize_params_t *resize_params,
+                                           dsp_job *job)
+{
+    if ((!device) || (!resize_params) || (!job)) {
+        LOGGER__ERROR("Error: NULL argument (device={}, resize_params={}, job={})\n", fmt::ptr(device),
+                      fmt::ptr(resize_params), fmt::ptr(job));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    ImagingCommand command;
+    auto status = build_batch_crop_and_resize_command(resize_params, command);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    return submit_command_async(device, std::move(command), NULL, job);
+}
+
+static dsp_status build_multi_crop_and_resize_command(const dsp_multi_resize_params_t *resize_params,
+                                                      const dsp_roi_t *crop_params,
+                                                      const dsp_privacy_mask_t *privacy_mask_params,
+                                                      imaging_request_t *in_data,
+                                                      BufferList &buffer_list)
+{
     auto status = verify_crop_params(resize_params->src, crop_params);
     if (status != DSP_SUCCESS) {
         LOGGER__ERROR("Error: Crop parameters check failed\n");
@@ -292,11 +681,22 @@ dsp_status dsp_multi_crop_and_resize_perf(dsp_device device,
         return status;
     }
 
-    if (resize_params->src->format != DSP_IMAGE_FORMAT_NV12) {
-        LOGGER__ERROR("Error: Src format ({}) is not supported\n", format_arg_to_string(resize_params->src->format));
+    auto src_format = resize_params->src->format;
+    if ((src_format != DSP_IMAGE_FORMAT_NV12) && (src_format != DSP_IMAGE_FORMAT_GRAY8) &&
+        (src_format != DSP_IMAGE_FORMAT_RGB)) {
+        LOGGER__ERROR("Error: Src format ({}) is not supported\n", format_arg_to_string(src_format));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    // The privacy mask colors are YUV, and are painted on the NV12 planes of the source
+    if (privacy_mask_params && (src_format != DSP_IMAGE_FORMAT_NV12)) {
+        LOGGER__ERROR("Error: Privacy mask is not supported for src format ({})\n", format_arg_to_string(src_format));
         return DSP_INVALID_ARGUMENT;
     }
 
+    // The original operations support NV12 sources with NV12 outputs only. Other sources, and mixed format outputs,
+    // use the converting operation
+    bool convert = (src_format != DSP_IMAGE_FORMAT_NV12);
     for (int i = 0; i < DSP_MULTI_RESIZE_OUTPUTS_COUNT; ++i) {
         auto dst_image = resize_params->dst[i];
         if (dst_image == NULL)
@@ -308,10 +708,16 @@ dsp_status dsp_multi_crop_and_resize_perf(dsp_device device,
             return status;
         }
 
-        if (dst_image->format != DSP_IMAGE_FORMAT_NV12) {
+        if (dst_image->format == src_format) {
+            continue;
+        }
+
+        if (!is_crop_resize_conversion_supported(src_format, dst_image->format)) {
             LOGGER__ERROR("Error: Dst[{}] format ({}) is not supported\n", i, format_arg_to_string(dst_image->format));
             return DSP_INVALID_ARGUMENT;
         }
+
+        convert = true;
     }
 
     if ((resize_params->interpolation != INTERPOLATION_TYPE_BILINEAR) &&
@@ -320,19 +726,20 @@ dsp_status dsp_multi_crop_and_resize_perf(dsp_device device,
         return DSP_INVALID_ARGUMENT;
     }
 
-    auto in_data = make_aligned_uptr<imaging_request_t>();
-    in_data->operation =
-        privacy_mask_params ? IMAGING_OP_MULTI_CROP_AND_RESIZE_PRIVACY_MASK : IMAGING_OP_MULTI_CROP_AND_RESIZE;
+    if (convert) {
+        in_data->operation = IMAGING_OP_MULTI_CROP_RESIZE_CONVERT;
+    } else {
+        in_data->operation =
+            privacy_mask_params ? IMAGING_OP_MULTI_CROP_AND_RESIZE_PRIVACY_MASK : IMAGING_OP_MULTI_CROP_AND_RESIZE;
+    }
     in_data->multi_crop_and_resize_args.interpolation = resize_params->interpolation;
     in_data->multi_crop_and_resize_args.crop_start_x = crop_params->start_x;
     in_data->multi_crop_and_resize_args.crop_start_y = crop_params->start_y;
     in_data->multi_crop_and_resize_args.crop_end_x = crop_params->end_x;
     in_data->multi_crop_and_resize_args.crop_end_y = crop_params->end_y;
 
-    std::vector<command_image_t> images;
-    images.reserve(1 + DSP_MULTI_RESIZE_OUTPUTS_COUNT);
-
-    images.emplace_back(command_image_t{
+    InlineVector<command_image_t, 1 + DSP_MULTI_RESIZE_OUTPUTS_COUNT> images;
+    images.push_back(command_image_t{
         .user_api_image = resize_params->src,
         .dsp_api_image = &in_data->multi_crop_and_resize_args.src,
         .access_type = BufferAccessType::Read,
@@ -341,7 +748,7 @@ dsp_status dsp_multi_crop_and_resize_perf(dsp_device device,
     for (auto dst_image : resize_params->dst) {
         if (dst_image == NULL)
             continue;
-        images.emplace_back(command_image_t{
+        images.push_back(command_image_t{
             .user_api_image = dst_image,
             .dsp_api_image = &in_data->multi_crop_and_resize_args.dst[images.size() - 1],
             .access_type = BufferAccessType::Write,
@@ -350,37 +757,79 @@ dsp_status dsp_multi_crop_and_resize_perf(dsp_device device,
 
     in_data->multi_crop_and_resize_args.dst_count = images.size() - 1;
 
-    BufferList buffer_list;
     status = add_images_to_buffer_list(buffer_list, images);
     if (status != DSP_SUCCESS) {
         LOGGER__ERROR("Error: Failed adding images to buffer list. Error code: {}\n", status);
         return status;
     }
 
+    // A zero ROIs count tells the converting operation that there is no privacy mask
+    in_data->multi_crop_and_resize_args.privacy_mask.rois_count = 0;
     if (privacy_mask_params) {
-        const size_t bitmask_width = ceil(resize_params->src->width / (double)(PRIVACY_MASK_QUANTIZATION * 8));
-        const size_t bitmask_stride = ROUND_UP(bitmask_width, 8);
-        const size_t bitmask_height = ceil(resize_params->src->height / (double)PRIVACY_MASK_QUANTIZATION);
-        in_data->multi_crop_and_resize_args.privacy_mask.bitmask.line_stride = bitmask_stride;
-        in_data->multi_crop_and_resize_args.privacy_mask.bitmask.plane_size = bitmask_stride * bitmask_height;
-        in_data->multi_crop_and_resize_args.privacy_mask.bitmask.xrp_buffer_index = buffer_list.add_buffer(
-            privacy_mask_params->bitmask, bitmask_stride * bitmask_height, BufferAccessType::Read);
-
-        in_data->multi_crop_and_resize_args.privacy_mask.y_color = privacy_mask_params->y_color;
-        in_data->multi_crop_and_resize_args.privacy_mask.u_color = privacy_mask_params->u_color;
-        in_data->multi_crop_and_resize_args.privacy_mask.v_color = privacy_mask_params->v_color;
-
-        in_data->multi_crop_and_resize_args.privacy_mask.rois_count = privacy_mask_params->rois_count;
-        for (size_t i = 0; i < privacy_mask_params->rois_count; ++i) {
-            in_data->multi_crop_and_resize_args.privacy_mask.rois[i].start_x = privacy_mask_params->rois[i].start_x;
-            in_data->multi_crop_and_resize_args.privacy_mask.rois[i].start_y = privacy_mask_params->rois[i].start_y;
-            in_data->multi_crop_and_resize_args.privacy_mask.rois[i].end_x = privacy_mask_params->rois[i].end_x;
-            in_data->multi_crop_and_resize_args.privacy_mask.rois[i].end_y = privacy_mask_params->rois[i].end_y;
+        return build_privacy_mask_in_data(resize_params->src, privacy_mask_params,
+                                          in_data->multi_crop_and_resize_args.privacy_mask, buffer_list);
+    }
+
+    return DSP_SUCCESS;
+}
+
+// Outputs beyond the limit of a single request are resized by chained multi crop&resize requests. Every request
+// resizes as many outputs as possible, so the source is read as few times as possible
+static dsp_status build_multi_crop_and_resize_list_request(const dsp_multi_resize_list_params_t *resize_params,
+                                                           const dsp_roi_t *crop_params,
+                                                           const dsp_privacy_mask_t *privacy_mask_params,
+                                                           size_t index,
+                                                           imaging_request_t *in_data,
+                                                           BufferList &buffer_list)
+{
+    size_t first = index * DSP_MULTI_RESIZE_OUTPUTS_COUNT;
+    dsp_multi_resize_params_t group_params = {
+        .src = resize_params->src,
+        .dst = {},
+        .interpolation = resize_params->interpolation,
+    };
+    for (size_t i = 0; (i < DSP_MULTI_RESIZE_OUTPUTS_COUNT) && (first + i < resize_params->dst_count); ++i) {
+        group_params.dst[i] = resize_params->dst[first + i];
+        if (!group_params.dst[i]) {
+            LOGGER__ERROR("Error: dst[{}] is NULL\n", first + i);
+            return DSP_INVALID_ARGUMENT;
         }
     }
 
-    size_t perf_info_size = perf_info ? sizeof(*perf_info) : 0;
-    status = send_command(device, buffer_list, in_data.get(), sizeof(imaging_request_t), perf_info, perf_info_size);
+    return build_multi_crop_and_resize_command(&group_params, crop_params, privacy_mask_params, in_data, buffer_list);
+}
+
+static dsp_status verify_multi_crop_and_resize_list_params(const dsp_multi_resize_list_params_t *resize_params)
+{
+    if ((!resize_params->src) || (!resize_params->dst) || (resize_params->dst_count == 0)) {
+        LOGGER__ERROR("Error: Invalid argument (src={}, dst={}, dst_count={})\n", fmt::ptr(resize_params->src),
+                      fmt::ptr(resize_params->dst), resize_params->dst_count);
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    return DSP_SUCCESS;
+}
+
+dsp_status dsp_multi_crop_and_resize_perf(dsp_device device,
+                                          const dsp_multi_resize_params_t *resize_params,
+                                          const dsp_roi_t *crop_params,
+                                          const dsp_privacy_mask_t *privacy_mask_params,
+                                          perf_info_t *perf_info)
+{
+    if ((!device) || (!resize_params)) {
+        LOGGER__ERROR("Error: NULL argument (device={}, resize_params={})\n", fmt::ptr(device),
+                      fmt::ptr(resize_params));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    ImagingCommand command;
+    auto status = build_multi_crop_and_resize_command(resize_params, crop_params, privacy_mask_params,
+                                                      command.request.get(), command.buffer_list);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    status = send_command(device, command, perf_info);
     if (status != DSP_SUCCESS) {
         LOGGER__ERROR("Error: Failed executing resize operation. Error code: {}\n", status);
     }
@@ -401,4 +850,322 @@ dsp_status dsp_multi_crop_and_resize_privacy_mask(dsp_device device,
                                                   const dsp_privacy_mask_t *privacy_mask_params)
 {
     return dsp_multi_crop_and_resize_perf(device, resize_params, crop_params, privacy_mask_params, NULL);
-}
\ No newline at end of file
+}
+
+dsp_status dsp_multi_crop_and_resize_list(dsp_device device,
+                                          const dsp_multi_resize_list_params_t *resize_params,
+                                          const dsp_roi_t *crop_params,
+                                          const dsp_privacy_mask_t *privacy_mask_params)
+{
+    if ((!device) || (!resize_params)) {
+        LOGGER__ERROR("Error: NULL argument (device={}, resize_params={})\n", fmt::ptr(device),
+                      fmt::ptr(resize_params));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    auto status = verify_multi_crop_and_resize_list_params(resize_params);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    ImagingCommand command;
+    status = build_chained_command(command, DIV_ROUND_UP(resize_params->dst_count, DSP_MULTI_RESIZE_OUTPUTS_COUNT),
+                                   [&](size_t index, imaging_request_t *request, BufferList &buffer_list) {
+                                       return build_multi_crop_and_resize_list_request(
+                                           resize_params, crop_params, privacy_mask_params, index, request,
+                                           buffer_list);
+                                   });
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    status = send_command(device, command, NULL);
+    if (status != DSP_SUCCESS) {
+        LOGGER__ERROR("Error: Failed executing resize operation. Error code: {}\n", status);
+    }
+
+    return status;
+}
+
+dsp_status dsp_multi_crop_and_resize_list_async(dsp_device device,
+                                                const dsp_multi_resize_list_params_t *resize_params,
+                                                const dsp_roi_t *crop_params,
+                                                const dsp_privacy_mask_t *privacy_mask_params,
+                                                dsp_job *job)
+{
+    if ((!device) || (!resize_params) || (!job)) {
+        LOGGER__ERROR("Error: NULL argument (device={}, resize_params={}, job={})\n", fmt::ptr(device),
+                      fmt::ptr(resize_params), fmt::ptr(job));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    auto status = verify_multi_crop_and_resize_list_params(resize_params);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    ImagingCommand command;
+    status = build_chained_command(command, DIV_ROUND_UP(resize_params->dst_count, DSP_MULTI_RESIZE_OUTPUTS_COUNT),
+                                   [&](size_t index, imaging_request_t *request, BufferList &buffer_list) {
+                                       return build_multi_crop_and_resize_list_request(
+                                           resize_params, crop_params, privacy_mask_params, index, request,
+                                           buffer_list);
+                                   });
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    return submit_command_async(device, std::move(command), NULL, job);
+}
+
+static dsp_status multi_crop_and_resize_async(dsp_device device,
+                                              const dsp_multi_resize_params_t *resize_params,
+                                              const dsp_roi_t *crop_params,
+                                              const dsp_privacy_mask_t *privacy_mask_params,
+                                              dsp_job *job)
+{
+    if ((!device) || (!resize_params) || (!job)) {
+        LOGGER__ERROR("Error: NULL argument (device={}, resize_params={}, job={})\n", fmt::ptr(device),
+                      fmt::ptr(resize_params), fmt::ptr(job));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    ImagingCommand command;
+    auto status = build_multi_crop_and_resize_command(resize_params, crop_params, privacy_mask_params,
+                                                      command.request.get(), command.buffer_list);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    return submit_command_async(device, std::move(command), NULL, job);
+}
+
+dsp_status dsp_multi_crop_and_resize_async(dsp_device device,
+                                           const dsp_multi_resize_params_t *resize_params,
+                                           const dsp_roi_t *crop_params,
+                                           dsp_job *job)
+{
+    return multi_crop_and_resize_async(device, resize_params, crop_params, NULL, job);
+}
+
+dsp_status dsp_multi_crop_and_resize_privacy_mask_async(dsp_device device,
+                                                        const dsp_multi_resize_params_t *resize_params,
+                                                        const dsp_roi_t *crop_params,
+                                                        const dsp_privacy_mask_t *privacy_mask_params,
+                                                        dsp_job *job)
+{
+    return multi_crop_and_resize_async(device, resize_params, crop_params, privacy_mask_params, job);
+}
+
+static dsp_status cmdbuf_record_crop_and_resize(dsp_cmdbuf cmdbuf,
+                                                const dsp_resize_params_t *resize_params,
+                                                const dsp_roi_t *crop_params,
+                                                const dsp_privacy_mask_t *privacy_mask_params)
+{
+    if ((!cmdbuf) || (!resize_params)) {
+        LOGGER__ERROR("Error: NULL argument (cmdbuf={}, resize_params={})\n", fmt::ptr(cmdbuf),
+                      fmt::ptr(resize_params));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    return cmdbuf_record(cmdbuf, {resize_params->src, resize_params->dst},
+                         [&](imaging_request_t *request, BufferList &buffer_list) {
+                             return build_crop_and_resize_command(resize_params, crop_params, privacy_mask_params,
+                                                                  request, buffer_list);
+                         });
+}
+
+dsp_status dsp_cmdbuf_record_crop_and_resize(dsp_cmdbuf cmdbuf,
+                                             const dsp_resize_params_t *resize_params,
+                                             const dsp_roi_t *crop_params)
+{
+    return cmdbuf_record_crop_and_resize(cmdbuf, resize_params, crop_params, NULL);
+}
+
+dsp_status dsp_cmdbuf_record_crop_and_resize_privacy_mask(dsp_cmdbuf cmdbuf,
+                                                          const dsp_resize_params_t *resize_params,
+                                                          const dsp_roi_t *crop_params,
+                                                          const dsp_privacy_mask_t *privacy_mask_params)
+{
+    if (!privacy_mask_params) {
+        LOGGER__ERROR("Error: privacy_mask_params is NULL\n");
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    return cmdbuf_record_crop_and_resize(cmdbuf, resize_params, crop_params, privacy_mask_params);
+}
+
+dsp_status dsp_cmdbuf_record_crop_and_resize_to_tensor(dsp_cmdbuf cmdbuf,
+                                                       const dsp_tensor_resize_params_t *resize_params,
+                                                       const dsp_roi_t *crop_params)
+{
+    if ((!cmdbuf) || (!resize_params)) {
+        LOGGER__ERROR("Error: NULL argument (cmdbuf={}, resize_params={})\n", fmt::ptr(cmdbuf),
+                      fmt::ptr(resize_params));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    return cmdbuf_record(cmdbuf, {resize_params->src}, [&](imaging_request_t *request, BufferList &buffer_list) {
+        return build_crop_and_resize_tensor_command(resize_params, crop_params, request, buffer_list);
+    });
+}
+
+dsp_status dsp_cmdbuf_record_resize(dsp_cmdbuf cmdbuf, const dsp_resize_params_t *resize_params)
+{
+    dsp_roi_t crop_params;
+    auto status = full_image_crop_params(resize_params, &crop_params);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    return dsp_cmdbuf_record_crop_and_resize(cmdbuf, resize_params, &crop_params);
+}
+
+static dsp_status cmdbuf_record_multi_crop_and_resize(dsp_cmdbuf cmdbuf,
+                                                      const dsp_multi_resize_params_t *resize_params,
+                                                      const dsp_roi_t *crop_params,
+                                                      const dsp_privacy_mask_t *privacy_mask_params)
+{
+    if ((!cmdbuf) || (!resize_params)) {
+        LOGGER__ERROR("Error: NULL argument (cmdbuf={}, resize_params={})\n", fmt::ptr(cmdbuf),
+                      fmt::ptr(resize_params));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    std::vector<const dsp_image_properties_t *> images = {resize_params->src};
+    images.insert(images.end(), std::begin(resize_params->dst), std::end(resize_params->dst));
+
+    return cmdbuf_record(cmdbuf, images, [&](imaging_request_t *request, BufferList &buffer_list) {
+        return build_multi_crop_and_resize_command(resize_params, crop_params, privacy_mask_params, request,
+                                                   buffer_list);
+    });
+}
+
+dsp_status dsp_cmdbuf_record_multi_crop_and_resize(dsp_cmdbuf cmdbuf,
+                                                   const dsp_multi_resize_params_t *resize_params,
+                                                   const dsp_roi_t *crop_params)
+{
+    return cmdbuf_record_multi_crop_and_resize(cmdbuf, resize_params, crop_params, NULL);
+}
+
+dsp_status dsp_cmdbuf_record_multi_crop_and_resize_privacy_mask(dsp_cmdbuf cmdbuf,
+                                                                const dsp_multi_resize_params_t *resize_params,
+                                                                const dsp_roi_t *crop_params,
+                                                                const dsp_privacy_mask_t *privacy_mask_params)
+{
+    return cmdbuf_record_multi_crop_and_resize(cmdbuf, resize_params, crop_params, privacy_mask_params);
+}
+
+dsp_status dsp_cmdbuf_record_multi_crop_and_resize_list(dsp_cmdbuf cmdbuf,
+                                                        const dsp_multi_resize_list_params_t *resize_params,
+                                                        const dsp_roi_t *crop_params,
+                                                        const dsp_privacy_mask_t *privacy_mask_params)
+{
+    if ((!cmdbuf) || (!resize_params)) {
+        LOGGER__ERROR("Error: NULL argument (cmdbuf={}, resize_params={})\n", fmt::ptr(cmdbuf),
+                      fmt::ptr(resize_params));
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    auto status = verify_multi_crop_and_resize_list_params(resize_params);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    std::vector<const dsp_image_properties_t *> images = {resize_params->src};
+    images.insert(images.end(), resize_params->dst, resize_params->dst + resize_params->dst_count);
+
+    return cmdbuf_record_chain(cmdbuf, images, DIV_ROUND_UP(resize_params->dst_count, DSP_MULTI_RESIZE_OUTPUTS_COUNT),
+                               [&](size_t index, imaging_request_t *request, BufferList &buffer_list) {
+                                   return build_multi_crop_and_resize_list_request(
+                                       resize_params, crop_params, privacy_mask_params, index, request, buffer_list);
+                               });
+}
+
+static dsp_status plan_create_crop_and_resize(dsp_device device,
+                                              const dsp_resize_params_t *resize_params,
+                                              const dsp_roi_t *crop_params,
+                                              const dsp_privacy_mask_t *privacy_mask_params,
+                                              dsp_plan *plan)
+{
+    if (!resize_params) {
+        LOGGER__ERROR("Error: resize_params is NULL\n");
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    return plan_create(device, {resize_params->src, resize_params->dst}, plan,
+                       [&](imaging_request_t *request, BufferList &buffer_list) {
+                           return build_crop_and_resize_command(resize_params, crop_params, privacy_mask_params,
+                                                                request, buffer_list);
+                       });
+}
+
+dsp_status dsp_plan_create_crop_and_resize(dsp_device device,
+                                           const dsp_resize_params_t *resize_params,
+                                           const dsp_roi_t *crop_params,
+                                           dsp_plan *plan)
+{
+    return plan_create_crop_and_resize(device, resize_params, crop_params, NULL, plan);
+}
+
+dsp_status dsp_plan_create_crop_and_resize_privacy_mask(dsp_device device,
+                                                        const dsp_resize_params_t *resize_params,
+                                                        const dsp_roi_t *crop_params,
+                                                        const dsp_privacy_mask_t *privacy_mask_params,
+                                                        dsp_plan *plan)
+{
+    if (!privacy_mask_params) {
+        LOGGER__ERROR("Error: privacy_mask_params is NULL\n");
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    return plan_create_crop_and_resize(device, resize_params, crop_params, privacy_mask_params, plan);
+}
+
+dsp_status dsp_plan_create_resize(dsp_device device, const dsp_resize_params_t *resize_params, dsp_plan *plan)
+{
+    dsp_roi_t crop_params;
+    auto status = full_image_crop_params(resize_params, &crop_params);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    return dsp_plan_create_crop_and_resize(device, resize_params, &crop_params, plan);
+}
+
+static dsp_status plan_create_multi_crop_and_resize(dsp_device device,
+                                                    const dsp_multi_resize_params_t *resize_params,
+                                                    const dsp_roi_t *crop_params,
+                                                    const dsp_privacy_mask_t *privacy_mask_params,
+                                                    dsp_plan *plan)
+{
+    if (!resize_params) {
+        LOGGER__ERROR("Error: resize_params is NULL\n");
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    std::vector<const dsp_image_properties_t *> images = {resize_params->src};
+    images.insert(images.end(), std::begin(resize_params->dst), std::end(resize_params->dst));
+
+    return plan_create(device, images, plan, [&](imaging_request_t *request, BufferList &buffer_list) {
+        return build_multi_crop_and_resize_command(resize_params, crop_params, privacy_mask_params, request,
+                                                   buffer_list);
+    });
+}
+
+dsp_status dsp_plan_create_multi_crop_and_resize(dsp_device device,
+                                                 const dsp_multi_resize_params_t *resize_params,
+                                                 const dsp_roi_t *crop_params,
+                                                 dsp_plan *plan)
+{
+    return plan_create_multi_crop_and_resize(device, resize_params, crop_params, NULL, plan);
+}
+
+dsp_status dsp_plan_create_multi_crop_and_resize_privacy_mask(dsp_device device,
+                                                              const dsp_multi_resize_params_t *resize_params,
+                                                              const dsp_roi_t *crop_params,
+                                                              const dsp_privacy_mask_t *privacy_mask_params,
+                                                              dsp_plan *plan)
+{
+    return plan_create_multi_crop_and_resize(device, resize_params, crop_params, privacy_mask_params, plan);
+}
@@ -0,0 +1,321 @@
+/*
+ * Copyright (c) 2017-2024 Hailo Technologies Ltd. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "hailo/hailodsp.h"
+#include "image_utils.hpp"
+#include "logger_macros.hpp"
+#include "rgba_to_a420.hpp"
+
+#include <cstring>
+#include <utils.h>
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#define RGBA_BYTES_PER_PIXEL (4)
+
+// The lines of a chroma line pair, and the A420 lines they are converted into
+typedef struct {
+    const uint8_t *rgba[2];
+    uint8_t *y[2];
+    uint8_t *a[2];
+    uint8_t *u;
+    uint8_t *v;
+} line_pair_t;
+
+dsp_status verify_rgba_plane(const dsp_data_plane_t *rgba, size_t width, size_t height)
+{
+    if ((!rgba) || (!rgba->userptr)) {
+        LOGGER__ERROR("Error: RGBA plane or its data pointer is NULL\n");
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    // A420 chroma covers 2x2 pixels
+    if ((width == 0) || (height == 0) || (width % 2 != 0) || (height % 2 != 0)) {
+        LOGGER__ERROR("Error: Invalid RGBA image size ({}x{}). Width and height must be non-zero even numbers\n",
+                      width, height);
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    if (rgba->bytesperline < width * RGBA_BYTES_PER_PIXEL) {
+        LOGGER__ERROR("Error: RGBA line stride ({}) is too small for the image width ({})\n", rgba->bytesperline,
+                      width);
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    if (rgba->bytesused < rgba->bytesperline * height) {
+        LOGGER__ERROR("Error: RGBA plane size ({}) is too small for the line stride and image height ({})\n",
+                      rgba->bytesused, height);
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    return DSP_SUCCESS;
+}
+
+// Same integer BT.601 conversion as the DSP RGB to NV12 conversion. Chroma is not clamped, since it is in [16, 240]
+static void rgba_to_yuv(const uint8_t *rgba, uint8_t &y, int &u, int &v)
+{
+    int r = rgba[0], g = rgba[1], b = rgba[2];
+    y = static_cast<uint8_t>(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+    u = ((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128;
+    v = ((112 * r - 94 * g - 18 * b + 128) >> 8) + 128;
+}
+
+// Converts the 2x2 pixels of columns [x, x + 2). Chroma is the average of the chroma of the 4 pixels
+static void convert_pixel_quad(const line_pair_t &lines, size_t x)
+{
+    int u_sum = 0, v_sum = 0;
+    for (size_t dy = 0; dy < 2; ++dy) {
+        for (size_t dx = 0; dx < 2; ++dx) {
+            const uint8_t *pixel = lines.rgba[dy] + (x + dx) * RGBA_BYTES_PER_PIXEL;
+            int u, v;
+            rgba_to_yuv(pixel, lines.y[dy][x + dx], u, v);
+            lines.a[dy][x + dx] = pixel[3];
+            u_sum += u;
+            v_sum += v;
+        }
+    }
+
+    lines.u[x / 2] = static_cast<uint8_t>((u_sum + 2) / 4);
+    lines.v[x / 2] = static_cast<uint8_t>((v_sum + 2) / 4);
+}
+
+#if defined(__aarch64__)
+
+#define SIMD_PIXELS (16)
+
+static uint8x8_t neon_luma(uint8x8_t r, uint8x8_t g, uint8x8_t b)
+{
+    uint16x8_t y = vmull_u8(r, vdup_n_u8(66));
+    y = vmlal_u8(y, g, vdup_n_u8(129));
+    y = vmlal_u8(y, b, vdup_n_u8(25));
+    return vadd_u8(vrshrn_n_u16(y, 8), vdup_n_u8(16));
+}
+
+// Per pixel chroma, ((r * kr + g * kg + b * kb + 128) >> 8) + 128. The sum fits 16 bits for the BT.601 coefficients
+static int16x8_t neon_chroma(uint8x8_t r, uint8x8_t g, uint8x8_t b, int16_t kr, int16_t kg, int16_t kb)
+{
+    int16x8_t value = vmulq_n_s16(vreinterpretq_s16_u16(vmovl_u8(r)), kr);
+    value = vmlaq_n_s16(value, vreinterpretq_s16_u16(vmovl_u8(g)), kg);
+    value = vmlaq_n_s16(value, vreinterpretq_s16_u16(vmovl_u8(b)), kb);
+    return vaddq_s16(vshrq_n_s16(vaddq_s16(value, vdupq_n_s16(128)), 8), vdupq_n_s16(128));
+}
+
+// Averages the 2x2 blocks of 8 columns of per pixel chroma of two lines into 4 chroma samples
+static int16x4_t neon_average_quads(int16x8_t line0, int16x8_t line1)
+{
+    int32x4_t sums = vpaddlq_s16(vaddq_s16(line0, line1));
+    return vmovn_s32(vshrq_n_s32(vaddq_s32(sums, vdupq_n_s32(2)), 2));
+}
+
+static void convert_simd_block(const line_pair_t &lines, size_t x)
+{
+    int16x8_t u_low[2], u_high[2], v_low[2], v_high[2];
+    for (size_t dy = 0; dy < 2; ++dy) {
+        uint8x16x4_t pixels = vld4q_u8(lines.rgba[dy] + x * RGBA_BYTES_PER_PIXEL);
+        uint8x8_t r_low = vget_low_u8(pixels.val[0]), r_high = vget_high_u8(pixels.val[0]);
+        uint8x8_t g_low = vget_low_u8(pixels.val[1]), g_high = vget_high_u8(pixels.val[1]);
+        uint8x8_t b_low = vget_low_u8(pixels.val[2]), b_high = vget_high_u8(pixels.val[2]);
+
+        vst1q_u8(lines.y[dy] + x, vcombine_u8(neon_luma(r_low, g_low, b_low), neon_luma(r_high, g_high, b_high)));
+        vst1q_u8(lines.a[dy] + x, pixels.val[3]);
+
+        u_low[dy] = neon_chroma(r_low, g_low, b_low, -38, -74, 112);
+        u_high[dy] = neon_chroma(r_high, g_high, b_high, -38, -74, 112);
+        v_low[dy] = neon_chroma(r_low, g_low, b_low, 112, -94, -18);
+        v_high[dy] = neon_chroma(r_high, g_high, b_high, 112, -94, -18);
+    }
+
+    int16x8_t u = vcombine_s16(neon_average_quads(u_low[0], u_low[1]), neon_average_quads(u_high[0], u_high[1]));
+    int16x8_t v = vcombine_s16(neon_average_quads(v_low[0], v_low[1]), neon_average_quads(v_high[0], v_high[1]));
+    vst1_u8(lines.u + x / 2, vqmovun_s16(u));
+    vst1_u8(lines.v + x / 2, vqmovun_s16(v));
+}
+
+#elif defined(__SSE2__)
+
+#define SIMD_PIXELS (8)
+
+// Channel of 8 RGBA pixels, which are held in two registers, as 16 bit lanes
+template <int shift>
+static __m128i sse2_channel(__m128i low, __m128i high)
+{
+    const __m128i mask = _mm_set1_epi32(0xff);
+    return _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(low, shift), mask),
+                           _mm_and_si128(_mm_srli_epi32(high, shift), mask));
+}
+
+// The sum fits 16 unsigned bits for the BT.601 coefficients, so the shift is logical
+static __m128i sse2_luma(__m128i r, __m128i g, __m128i b)
+{
+    __m128i y = _mm_mullo_epi16(r, _mm_set1_epi16(66));
+    y = _mm_add_epi16(y, _mm_mullo_epi16(g, _mm_set1_epi16(129)));
+    y = _mm_add_epi16(y, _mm_mullo_epi16(b, _mm_set1_epi16(25)));
+    y = _mm_srli_epi16(_mm_add_epi16(y, _mm_set1_epi16(128)), 8);
+    return _mm_add_epi16(y, _mm_set1_epi16(16));
+}
+
+// Per pixel chroma, ((r * kr + g * kg + b * kb + 128) >> 8) + 128. The sum fits 16 signed bits for the BT.601
+// coefficients
+static __m128i sse2_chroma(__m128i r, __m128i g, __m128i b, int16_t kr, int16_t kg, int16_t kb)
+{
+    __m128i value = _mm_mullo_epi16(r, _mm_set1_epi16(kr));
+    value = _mm_add_epi16(value, _mm_mullo_epi16(g, _mm_set1_epi16(kg)));
+    value = _mm_add_epi16(value, _mm_mullo_epi16(b, _mm_set1_epi16(kb)));
+    value = _mm_srai_epi16(_mm_add_epi16(value, _mm_set1_epi16(128)), 8);
+    return _mm_add_epi16(value, _mm_set1_epi16(128));
+}
+
+// Averages the 2x2 blocks of 8 columns of per pixel chroma of two lines into 4 chroma samples, as bytes
+static uint32_t sse2_average_quads(__m128i line0, __m128i line1)
+{
+    __m128i sums = _mm_madd_epi16(_mm_add_epi16(line0, line1), _mm_set1_epi16(1));
+    sums = _mm_srli_epi32(_mm_add_epi32(sums, _mm_set1_epi32(2)), 2);
+    __m128i words = _mm_packs_epi32(sums, sums);
+    return static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_packus_epi16(words, words)));
+}
+
+static void convert_simd_block(const line_pair_t &lines, size_t x)
+{
+    __m128i u[2], v[2];
+    for (size_t dy = 0; dy < 2; ++dy) {
+        auto pixels = reinterpret_cast<const __m128i *>(lines.rgba[dy] + x * RGBA_BYTES_PER_PIXEL);
+        __m128i low = _mm_loadu_si128(pixels);
+        __m128i high = _mm_loadu_si128(pixels + 1);
+        __m128i r = sse2_channel<0>(low, high);
+        __m128i g = sse2_channel<8>(low, high);
+        __m128i b = sse2_channel<16>(low, high);
+        __m128i a = sse2_channel<24>(low, high);
+
+        __m128i y = sse2_luma(r, g, b);
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(lines.y[dy] + x), _mm_packus_epi16(y, y));
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(lines.a[dy] + x), _mm_packus_epi16(a, a));
+
+        u[dy] = sse2_chroma(r, g, b, -38, -74, 112);
+        v[dy] = sse2_chroma(r, g, b, 112, -94, -18);
+    }
+
+    uint32_t u_samples = sse2_average_quads(u[0], u[1]);
+    uint32_t v_samples = sse2_average_quads(v[0], v[1]);
+    memcpy(lines.u + x / 2, &u_samples, sizeof(u_samples));
+    memcpy(lines.v + x / 2, &v_samples, sizeof(v_samples));
+}
+
+#endif
+
+void convert_rgba_to_a420(const dsp_data_plane_t &rgba,
+                          size_t width,
+                          size_t start_y,
+                          size_t end_y,
+                          const dsp_data_plane_t a420_planes[])
+{
+    auto line = [](const dsp_data_plane_t &plane, size_t y) {
+        return static_cast<uint8_t *>(plane.userptr) + y * plane.bytesperline;
+    };
+
+    for (size_t y = start_y; y < end_y; y += 2) {
+        line_pair_t lines = {
+            .rgba = {line(rgba, y), line(rgba, y + 1)},
+            .y = {line(a420_planes[0], y), line(a420_planes[0], y + 1)},
+            .a = {line(a420_planes[3], y), line(a420_planes[3], y + 1)},
+            .u = line(a420_planes[1], y / 2),
+            .v = line(a420_planes[2], y / 2),
+        };
+
+        size_t x = 0;
+#if defined(SIMD_PIXELS)
+        for (; x + SIMD_PIXELS <= width; x += SIMD_PIXELS) {
+            convert_simd_block(lines, x);
+        }
+#endif
+        for (; x < width; x += 2) {
+            convert_pixel_quad(lines, x);
+        }
+    }
+}
+
+static uint64_t hash_mix(uint64_t hash, uint64_t word)
+{
+    hash ^= word * 0x9e3779b97f4a7c15ull;
+    return ((hash << 31) | (hash >> 33)) * 0xbf58476d1ce4e5b9ull;
+}
+
+uint64_t hash_rgba_lines(const dsp_data_plane_t &rgba, size_t width, size_t start_y, size_t end_y)
+{
+    // Independent lanes, so that consecutive words are mixed in parallel. Lines of even width are whole words
+    uint64_t lanes[4] = {1, 2, 3, 4};
+    size_t line_size = width * RGBA_BYTES_PER_PIXEL;
+    for (size_t y = start_y; y < end_y; ++y) {
+        auto line = static_cast<const uint8_t *>(rgba.userptr) + y * rgba.bytesperline;
+        size_t i = 0;
+        for (; i + sizeof(lanes) <= line_size; i += sizeof(lanes)) {
+            for (size_t lane = 0; lane < ARRAY_LENGTH(lanes); ++lane) {
+                uint64_t word;
+                memcpy(&word, line + i + lane * sizeof(word), sizeof(word));
+                lanes[lane] = hash_mix(lanes[lane], word);
+            }
+        }
+        for (; i < line_size; i += sizeof(uint64_t)) {
+            uint64_t word;
+            memcpy(&word, line + i, sizeof(word));
+            lanes[0] = hash_mix(lanes[0], word);
+        }
+    }
+
+    return hash_mix(hash_mix(hash_mix(lanes[0], lanes[1]), lanes[2]), lanes[3]);
+}
+
+dsp_status dsp_convert_rgba_to_a420(const dsp_data_plane_t *rgba,
+                                    size_t width,
+                                    size_t height,
+                                    const dsp_image_properties_t *a420)
+{
+    auto status = verify_rgba_plane(rgba, width, height);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    status = verify_image_properties(a420);
+    if (status != DSP_SUCCESS) {
+        LOGGER__ERROR("Error: Image properties check failed for \"a420\"\n");
+        return status;
+    }
+
+    if ((a420->format != DSP_IMAGE_FORMAT_A420) || (a420->memory != DSP_MEMORY_TYPE_USERPTR)) {
+        LOGGER__ERROR("Error: Image format ({}) or memory type ({}) is not supported\n",
+                      format_arg_to_string(a420->format), a420->memory);
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    if ((a420->width != width) || (a420->height != height)) {
+        LOGGER__ERROR("Error: Image size ({}x{}) differs from the RGBA image size ({}x{})\n", a420->width,
+                      a420->height, width, height);
+        return DSP_INVALID_ARGUMENT;
+    }
+
+    convert_rgba_to_a420(*rgba, width, 0, height, a420->planes);
+    return DSP_SUCCESS;
+}
@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2017-2024 Hailo Technologies Ltd. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "hailo/hailodsp.h"
+
+#include <cstddef>
+#include <cstdint>
+
+dsp_status verify_rgba_plane(const dsp_data_plane_t *rgba, size_t width, size_t height);
+
+// Converts lines [start_y, end_y) of a verified RGBA image into the planes of an A420 image of the same size, with the
+// BT.601 coefficients of the DSP format conversion. "start_y" and "end_y" are even
+void convert_rgba_to_a420(const dsp_data_plane_t &rgba,
+                          size_t width,
+                          size_t start_y,
+                          size_t end_y,
+                          const dsp_data_plane_t a420_planes[]);
+
+// Hash of the pixels of lines [start_y, end_y) of a verified RGBA image, ignoring the line padding. It detects
+// changed content, and is not collision resistant against crafted input
+uint64_t hash_rgba_lines(const dsp_data_plane_t &rgba, size_t width, size_t start_y, size_t end_y);
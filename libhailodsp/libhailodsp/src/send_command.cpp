@@ -26,19 +26,33 @@
 #include "hailodsp_driver.hpp"
 #include "image_utils.hpp"
 #include "logger_macros.hpp"
+#include "request_pool.hpp"
 #include "send_command.hpp"
 
-dsp_status add_images_to_buffer_list(BufferList &buffer_list, std::vector<command_image_t> images)
+ImagingCommand::ImagingCommand() : request(nullptr, &free), payload(nullptr, &free)
 {
-    for (auto &image : images) {
+    // A new command starts a new host overhead sample on this thread
+    host_stats_begin_command();
+    HOST_STATS_STAGE(DSP_HOST_STAGE_REQUEST_ALLOC);
+    request = make_pooled_request();
+}
+
+dsp_status add_images_to_buffer_list(BufferList &buffer_list, std::span<const command_image_t> images)
+{
+    HOST_STATS_STAGE(DSP_HOST_STAGE_CONVERT);
+    for (const auto &image : images) {
         auto status = convert_image(image.user_api_image, image.dsp_api_image);
         if (status != DSP_SUCCESS) {
             return status;
         }
 
         for (size_t j = 0; j < image.dsp_api_image->planes_count; j++) {
-            image.dsp_api_image->planes[j].xrp_buffer_index =
-                buffer_list.add_plane(image.user_api_image->planes[j], image.access_type, image.user_api_image->memory);
+            const auto &user_image = *image.user_api_image;
+            status = buffer_list.add_plane(user_image.planes[j], image.access_type, user_image.memory,
+                                           image.dsp_api_image->planes[j].xrp_buffer_index);
+            if (status != DSP_SUCCESS) {
+                return status;
+            }
         }
     }
 
@@ -50,13 +64,23 @@ dsp_status send_command(dsp_device device,
                         const void *in_data,
                         size_t in_data_size,
                         void *out_data,
-                        size_t out_data_size)
+                        size_t out_data_size,
+                        dsp_priority_t priority)
 {
-    return driver_send_command(device->fd, IMAGING_NSID, buffer_list, in_data, in_data_size, out_data, out_data_size);
+    device->buffer_registry->translate(buffer_list);
+
+    auto queue_priority = get_queue_priority(get_command_priority(device, priority));
+
+    auto &context = get_submission_context(device);
+    context.outstanding_commands.fetch_add(1, std::memory_order_relaxed);
+    auto status = driver_send_command(*device->driver, IMAGING_NSID, buffer_list, in_data, in_data_size, out_data,
+                                      out_data_size, queue_priority);
+    context.outstanding_commands.fetch_sub(1, std::memory_order_relaxed);
+    return status;
 }
 
 dsp_status send_command(dsp_device device,
-                        std::vector<command_image_t> images,
+                        std::span<const command_image_t> images,
                         const void *in_data,
                         size_t in_data_size,
                         void *out_data,
@@ -70,3 +94,20 @@ dsp_status send_command(dsp_device device,
 
     return send_command(device, buffer_list, in_data, in_data_size, out_data, out_data_size);
 }
+
+dsp_status send_command(dsp_device device, ImagingCommand &command, perf_info_t *perf_info)
+{
+    size_t perf_info_size = perf_info ? sizeof(*perf_info) : 0;
+
+    // Asynchronous commands have their sample attached on submission, and nothing is pending on the worker thread
+    command.host_sample += host_stats_take_pending();
+    dsp_status status;
+    {
+        HOST_STATS_STAGE(DSP_HOST_STAGE_DRIVER_CALL, &command.host_sample);
+        status = send_command(device, command.buffer_list, command.request.get(), sizeof(imaging_request_t),
+                              perf_info, perf_info_size, command.priority);
+    }
+    host_stats_commit(static_cast<imaging_operation_t>(command.request->operation), command.host_sample);
+
+    return status;
+}
@@ -23,12 +23,16 @@
 
 #pragma once
 
+#include "aligned_uptr.hpp"
 #include "buffer_list.hpp"
 #include "hailo/hailodsp.h"
+#include "host_stats.hpp"
+#include "logger_macros.hpp"
 #include "user_dsp_interface.h"
 #include "xrp_types.h"
 
 #include <functional>
+#include <span>
 
 #include "xrp_kernel_defs.h"
 
@@ -38,18 +42,77 @@ typedef struct {
     BufferAccessType access_type;
 } command_image_t;
 
+// A fully encoded imaging request, together with the buffers it references.
+// Operations build an ImagingCommand and then either send it synchronously or hand it over to a dsp_job
+struct ImagingCommand {
+    ImagingCommand();
+
+    unique_ptr_aligned<imaging_request_t> request;
+    // Operation data that the request references through the buffer list (e.g. per-ROI arrays). Owned by the
+    // command, so it remains valid until an asynchronous command completes
+    unique_ptr_aligned<uint8_t> payload;
+    BufferList buffer_list;
+    host_sample_t host_sample = {};
+    // Resolved on submission of asynchronous commands, on the submitting thread
+    dsp_priority_t priority = DSP_PRIORITY_DEFAULT;
+};
+
 dsp_status send_command(dsp_device device,
                         BufferList &buffers,
                         const void *in_data,
                         size_t in_data_size,
                         void *out_data,
-                        size_t out_data_size);
+                        size_t out_data_size,
+                        dsp_priority_t priority = DSP_PRIORITY_DEFAULT);
 
 dsp_status send_command(dsp_device device,
-                        std::vector<command_image_t> images,
+                        std::span<const command_image_t> images,
                         const void *in_data,
                         size_t in_data_size,
                         void *out_data,
                         size_t out_data_size);
 
-dsp_status add_images_to_buffer_list(BufferList &buffer_list, std::vector<command_image_t> images);
\ No newline at end of file
+dsp_status send_command(dsp_device device, ImagingCommand &command, perf_info_t *perf_info);
+
+dsp_status add_images_to_buffer_list(BufferList &buffer_list, std::span<const command_image_t> images);
+
+// Encodes an operation that exceeds the limits of a single request as "count" chained requests, executed in order as
+// a single batch command. "build" encodes part "index" of the operation into a request. A single part is encoded
+// directly into the command's request
+template <typename Build>
+dsp_status build_chained_command(ImagingCommand &command, size_t count, Build build)
+{
+    if (count == 1) {
+        return build(0, command.request.get(), command.buffer_list);
+    }
+
+    size_t requests_size = count * sizeof(imaging_request_t);
+    {
+        HOST_STATS_STAGE(DSP_HOST_STAGE_REQUEST_ALLOC);
+        command.payload = make_aligned_array_uptr<uint8_t>(requests_size);
+    }
+    if (!command.payload) {
+        LOGGER__ERROR("Failed to allocate memory for {} chained requests", count);
+        return DSP_OUT_OF_HOST_MEMORY;
+    }
+
+    auto requests = reinterpret_cast<imaging_request_t *>(command.payload.get());
+    command.request->operation = IMAGING_OP_BATCH;
+    command.request->batch_args.requests_count = count;
+    command.request->batch_args.requests.line_stride = sizeof(imaging_request_t);
+    command.request->batch_args.requests.plane_size = requests_size;
+    auto status = command.buffer_list.add_buffer(requests, requests_size, BufferAccessType::Read,
+                                                 command.request->batch_args.requests.xrp_buffer_index);
+    if (status != DSP_SUCCESS) {
+        return status;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        status = build(i, &requests[i], command.buffer_list);
+        if (status != DSP_SUCCESS) {
+            return status;
+        }
+    }
+
+    return DSP_SUCCESS;
+}
\ No newline at end of file
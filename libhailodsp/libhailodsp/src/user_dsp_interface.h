@@ -38,6 +38,8 @@
 #define MAX_BLUR_ROIS (80)
 #define MAX_PRIVACY_MASK_ROIS (8)
 #define INTERFACE_MULTI_RESIZE_OUTPUTS_COUNT (7)
+#define MAX_BATCH_CROP_RESIZE_ENTRIES (256)
+#define MAX_BLEND_ATLAS_ENTRIES (1024)
 #define IDMA_TEST_BUFFER_SIZE (0x100)
 
 #define IDMA_TEST_NSID "idmaidmaidmaidma"
@@ -56,6 +58,24 @@ typedef enum {
     IMAGING_OP_DEWARP,
     IMAGING_OP_MULTI_CROP_AND_RESIZE,
     IMAGING_OP_MULTI_CROP_AND_RESIZE_PRIVACY_MASK,
+    IMAGING_OP_BATCH,
+    // Crop&resize with a format conversion (NV12 <-> RGB) in the same pass. Uses crop_and_resize_args
+    IMAGING_OP_CROP_RESIZE_CONVERT,
+    // Multi crop&resize where every dst may have its own format, and the only one that accepts GRAY8 and RGB sources
+    // (IMAGING_OP_MULTI_CROP_AND_RESIZE is NV12 only). Uses multi_crop_and_resize_args, and applies the privacy mask
+    // only when privacy_mask.rois_count is not 0
+    IMAGING_OP_MULTI_CROP_RESIZE_CONVERT,
+    IMAGING_OP_CROP_RESIZE_TENSOR,
+    IMAGING_OP_BATCH_CROP_RESIZE,
+    // Colors the masked pixels of an NV12 image in place. Only the privacy mask ROIs are scanned
+    IMAGING_OP_PRIVACY_MASK,
+    // Crop&resize of an NV12 source with a privacy mask applied to the source (which is not modified). The dst is
+    // NV12, or RGB when converted in the same pass
+    IMAGING_OP_CROP_RESIZE_PRIVACY_MASK,
+    // Blend of many regions of a single A420 atlas image into an NV12 image
+    IMAGING_OP_BLEND_ATLAS,
+    // Blur where every ROI has its own mode (dsp_blur_mode_t) and kernel size
+    IMAGING_OP_BLUR_ROIS,
 } imaging_operation_t;
 
 enum dsp_interface_image_format {
@@ -65,6 +85,17 @@ enum dsp_interface_image_format {
     INTERFACE_IMAGE_FORMAT_A420,
 };
 
+enum dsp_interface_tensor_layout {
+    INTERFACE_TENSOR_LAYOUT_NHWC,
+    INTERFACE_TENSOR_LAYOUT_NCHW,
+};
+
+enum dsp_interface_tensor_data_type {
+    INTERFACE_TENSOR_DATA_TYPE_UINT8,
+    INTERFACE_TENSOR_DATA_TYPE_INT8,
+    INTERFACE_TENSOR_DATA_TYPE_FLOAT16,
+};
+
 typedef struct {
     uint32_t xrp_buffer_index;
     uint32_t line_stride; // in bytes
@@ -105,6 +136,55 @@ typedef struct {
     uint8_t interpolation;
 } crop_resize_in_data_t;
 
+/*
+ * A 3 channel tensor. Every element is computed from the RGB value of its pixel as
+ * value = pixel[channel] * gain[c] + offset[c], where channel is c for RGB order and 2 - c for BGR order.
+ * Integer data types round and saturate the value, float16 stores it as is.
+ * line_stride is the distance between rows, which for NCHW is also the distance between rows of the same channel.
+ * Channel planes of NCHW tensors are line_stride * height bytes apart
+ */
+typedef struct {
+    data_plane_t data;
+    uint32_t width;
+    uint32_t height;
+    uint8_t layout;
+    uint8_t data_type;
+    uint8_t bgr;
+    float gain[3];
+    float offset[3];
+} tensor_in_data_t;
+
+typedef struct {
+    image_properties_t src;
+    tensor_in_data_t dst;
+    uint32_t crop_start_x;
+    uint32_t crop_start_y;
+    uint32_t crop_end_x;
+    uint32_t crop_end_y;
+    uint8_t interpolation;
+} crop_resize_tensor_in_data_t;
+
+// One output of a batch crop&resize. dst is unused when the batch writes into a tensor
+typedef struct {
+    roi_in_data_t crop;
+    image_properties_t dst;
+} batch_crop_resize_entry_t;
+
+/*
+ * Crops and resizes many regions of one source image as a single command.
+ * The entries are stored contiguously in an xrp buffer (line_stride is sizeof(batch_crop_resize_entry_t)).
+ * When tensor_output is set, entry i is written into dst_tensor at an offset of i * tensor_stride bytes
+ */
+typedef struct {
+    image_properties_t src;
+    data_plane_t entries;
+    uint32_t entries_count;
+    uint8_t interpolation;
+    uint8_t tensor_output;
+    uint32_t tensor_stride;
+    tensor_in_data_t dst_tensor;
+} batch_crop_resize_in_data_t;
+
 typedef struct {
     image_properties_t src;
     image_properties_t dst[INTERFACE_MULTI_RESIZE_OUTPUTS_COUNT];
@@ -117,6 +197,16 @@ typedef struct {
     privacy_mask_in_data_t privacy_mask;
 } multi_crop_resize_in_data_t;
 
+typedef struct {
+    image_properties_t image;
+    privacy_mask_in_data_t privacy_mask;
+} privacy_mask_op_in_data_t;
+
+typedef struct {
+    crop_resize_in_data_t resize;
+    privacy_mask_in_data_t privacy_mask;
+} crop_resize_privacy_mask_in_data_t;
+
 typedef struct {
     image_properties_t overlay;
     uint32_t x_offset;
@@ -129,6 +219,24 @@ typedef struct {
     uint32_t overlays_count;
 } blend_in_data_t;
 
+// One label of an atlas blend. The src region of the atlas has even coordinates
+typedef struct {
+    roi_in_data_t src;
+    uint32_t x_offset;
+    uint32_t y_offset;
+} blend_atlas_entry_t;
+
+/*
+ * Blends regions of one atlas image into the background, in order, so later entries are drawn on top of earlier ones.
+ * The entries are stored contiguously in an xrp buffer (line_stride is sizeof(blend_atlas_entry_t))
+ */
+typedef struct {
+    image_properties_t background;
+    image_properties_t atlas;
+    data_plane_t entries;
+    uint32_t entries_count;
+} blend_atlas_in_data_t;
+
 typedef struct {
     image_properties_t image;
     roi_in_data_t rois[MAX_BLUR_ROIS];
@@ -136,6 +244,25 @@ typedef struct {
     uint32_t kernel_size;
 } blur_in_data_t;
 
+/*
+ * One ROI of a blur with modes. For box and Gaussian blurs, kernel_size is the odd kernel size, and a downscale
+ * greater than 1 blurs a copy of the ROI and its surroundings that is downscaled by that factor, and upscales the
+ * result back into the ROI. For pixelation, kernel_size is the size of the square blocks, which are aligned to the
+ * ROI start, and downscale is 1
+ */
+typedef struct {
+    roi_in_data_t roi;
+    uint32_t kernel_size;
+    uint8_t mode;
+    uint8_t downscale;
+} blur_roi_in_data_t;
+
+typedef struct {
+    image_properties_t image;
+    blur_roi_in_data_t rois[MAX_BLUR_ROIS];
+    uint32_t rois_count;
+} blur_rois_in_data_t;
+
 typedef struct {
     image_properties_t src;
     image_properties_t dst;
@@ -150,6 +277,16 @@ typedef struct {
     uint8_t interpolation;
 } dewarp_in_data_t;
 
+/*
+ * A batch executes several imaging requests, in order, as a single command.
+ * The requests are stored contiguously in an xrp buffer (line_stride is sizeof(imaging_request_t)), and their
+ * xrp_buffer_index fields refer to the buffers of the batch command itself
+ */
+typedef struct {
+    data_plane_t requests;
+    uint32_t requests_count;
+} batch_in_data_t;
+
 typedef struct {
     int32_t operation;
     union {
@@ -159,6 +296,13 @@ typedef struct {
         convert_format_in_data_t convert_format_args;
         dewarp_in_data_t dewarp_args;
         multi_crop_resize_in_data_t multi_crop_and_resize_args;
+        batch_in_data_t batch_args;
+        crop_resize_tensor_in_data_t crop_resize_tensor_args;
+        batch_crop_resize_in_data_t batch_crop_resize_args;
+        privacy_mask_op_in_data_t privacy_mask_args;
+        crop_resize_privacy_mask_in_data_t crop_resize_privacy_mask_args;
+        blend_atlas_in_data_t blend_atlas_args;
+        blur_rois_in_data_t blur_rois_args;
     };
 } imaging_request_t;
 
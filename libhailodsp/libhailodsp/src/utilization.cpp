@@ -37,7 +37,7 @@ dsp_status dsp_get_utilization(dsp_device device, uint32_t &utilization)
     }
 
     utilization_response_t response = {};
-    auto status = driver_send_command(device->fd, UTILIZATION_NSID, nullptr, 0, &response, sizeof(response));
+    auto status = driver_send_command(*device->driver, UTILIZATION_NSID, nullptr, 0, &response, sizeof(response));
     if (status != DSP_SUCCESS) {
         return status;
     }
@@ -43,6 +43,15 @@
 #define XRP_IOCTL_QUEUE		_IO(XRP_IOCTL_MAGIC, 3)
 #define XRP_IOCTL_QUEUE_NS	_IO(XRP_IOCTL_MAGIC, 4)
 #define XRP_IOCTL_DMA_SYNC  _IO(XRP_IOCTL_MAGIC, 5)
+/*
+ * Buffer registration (XRP_IOCTL_REGISTER, XRP_IOCTL_UNREGISTER and XRP_MEMORY_TYPE_REGISTERED) requires a kernel
+ * driver built from this revision of the header. Earlier drivers fail both ioctls with ENOTTY. Handle 0 is never
+ * assigned, so XRP_IOCTL_UNREGISTER of handle 0 queries the capability without side effects: it fails with EINVAL
+ * on drivers that support registration
+ */
+#define XRP_IOCTL_REGISTER  _IO(XRP_IOCTL_MAGIC, 6)
+#define XRP_IOCTL_UNREGISTER  _IO(XRP_IOCTL_MAGIC, 7)
+#define XRP_REGISTER_INVALID_HANDLE 0
 
 struct xrp_ioctl_alloc {
     __u32 size;
@@ -59,6 +68,7 @@ enum ioctl_buffer_flags {
 enum ioctl_memory_type {
     XRP_MEMORY_TYPE_USERPTR,
     XRP_MEMORY_TYPE_DMABUF,
+    XRP_MEMORY_TYPE_REGISTERED,
 };
 
 struct xrp_ioctl_buffer {
@@ -68,9 +78,21 @@ struct xrp_ioctl_buffer {
     union{
         __u64 addr;
         __s32 fd;
+        /* XRP_MEMORY_TYPE_REGISTERED: range within a buffer pinned by XRP_IOCTL_REGISTER */
+        struct {
+            __u32 handle;
+            __u32 offset;
+        } registered;
     };
 };
 
+/* Pins a userspace range once, so it can be referenced by handle in later commands */
+struct xrp_ioctl_register {
+    __u64 addr;
+    __u32 size;
+    __u32 handle;
+};
+
 enum {
     XRP_QUEUE_FLAG_NSID = 0x4,
     XRP_QUEUE_FLAG_PRIO = 0xff00,
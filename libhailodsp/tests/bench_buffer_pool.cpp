@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2017-2024 Hailo Technologies Ltd. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+// Cost of dsp_create_buffer / dsp_release_buffer served from the buffer pool, with several threads allocating from
+// the same size class (every allocation takes the same class mutex) and from separate size classes, next to the
+// cost of the class mutex alone. The emulator allocates with aligned_alloc, so the "Unpooled" baseline measures the
+// driver path without an ioctl
+
+#include "test_utils.hpp"
+
+#include <benchmark/benchmark.h>
+#include <mutex>
+
+// Small enough for the largest class of BM_SeparateSizeClasses to be pooled
+#define BUFFER_SIZE (128 * 1024)
+
+static EmulatorDevice *device;
+
+static void setup(const benchmark::State &)
+{
+    device = new EmulatorDevice(0, true);
+}
+
+static void setup_unpooled(const benchmark::State &state)
+{
+    setup(state);
+    dsp_buffer_pool_params_t params = {
+        .max_cached_bytes = 0,
+        .preallocations = nullptr,
+        .preallocations_count = 0,
+    };
+    (void)dsp_configure_buffer_pool(*device, &params);
+}
+
+static void teardown(const benchmark::State &)
+{
+    delete device;
+}
+
+static void allocate_and_release(benchmark::State &state, size_t size)
+{
+    for (auto _ : state) {
+        void *buffer;
+        if (dsp_create_buffer(*device, size, &buffer) != DSP_SUCCESS) {
+            state.SkipWithError("dsp_create_buffer failed");
+            break;
+        }
+        benchmark::DoNotOptimize(buffer);
+        (void)dsp_release_buffer(*device, buffer);
+    }
+}
+
+static void BM_SameSizeClass(benchmark::State &state)
+{
+    allocate_and_release(state, BUFFER_SIZE);
+}
+
+static void BM_SeparateSizeClasses(benchmark::State &state)
+{
+    // Sizes a power of two apart always fall in different classes
+    allocate_and_release(state, BUFFER_SIZE << state.thread_index());
+}
+
+static void BM_Unpooled(benchmark::State &state)
+{
+    allocate_and_release(state, BUFFER_SIZE);
+}
+
+// The part of a pooled allocation that is serialized between threads of the same size class
+static void BM_ClassMutex(benchmark::State &state)
+{
+    static std::mutex mutex;
+    for (auto _ : state) {
+        std::lock_guard<std::mutex> lock(mutex);
+        benchmark::ClobberMemory();
+    }
+}
+
+#define THREAD_ARGS Teardown(teardown)->ThreadRange(1, 8)->UseRealTime()
+
+BENCHMARK(BM_SameSizeClass)->Setup(setup)->THREAD_ARGS;
+BENCHMARK(BM_SeparateSizeClasses)->Setup(setup)->THREAD_ARGS;
+BENCHMARK(BM_Unpooled)->Setup(setup_unpooled)->THREAD_ARGS;
+BENCHMARK(BM_ClassMutex)->ThreadRange(1, 8)->UseRealTime();
+
+BENCHMARK_MAIN();
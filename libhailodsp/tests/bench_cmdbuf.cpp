@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2017-2024 Hailo Technologies Ltd. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+// Per-frame cost of N crop&resize operations, submitted one by one versus recorded once in a command buffer and
+// submitted as a single command. The emulator runs in no-op mode, so the images are not processed. The first argument
+// is N, the second the emulated per-command latency in microseconds (0 measures the host overhead only)
+
+#include "test_utils.hpp"
+
+#include <benchmark/benchmark.h>
+
+#define SRC_WIDTH (1920)
+#define SRC_HEIGHT (1080)
+#define DST_SIZE (224)
+
+struct Frame {
+    explicit Frame(size_t crops_count) :
+        src(SRC_WIDTH, SRC_HEIGHT, DSP_IMAGE_FORMAT_NV12),
+        dsts(crops_count, TestImage(DST_SIZE, DST_SIZE, DSP_IMAGE_FORMAT_NV12))
+    {
+        for (size_t i = 0; i < crops_count; ++i) {
+            size_t x = (i * 97) % (SRC_WIDTH - 400);
+            size_t y = (i * 53) % (SRC_HEIGHT - 400);
+            crops.push_back({.start_x = x, .start_y = y, .end_x = x + 400, .end_y = y + 400});
+        }
+    }
+
+    dsp_resize_params_t params(size_t index)
+    {
+        return {src.get(), dsts[index].get(), INTERPOLATION_TYPE_BILINEAR};
+    }
+
+    TestImage src;
+    std::vector<TestImage> dsts;
+    std::vector<dsp_roi_t> crops;
+};
+
+static void BM_PerOperation(benchmark::State &state)
+{
+    size_t crops_count = state.range(0);
+    unsigned latency_us = static_cast<unsigned>(state.range(1));
+    EmulatorDevice device(latency_us, true);
+    Frame frame(crops_count);
+
+    for (auto _ : state) {
+        for (size_t i = 0; i < crops_count; ++i) {
+            auto params = frame.params(i);
+            if (dsp_crop_and_resize(device, &params, &frame.crops[i]) != DSP_SUCCESS) {
+                state.SkipWithError("dsp_crop_and_resize failed");
+                return;
+            }
+        }
+    }
+    state.counters["ops"] = benchmark::Counter(state.iterations() * crops_count, benchmark::Counter::kIsRate);
+}
+
+static void BM_Cmdbuf(benchmark::State &state)
+{
+    size_t crops_count = state.range(0);
+    unsigned latency_us = static_cast<unsigned>(state.range(1));
+    EmulatorDevice device(latency_us, true);
+    Frame frame(crops_count);
+    // A new frame arrives in a different buffer every iteration, and is bound to the recorded source image
+    TestImage next_src(SRC_WIDTH, SRC_HEIGHT, DSP_IMAGE_FORMAT_NV12);
+
+    dsp_cmdbuf cmdbuf;
+    if (dsp_create_cmdbuf(device, &cmdbuf) != DSP_SUCCESS) {
+        state.SkipWithError("dsp_create_cmdbuf failed");
+        return;
+    }
+    for (size_t i = 0; i < crops_count; ++i) {
+        auto params = frame.params(i);
+        (void)dsp_cmdbuf_record_crop_and_resize(cmdbuf, &params, &frame.crops[i]);
+    }
+
+    bool use_next = false;
+    for (auto _ : state) {
+        auto bound = use_next ? next_src.get() : frame.src.get();
+        use_next = !use_next;
+        if ((dsp_cmdbuf_bind_image(cmdbuf, frame.src.get(), bound) != DSP_SUCCESS) ||
+            (dsp_cmdbuf_submit(cmdbuf) != DSP_SUCCESS)) {
+            state.SkipWithError("Command buffer submission failed");
+            break;
+        }
+    }
+    state.counters["ops"] = benchmark::Counter(state.iterations() * crops_count, benchmark::Counter::kIsRate);
+
+    (void)dsp_release_cmdbuf(cmdbuf);
+}
+
+#define FRAME_ARGS ArgsProduct({{1, 4, 16}, {0, 200}})->Unit(benchmark::kMicrosecond)->UseRealTime()
+
+BENCHMARK(BM_PerOperation)->FRAME_ARGS;
+BENCHMARK(BM_Cmdbuf)->FRAME_ARGS;
+
+BENCHMARK_MAIN();
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2017-2024 Hailo Technologies Ltd. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+// Host overhead of the submission path, against the emulator in no-op mode, so the DSP work itself costs nothing.
+// Reports ns/op, and the allocations/op made by the submitting thread through the global allocation functions.
+// With a library built with DSP_HOST_STATS, the allocations are also attributed to the stages of dsp_get_host_stats
+
+#include "allocation_counter.hpp"
+#include "test_utils.hpp"
+
+#include <benchmark/benchmark.h>
+
+#define SRC_WIDTH (1920)
+#define SRC_HEIGHT (1080)
+#define DST_SIZE (224)
+
+class AllocationsCounter {
+   public:
+    explicit AllocationsCounter(benchmark::State &state) : m_state(state), m_start(thread_allocations_count()) {}
+    ~AllocationsCounter()
+    {
+        double allocations = static_cast<double>(thread_allocations_count() - m_start);
+        m_state.counters["allocs/op"] = benchmark::Counter(allocations, benchmark::Counter::kAvgIterations);
+    }
+
+   private:
+    benchmark::State &m_state;
+    uint64_t m_start;
+};
+
+static void BM_CropAndResize(benchmark::State &state)
+{
+    EmulatorDevice device(0, true);
+    TestImage src(SRC_WIDTH, SRC_HEIGHT, DSP_IMAGE_FORMAT_NV12);
+    TestImage dst(DST_SIZE, DST_SIZE, DSP_IMAGE_FORMAT_NV12);
+    dsp_resize_params_t params = {src.get(), dst.get(), INTERPOLATION_TYPE_BILINEAR};
+    dsp_roi_t crop = {.start_x = 100, .start_y = 100, .end_x = 500, .end_y = 500};
+
+    // The first command creates the per-thread state of the device
+    (void)dsp_crop_and_resize(device, &params, &crop);
+
+    AllocationsCounter allocations(state);
+    for (auto _ : state) {
+        if (dsp_crop_and_resize(device, &params, &crop) != DSP_SUCCESS) {
+            state.SkipWithError("dsp_crop_and_resize failed");
+            break;
+        }
+    }
+}
+
+static void BM_CropAndResizeAsync(benchmark::State &state)
+{
+    EmulatorDevice device(0, true);
+    TestImage src(SRC_WIDTH, SRC_HEIGHT, DSP_IMAGE_FORMAT_NV12);
+    TestImage dst(DST_SIZE, DST_SIZE, DSP_IMAGE_FORMAT_NV12);
+    dsp_resize_params_t params = {src.get(), dst.get(), INTERPOLATION_TYPE_BILINEAR};
+    dsp_roi_t crop = {.start_x = 100, .start_y = 100, .end_x = 500, .end_y = 500};
+
+    AllocationsCounter allocations(state);
+    for (auto _ : state) {
+        dsp_job job;
+        if (dsp_crop_and_resize_async(device, &params, &crop, &job) != DSP_SUCCESS) {
+            state.SkipWithError("dsp_crop_and_resize_async failed");
+            break;
+        }
+        (void)dsp_job_wait(job);
+        (void)dsp_job_release(job);
+    }
+}
+
+static void BM_MultiCropAndResize(benchmark::State &state)
+{
+    EmulatorDevice device(0, true);
+    TestImage src(SRC_WIDTH, SRC_HEIGHT, DSP_IMAGE_FORMAT_NV12);
+    std::vector<TestImage> dsts(DSP_MULTI_RESIZE_OUTPUTS_COUNT, TestImage(DST_SIZE, DST_SIZE, DSP_IMAGE_FORMAT_NV12));
+    dsp_multi_resize_params_t params = {
+        .src = src.get(),
+        .dst = {},
+        .interpolation = INTERPOLATION_TYPE_BILINEAR,
+    };
+    dsp_roi_t crop = {.start_x = 100, .start_y = 100, .end_x = 500, .end_y = 500};
+    for (size_t i = 0; i < DSP_MULTI_RESIZE_OUTPUTS_COUNT; ++i) {
+        params.dst[i] = dsts[i].get();
+    }
+
+    (void)dsp_multi_crop_and_resize(device, &params, &crop);
+
+    AllocationsCounter allocations(state);
+    for (auto _ : state) {
+        if (dsp_multi_crop_and_resize(device, &params, &crop) != DSP_SUCCESS) {
+            state.SkipWithError("dsp_multi_crop_and_resize failed");
+            break;
+        }
+    }
+}
+
+BENCHMARK(BM_CropAndResize);
+BENCHMARK(BM_CropAndResizeAsync);
+BENCHMARK(BM_MultiCropAndResize);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2017-2024 Hailo Technologies Ltd. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+// Per-frame submission latency with the frame buffers passed by address, and with the same buffers registered with
+// dsp_register_buffer. The emulator runs in no-op mode, so only the host side is measured: the emulator accesses
+// userspace memory directly, and does not model the per-command page pinning that registration saves in the kernel
+// driver
+
+#include "test_utils.hpp"
+
+#include <benchmark/benchmark.h>
+#include <memory>
+
+#define SRC_WIDTH (1920)
+#define SRC_HEIGHT (1080)
+#define DST_SIZE (224)
+#define CROPS_COUNT (4)
+
+// Image whose planes are carved out of one DSP buffer
+class BufferImage {
+   public:
+    BufferImage(dsp_device device, size_t width, size_t height, dsp_image_format_t format) : m_device(device)
+    {
+        size_t planes_count = 0;
+        (void)get_packed_image_layout(format, width, height, m_planes, planes_count);
+        for (size_t i = 0; i < planes_count; ++i) {
+            m_size += m_planes[i].bytesused;
+        }
+        m_status = dsp_create_buffer(device, m_size, &m_buffer);
+
+        auto data = static_cast<uint8_t *>(m_buffer);
+        for (size_t i = 0; i < planes_count; ++i) {
+            m_planes[i].userptr = data;
+            data += m_planes[i].bytesused;
+        }
+        m_image = {width, height, m_planes, planes_count, format, DSP_MEMORY_TYPE_USERPTR};
+    }
+
+    ~BufferImage()
+    {
+        if (m_registered) {
+            (void)dsp_unregister_buffer(m_device, m_buffer);
+        }
+        if (m_status == DSP_SUCCESS) {
+            (void)dsp_release_buffer(m_device, m_buffer);
+        }
+    }
+
+    dsp_status register_buffer()
+    {
+        m_registered = true;
+        return dsp_register_buffer(m_device, m_buffer, m_size);
+    }
+
+    dsp_status status() const { return m_status; }
+    const dsp_image_properties_t *get() const { return &m_image; }
+
+   private:
+    dsp_device m_device;
+    dsp_status m_status;
+    void *m_buffer = nullptr;
+    size_t m_size = 0;
+    bool m_registered = false;
+    dsp_data_plane_t m_planes[MAX_PLANES] = {};
+    dsp_image_properties_t m_image;
+};
+
+static void BM_FrameSubmission(benchmark::State &state)
+{
+    bool registered = state.range(0) != 0;
+    EmulatorDevice device(0, true);
+
+    BufferImage src(device, SRC_WIDTH, SRC_HEIGHT, DSP_IMAGE_FORMAT_NV12);
+    std::vector<std::unique_ptr<BufferImage>> dsts;
+    for (size_t i = 0; i < CROPS_COUNT; ++i) {
+        dsts.push_back(std::make_unique<BufferImage>(device, DST_SIZE, DST_SIZE, DSP_IMAGE_FORMAT_NV12));
+    }
+    if (registered) {
+        (void)src.register_buffer();
+        for (auto &dst : dsts) {
+            (void)dst->register_buffer();
+        }
+    }
+
+    for (auto _ : state) {
+        for (size_t i = 0; i < CROPS_COUNT; ++i) {
+            dsp_resize_params_t params = {src.get(), dsts[i]->get(), INTERPOLATION_TYPE_BILINEAR};
+            dsp_roi_t crop = {.start_x = 100 * i, .start_y = 50 * i, .end_x = 100 * i + 600, .end_y = 50 * i + 600};
+            if (dsp_crop_and_resize(device, &params, &crop) != DSP_SUCCESS) {
+                state.SkipWithError("dsp_crop_and_resize failed");
+                return;
+            }
+        }
+    }
+}
+
+BENCHMARK(BM_FrameSubmission)->ArgName("registered")->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
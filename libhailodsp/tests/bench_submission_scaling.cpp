@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2017-2024 Hailo Technologies Ltd. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+// Submission throughput against the number of threads submitting to one device. The emulator runs in no-op mode
+// without latency, so commands are not serialized by the driver and only the host side of the submission path is
+// measured: with no shared mutable state between the submitting threads, ops/s should grow with the thread count up
+// to the number of cores. The asynchronous variant goes through the device's single worker thread, so it does not
+
+#include "test_utils.hpp"
+
+#include <benchmark/benchmark.h>
+
+static EmulatorDevice *device;
+
+static void setup(const benchmark::State &)
+{
+    device = new EmulatorDevice(0, true);
+}
+
+static void teardown(const benchmark::State &)
+{
+    delete device;
+}
+
+static void BM_CropAndResize(benchmark::State &state)
+{
+    TestImage src(1920, 1080, DSP_IMAGE_FORMAT_NV12);
+    TestImage dst(224, 224, DSP_IMAGE_FORMAT_NV12);
+    dsp_resize_params_t params = {src.get(), dst.get(), INTERPOLATION_TYPE_BILINEAR};
+    dsp_roi_t crop = {.start_x = 100, .start_y = 100, .end_x = 500, .end_y = 500};
+
+    for (auto _ : state) {
+        if (dsp_crop_and_resize(*device, &params, &crop) != DSP_SUCCESS) {
+            state.SkipWithError("dsp_crop_and_resize failed");
+            break;
+        }
+    }
+    state.counters["ops"] = benchmark::Counter(state.iterations(), benchmark::Counter::kIsRate);
+}
+
+static void BM_CropAndResizeAsync(benchmark::State &state)
+{
+    TestImage src(1920, 1080, DSP_IMAGE_FORMAT_NV12);
+    TestImage dst(224, 224, DSP_IMAGE_FORMAT_NV12);
+    dsp_resize_params_t params = {src.get(), dst.get(), INTERPOLATION_TYPE_BILINEAR};
+    dsp_roi_t crop = {.start_x = 100, .start_y = 100, .end_x = 500, .end_y = 500};
+
+    for (auto _ : state) {
+        dsp_job job;
+        if (dsp_crop_and_resize_async(*device, &params, &crop, &job) != DSP_SUCCESS) {
+            state.SkipWithError("dsp_crop_and_resize_async failed");
+            break;
+        }
+        (void)dsp_job_release(job);
+    }
+    state.counters["ops"] = benchmark::Counter(state.iterations(), benchmark::Counter::kIsRate);
+}
+
+#define THREAD_ARGS Setup(setup)->Teardown(teardown)->ThreadRange(1, 8)->UseRealTime()
+
+BENCHMARK(BM_CropAndResize)->THREAD_ARGS;
+BENCHMARK(BM_CropAndResizeAsync)->THREAD_ARGS;
+
+BENCHMARK_MAIN();
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2017-2024 Hailo Technologies Ltd. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+// The steady-state submission path must not touch the heap: once a thread submitted its first command, commands of
+// a single operation are built in pooled and inline storage. Runs against the emulator in no-op mode, so only the
+// host side is measured
+
+#include "allocation_counter.hpp"
+#include "test_utils.hpp"
+
+#include <gtest/gtest.h>
+
+#define ITERATIONS (100)
+
+class AllocationsTest : public ::testing::Test {
+   protected:
+    void SetUp() override { ASSERT_EQ(m_device.status(), DSP_SUCCESS); }
+
+    // Allocations made by "submit" over ITERATIONS calls, after a first call that creates the per-thread state
+    template <typename Submit>
+    uint64_t steady_state_allocations(Submit submit)
+    {
+        if (submit() != DSP_SUCCESS) {
+            ADD_FAILURE() << "first submission failed";
+        }
+
+        auto start = thread_allocations_count();
+        bool succeeded = true;
+        for (size_t i = 0; i < ITERATIONS; ++i) {
+            succeeded &= (submit() == DSP_SUCCESS);
+        }
+        auto allocations = thread_allocations_count() - start;
+
+        EXPECT_TRUE(succeeded);
+        return allocations;
+    }
+
+    EmulatorDevice m_device{0, true};
+    TestImage m_src{1920, 1080, DSP_IMAGE_FORMAT_NV12};
+    dsp_roi_t m_crop = {.start_x = 100, .start_y = 100, .end_x = 500, .end_y = 500};
+};
+
+TEST_F(AllocationsTest, CropAndResize)
+{
+    TestImage dst(224, 224, DSP_IMAGE_FORMAT_NV12);
+    dsp_resize_params_t params = {m_src.get(), dst.get(), INTERPOLATION_TYPE_BILINEAR};
+
+    EXPECT_EQ(steady_state_allocations([&] { return dsp_crop_and_resize(m_device, &params, &m_crop); }), 0u);
+}
+
+TEST_F(AllocationsTest, MultiCropAndResize)
+{
+    std::vector<TestImage> dsts(DSP_MULTI_RESIZE_OUTPUTS_COUNT, TestImage(224, 224, DSP_IMAGE_FORMAT_NV12));
+    dsp_multi_resize_params_t params = {
+        .src = m_src.get(),
+        .dst = {},
+        .interpolation = INTERPOLATION_TYPE_BILINEAR,
+    };
+    for (size_t i = 0; i < DSP_MULTI_RESIZE_OUTPUTS_COUNT; ++i) {
+        params.dst[i] = dsts[i].get();
+    }
+
+    EXPECT_EQ(steady_state_allocations([&] { return dsp_multi_crop_and_resize(m_device, &params, &m_crop); }), 0u);
+}
+
+TEST_F(AllocationsTest, PlanExecute)
+{
+    TestImage dst(224, 224, DSP_IMAGE_FORMAT_NV12);
+    dsp_resize_params_t params = {m_src.get(), dst.get(), INTERPOLATION_TYPE_BILINEAR};
+    dsp_plan plan;
+    ASSERT_EQ(dsp_plan_create_crop_and_resize(m_device, &params, &m_crop, &plan), DSP_SUCCESS);
+
+    dsp_data_plane_t planes[] = {m_src.planes()[0], m_src.planes()[1], dst.planes()[0], dst.planes()[1]};
+    EXPECT_EQ(steady_state_allocations([&] { return dsp_plan_execute(plan, planes, 4); }), 0u);
+
+    EXPECT_EQ(dsp_release_plan(plan), DSP_SUCCESS);
+}
+
+TEST_F(AllocationsTest, CmdbufSubmit)
+{
+    std::vector<TestImage> dsts(4, TestImage(224, 224, DSP_IMAGE_FORMAT_NV12));
+    dsp_cmdbuf cmdbuf;
+    ASSERT_EQ(dsp_create_cmdbuf(m_device, &cmdbuf), DSP_SUCCESS);
+    for (auto &dst : dsts) {
+        dsp_resize_params_t params = {m_src.get(), dst.get(), INTERPOLATION_TYPE_BILINEAR};
+        ASSERT_EQ(dsp_cmdbuf_record_crop_and_resize(cmdbuf, &params, &m_crop), DSP_SUCCESS);
+    }
+
+    EXPECT_EQ(steady_state_allocations([&] { return dsp_cmdbuf_submit(cmdbuf); }), 0u);
+
+    EXPECT_EQ(dsp_release_cmdbuf(cmdbuf), DSP_SUCCESS);
+}
@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2017-2024 Hailo Technologies Ltd. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "test_utils.hpp"
+
+#include <chrono>
+#include <gtest/gtest.h>
+#include <poll.h>
+
+#define LATENCY_US (20000)
+#define JOBS_COUNT (8)
+
+using namespace std::chrono;
+
+static dsp_resize_params_t make_resize_params(TestImage &src, TestImage &dst)
+{
+    return {
+        .src = src.get(),
+        .dst = dst.get(),
+        .interpolation = INTERPOLATION_TYPE_BILINEAR,
+    };
+}
+
+TEST(AsyncTest, ResultMatchesSynchronousOperation)
+{
+    EmulatorDevice device(LATENCY_US);
+    ASSERT_EQ(device.status(), DSP_SUCCESS);
+
+    TestImage src(320, 240, DSP_IMAGE_FORMAT_NV12);
+    src.fill_random(1);
+    TestImage sync_dst(128, 96, DSP_IMAGE_FORMAT_NV12);
+    TestImage async_dst(128, 96, DSP_IMAGE_FORMAT_NV12);
+    dsp_roi_t crop = {.start_x = 16, .start_y = 8, .end_x = 300, .end_y = 200};
+
+    auto sync_params = make_resize_params(src, sync_dst);
+    ASSERT_EQ(dsp_crop_and_resize(device, &sync_params, &crop), DSP_SUCCESS);
+
+    auto async_params = make_resize_params(src, async_dst);
+    dsp_job job;
+    ASSERT_EQ(dsp_crop_and_resize_async(device, &async_params, &crop, &job), DSP_SUCCESS);
+    EXPECT_EQ(dsp_job_wait(job), DSP_SUCCESS);
+    EXPECT_EQ(dsp_job_release(job), DSP_SUCCESS);
+
+    EXPECT_TRUE(sync_dst == async_dst);
+}
+
+TEST(AsyncTest, SubmissionDoesNotWaitForTheDevice)
+{
+    EmulatorDevice device(LATENCY_US);
+    ASSERT_EQ(device.status(), DSP_SUCCESS);
+
+    TestImage src(64, 64, DSP_IMAGE_FORMAT_GRAY8);
+    TestImage dst(32, 32, DSP_IMAGE_FORMAT_GRAY8);
+    auto params = make_resize_params(src, dst);
+
+    auto start = steady_clock::now();
+    dsp_job job;
+    ASSERT_EQ(dsp_resize_async(device, &params, &job), DSP_SUCCESS);
+    auto submit_time = steady_clock::now() - start;
+
+    EXPECT_EQ(dsp_job_poll(job), DSP_IN_PROGRESS);
+    EXPECT_LT(submit_time, microseconds(LATENCY_US / 2));
+
+    EXPECT_EQ(dsp_job_wait(job), DSP_SUCCESS);
+    EXPECT_GE(steady_clock::now() - start, microseconds(LATENCY_US));
+    EXPECT_EQ(dsp_job_poll(job), DSP_SUCCESS);
+    EXPECT_EQ(dsp_job_release(job), DSP_SUCCESS);
+}
+
+TEST(AsyncTest, JobsCompleteInSubmissionOrder)
+{
+    EmulatorDevice device(LATENCY_US / 4);
+    ASSERT_EQ(device.status(), DSP_SUCCESS);
+
+    TestImage src(64, 64, DSP_IMAGE_FORMAT_GRAY8);
+    src.fill_random(2);
+    std::vector<TestImage> dsts(JOBS_COUNT, TestImage(32, 32, DSP_IMAGE_FORMAT_GRAY8));
+    dsp_job jobs[JOBS_COUNT];
+    for (size_t i = 0; i < JOBS_COUNT; ++i) {
+        auto params = make_resize_params(src, dsts[i]);
+        ASSERT_EQ(dsp_resize_async(device, &params, &jobs[i]), DSP_SUCCESS);
+    }
+
+    // Waiting on the last job, all earlier jobs on the device are done as well
+    EXPECT_EQ(dsp_job_wait(jobs[JOBS_COUNT - 1]), DSP_SUCCESS);
+    for (size_t i = 0; i < JOBS_COUNT; ++i) {
+        EXPECT_EQ(dsp_job_poll(jobs[i]), DSP_SUCCESS);
+        EXPECT_TRUE(dsts[i] == dsts[0]);
+        EXPECT_EQ(dsp_job_release(jobs[i]), DSP_SUCCESS);
+    }
+}
+
+TEST(AsyncTest, FdBecomesReadableOnCompletion)
+{
+    EmulatorDevice device(LATENCY_US);
+    ASSERT_EQ(device.status(), DSP_SUCCESS);
+
+    TestImage src(64, 64, DSP_IMAGE_FORMAT_GRAY8);
+    TestImage dst(32, 32, DSP_IMAGE_FORMAT_GRAY8);
+    auto params = make_resize_params(src, dst);
+
+    dsp_job job;
+    ASSERT_EQ(dsp_resize_async(device, &params, &job), DSP_SUCCESS);
+    int fd;
+    ASSERT_EQ(dsp_job_get_fd(job, &fd), DSP_SUCCESS);
+
+    struct pollfd job_poll = {.fd = fd, .events = POLLIN, .revents = 0};
+    EXPECT_EQ(poll(&job_poll, 1, 0), 0);
+    EXPECT_EQ(poll(&job_poll, 1, 10 * LATENCY_US / 1000), 1);
+    EXPECT_EQ(dsp_job_poll(job), DSP_SUCCESS);
+    EXPECT_EQ(dsp_job_release(job), DSP_SUCCESS);
+}
+
+TEST(AsyncTest, DetachedJobIsReleasedOnCompletion)
+{
+    EmulatorDevice device(LATENCY_US);
+    ASSERT_EQ(device.status(), DSP_SUCCESS);
+
+    TestImage src(64, 64, DSP_IMAGE_FORMAT_GRAY8);
+    src.fill(100);
+    TestImage dst(32, 32, DSP_IMAGE_FORMAT_GRAY8);
+    auto params = make_resize_params(src, dst);
+
+    dsp_job job;
+    ASSERT_EQ(dsp_resize_async(device, &params, &job), DSP_SUCCESS);
+    EXPECT_EQ(dsp_job_detach(job), DSP_SUCCESS);
+
+    // Jobs of a device are executed in order, so the detached job is done once a later one is
+    ASSERT_EQ(dsp_resize_async(device, &params, &job), DSP_SUCCESS);
+    EXPECT_EQ(dsp_job_wait(job), DSP_SUCCESS);
+    EXPECT_EQ(dsp_job_release(job), DSP_SUCCESS);
+    EXPECT_EQ(dst.plane(0)[0], 100);
+}
+
+TEST(AsyncTest, InvalidParametersAreRejectedOnSubmission)
+{
+    EmulatorDevice device(LATENCY_US);
+    ASSERT_EQ(device.status(), DSP_SUCCESS);
+
+    TestImage src(64, 64, DSP_IMAGE_FORMAT_GRAY8);
+    TestImage dst(32, 32, DSP_IMAGE_FORMAT_RGB);
+    auto params = make_resize_params(src, dst);
+
+    dsp_job job = nullptr;
+    EXPECT_NE(dsp_resize_async(device, &params, &job), DSP_SUCCESS);
+    EXPECT_EQ(job, nullptr);
+    EXPECT_EQ(dsp_resize_async(device, &params, nullptr), DSP_INVALID_ARGUMENT);
+}
+
+TEST(AsyncTest, ReleasingTheDeviceCompletesPendingJobs)
+{
+    TestImage src(64, 64, DSP_IMAGE_FORMAT_GRAY8);
+    src.fill(7);
+    TestImage dst(32, 32, DSP_IMAGE_FORMAT_GRAY8);
+    auto params = make_resize_params(src, dst);
+
+    dsp_job job;
+    {
+        EmulatorDevice device(LATENCY_US);
+        ASSERT_EQ(device.status(), DSP_SUCCESS);
+        ASSERT_EQ(dsp_resize_async(device, &params, &job), DSP_SUCCESS);
+    }
+
+    EXPECT_EQ(dsp_job_poll(job), DSP_SUCCESS);
+    EXPECT_EQ(dsp_job_release(job), DSP_SUCCESS);
+    EXPECT_EQ(dst.plane(0)[0], 7);
+}
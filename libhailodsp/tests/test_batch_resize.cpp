@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2017-2024 Hailo Technologies Ltd. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+// Batch crop&resize, against a crop&resize call per ROI
+
+#include "test_utils.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+#define SRC_WIDTH (640)
+#define SRC_HEIGHT (480)
+
+// ROIs of different sizes and positions, with even coordinates for NV12 sources
+static std::vector<dsp_roi_t> make_rois(size_t count)
+{
+    std::vector<dsp_roi_t> rois;
+    for (size_t i = 0; i < count; ++i) {
+        size_t x = (i * 38) % (SRC_WIDTH - 128);
+        size_t y = (i * 22) % (SRC_HEIGHT - 96);
+        rois.push_back({.start_x = x, .start_y = y, .end_x = x + 32 + (i % 5) * 24, .end_y = y + 24 + (i % 4) * 18});
+    }
+    return rois;
+}
+
+class BatchResizeTest : public ::testing::Test {
+   protected:
+    void SetUp() override
+    {
+        ASSERT_EQ(m_device.status(), DSP_SUCCESS);
+        m_src.fill_random(1);
+    }
+
+    EmulatorDevice m_device;
+    TestImage m_src{SRC_WIDTH, SRC_HEIGHT, DSP_IMAGE_FORMAT_NV12};
+};
+
+TEST_F(BatchResizeTest, ImagesMatchCropAndResizePerRoi)
+{
+    auto rois = make_rois(DSP_BATCH_RESIZE_MAX_ROIS);
+
+    // Outputs of different sizes, and both NV12 and converted RGB ones
+    std::vector<TestImage> outputs;
+    std::vector<TestImage> references;
+    for (size_t i = 0; i < rois.size(); ++i) {
+        auto format = (i % 3) ? DSP_IMAGE_FORMAT_NV12 : DSP_IMAGE_FORMAT_RGB;
+        outputs.emplace_back(16 + (i % 4) * 8, 16 + (i % 3) * 8, format);
+        references.emplace_back(16 + (i % 4) * 8, 16 + (i % 3) * 8, format);
+    }
+    std::vector<const dsp_image_properties_t *> dst;
+    for (auto &output : outputs) {
+        dst.push_back(output.get());
+    }
+
+    dsp_batch_resize_params_t params = {
+        .src = m_src.get(),
+        .rois = rois.data(),
+        .rois_count = rois.size(),
+        .dst = dst.data(),
+        .dst_tensor = NULL,
+        .interpolation = INTERPOLATION_TYPE_BILINEAR,
+    };
+    ASSERT_EQ(dsp_batch_crop_and_resize(m_device, &params), DSP_SUCCESS);
+
+    for (size_t i = 0; i < rois.size(); ++i) {
+        dsp_resize_params_t resize_params = {m_src.get(), references[i].get(), INTERPOLATION_TYPE_BILINEAR};
+        ASSERT_EQ(dsp_crop_and_resize(m_device, &resize_params, &rois[i]), DSP_SUCCESS);
+        EXPECT_TRUE(outputs[i] == references[i]) << "roi " << i;
+    }
+}
+
+TEST_F(BatchResizeTest, TensorMatchesCropAndResizePerRoi)
+{
+    auto rois = make_rois(37);
+    const size_t width = 24, height = 16;
+    dsp_tensor_t tensor = {
+        .width = width,
+        .height = height,
+        .layout = DSP_TENSOR_LAYOUT_NCHW,
+        .channel_order = DSP_TENSOR_CHANNEL_ORDER_BGR,
+        .data_type = DSP_TENSOR_DATA_TYPE_INT8,
+        .mean = {104.0f, 117.0f, 123.0f},
+        .std = {57.0f, 57.0f, 58.0f},
+        .quant_scale = 0.02f,
+        .quant_zero_point = -2,
+        .plane = {.userptr = NULL, .bytesperline = width, .bytesused = width * height * 3},
+        .memory = DSP_MEMORY_TYPE_USERPTR,
+    };
+    size_t tensor_size = tensor.plane.bytesused;
+
+    std::vector<uint8_t> batch(tensor_size * rois.size());
+    dsp_tensor_t batch_tensor = tensor;
+    batch_tensor.plane.userptr = batch.data();
+    batch_tensor.plane.bytesused = batch.size();
+    dsp_batch_resize_params_t params = {
+        .src = m_src.get(),
+        .rois = rois.data(),
+        .rois_count = rois.size(),
+        .dst = NULL,
+        .dst_tensor = &batch_tensor,
+        .interpolation = INTERPOLATION_TYPE_BILINEAR,
+    };
+    ASSERT_EQ(dsp_batch_crop_and_resize(m_device, &params), DSP_SUCCESS);
+
+    std::vector<uint8_t> reference(tensor_size);
+    tensor.plane.userptr = reference.data();
+    dsp_tensor_resize_params_t resize_params = {m_src.get(), &tensor, INTERPOLATION_TYPE_BILINEAR};
+    for (size_t i = 0; i < rois.size(); ++i) {
+        ASSERT_EQ(dsp_crop_and_resize_to_tensor(m_device, &resize_params, &rois[i]), DSP_SUCCESS);
+        EXPECT_EQ(memcmp(reference.data(), batch.data() + i * tensor_size, tensor_size), 0) << "roi " << i;
+    }
+}
+
+TEST_F(BatchResizeTest, RejectsInvalidParams)
+{
+    auto rois = make_rois(DSP_BATCH_RESIZE_MAX_ROIS + 1);
+    std::vector<TestImage> outputs(rois.size(), TestImage(16, 16, DSP_IMAGE_FORMAT_NV12));
+    std::vector<const dsp_image_properties_t *> dst;
+    for (auto &output : outputs) {
+        dst.push_back(output.get());
+    }
+
+    dsp_batch_resize_params_t params = {
+        .src = m_src.get(),
+        .rois = rois.data(),
+        .rois_count = 0,
+        .dst = dst.data(),
+        .dst_tensor = NULL,
+        .interpolation = INTERPOLATION_TYPE_BILINEAR,
+    };
+    EXPECT_EQ(dsp_batch_crop_and_resize(m_device, &params), DSP_INVALID_ARGUMENT);
+
+    params.rois_count = DSP_BATCH_RESIZE_MAX_ROIS + 1;
+    EXPECT_EQ(dsp_batch_crop_and_resize(m_device, &params), DSP_INVALID_ARGUMENT);
+
+    // A ROI beyond the source
+    params.rois_count = 2;
+    rois[1].end_x = SRC_WIDTH + 2;
+    EXPECT_EQ(dsp_batch_crop_and_resize(m_device, &params), DSP_INVALID_ARGUMENT);
+    rois[1] = rois[0];
+
+    // Both destination kinds, and none
+    std::vector<uint8_t> data(16 * 16 * 3 * 2);
+    dsp_tensor_t tensor = {
+        .width = 16,
+        .height = 16,
+        .layout = DSP_TENSOR_LAYOUT_NHWC,
+        .channel_order = DSP_TENSOR_CHANNEL_ORDER_RGB,
+        .data_type = DSP_TENSOR_DATA_TYPE_UINT8,
+        .mean = {0, 0, 0},
+        .std = {1, 1, 1},
+        .quant_scale = 1,
+        .quant_zero_point = 0,
+        .plane = {.userptr = data.data(), .bytesperline = 16 * 3, .bytesused = data.size()},
+        .memory = DSP_MEMORY_TYPE_USERPTR,
+    };
+    params.dst_tensor = &tensor;
+    EXPECT_EQ(dsp_batch_crop_and_resize(m_device, &params), DSP_INVALID_ARGUMENT);
+    params.dst = NULL;
+    params.dst_tensor = NULL;
+    EXPECT_EQ(dsp_batch_crop_and_resize(m_device, &params), DSP_INVALID_ARGUMENT);
+
+    // A batch tensor that does not cover all the ROIs
+    params.dst_tensor = &tensor;
+    EXPECT_EQ(dsp_batch_crop_and_resize(m_device, &params), DSP_SUCCESS);
+    params.rois_count = 3;
+    rois[2] = rois[0];
+    EXPECT_EQ(dsp_batch_crop_and_resize(m_device, &params), DSP_INVALID_ARGUMENT);
+}
@@ -0,0 +1,439 @@
+/*
+ * Copyright (c) 2017-2024 Hailo Technologies Ltd. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+// Blur with a mode and a kernel size per ROI: validation of each mode's parameters, box mode against dsp_blur, every
+// mode against a CPU reference, and every submission path against dsp_blur_rois
+
+#include "test_utils.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <gtest/gtest.h>
+
+#define IMAGE_WIDTH (320)
+#define IMAGE_HEIGHT (240)
+// More than the ROIs of a single blur request, so the ROIs are blurred by chained requests
+#define CHAINED_ROIS_COUNT (100)
+
+static const dsp_roi_t ROI = {.start_x = 10, .start_y = 10, .end_x = 100, .end_y = 80};
+
+// Disjoint ROIs of every mode, so each one is blurred from the original pixels whatever request it belongs to
+static std::vector<dsp_blur_roi_params_t> mixed_rois(size_t count)
+{
+    static const dsp_blur_mode_t modes[] = {DSP_BLUR_MODE_BOX, DSP_BLUR_MODE_GAUSSIAN, DSP_BLUR_MODE_PIXELATE};
+    std::vector<dsp_blur_roi_params_t> rois;
+    for (size_t i = 0; i < count; ++i) {
+        size_t x = (i % 16) * 20;
+        size_t y = (i / 16) * 24;
+        auto mode = modes[i % 3];
+        bool pixelate = (mode == DSP_BLUR_MODE_PIXELATE);
+        rois.push_back({
+            .roi = {.start_x = x, .start_y = y, .end_x = x + 16, .end_y = y + 18},
+            .mode = mode,
+            .kernel_size = pixelate ? 1 + i % 9 : 1 + 2 * (i % 8),
+            .downscale = pixelate ? 1 : size_t(1) << (i % 5),
+        });
+    }
+    return rois;
+}
+
+// A plane of a packed test image, whose pixels are clamped to the plane edges
+struct ReferencePlane {
+    uint8_t *data;
+    size_t width;
+    size_t height;
+    size_t channels;
+
+    uint8_t *at(long x, long y)
+    {
+        x = std::clamp<long>(x, 0, width - 1);
+        y = std::clamp<long>(y, 0, height - 1);
+        return &data[(y * width + x) * channels];
+    }
+};
+
+// The luma plane, and the chroma plane of NV12 images at half resolution
+static std::vector<ReferencePlane> reference_planes(TestImage &image)
+{
+    auto width = image.get()->width;
+    auto height = image.get()->height;
+    std::vector<ReferencePlane> planes = {{image.plane(0).data(), width, height, 1}};
+    if (image.get()->format == DSP_IMAGE_FORMAT_NV12) {
+        planes.push_back({image.plane(1).data(), width / 2, height / 2, 2});
+    }
+    return planes;
+}
+
+// Each block of the ROI, aligned to the ROI start, is filled with the rounded mean of its original pixels. The
+// chroma of a luma block covers its pixels from start / 2 to ceil(end / 2)
+static void pixelate_reference(TestImage &image, const dsp_roi_t &roi, size_t block)
+{
+    TestImage original(image);
+    auto planes = reference_planes(image);
+    auto original_planes = reference_planes(original);
+    for (size_t i = 0; i < planes.size(); ++i) {
+        size_t subsampling = i + 1;
+        auto &plane = planes[i];
+        for (size_t luma_y = roi.start_y; luma_y < roi.end_y; luma_y += block) {
+            size_t start_y = luma_y / subsampling;
+            size_t end_y = (std::min(luma_y + block, roi.end_y) + subsampling - 1) / subsampling;
+            for (size_t luma_x = roi.start_x; luma_x < roi.end_x; luma_x += block) {
+                size_t start_x = luma_x / subsampling;
+                size_t end_x = (std::min(luma_x + block, roi.end_x) + subsampling - 1) / subsampling;
+                size_t count = (end_y - start_y) * (end_x - start_x);
+                for (size_t c = 0; c < plane.channels; ++c) {
+                    size_t sum = 0;
+                    for (size_t y = start_y; y < end_y; ++y) {
+                        for (size_t x = start_x; x < end_x; ++x) {
+                            sum += original_planes[i].at(x, y)[c];
+                        }
+                    }
+                    for (size_t y = start_y; y < end_y; ++y) {
+                        for (size_t x = start_x; x < end_x; ++x) {
+                            plane.at(x, y)[c] = (sum + count / 2) / count;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Separable filter of the region in double precision, reading from the original plane. Pixels outside the plane are
+// replicated from its edges
+static void filter_reference(ReferencePlane &plane, const dsp_roi_t &region, const std::vector<double> &weights)
+{
+    std::vector<uint8_t> original_data(plane.data, plane.data + plane.width * plane.height * plane.channels);
+    ReferencePlane original = {original_data.data(), plane.width, plane.height, plane.channels};
+    long radius = weights.size() / 2;
+    for (size_t y = region.start_y; y < region.end_y; ++y) {
+        for (size_t x = region.start_x; x < region.end_x; ++x) {
+            for (size_t c = 0; c < plane.channels; ++c) {
+                double sum = 0;
+                for (long ky = -radius; ky <= radius; ++ky) {
+                    double row = 0;
+                    for (long kx = -radius; kx <= radius; ++kx) {
+                        row += weights[kx + radius] * original.at(x + kx, y + ky)[c];
+                    }
+                    sum += weights[ky + radius] * row;
+                }
+                plane.at(x, y)[c] = std::clamp(std::lround(sum), 0L, 255L);
+            }
+        }
+    }
+}
+
+// Box weights, or Gaussian weights with the sigma OpenCV derives from the kernel size
+static std::vector<double> kernel_weights(dsp_blur_mode_t mode, size_t kernel_size)
+{
+    std::vector<double> weights(kernel_size, 1.0 / kernel_size);
+    if (mode == DSP_BLUR_MODE_GAUSSIAN) {
+        double sigma = 0.3 * ((kernel_size - 1) * 0.5 - 1) + 0.8;
+        long radius = kernel_size / 2;
+        double sum = 0;
+        for (long i = -radius; i <= radius; ++i) {
+            weights[i + radius] = std::exp(-(i * i) / (2 * sigma * sigma));
+            sum += weights[i + radius];
+        }
+        for (auto &weight : weights) {
+            weight /= sum;
+        }
+    }
+    return weights;
+}
+
+// The region and the margin of the kernel around it are downscaled by area averaging, filtered, and upscaled back
+// bilinearly into the region
+static void downscaled_blur_reference(ReferencePlane &plane,
+                                      const dsp_roi_t &region,
+                                      dsp_blur_mode_t mode,
+                                      size_t kernel_size,
+                                      size_t factor)
+{
+    size_t margin = kernel_size / 2 * factor;
+    dsp_roi_t work = {
+        .start_x = region.start_x - std::min(region.start_x, margin),
+        .start_y = region.start_y - std::min(region.start_y, margin),
+        .end_x = std::min(region.end_x + margin, plane.width),
+        .end_y = std::min(region.end_y + margin, plane.height),
+    };
+    size_t small_width = (work.end_x - work.start_x + factor - 1) / factor;
+    size_t small_height = (work.end_y - work.start_y + factor - 1) / factor;
+    std::vector<uint8_t> small_data(small_width * small_height * plane.channels);
+    ReferencePlane small = {small_data.data(), small_width, small_height, plane.channels};
+
+    for (size_t y = 0; y < small_height; ++y) {
+        size_t start_y = work.start_y + y * factor;
+        size_t end_y = std::min(start_y + factor, work.end_y);
+        for (size_t x = 0; x < small_width; ++x) {
+            size_t start_x = work.start_x + x * factor;
+            size_t end_x = std::min(start_x + factor, work.end_x);
+            size_t count = (end_y - start_y) * (end_x - start_x);
+            for (size_t c = 0; c < plane.channels; ++c) {
+                size_t sum = 0;
+                for (size_t sy = start_y; sy < end_y; ++sy) {
+                    for (size_t sx = start_x; sx < end_x; ++sx) {
+                        sum += plane.at(sx, sy)[c];
+                    }
+                }
+                small.at(x, y)[c] = (sum + count / 2) / count;
+            }
+        }
+    }
+
+    filter_reference(small, {0, 0, small_width, small_height}, kernel_weights(mode, kernel_size));
+
+    for (size_t y = region.start_y; y < region.end_y; ++y) {
+        double small_y = std::clamp((y - work.start_y + 0.5) / factor - 0.5, 0.0, small_height - 1.0);
+        size_t y0 = small_y;
+        double fy = small_y - y0;
+        for (size_t x = region.start_x; x < region.end_x; ++x) {
+            double small_x = std::clamp((x - work.start_x + 0.5) / factor - 0.5, 0.0, small_width - 1.0);
+            size_t x0 = small_x;
+            double fx = small_x - x0;
+            for (size_t c = 0; c < plane.channels; ++c) {
+                double top = small.at(x0, y0)[c] * (1 - fx) + small.at(x0 + 1, y0)[c] * fx;
+                double bottom = small.at(x0, y0 + 1)[c] * (1 - fx) + small.at(x0 + 1, y0 + 1)[c] * fx;
+                plane.at(x, y)[c] = std::clamp(std::lround(top * (1 - fy) + bottom * fy), 0L, 255L);
+            }
+        }
+    }
+}
+
+// Box and Gaussian blur of a ROI. The NV12 chroma kernel covers the same area as the luma kernel, rounded to an odd
+// size
+static void blur_reference(TestImage &image, const dsp_blur_roi_params_t &params)
+{
+    auto planes = reference_planes(image);
+    for (size_t i = 0; i < planes.size(); ++i) {
+        dsp_roi_t region = params.roi;
+        size_t kernel_size = params.kernel_size;
+        if (i > 0) {
+            region = {region.start_x / 2, region.start_y / 2, (region.end_x + 1) / 2, (region.end_y + 1) / 2};
+            kernel_size = (kernel_size / 2) | 1;
+        }
+
+        if (params.downscale > 1) {
+            downscaled_blur_reference(planes[i], region, params.mode, kernel_size, params.downscale);
+        } else {
+            filter_reference(planes[i], region, kernel_weights(params.mode, kernel_size));
+        }
+    }
+}
+
+class BlurRoisTest : public ::testing::Test {
+   protected:
+    void SetUp() override { ASSERT_EQ(m_device.status(), DSP_SUCCESS); }
+
+    EmulatorDevice m_device;
+};
+
+class BlurRoisValidationTest : public BlurRoisTest, public ::testing::WithParamInterface<dsp_blur_roi_params_t> {};
+
+TEST_P(BlurRoisValidationTest, RejectsInvalidKernel)
+{
+    TestImage image(IMAGE_WIDTH, IMAGE_HEIGHT, DSP_IMAGE_FORMAT_NV12);
+    image.fill_random(1);
+    TestImage original(image);
+    auto roi = GetParam();
+    EXPECT_EQ(dsp_blur_rois(m_device, image.get(), &roi, 1), DSP_INVALID_ARGUMENT);
+
+    dsp_job job = nullptr;
+    EXPECT_EQ(dsp_blur_rois_async(m_device, image.get(), &roi, 1, &job), DSP_INVALID_ARGUMENT);
+    EXPECT_EQ(job, nullptr);
+
+    dsp_cmdbuf cmdbuf;
+    ASSERT_EQ(dsp_create_cmdbuf(m_device, &cmdbuf), DSP_SUCCESS);
+    EXPECT_EQ(dsp_cmdbuf_record_blur_rois(cmdbuf, image.get(), &roi, 1), DSP_INVALID_ARGUMENT);
+    EXPECT_EQ(dsp_release_cmdbuf(cmdbuf), DSP_SUCCESS);
+
+    dsp_plan plan = nullptr;
+    EXPECT_EQ(dsp_plan_create_blur_rois(m_device, image.get(), &roi, 1, &plan), DSP_INVALID_ARGUMENT);
+    EXPECT_EQ(plan, nullptr);
+
+    // An invalid ROI among valid ones fails the whole operation
+    auto rois = mixed_rois(CHAINED_ROIS_COUNT);
+    rois.back() = roi;
+    EXPECT_EQ(dsp_blur_rois(m_device, image.get(), rois.data(), rois.size()), DSP_INVALID_ARGUMENT);
+    EXPECT_TRUE(image == original);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Kernels,
+    BlurRoisValidationTest,
+    ::testing::Values(dsp_blur_roi_params_t{ROI, DSP_BLUR_MODE_BOX, 0, 1},
+                      dsp_blur_roi_params_t{ROI, DSP_BLUR_MODE_BOX, 8, 1},
+                      dsp_blur_roi_params_t{ROI, DSP_BLUR_MODE_BOX, DSP_BLUR_MAX_KERNEL_SIZE + 2, 1},
+                      dsp_blur_roi_params_t{ROI, DSP_BLUR_MODE_BOX, 5, 0},
+                      dsp_blur_roi_params_t{ROI, DSP_BLUR_MODE_BOX, 5, 3},
+                      dsp_blur_roi_params_t{ROI, DSP_BLUR_MODE_BOX, 5, DSP_BLUR_MAX_DOWNSCALE * 2},
+                      dsp_blur_roi_params_t{ROI, DSP_BLUR_MODE_GAUSSIAN, 6, 1},
+                      dsp_blur_roi_params_t{ROI, DSP_BLUR_MODE_GAUSSIAN, DSP_BLUR_MAX_KERNEL_SIZE + 2, 1},
+                      dsp_blur_roi_params_t{ROI, DSP_BLUR_MODE_GAUSSIAN, 7, 0},
+                      dsp_blur_roi_params_t{ROI, DSP_BLUR_MODE_GAUSSIAN, 7, 6},
+                      dsp_blur_roi_params_t{ROI, DSP_BLUR_MODE_PIXELATE, 0, 1},
+                      dsp_blur_roi_params_t{ROI, DSP_BLUR_MODE_PIXELATE, DSP_BLUR_MAX_PIXELATE_BLOCK + 1, 1},
+                      dsp_blur_roi_params_t{ROI, DSP_BLUR_MODE_PIXELATE, 8, 2},
+                      dsp_blur_roi_params_t{ROI, DSP_BLUR_MODE_PIXELATE, 8, 0},
+                      dsp_blur_roi_params_t{ROI, DSP_BLUR_MODE_COUNT, 3, 1}));
+
+class BlurRoisLimitsTest : public BlurRoisTest, public ::testing::WithParamInterface<dsp_blur_roi_params_t> {};
+
+TEST_P(BlurRoisLimitsTest, AcceptsKernelLimits)
+{
+    TestImage image(IMAGE_WIDTH, IMAGE_HEIGHT, DSP_IMAGE_FORMAT_NV12);
+    image.fill_random(1);
+    auto roi = GetParam();
+    EXPECT_EQ(dsp_blur_rois(m_device, image.get(), &roi, 1), DSP_SUCCESS);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Kernels,
+    BlurRoisLimitsTest,
+    ::testing::Values(dsp_blur_roi_params_t{ROI, DSP_BLUR_MODE_BOX, 1, 1},
+                      dsp_blur_roi_params_t{ROI, DSP_BLUR_MODE_BOX, DSP_BLUR_MAX_KERNEL_SIZE, DSP_BLUR_MAX_DOWNSCALE},
+                      dsp_blur_roi_params_t{ROI, DSP_BLUR_MODE_GAUSSIAN, 1, 1},
+                      dsp_blur_roi_params_t{ROI, DSP_BLUR_MODE_GAUSSIAN, DSP_BLUR_MAX_KERNEL_SIZE,
+                                            DSP_BLUR_MAX_DOWNSCALE},
+                      dsp_blur_roi_params_t{ROI, DSP_BLUR_MODE_PIXELATE, 1, 1},
+                      dsp_blur_roi_params_t{ROI, DSP_BLUR_MODE_PIXELATE, DSP_BLUR_MAX_PIXELATE_BLOCK, 1}));
+
+class BlurRoisFormatTest : public BlurRoisTest, public ::testing::WithParamInterface<dsp_image_format_t> {};
+
+TEST_P(BlurRoisFormatTest, BoxMatchesBlur)
+{
+    TestImage image(IMAGE_WIDTH, IMAGE_HEIGHT, GetParam());
+    image.fill_random(1);
+    TestImage reference(image);
+    dsp_roi_t rois[] = {ROI, {.start_x = 50, .start_y = 50, .end_x = 200, .end_y = 200}};
+    dsp_blur_roi_params_t params[] = {{rois[0], DSP_BLUR_MODE_BOX, 9, 1}, {rois[1], DSP_BLUR_MODE_BOX, 9, 1}};
+
+    ASSERT_EQ(dsp_blur_rois(m_device, image.get(), params, 2), DSP_SUCCESS);
+    ASSERT_EQ(dsp_blur(m_device, reference.get(), rois, 2, 9), DSP_SUCCESS);
+    EXPECT_TRUE(image == reference);
+}
+
+TEST_P(BlurRoisFormatTest, UnitKernelsKeepImage)
+{
+    TestImage image(IMAGE_WIDTH, IMAGE_HEIGHT, GetParam());
+    image.fill_random(1);
+    TestImage original(image);
+    dsp_blur_roi_params_t params[] = {{ROI, DSP_BLUR_MODE_BOX, 1, 1},
+                                      {ROI, DSP_BLUR_MODE_GAUSSIAN, 1, 1},
+                                      {ROI, DSP_BLUR_MODE_PIXELATE, 1, 1}};
+    ASSERT_EQ(dsp_blur_rois(m_device, image.get(), params, 3), DSP_SUCCESS);
+    EXPECT_TRUE(image == original);
+}
+
+// Chained requests blur the ROIs as one request per ROI does
+TEST_P(BlurRoisFormatTest, MatchesRoisBlurredOneByOne)
+{
+    TestImage image(IMAGE_WIDTH, IMAGE_HEIGHT, GetParam());
+    image.fill_random(1);
+    TestImage reference(image);
+    TestImage original(image);
+    auto rois = mixed_rois(CHAINED_ROIS_COUNT);
+
+    ASSERT_EQ(dsp_blur_rois(m_device, image.get(), rois.data(), rois.size()), DSP_SUCCESS);
+    EXPECT_FALSE(image == original);
+    for (const auto &roi : rois) {
+        ASSERT_EQ(dsp_blur_rois(m_device, reference.get(), &roi, 1), DSP_SUCCESS);
+    }
+    EXPECT_TRUE(image == reference);
+}
+
+TEST_P(BlurRoisFormatTest, PathsMatchBlurRois)
+{
+    TestImage image(IMAGE_WIDTH, IMAGE_HEIGHT, GetParam());
+    image.fill_random(1);
+    TestImage async_image(image);
+    TestImage cmdbuf_image(image);
+    TestImage plan_image(image);
+    auto rois = mixed_rois(CHAINED_ROIS_COUNT);
+    ASSERT_EQ(dsp_blur_rois(m_device, image.get(), rois.data(), rois.size()), DSP_SUCCESS);
+
+    dsp_job job;
+    ASSERT_EQ(dsp_blur_rois_async(m_device, async_image.get(), rois.data(), rois.size(), &job), DSP_SUCCESS);
+    EXPECT_EQ(dsp_job_wait(job), DSP_SUCCESS);
+    EXPECT_EQ(dsp_job_release(job), DSP_SUCCESS);
+    EXPECT_TRUE(async_image == image);
+
+    dsp_cmdbuf cmdbuf;
+    ASSERT_EQ(dsp_create_cmdbuf(m_device, &cmdbuf), DSP_SUCCESS);
+    ASSERT_EQ(dsp_cmdbuf_record_blur_rois(cmdbuf, cmdbuf_image.get(), rois.data(), rois.size()), DSP_SUCCESS);
+    ASSERT_EQ(dsp_cmdbuf_submit(cmdbuf), DSP_SUCCESS);
+    EXPECT_EQ(dsp_release_cmdbuf(cmdbuf), DSP_SUCCESS);
+    EXPECT_TRUE(cmdbuf_image == image);
+
+    TestImage recorded(IMAGE_WIDTH, IMAGE_HEIGHT, GetParam());
+    dsp_plan plan;
+    ASSERT_EQ(dsp_plan_create_blur_rois(m_device, recorded.get(), rois.data(), rois.size(), &plan), DSP_SUCCESS);
+    ASSERT_EQ(dsp_plan_execute(plan, plan_image.planes(), plan_image.planes_count()), DSP_SUCCESS);
+    EXPECT_EQ(dsp_release_plan(plan), DSP_SUCCESS);
+    EXPECT_TRUE(plan_image == image);
+}
+
+// Odd blocks at an odd ROI start, so that the chroma tiles can't simply be half the luma tiles
+TEST_P(BlurRoisFormatTest, PixelateMatchesReference)
+{
+    TestImage image(IMAGE_WIDTH, IMAGE_HEIGHT, GetParam());
+    image.fill_random(1);
+    TestImage reference(image);
+    dsp_roi_t roi = {.start_x = 11, .start_y = 9, .end_x = 100, .end_y = 80};
+    for (size_t block : {1, 2, 5, 8}) {
+        dsp_blur_roi_params_t params = {roi, DSP_BLUR_MODE_PIXELATE, block, 1};
+        ASSERT_EQ(dsp_blur_rois(m_device, image.get(), &params, 1), DSP_SUCCESS);
+        pixelate_reference(reference, roi, block);
+        EXPECT_TRUE(image == reference) << "block " << block;
+    }
+}
+
+// Rounding differs by at most one level between the float DSP implementation and the double references
+TEST_P(BlurRoisFormatTest, BlurMatchesReference)
+{
+    TestImage image(IMAGE_WIDTH, IMAGE_HEIGHT, GetParam());
+    image.fill_random(1);
+    dsp_roi_t roi = {.start_x = 3, .start_y = 7, .end_x = 161, .end_y = 120};
+    dsp_blur_roi_params_t cases[] = {
+        {roi, DSP_BLUR_MODE_BOX, 7, 1},
+        {roi, DSP_BLUR_MODE_GAUSSIAN, 3, 1},
+        {roi, DSP_BLUR_MODE_GAUSSIAN, 9, 1},
+        {roi, DSP_BLUR_MODE_GAUSSIAN, DSP_BLUR_MAX_KERNEL_SIZE, 1},
+        {roi, DSP_BLUR_MODE_BOX, 5, 2},
+        {roi, DSP_BLUR_MODE_BOX, 3, DSP_BLUR_MAX_DOWNSCALE},
+        {roi, DSP_BLUR_MODE_GAUSSIAN, 7, 4},
+        {roi, DSP_BLUR_MODE_GAUSSIAN, 5, 8},
+    };
+    for (const auto &params : cases) {
+        TestImage blurred(image);
+        TestImage reference(image);
+        ASSERT_EQ(dsp_blur_rois(m_device, blurred.get(), &params, 1), DSP_SUCCESS);
+        blur_reference(reference, params);
+        EXPECT_LE(blurred.max_difference(reference), 1)
+            << "mode " << params.mode << ", kernel " << params.kernel_size << ", downscale " << params.downscale;
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(Formats,
+                         BlurRoisFormatTest,
+                         ::testing::Values(DSP_IMAGE_FORMAT_GRAY8, DSP_IMAGE_FORMAT_NV12));
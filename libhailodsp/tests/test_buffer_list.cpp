@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2017-2024 Hailo Technologies Ltd. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <linux/types.h>
+#define HAVE___U8
+#define HAVE___U32
+#define HAVE___S32
+#define HAVE___U64
+
+#include "buffer_list.hpp"
+#include "inline_vector.hpp"
+
+#include <gtest/gtest.h>
+#include <sys/ioctl.h>
+
+TEST(BufferListTest, IndicesFollowInsertionOrder)
+{
+    std::vector<uint8_t> data(BUFFER_LIST_INLINE_CAPACITY + 1);
+    BufferList buffer_list;
+    for (size_t i = 0; i < data.size(); ++i) {
+        uint32_t index;
+        ASSERT_EQ(buffer_list.add_buffer(&data[i], 1, BufferAccessType::Read, index), DSP_SUCCESS);
+        ASSERT_EQ(index, i);
+    }
+
+    // The list spilled to the heap, and kept the inline buffers
+    auto buffers = buffer_list.get_buffers();
+    ASSERT_EQ(buffers.size(), data.size());
+    for (size_t i = 0; i < data.size(); ++i) {
+        EXPECT_EQ(buffers[i].addr, reinterpret_cast<uintptr_t>(&data[i]));
+    }
+
+    buffer_list.truncate(2);
+    EXPECT_EQ(buffer_list.get_buffers().size(), 2u);
+    EXPECT_EQ(buffer_list.get_buffers()[1].addr, reinterpret_cast<uintptr_t>(&data[1]));
+}
+
+TEST(BufferListTest, AddFailsWhenFull)
+{
+    uint8_t data[4] = {};
+    BufferList buffer_list(3);
+    uint32_t index = 0;
+    for (size_t i = 0; i < 3; ++i) {
+        ASSERT_EQ(buffer_list.add_buffer(&data[i], 1, BufferAccessType::Read, index), DSP_SUCCESS);
+    }
+
+    dsp_data_plane_t plane = {.userptr = &data[3], .bytesperline = 1, .bytesused = 1};
+    EXPECT_EQ(buffer_list.add_buffer(&data[3], 1, BufferAccessType::Read, index), DSP_INVALID_ARGUMENT);
+    EXPECT_EQ(buffer_list.add_buffer(0, 1, BufferAccessType::Read, index), DSP_INVALID_ARGUMENT);
+    EXPECT_EQ(buffer_list.add_plane(plane, BufferAccessType::Read, DSP_MEMORY_TYPE_USERPTR, index),
+              DSP_INVALID_ARGUMENT);
+    EXPECT_EQ(index, 2u);
+    EXPECT_EQ(buffer_list.get_buffers().size(), 3u);
+
+    // The limit is kept by copies
+    BufferList copy(buffer_list);
+    EXPECT_EQ(copy.add_buffer(&data[3], 1, BufferAccessType::Read, index), DSP_INVALID_ARGUMENT);
+}
+
+#ifndef NDEBUG
+TEST(InlineVectorDeathTest, PushBeyondCapacityAsserts)
+{
+    InlineVector<int, 2> vector;
+    vector.push_back(1);
+    vector.push_back(2);
+    EXPECT_DEATH(vector.push_back(3), "");
+}
+#endif
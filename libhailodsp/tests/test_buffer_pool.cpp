@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2017-2024 Hailo Technologies Ltd. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+// Buffers released through another device than the one they were created on, as with device groups
+
+#include "test_utils.hpp"
+
+#include <gtest/gtest.h>
+
+#define BUFFER_SIZE (4096)
+
+TEST(BufferPoolTest, ReleaseReturnsBufferToItsDevice)
+{
+    EmulatorDevice owner;
+    EmulatorDevice other;
+    ASSERT_EQ(owner.status(), DSP_SUCCESS);
+    ASSERT_EQ(other.status(), DSP_SUCCESS);
+
+    void *buffer;
+    ASSERT_EQ(dsp_create_buffer(owner, BUFFER_SIZE, &buffer), DSP_SUCCESS);
+    ASSERT_EQ(dsp_release_buffer(other, buffer), DSP_SUCCESS);
+
+    dsp_buffer_pool_stats_t owner_stats;
+    dsp_buffer_pool_stats_t other_stats;
+    ASSERT_EQ(dsp_get_buffer_pool_stats(owner, &owner_stats), DSP_SUCCESS);
+    ASSERT_EQ(dsp_get_buffer_pool_stats(other, &other_stats), DSP_SUCCESS);
+    EXPECT_EQ(owner_stats.in_use_buffers, 0u);
+    EXPECT_EQ(owner_stats.cached_buffers, 1u);
+    EXPECT_EQ(other_stats.cached_buffers, 0u);
+
+    // The cached buffer is served again by its own device only
+    void *reused;
+    ASSERT_EQ(dsp_create_buffer(other, BUFFER_SIZE, &reused), DSP_SUCCESS);
+    ASSERT_EQ(dsp_get_buffer_pool_stats(other, &other_stats), DSP_SUCCESS);
+    EXPECT_EQ(other_stats.hits, 0u);
+    EXPECT_EQ(dsp_release_buffer(other, reused), DSP_SUCCESS);
+
+    ASSERT_EQ(dsp_create_buffer(owner, BUFFER_SIZE, &reused), DSP_SUCCESS);
+    ASSERT_EQ(dsp_get_buffer_pool_stats(owner, &owner_stats), DSP_SUCCESS);
+    EXPECT_EQ(owner_stats.hits, 1u);
+    EXPECT_EQ(dsp_release_buffer(owner, reused), DSP_SUCCESS);
+}
@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2017-2024 Hailo Technologies Ltd. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+// GTest includes the kernel integer types, so the XRP headers must use them rather than define their own
+#include <linux/types.h>
+#define HAVE___U8
+#define HAVE___U32
+#define HAVE___S32
+#define HAVE___U64
+
+#include "buffer_registry.hpp"
+#include "xrp_kernel_defs.h"
+
+#include <cerrno>
+#include <gtest/gtest.h>
+#include <sys/ioctl.h>
+#include <vector>
+
+// Driver stand-in that implements only the registration ioctls, optionally failing them like a driver that
+// predates them
+class RegistrationDriver : public Driver {
+   public:
+    explicit RegistrationDriver(bool supported) : m_supported(supported) {}
+
+    int ioctl(unsigned long request, void *arg) override
+    {
+        requests.push_back(request);
+        if (!m_supported) {
+            errno = ENOTTY;
+            return -1;
+        }
+
+        auto ioctl_register = static_cast<struct xrp_ioctl_register *>(arg);
+        if (request == XRP_IOCTL_REGISTER) {
+            ioctl_register->handle = m_next_handle++;
+            return 0;
+        }
+        if (ioctl_register->handle == XRP_REGISTER_INVALID_HANDLE) {
+            errno = EINVAL;
+            return -1;
+        }
+        return 0;
+    }
+
+    std::vector<unsigned long> requests;
+
+   private:
+    bool m_supported;
+    uint32_t m_next_handle = 1;
+};
+
+TEST(BufferRegistryTest, RegisteredRangesAreReferencedByHandle)
+{
+    RegistrationDriver driver(true);
+    std::vector<uint8_t> data(8192);
+    {
+        BufferRegistry registry(driver);
+        ASSERT_EQ(registry.register_buffer(data.data(), data.size()), DSP_SUCCESS);
+
+        BufferList buffer_list;
+        uint32_t inside;
+        uint32_t crossing;
+        ASSERT_EQ(buffer_list.add_buffer(data.data() + 4096, 1024, BufferAccessType::Read, inside), DSP_SUCCESS);
+        ASSERT_EQ(buffer_list.add_buffer(data.data() + 8000, 1024, BufferAccessType::Read, crossing), DSP_SUCCESS);
+        registry.translate(buffer_list);
+
+        auto buffers = buffer_list.get_buffers();
+        EXPECT_EQ(buffers[inside].memory_type, XRP_MEMORY_TYPE_REGISTERED);
+        EXPECT_EQ(buffers[inside].registered.handle, 1u);
+        EXPECT_EQ(buffers[inside].registered.offset, 4096u);
+        EXPECT_EQ(buffers[crossing].memory_type, XRP_MEMORY_TYPE_USERPTR);
+
+        EXPECT_EQ(registry.unregister_buffer(data.data()), DSP_SUCCESS);
+    }
+
+    std::vector<unsigned long> expected = {XRP_IOCTL_UNREGISTER, XRP_IOCTL_REGISTER, XRP_IOCTL_UNREGISTER};
+    EXPECT_EQ(driver.requests, expected);
+}
+
+TEST(BufferRegistryTest, OlderDriverIsQueriedOnce)
+{
+    RegistrationDriver driver(false);
+    std::vector<uint8_t> first(4096);
+    std::vector<uint8_t> second(4096);
+    {
+        BufferRegistry registry(driver);
+        ASSERT_EQ(registry.register_buffer(first.data(), first.size()), DSP_SUCCESS);
+        ASSERT_EQ(registry.register_buffer(second.data(), second.size()), DSP_SUCCESS);
+
+        BufferList buffer_list;
+        uint32_t index;
+        ASSERT_EQ(buffer_list.add_buffer(first.data(), first.size(), BufferAccessType::Read, index), DSP_SUCCESS);
+        registry.translate(buffer_list);
+        EXPECT_EQ(buffer_list.get_buffers()[0].memory_type, XRP_MEMORY_TYPE_USERPTR);
+
+        EXPECT_EQ(registry.unregister_buffer(first.data()), DSP_SUCCESS);
+        EXPECT_EQ(registry.unregister_buffer(second.data()), DSP_SUCCESS);
+    }
+
+    // Only the capability query reaches the driver
+    std::vector<unsigned long> expected = {XRP_IOCTL_UNREGISTER};
+    EXPECT_EQ(driver.requests, expected);
+}
+
+TEST(BufferRegistryTest, OverlappingRegistrationIsRejected)
+{
+    RegistrationDriver driver(true);
+    std::vector<uint8_t> data(8192);
+    BufferRegistry registry(driver);
+    ASSERT_EQ(registry.register_buffer(data.data(), 4096), DSP_SUCCESS);
+    EXPECT_EQ(registry.register_buffer(data.data() + 2048, 4096), DSP_INVALID_ARGUMENT);
+    EXPECT_EQ(registry.register_buffer(data.data() + 4096, 4096), DSP_SUCCESS);
+    EXPECT_EQ(registry.unregister_buffer(data.data()), DSP_SUCCESS);
+    EXPECT_EQ(registry.unregister_buffer(data.data() + 4096), DSP_SUCCESS);
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2017-2024 Hailo Technologies Ltd. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "test_utils.hpp"
+
+#include <gtest/gtest.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#define CROPS_COUNT (4)
+
+class CmdbufTest : public ::testing::Test {
+   protected:
+    void SetUp() override
+    {
+        ASSERT_EQ(m_device.status(), DSP_SUCCESS);
+        ASSERT_EQ(dsp_create_cmdbuf(m_device, &m_cmdbuf), DSP_SUCCESS);
+    }
+
+    void TearDown() override { EXPECT_EQ(dsp_release_cmdbuf(m_cmdbuf), DSP_SUCCESS); }
+
+    EmulatorDevice m_device;
+    dsp_cmdbuf m_cmdbuf = nullptr;
+};
+
+TEST_F(CmdbufTest, MatchesPerOperationSubmission)
+{
+    TestImage src(320, 240, DSP_IMAGE_FORMAT_NV12);
+    src.fill_random(1);
+    std::vector<TestImage> cmdbuf_dsts(CROPS_COUNT, TestImage(64, 64, DSP_IMAGE_FORMAT_NV12));
+    std::vector<TestImage> op_dsts(CROPS_COUNT, TestImage(64, 64, DSP_IMAGE_FORMAT_NV12));
+
+    for (size_t i = 0; i < CROPS_COUNT; ++i) {
+        dsp_roi_t crop = {.start_x = 20 * i, .start_y = 10 * i, .end_x = 200 + 20 * i, .end_y = 150 + 10 * i};
+        dsp_resize_params_t cmdbuf_params = {src.get(), cmdbuf_dsts[i].get(), INTERPOLATION_TYPE_BILINEAR};
+        ASSERT_EQ(dsp_cmdbuf_record_crop_and_resize(m_cmdbuf, &cmdbuf_params, &crop), DSP_SUCCESS);
+
+        dsp_resize_params_t op_params = {src.get(), op_dsts[i].get(), INTERPOLATION_TYPE_BILINEAR};
+        ASSERT_EQ(dsp_crop_and_resize(m_device, &op_params, &crop), DSP_SUCCESS);
+    }
+
+    ASSERT_EQ(dsp_cmdbuf_submit(m_cmdbuf), DSP_SUCCESS);
+    for (size_t i = 0; i < CROPS_COUNT; ++i) {
+        EXPECT_TRUE(cmdbuf_dsts[i] == op_dsts[i]) << "crop " << i;
+    }
+}
+
+TEST_F(CmdbufTest, BoundImageReplacesRecordedData)
+{
+    TestImage recorded(128, 128, DSP_IMAGE_FORMAT_GRAY8);
+    recorded.fill(10);
+    TestImage bound(128, 128, DSP_IMAGE_FORMAT_GRAY8);
+    bound.fill(200);
+    TestImage dst(32, 32, DSP_IMAGE_FORMAT_GRAY8);
+
+    dsp_resize_params_t params = {recorded.get(), dst.get(), INTERPOLATION_TYPE_BILINEAR};
+    ASSERT_EQ(dsp_cmdbuf_record_resize(m_cmdbuf, &params), DSP_SUCCESS);
+    ASSERT_EQ(dsp_cmdbuf_submit(m_cmdbuf), DSP_SUCCESS);
+    EXPECT_EQ(dst.plane(0)[0], 10);
+
+    ASSERT_EQ(dsp_cmdbuf_bind_image(m_cmdbuf, recorded.get(), bound.get()), DSP_SUCCESS);
+    ASSERT_EQ(dsp_cmdbuf_submit(m_cmdbuf), DSP_SUCCESS);
+    EXPECT_EQ(dst.plane(0)[0], 200);
+}
+
+TEST_F(CmdbufTest, BindRejectsNullUserptr)
+{
+    TestImage recorded(64, 64, DSP_IMAGE_FORMAT_GRAY8);
+    TestImage dst(32, 32, DSP_IMAGE_FORMAT_GRAY8);
+    dsp_resize_params_t params = {recorded.get(), dst.get(), INTERPOLATION_TYPE_BILINEAR};
+    ASSERT_EQ(dsp_cmdbuf_record_resize(m_cmdbuf, &params), DSP_SUCCESS);
+
+    TestImage bound(64, 64, DSP_IMAGE_FORMAT_GRAY8);
+    bound.planes()[0].userptr = nullptr;
+    EXPECT_EQ(dsp_cmdbuf_bind_image(m_cmdbuf, recorded.get(), bound.get()), DSP_INVALID_ARGUMENT);
+}
+
+TEST_F(CmdbufTest, BindValidatesDmabufFd)
+{
+    size_t size = 64 * 64;
+    int fd = memfd_create("cmdbuf_test", MFD_CLOEXEC);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(ftruncate(fd, size), 0);
+
+    dsp_data_plane_t plane = {.fd = fd, .bytesperline = 64, .bytesused = size};
+    dsp_image_properties_t recorded = {64, 64, &plane, 1, DSP_IMAGE_FORMAT_GRAY8, DSP_MEMORY_TYPE_DMABUF};
+    TestImage dst(32, 32, DSP_IMAGE_FORMAT_GRAY8);
+    dsp_resize_params_t params = {&recorded, dst.get(), INTERPOLATION_TYPE_BILINEAR};
+    ASSERT_EQ(dsp_cmdbuf_record_resize(m_cmdbuf, &params), DSP_SUCCESS);
+
+    // fd 0 is a valid descriptor, even though its union member reads as a NULL pointer
+    dsp_data_plane_t bound_plane = plane;
+    dsp_image_properties_t bound = recorded;
+    bound.planes = &bound_plane;
+    bound_plane.fd = 0;
+    EXPECT_EQ(dsp_cmdbuf_bind_image(m_cmdbuf, &recorded, &bound), DSP_SUCCESS);
+
+    bound_plane.fd = -1;
+    EXPECT_EQ(dsp_cmdbuf_bind_image(m_cmdbuf, &recorded, &bound), DSP_INVALID_ARGUMENT);
+
+    close(fd);
+}
@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2017-2024 Hailo Technologies Ltd. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "test_utils.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <thread>
+#include <unistd.h>
+
+#define LATENCY_US (5000)
+
+using namespace std::chrono;
+
+static size_t open_fds_count()
+{
+    auto fds = std::filesystem::directory_iterator("/proc/self/fd");
+    return std::distance(std::filesystem::begin(fds), std::filesystem::end(fds));
+}
+
+class FenceTest : public ::testing::Test {
+   protected:
+    void SetUp() override
+    {
+        m_fence = eventfd(0, EFD_CLOEXEC);
+        ASSERT_GE(m_fence, 0);
+    }
+
+    void TearDown() override { close(m_fence); }
+
+    dsp_status resize_async(dsp_device device, dsp_job *job)
+    {
+        dsp_resize_params_t params = {m_src.get(), m_dst.get(), INTERPOLATION_TYPE_BILINEAR};
+        return dsp_resize_async(device, &params, job);
+    }
+
+    // Long enough for an unblocked job to complete
+    static void wait_a_few_commands() { std::this_thread::sleep_for(microseconds(5 * LATENCY_US)); }
+
+    int m_fence = -1;
+    TestImage m_src{64, 64, DSP_IMAGE_FORMAT_GRAY8};
+    TestImage m_dst{32, 32, DSP_IMAGE_FORMAT_GRAY8};
+};
+
+TEST_F(FenceTest, JobWaitsForFence)
+{
+    EmulatorDevice device(LATENCY_US, true);
+    ASSERT_EQ(device.status(), DSP_SUCCESS);
+
+    ASSERT_EQ(dsp_queue_fence_wait(device, m_fence), DSP_SUCCESS);
+    dsp_job job;
+    ASSERT_EQ(resize_async(device, &job), DSP_SUCCESS);
+
+    wait_a_few_commands();
+    EXPECT_EQ(dsp_job_poll(job), DSP_IN_PROGRESS);
+
+    ASSERT_EQ(eventfd_write(m_fence, 1), 0);
+    EXPECT_EQ(dsp_job_wait(job), DSP_SUCCESS);
+    EXPECT_EQ(dsp_job_release(job), DSP_SUCCESS);
+}
+
+TEST_F(FenceTest, FenceAppliesToTheCallingThreadOnly)
+{
+    EmulatorDevice device(LATENCY_US, true);
+    ASSERT_EQ(device.status(), DSP_SUCCESS);
+
+    dsp_job first;
+    dsp_job second;
+    std::thread([&] {
+        ASSERT_EQ(dsp_queue_fence_wait(device, m_fence), DSP_SUCCESS);
+        ASSERT_EQ(resize_async(device, &first), DSP_SUCCESS);
+        ASSERT_EQ(resize_async(device, &second), DSP_SUCCESS);
+    }).join();
+
+    // A job of another thread runs while the fenced thread is held back
+    dsp_job other;
+    ASSERT_EQ(resize_async(device, &other), DSP_SUCCESS);
+    EXPECT_EQ(dsp_job_wait(other), DSP_SUCCESS);
+    EXPECT_EQ(dsp_job_release(other), DSP_SUCCESS);
+
+    // The job after the fenced one keeps its order behind it
+    wait_a_few_commands();
+    EXPECT_EQ(dsp_job_poll(first), DSP_IN_PROGRESS);
+    EXPECT_EQ(dsp_job_poll(second), DSP_IN_PROGRESS);
+
+    ASSERT_EQ(eventfd_write(m_fence, 1), 0);
+    EXPECT_EQ(dsp_job_wait(first), DSP_SUCCESS);
+    EXPECT_EQ(dsp_job_wait(second), DSP_SUCCESS);
+    EXPECT_EQ(dsp_job_release(first), DSP_SUCCESS);
+    EXPECT_EQ(dsp_job_release(second), DSP_SUCCESS);
+}
+
+TEST_F(FenceTest, JobFenceOrdersDevices)
+{
+    EmulatorDevice producer(LATENCY_US, true);
+    EmulatorDevice consumer(LATENCY_US, true);
+    ASSERT_EQ(producer.status(), DSP_SUCCESS);
+    ASSERT_EQ(consumer.status(), DSP_SUCCESS);
+
+    // The producer job waits for m_fence, so the consumer job can't start either
+    ASSERT_EQ(dsp_queue_fence_wait(producer, m_fence), DSP_SUCCESS);
+    dsp_job produce;
+    ASSERT_EQ(resize_async(producer, &produce), DSP_SUCCESS);
+    int produced;
+    ASSERT_EQ(dsp_job_get_fence(produce, &produced), DSP_SUCCESS);
+    ASSERT_EQ(dsp_job_detach(produce), DSP_SUCCESS);
+
+    ASSERT_EQ(dsp_queue_fence_wait(consumer, produced), DSP_SUCCESS);
+    close(produced);
+    dsp_job consume;
+    ASSERT_EQ(resize_async(consumer, &consume), DSP_SUCCESS);
+
+    wait_a_few_commands();
+    EXPECT_EQ(dsp_job_poll(consume), DSP_IN_PROGRESS);
+
+    ASSERT_EQ(eventfd_write(m_fence, 1), 0);
+    EXPECT_EQ(dsp_job_wait(consume), DSP_SUCCESS);
+    EXPECT_EQ(dsp_job_release(consume), DSP_SUCCESS);
+}
+
+TEST_F(FenceTest, FenceInErrorStateIsNotWaitedFor)
+{
+    EmulatorDevice device(LATENCY_US, true);
+    ASSERT_EQ(device.status(), DSP_SUCCESS);
+
+    // The write end of a pipe whose read end is closed polls as POLLERR
+    int pipe_fds[2];
+    ASSERT_EQ(pipe(pipe_fds), 0);
+    close(pipe_fds[0]);
+
+    ASSERT_EQ(dsp_queue_fence_wait(device, pipe_fds[1]), DSP_SUCCESS);
+    close(pipe_fds[1]);
+    dsp_job job;
+    ASSERT_EQ(resize_async(device, &job), DSP_SUCCESS);
+    EXPECT_EQ(dsp_job_wait(job), DSP_SUCCESS);
+    EXPECT_EQ(dsp_job_release(job), DSP_SUCCESS);
+}
+
+TEST_F(FenceTest, ReleaseCancelsJobsWaitingForFences)
+{
+    dsp_job unfenced;
+    dsp_job fenced;
+    dsp_job behind_fenced;
+    int fenced_completion;
+    auto fds_count = open_fds_count();
+    {
+        EmulatorDevice device(LATENCY_US, true);
+        ASSERT_EQ(device.status(), DSP_SUCCESS);
+
+        ASSERT_EQ(resize_async(device, &unfenced), DSP_SUCCESS);
+        ASSERT_EQ(dsp_queue_fence_wait(device, m_fence), DSP_SUCCESS);
+        ASSERT_EQ(resize_async(device, &fenced), DSP_SUCCESS);
+        ASSERT_EQ(dsp_job_get_fence(fenced, &fenced_completion), DSP_SUCCESS);
+        ASSERT_EQ(resize_async(device, &behind_fenced), DSP_SUCCESS);
+
+        // A fence that no job took is released with the device
+        ASSERT_EQ(dsp_queue_fence_wait(device, m_fence), DSP_SUCCESS);
+    }
+
+    // The device is released without the fence being signaled
+    EXPECT_EQ(dsp_job_poll(unfenced), DSP_SUCCESS);
+    EXPECT_EQ(dsp_job_poll(fenced), DSP_CANCELED);
+    EXPECT_EQ(dsp_job_poll(behind_fenced), DSP_CANCELED);
+
+    // Consumers waiting on the completion fence of a canceled job are released too
+    struct pollfd fence_poll = {.fd = fenced_completion, .events = POLLIN, .revents = 0};
+    EXPECT_EQ(poll(&fence_poll, 1, 0), 1);
+    close(fenced_completion);
+
+    EXPECT_EQ(dsp_job_release(unfenced), DSP_SUCCESS);
+    EXPECT_EQ(dsp_job_release(fenced), DSP_SUCCESS);
+    EXPECT_EQ(dsp_job_release(behind_fenced), DSP_SUCCESS);
+
+    // The duplicates of the fences were closed
+    EXPECT_EQ(open_fds_count(), fds_count);
+}
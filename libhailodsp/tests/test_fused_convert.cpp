@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2017-2024 Hailo Technologies Ltd. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+// Crop&resize with a format conversion in the same operation, against crop&resize followed by a conversion, and
+// against a BT.601 (limited range) conversion computed on the CPU
+
+#include "test_utils.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <tuple>
+
+// Rounding of the fixed point conversion, which the CPU reference does in floating point
+#define CONVERSION_TOLERANCE (2)
+
+static void cpu_yuv_to_rgb(int y, int u, int v, int rgb[3])
+{
+    double c = 1.164 * (y - 16);
+    rgb[0] = std::clamp(static_cast<int>(std::lround(c + 1.596 * (v - 128))), 0, 255);
+    rgb[1] = std::clamp(static_cast<int>(std::lround(c - 0.391 * (u - 128) - 0.813 * (v - 128))), 0, 255);
+    rgb[2] = std::clamp(static_cast<int>(std::lround(c + 2.018 * (u - 128))), 0, 255);
+}
+
+static void cpu_rgb_to_yuv(int r, int g, int b, int yuv[3])
+{
+    yuv[0] = static_cast<int>(std::lround(16 + 0.257 * r + 0.504 * g + 0.098 * b));
+    yuv[1] = static_cast<int>(std::lround(128 - 0.148 * r - 0.291 * g + 0.439 * b));
+    yuv[2] = static_cast<int>(std::lround(128 + 0.439 * r - 0.368 * g - 0.071 * b));
+}
+
+class FusedConvertTest
+    : public ::testing::TestWithParam<std::tuple<dsp_image_format_t, dsp_image_format_t, dsp_interpolation_type_t>> {
+   protected:
+    void SetUp() override { ASSERT_EQ(m_device.status(), DSP_SUCCESS); }
+
+    EmulatorDevice m_device;
+};
+
+TEST_P(FusedConvertTest, MatchesResizeThenConvert)
+{
+    auto [src_format, dst_format, interpolation] = GetParam();
+    TestImage src(256, 192, src_format);
+    src.fill_random(1);
+
+    TestImage fused(96, 64, dst_format);
+    TestImage resized(96, 64, src_format);
+    TestImage reference(96, 64, dst_format);
+
+    dsp_roi_t crop = {.start_x = 16, .start_y = 10, .end_x = 240, .end_y = 170};
+    dsp_resize_params_t params = {src.get(), fused.get(), interpolation};
+    ASSERT_EQ(dsp_crop_and_resize(m_device, &params, &crop), DSP_SUCCESS);
+
+    params.dst = resized.get();
+    ASSERT_EQ(dsp_crop_and_resize(m_device, &params, &crop), DSP_SUCCESS);
+    ASSERT_EQ(dsp_convert_format(m_device, resized.get(), reference.get()), DSP_SUCCESS);
+
+    EXPECT_TRUE(fused == reference);
+}
+
+INSTANTIATE_TEST_SUITE_P(FusedConvert,
+                         FusedConvertTest,
+                         ::testing::Values(std::make_tuple(DSP_IMAGE_FORMAT_NV12, DSP_IMAGE_FORMAT_RGB,
+                                                           INTERPOLATION_TYPE_BILINEAR),
+                                           std::make_tuple(DSP_IMAGE_FORMAT_NV12, DSP_IMAGE_FORMAT_RGB,
+                                                           INTERPOLATION_TYPE_BICUBIC),
+                                           std::make_tuple(DSP_IMAGE_FORMAT_RGB, DSP_IMAGE_FORMAT_NV12,
+                                                           INTERPOLATION_TYPE_BILINEAR),
+                                           std::make_tuple(DSP_IMAGE_FORMAT_RGB, DSP_IMAGE_FORMAT_NV12,
+                                                           INTERPOLATION_TYPE_AREA)));
+
+class FusedConvertReferenceTest : public ::testing::Test {
+   protected:
+    void SetUp() override { ASSERT_EQ(m_device.status(), DSP_SUCCESS); }
+
+    EmulatorDevice m_device;
+};
+
+// A crop of the size of the dst is not resampled, so every dst pixel is the conversion of a single src pixel
+TEST_F(FusedConvertReferenceTest, Nv12ToRgbMatchesCpu)
+{
+    TestImage src(128, 96, DSP_IMAGE_FORMAT_NV12);
+    src.fill_random(1);
+    TestImage dst(64, 48, DSP_IMAGE_FORMAT_RGB);
+
+    dsp_roi_t crop = {.start_x = 20, .start_y = 10, .end_x = 84, .end_y = 58};
+    dsp_resize_params_t params = {src.get(), dst.get(), INTERPOLATION_TYPE_BILINEAR};
+    ASSERT_EQ(dsp_crop_and_resize(m_device, &params, &crop), DSP_SUCCESS);
+
+    int difference = 0;
+    for (size_t y = 0; y < 48; ++y) {
+        for (size_t x = 0; x < 64; ++x) {
+            size_t src_x = crop.start_x + x;
+            size_t src_y = crop.start_y + y;
+            const uint8_t *uv = &src.plane(1)[src_y / 2 * 128 + src_x / 2 * 2];
+            int rgb[3];
+            cpu_yuv_to_rgb(src.plane(0)[src_y * 128 + src_x], uv[0], uv[1], rgb);
+            for (size_t c = 0; c < 3; ++c) {
+                difference = std::max(difference, std::abs(dst.plane(0)[(y * 64 + x) * 3 + c] - rgb[c]));
+            }
+        }
+    }
+    EXPECT_LE(difference, CONVERSION_TOLERANCE);
+}
+
+// The chroma of every 2x2 block is the average of the chroma of its 4 pixels
+TEST_F(FusedConvertReferenceTest, RgbToNv12MatchesCpu)
+{
+    TestImage src(128, 96, DSP_IMAGE_FORMAT_RGB);
+    src.fill_random(1);
+    TestImage dst(64, 48, DSP_IMAGE_FORMAT_NV12);
+
+    dsp_roi_t crop = {.start_x = 20, .start_y = 10, .end_x = 84, .end_y = 58};
+    dsp_resize_params_t params = {src.get(), dst.get(), INTERPOLATION_TYPE_BILINEAR};
+    ASSERT_EQ(dsp_crop_and_resize(m_device, &params, &crop), DSP_SUCCESS);
+
+    int difference = 0;
+    for (size_t y = 0; y < 48; y += 2) {
+        for (size_t x = 0; x < 64; x += 2) {
+            double u = 0, v = 0;
+            for (size_t dy = 0; dy < 2; ++dy) {
+                for (size_t dx = 0; dx < 2; ++dx) {
+                    const uint8_t *rgb = &src.plane(0)[((crop.start_y + y + dy) * 128 + crop.start_x + x + dx) * 3];
+                    int yuv[3];
+                    cpu_rgb_to_yuv(rgb[0], rgb[1], rgb[2], yuv);
+                    difference = std::max(difference, std::abs(dst.plane(0)[(y + dy) * 64 + x + dx] - yuv[0]));
+                    u += yuv[1] / 4.0;
+                    v += yuv[2] / 4.0;
+                }
+            }
+            const uint8_t *uv = &dst.plane(1)[y / 2 * 64 + x];
+            difference = std::max(difference, std::abs(uv[0] - static_cast<int>(std::lround(u))));
+            difference = std::max(difference, std::abs(uv[1] - static_cast<int>(std::lround(v))));
+        }
+    }
+    EXPECT_LE(difference, CONVERSION_TOLERANCE);
+}
+
+TEST_F(FusedConvertReferenceTest, MixedMultiResizeMatchesCropAndResizePerOutput)
+{
+    TestImage src(256, 192, DSP_IMAGE_FORMAT_NV12);
+    src.fill_random(1);
+
+    TestImage rgb(64, 48, DSP_IMAGE_FORMAT_RGB);
+    TestImage nv12(80, 60, DSP_IMAGE_FORMAT_NV12);
+    TestImage rgb_reference(64, 48, DSP_IMAGE_FORMAT_RGB);
+    TestImage nv12_reference(80, 60, DSP_IMAGE_FORMAT_NV12);
+
+    dsp_roi_t crop = {.start_x = 16, .start_y = 10, .end_x = 240, .end_y = 170};
+    dsp_multi_resize_params_t multi_params = {
+        .src = src.get(),
+        .dst = {rgb.get(), nv12.get()},
+        .interpolation = INTERPOLATION_TYPE_BILINEAR,
+    };
+    ASSERT_EQ(dsp_multi_crop_and_resize(m_device, &multi_params, &crop), DSP_SUCCESS);
+
+    dsp_resize_params_t params = {src.get(), rgb_reference.get(), INTERPOLATION_TYPE_BILINEAR};
+    ASSERT_EQ(dsp_crop_and_resize(m_device, &params, &crop), DSP_SUCCESS);
+    params.dst = nv12_reference.get();
+    ASSERT_EQ(dsp_crop_and_resize(m_device, &params, &crop), DSP_SUCCESS);
+
+    EXPECT_TRUE(rgb == rgb_reference);
+    EXPECT_TRUE(nv12 == nv12_reference);
+}
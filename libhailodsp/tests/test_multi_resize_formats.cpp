@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2017-2024 Hailo Technologies Ltd. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+// Multi crop&resize of GRAY8 and RGB sources, which the DSP supports only with the converting operation, must
+// produce the same outputs as a crop&resize per output
+
+#include "test_utils.hpp"
+
+#include <gtest/gtest.h>
+
+#include <tuple>
+
+class MultiResizeFormatsTest
+    : public ::testing::TestWithParam<std::tuple<dsp_image_format_t, dsp_interpolation_type_t>> {
+   protected:
+    void SetUp() override { ASSERT_EQ(m_device.status(), DSP_SUCCESS); }
+
+    EmulatorDevice m_device;
+};
+
+TEST_P(MultiResizeFormatsTest, MatchesCropAndResizePerOutput)
+{
+    auto [src_format, interpolation] = GetParam();
+    TestImage src(320, 240, src_format);
+    src.fill_random(1);
+
+    // RGB sources may also produce NV12 outputs in the same operation
+    std::vector<TestImage> outputs;
+    std::vector<TestImage> references;
+    for (size_t i = 0; i < DSP_MULTI_RESIZE_OUTPUTS_COUNT; ++i) {
+        auto dst_format = ((src_format == DSP_IMAGE_FORMAT_RGB) && (i % 2)) ? DSP_IMAGE_FORMAT_NV12 : src_format;
+        outputs.emplace_back(40 + 8 * i, 30 + 6 * i, dst_format);
+        references.emplace_back(40 + 8 * i, 30 + 6 * i, dst_format);
+    }
+
+    dsp_multi_resize_params_t params = {.src = src.get(), .dst = {}, .interpolation = interpolation};
+    for (size_t i = 0; i < outputs.size(); ++i) {
+        params.dst[i] = outputs[i].get();
+    }
+
+    dsp_roi_t crop = {.start_x = 20, .start_y = 10, .end_x = 300, .end_y = 230};
+    ASSERT_EQ(dsp_multi_crop_and_resize(m_device, &params, &crop), DSP_SUCCESS);
+
+    for (size_t i = 0; i < outputs.size(); ++i) {
+        dsp_resize_params_t resize_params = {src.get(), references[i].get(), interpolation};
+        ASSERT_EQ(dsp_crop_and_resize(m_device, &resize_params, &crop), DSP_SUCCESS);
+        EXPECT_TRUE(outputs[i] == references[i]) << "output " << i;
+    }
+}
+
+TEST_P(MultiResizeFormatsTest, RejectsPrivacyMask)
+{
+    auto [src_format, interpolation] = GetParam();
+    TestImage src(320, 240, src_format);
+    TestImage dst(64, 48, src_format);
+    dsp_multi_resize_params_t params = {.src = src.get(), .dst = {dst.get()}, .interpolation = interpolation};
+    dsp_roi_t crop = {.start_x = 0, .start_y = 0, .end_x = 320, .end_y = 240};
+
+    size_t bitmask_size;
+    ASSERT_EQ(dsp_privacy_mask_get_bitmask_size(320, 240, &bitmask_size), DSP_SUCCESS);
+    std::vector<uint8_t> bitmask(bitmask_size, 0);
+    dsp_roi_t roi = {.start_x = 0, .start_y = 0, .end_x = 80, .end_y = 60};
+    dsp_privacy_mask_t privacy_mask = {
+        .bitmask = bitmask.data(),
+        .y_color = 0,
+        .u_color = 0,
+        .v_color = 0,
+        .rois = &roi,
+        .rois_count = 1,
+    };
+    EXPECT_EQ(dsp_multi_crop_and_resize_privacy_mask(m_device, &params, &crop, &privacy_mask), DSP_INVALID_ARGUMENT);
+}
+
+INSTANTIATE_TEST_SUITE_P(MultiResizeFormats,
+                         MultiResizeFormatsTest,
+                         ::testing::Combine(::testing::Values(DSP_IMAGE_FORMAT_GRAY8, DSP_IMAGE_FORMAT_RGB),
+                                            ::testing::Values(INTERPOLATION_TYPE_BILINEAR,
+                                                              INTERPOLATION_TYPE_BICUBIC)));
@@ -0,0 +1,227 @@
+/*
+ * Copyright (c) 2017-2024 Hailo Technologies Ltd. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+// Persistent overlays and overlay sets, against dsp_blend with the same overlays in user memory
+
+#include "test_utils.hpp"
+
+#include <gtest/gtest.h>
+
+#define OVERLAY_WIDTH (24)
+#define OVERLAY_HEIGHT (16)
+#define OVERLAYS_COUNT (120)
+// Plans are limited to the overlays of a single blend request
+#define MAX_BLEND_OVERLAYS (50)
+
+class OverlayTest : public ::testing::Test {
+   protected:
+    void SetUp() override
+    {
+        ASSERT_EQ(m_device.status(), DSP_SUCCESS);
+        m_background.fill_random(1000);
+    }
+
+    void TearDown() override
+    {
+        for (auto overlay : m_overlays) {
+            EXPECT_EQ(dsp_release_overlay(overlay), DSP_SUCCESS);
+        }
+    }
+
+    // Overlapping overlays of random content, so that the blending order matters
+    void create_overlays(size_t count)
+    {
+        for (size_t i = 0; i < count; ++i) {
+            m_images.emplace_back(OVERLAY_WIDTH, OVERLAY_HEIGHT, DSP_IMAGE_FORMAT_A420);
+            m_images.back().fill_random(i);
+            dsp_overlay overlay;
+            ASSERT_EQ(dsp_create_overlay(m_device, m_images.back().get(), &overlay), DSP_SUCCESS);
+            m_overlays.push_back(overlay);
+            m_placements.push_back({.overlay = overlay, .x_offset = (i * 14) % 296, .y_offset = (i * 10) % 150});
+        }
+    }
+
+    // dsp_blend of the user images, at the placements of the set
+    TestImage blend_reference()
+    {
+        std::vector<dsp_overlay_properties_t> overlays;
+        for (size_t i = 0; i < m_images.size(); ++i) {
+            overlays.push_back({
+                .overlay = *m_images[i].get(),
+                .x_offset = m_placements[i].x_offset,
+                .y_offset = m_placements[i].y_offset,
+            });
+        }
+        TestImage reference(m_background);
+        EXPECT_EQ(dsp_blend(m_device, reference.get(), overlays.data(), overlays.size()), DSP_SUCCESS);
+        return reference;
+    }
+
+    EmulatorDevice m_device;
+    TestImage m_background{320, 180, DSP_IMAGE_FORMAT_NV12};
+    std::vector<TestImage> m_images;
+    std::vector<dsp_overlay> m_overlays;
+    std::vector<dsp_overlay_placement_t> m_placements;
+};
+
+TEST_F(OverlayTest, SetMatchesBlend)
+{
+    create_overlays(OVERLAYS_COUNT);
+    auto reference = blend_reference();
+    dsp_overlay_set overlay_set;
+    ASSERT_EQ(dsp_create_overlay_set(m_placements.data(), m_placements.size(), &overlay_set), DSP_SUCCESS);
+
+    TestImage sync_image(m_background);
+    ASSERT_EQ(dsp_blend_overlay_set(m_device, sync_image.get(), overlay_set), DSP_SUCCESS);
+    EXPECT_TRUE(sync_image == reference);
+
+    TestImage async_image(m_background);
+    dsp_job job;
+    ASSERT_EQ(dsp_blend_overlay_set_async(m_device, async_image.get(), overlay_set, &job), DSP_SUCCESS);
+    ASSERT_EQ(dsp_job_wait(job), DSP_SUCCESS);
+    ASSERT_EQ(dsp_job_release(job), DSP_SUCCESS);
+    EXPECT_TRUE(async_image == reference);
+
+    TestImage cmdbuf_image(m_background);
+    dsp_cmdbuf cmdbuf;
+    ASSERT_EQ(dsp_create_cmdbuf(m_device, &cmdbuf), DSP_SUCCESS);
+    ASSERT_EQ(dsp_cmdbuf_record_blend_overlay_set(cmdbuf, cmdbuf_image.get(), overlay_set), DSP_SUCCESS);
+    ASSERT_EQ(dsp_cmdbuf_submit(cmdbuf), DSP_SUCCESS);
+    ASSERT_EQ(dsp_release_cmdbuf(cmdbuf), DSP_SUCCESS);
+    EXPECT_TRUE(cmdbuf_image == reference);
+
+    // The resident images blend like the user images with the plain API too
+    std::vector<dsp_overlay_properties_t> overlays;
+    for (const auto &placement : m_placements) {
+        const dsp_image_properties_t *image;
+        ASSERT_EQ(dsp_overlay_get_image(placement.overlay, &image), DSP_SUCCESS);
+        overlays.push_back({.overlay = *image, .x_offset = placement.x_offset, .y_offset = placement.y_offset});
+    }
+    TestImage resident_image(m_background);
+    ASSERT_EQ(dsp_blend(m_device, resident_image.get(), overlays.data(), overlays.size()), DSP_SUCCESS);
+    EXPECT_TRUE(resident_image == reference);
+
+    EXPECT_EQ(dsp_release_overlay_set(overlay_set), DSP_SUCCESS);
+}
+
+TEST_F(OverlayTest, PlanMatchesBlend)
+{
+    create_overlays(MAX_BLEND_OVERLAYS);
+    auto reference = blend_reference();
+    dsp_overlay_set overlay_set;
+    ASSERT_EQ(dsp_create_overlay_set(m_placements.data(), m_placements.size(), &overlay_set), DSP_SUCCESS);
+
+    TestImage image(m_background);
+    dsp_plan plan;
+    ASSERT_EQ(dsp_plan_create_blend_overlay_set(m_device, image.get(), overlay_set, &plan), DSP_SUCCESS);
+    ASSERT_EQ(dsp_plan_execute(plan, image.planes(), image.planes_count()), DSP_SUCCESS);
+    EXPECT_TRUE(image == reference);
+
+    EXPECT_EQ(dsp_release_plan(plan), DSP_SUCCESS);
+    EXPECT_EQ(dsp_release_overlay_set(overlay_set), DSP_SUCCESS);
+}
+
+// The dirty rect is widened to even coordinates, and nothing outside of it is copied
+TEST_F(OverlayTest, UpdateCopiesDirtyRect)
+{
+    create_overlays(1);
+    TestImage update(OVERLAY_WIDTH, OVERLAY_HEIGHT, DSP_IMAGE_FORMAT_A420);
+    update.fill_random(100);
+    dsp_roi_t dirty_rect = {.start_x = 3, .start_y = 5, .end_x = 9, .end_y = 11};
+    ASSERT_EQ(dsp_overlay_update(m_overlays[0], update.get(), &dirty_rect), DSP_SUCCESS);
+
+    // Y, U, V, A planes, where U and V have half the resolution
+    TestImage expected(m_images[0]);
+    for (size_t i = 0; i < expected.planes_count(); ++i) {
+        size_t ratio = ((i == 1) || (i == 2)) ? 2 : 1;
+        size_t bytesperline = expected.planes()[i].bytesperline;
+        for (size_t y = 4 / ratio; y < 12 / ratio; ++y) {
+            for (size_t x = 2 / ratio; x < 10 / ratio; ++x) {
+                expected.plane(i)[y * bytesperline + x] = update.plane(i)[y * bytesperline + x];
+            }
+        }
+    }
+    const dsp_image_properties_t *image;
+    ASSERT_EQ(dsp_overlay_get_image(m_overlays[0], &image), DSP_SUCCESS);
+    EXPECT_TRUE(copy_image(*image) == expected);
+
+    // And the whole image without a dirty rect
+    ASSERT_EQ(dsp_overlay_update(m_overlays[0], update.get(), NULL), DSP_SUCCESS);
+    EXPECT_TRUE(copy_image(*image) == update);
+}
+
+// Sets and command buffers reference the overlays, so they blend their latest content
+TEST_F(OverlayTest, UpdatesAreBlendedBySetsAndCommandBuffers)
+{
+    create_overlays(OVERLAYS_COUNT);
+    dsp_overlay_set overlay_set;
+    ASSERT_EQ(dsp_create_overlay_set(m_placements.data(), m_placements.size(), &overlay_set), DSP_SUCCESS);
+    TestImage cmdbuf_image(m_background);
+    dsp_cmdbuf cmdbuf;
+    ASSERT_EQ(dsp_create_cmdbuf(m_device, &cmdbuf), DSP_SUCCESS);
+    ASSERT_EQ(dsp_cmdbuf_record_blend_overlay_set(cmdbuf, cmdbuf_image.get(), overlay_set), DSP_SUCCESS);
+
+    for (size_t i = 0; i < m_images.size(); i += 7) {
+        m_images[i].fill_random(1000 + i);
+        ASSERT_EQ(dsp_overlay_update(m_overlays[i], m_images[i].get(), NULL), DSP_SUCCESS);
+    }
+    auto reference = blend_reference();
+
+    TestImage image(m_background);
+    ASSERT_EQ(dsp_blend_overlay_set(m_device, image.get(), overlay_set), DSP_SUCCESS);
+    EXPECT_TRUE(image == reference);
+
+    ASSERT_EQ(dsp_cmdbuf_submit(cmdbuf), DSP_SUCCESS);
+    EXPECT_TRUE(cmdbuf_image == reference);
+
+    EXPECT_EQ(dsp_release_cmdbuf(cmdbuf), DSP_SUCCESS);
+    EXPECT_EQ(dsp_release_overlay_set(overlay_set), DSP_SUCCESS);
+}
+
+TEST_F(OverlayTest, RejectsUpdateOfOtherSize)
+{
+    create_overlays(1);
+    TestImage update(OVERLAY_WIDTH + 2, OVERLAY_HEIGHT, DSP_IMAGE_FORMAT_A420);
+    EXPECT_EQ(dsp_overlay_update(m_overlays[0], update.get(), NULL), DSP_INVALID_ARGUMENT);
+
+    TestImage same_size(OVERLAY_WIDTH, OVERLAY_HEIGHT, DSP_IMAGE_FORMAT_A420);
+    dsp_roi_t dirty_rect = {.start_x = 0, .start_y = 0, .end_x = OVERLAY_WIDTH + 2, .end_y = 4};
+    EXPECT_EQ(dsp_overlay_update(m_overlays[0], same_size.get(), &dirty_rect), DSP_INVALID_ARGUMENT);
+}
+
+TEST_F(OverlayTest, RejectsOverflowingOffsets)
+{
+    create_overlays(1);
+    dsp_overlay_set overlay_set = nullptr;
+    dsp_overlay_placement_t placement = {.overlay = m_overlays[0], .x_offset = SIZE_MAX - 4, .y_offset = 0};
+    EXPECT_EQ(dsp_create_overlay_set(&placement, 1, &overlay_set), DSP_INVALID_ARGUMENT);
+    placement = {.overlay = m_overlays[0], .x_offset = 0, .y_offset = SIZE_MAX - OVERLAY_HEIGHT + 1};
+    EXPECT_EQ(dsp_create_overlay_set(&placement, 1, &overlay_set), DSP_INVALID_ARGUMENT);
+    EXPECT_EQ(overlay_set, nullptr);
+
+    // The largest offsets that don't overflow are only rejected by the blend, against the image size
+    placement = {.overlay = m_overlays[0], .x_offset = SIZE_MAX - OVERLAY_WIDTH, .y_offset = 0};
+    ASSERT_EQ(dsp_create_overlay_set(&placement, 1, &overlay_set), DSP_SUCCESS);
+    EXPECT_EQ(dsp_blend_overlay_set(m_device, m_background.get(), overlay_set), DSP_INVALID_ARGUMENT);
+    EXPECT_EQ(dsp_release_overlay_set(overlay_set), DSP_SUCCESS);
+}
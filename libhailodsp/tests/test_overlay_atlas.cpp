@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2017-2024 Hailo Technologies Ltd. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "test_utils.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+#define ATLAS_SIZE (64)
+#define IMAGE_SIZE (16)
+
+// An image written to the atlas is synced once before and once after the write, for every A420 plane
+#define A420_PLANES_COUNT (4)
+#define SYNCS_PER_ADD (2 * A420_PLANES_COUNT)
+
+class OverlayAtlasTest : public ::testing::Test {
+   protected:
+    void SetUp() override { ASSERT_EQ(m_device.status(), DSP_SUCCESS); }
+
+    EmulatorDevice m_device;
+};
+
+static bool operator==(const dsp_roi_t &a, const dsp_roi_t &b)
+{
+    return (a.start_x == b.start_x) && (a.start_y == b.start_y) && (a.end_x == b.end_x) && (a.end_y == b.end_y);
+}
+
+// Adds an A420 image, then an RGBA image, where one of the buffer syncs fails
+static void add_images(unsigned failing_sync, dsp_status &first_status, dsp_status &second_status, dsp_roi_t &retry)
+{
+    EmulatorDevice device(0, false, DSP_PRIORITY_DEFAULT, failing_sync);
+    ASSERT_EQ(device.status(), DSP_SUCCESS);
+
+    dsp_overlay_atlas atlas;
+    ASSERT_EQ(dsp_create_overlay_atlas(device, ATLAS_SIZE, ATLAS_SIZE, &atlas), DSP_SUCCESS);
+
+    TestImage image(IMAGE_SIZE, IMAGE_SIZE, DSP_IMAGE_FORMAT_A420);
+    image.fill_random(1);
+    std::vector<uint8_t> rgba(IMAGE_SIZE * IMAGE_SIZE * 4, 0x80);
+    dsp_data_plane_t rgba_plane = {
+        .userptr = rgba.data(),
+        .bytesperline = IMAGE_SIZE * 4,
+        .bytesused = rgba.size(),
+    };
+
+    dsp_roi_t rect;
+    first_status = dsp_overlay_atlas_add(atlas, image.get(), &rect);
+    second_status = dsp_overlay_atlas_add_rgba(atlas, &rgba_plane, IMAGE_SIZE, IMAGE_SIZE, &rect);
+    // The image that failed is added again, into the room it was given before
+    if (first_status != DSP_SUCCESS) {
+        EXPECT_EQ(dsp_overlay_atlas_add(atlas, image.get(), &retry), DSP_SUCCESS);
+    } else {
+        EXPECT_EQ(dsp_overlay_atlas_add_rgba(atlas, &rgba_plane, IMAGE_SIZE, IMAGE_SIZE, &retry), DSP_SUCCESS);
+    }
+
+    EXPECT_EQ(dsp_release_overlay_atlas(atlas), DSP_SUCCESS);
+}
+
+TEST_F(OverlayAtlasTest, FailedAddToNewShelfIsRolledBack)
+{
+    // Both the sync before and the sync after the write
+    for (unsigned failing_sync : {1, 1 + A420_PLANES_COUNT}) {
+        dsp_status first_status, second_status;
+        dsp_roi_t retry;
+        add_images(failing_sync, first_status, second_status, retry);
+        EXPECT_NE(first_status, DSP_SUCCESS);
+        EXPECT_EQ(second_status, DSP_SUCCESS);
+        // The RGBA image took the first shelf, and the retry is placed next to it
+        EXPECT_TRUE(retry == (dsp_roi_t{IMAGE_SIZE, 0, 2 * IMAGE_SIZE, IMAGE_SIZE})) << "failing sync " << failing_sync;
+    }
+}
+
+TEST_F(OverlayAtlasTest, FailedAddToExistingShelfIsRolledBack)
+{
+    for (unsigned failing_sync : {SYNCS_PER_ADD + 1, SYNCS_PER_ADD + 1 + A420_PLANES_COUNT}) {
+        dsp_status first_status, second_status;
+        dsp_roi_t retry;
+        add_images(failing_sync, first_status, second_status, retry);
+        EXPECT_EQ(first_status, DSP_SUCCESS);
+        EXPECT_NE(second_status, DSP_SUCCESS);
+        EXPECT_TRUE(retry == (dsp_roi_t{IMAGE_SIZE, 0, 2 * IMAGE_SIZE, IMAGE_SIZE})) << "failing sync " << failing_sync;
+    }
+}
+
+TEST_F(OverlayAtlasTest, BlendMatchesOverlays)
+{
+    dsp_overlay_atlas atlas;
+    ASSERT_EQ(dsp_create_overlay_atlas(m_device, ATLAS_SIZE, ATLAS_SIZE, &atlas), DSP_SUCCESS);
+
+    // Images of different heights, so that more than one shelf is used
+    std::vector<TestImage> images;
+    std::vector<dsp_atlas_label_t> labels;
+    std::vector<dsp_overlay_properties_t> overlays;
+    for (size_t i = 0; i < 10; ++i) {
+        images.emplace_back(IMAGE_SIZE, 8 + 2 * (i % 3), DSP_IMAGE_FORMAT_A420);
+    }
+    for (size_t i = 0; i < images.size(); ++i) {
+        images[i].fill_random(i);
+        dsp_atlas_label_t label = {.rect = {}, .x_offset = 20 * i, .y_offset = 6 * i};
+        ASSERT_EQ(dsp_overlay_atlas_add(atlas, images[i].get(), &label.rect), DSP_SUCCESS);
+        labels.push_back(label);
+        overlays.push_back({.overlay = *images[i].get(), .x_offset = label.x_offset, .y_offset = label.y_offset});
+    }
+
+    TestImage image(256, 128, DSP_IMAGE_FORMAT_NV12);
+    image.fill_random(100);
+    TestImage reference(image);
+
+    const dsp_image_properties_t *atlas_image;
+    ASSERT_EQ(dsp_overlay_atlas_get_image(atlas, &atlas_image), DSP_SUCCESS);
+    ASSERT_EQ(dsp_blend_atlas(m_device, image.get(), atlas_image, labels.data(), labels.size()), DSP_SUCCESS);
+    ASSERT_EQ(dsp_blend(m_device, reference.get(), overlays.data(), overlays.size()), DSP_SUCCESS);
+    EXPECT_TRUE(image == reference);
+
+    EXPECT_EQ(dsp_release_overlay_atlas(atlas), DSP_SUCCESS);
+}
+
+TEST_F(OverlayAtlasTest, BlendRejectsOverflowingOffsets)
+{
+    dsp_overlay_atlas atlas;
+    ASSERT_EQ(dsp_create_overlay_atlas(m_device, ATLAS_SIZE, ATLAS_SIZE, &atlas), DSP_SUCCESS);
+    const dsp_image_properties_t *atlas_image;
+    ASSERT_EQ(dsp_overlay_atlas_get_image(atlas, &atlas_image), DSP_SUCCESS);
+
+    TestImage image(256, 128, DSP_IMAGE_FORMAT_NV12);
+    dsp_roi_t rect = {.start_x = 0, .start_y = 0, .end_x = IMAGE_SIZE, .end_y = IMAGE_SIZE};
+    // Offsets that wrap around to within the image when the label size is added to them
+    dsp_atlas_label_t labels[] = {
+        {.rect = rect, .x_offset = SIZE_MAX - IMAGE_SIZE + 2, .y_offset = 0},
+        {.rect = rect, .x_offset = 0, .y_offset = SIZE_MAX - IMAGE_SIZE + 2},
+        {.rect = rect, .x_offset = 256 - IMAGE_SIZE + 2, .y_offset = 0},
+    };
+    for (const auto &label : labels) {
+        EXPECT_EQ(dsp_blend_atlas(m_device, image.get(), atlas_image, &label, 1), DSP_INVALID_ARGUMENT);
+    }
+
+    dsp_atlas_label_t label = {.rect = rect, .x_offset = 256 - IMAGE_SIZE, .y_offset = 128 - IMAGE_SIZE};
+    EXPECT_EQ(dsp_blend_atlas(m_device, image.get(), atlas_image, &label, 1), DSP_SUCCESS);
+
+    EXPECT_EQ(dsp_release_overlay_atlas(atlas), DSP_SUCCESS);
+}
@@ -0,0 +1,248 @@
+/*
+ * Copyright (c) 2017-2024 Hailo Technologies Ltd. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+// RGBA conversion against a CPU reference and dsp_convert_format, and the band tracking of RGBA overlay updates
+
+#include "test_utils.hpp"
+
+#include <algorithm>
+#include <gtest/gtest.h>
+
+// Lines per hashed band of RGBA overlays
+#define BAND_LINES (16)
+#define OVERLAY_WIDTH (200)
+// The last band is partial
+#define OVERLAY_HEIGHT (100)
+
+class RgbaImage {
+   public:
+    RgbaImage(size_t width, size_t height, size_t padding = 0) :
+        m_width(width), m_height(height), m_data((width * 4 + padding) * height)
+    {
+        m_plane.userptr = m_data.data();
+        m_plane.bytesperline = width * 4 + padding;
+        m_plane.bytesused = m_data.size();
+    }
+
+    dsp_data_plane_t *get() { return &m_plane; }
+    uint8_t *pixel(size_t x, size_t y) { return m_data.data() + y * m_plane.bytesperline + x * 4; }
+
+    void fill_random(unsigned seed)
+    {
+        std::mt19937 generator(seed);
+        std::uniform_int_distribution<int> distribution(0, 255);
+        for (auto &value : m_data) {
+            value = distribution(generator);
+        }
+    }
+
+    // Per-pixel BT.601 conversion with the integer coefficients of the DSP
+    TestImage to_a420()
+    {
+        TestImage image(m_width, m_height, DSP_IMAGE_FORMAT_A420);
+        for (size_t y = 0; y < m_height; y += 2) {
+            for (size_t x = 0; x < m_width; x += 2) {
+                int u_sum = 0;
+                int v_sum = 0;
+                for (size_t dy = 0; dy < 2; ++dy) {
+                    for (size_t dx = 0; dx < 2; ++dx) {
+                        const uint8_t *p = pixel(x + dx, y + dy);
+                        int r = p[0], g = p[1], b = p[2];
+                        image.plane(0)[(y + dy) * m_width + x + dx] = ((66 * r + 129 * g + 25 * b + 128) >> 8) + 16;
+                        image.plane(3)[(y + dy) * m_width + x + dx] = p[3];
+                        u_sum += ((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128;
+                        v_sum += ((112 * r - 94 * g - 18 * b + 128) >> 8) + 128;
+                    }
+                }
+                image.plane(1)[(y / 2) * (m_width / 2) + x / 2] = (u_sum + 2) / 4;
+                image.plane(2)[(y / 2) * (m_width / 2) + x / 2] = (v_sum + 2) / 4;
+            }
+        }
+        return image;
+    }
+
+   private:
+    size_t m_width;
+    size_t m_height;
+    std::vector<uint8_t> m_data;
+    dsp_data_plane_t m_plane = {};
+};
+
+class RgbaConvertTest : public ::testing::TestWithParam<std::tuple<size_t, size_t>> {};
+
+// Widths that leave a tail after the vectorized part, and padded lines
+TEST_P(RgbaConvertTest, MatchesReference)
+{
+    auto [width, height] = GetParam();
+    RgbaImage rgba(width, height, 12);
+    rgba.fill_random(width * height);
+
+    TestImage a420(width, height, DSP_IMAGE_FORMAT_A420);
+    ASSERT_EQ(dsp_convert_rgba_to_a420(rgba.get(), width, height, a420.get()), DSP_SUCCESS);
+    EXPECT_TRUE(a420 == rgba.to_a420());
+}
+
+INSTANTIATE_TEST_SUITE_P(Sizes,
+                         RgbaConvertTest,
+                         ::testing::Combine(::testing::Values(2, 6, 16, 18, 38, 254), ::testing::Values(2, 34)));
+
+TEST(RgbaConvertFormatTest, MatchesConvertFormat)
+{
+    EmulatorDevice device;
+    ASSERT_EQ(device.status(), DSP_SUCCESS);
+    size_t width = 64;
+    size_t height = 32;
+    RgbaImage rgba(width, height);
+    rgba.fill_random(1);
+    TestImage rgb(width, height, DSP_IMAGE_FORMAT_RGB);
+    for (size_t y = 0; y < height; ++y) {
+        for (size_t x = 0; x < width; ++x) {
+            memcpy(&rgb.plane(0)[(y * width + x) * 3], rgba.pixel(x, y), 3);
+        }
+    }
+    TestImage nv12(width, height, DSP_IMAGE_FORMAT_NV12);
+    ASSERT_EQ(dsp_convert_format(device, rgb.get(), nv12.get()), DSP_SUCCESS);
+
+    TestImage a420(width, height, DSP_IMAGE_FORMAT_A420);
+    ASSERT_EQ(dsp_convert_rgba_to_a420(rgba.get(), width, height, a420.get()), DSP_SUCCESS);
+    EXPECT_EQ(a420.plane(0), nv12.plane(0));
+    for (size_t i = 0; i < width * height / 4; ++i) {
+        ASSERT_EQ(a420.plane(1)[i], nv12.plane(1)[i * 2]);
+        ASSERT_EQ(a420.plane(2)[i], nv12.plane(1)[i * 2 + 1]);
+    }
+}
+
+TEST(RgbaConvertFormatTest, RejectsOddSizes)
+{
+    RgbaImage rgba(4, 4);
+    TestImage a420(4, 4, DSP_IMAGE_FORMAT_A420);
+    EXPECT_EQ(dsp_convert_rgba_to_a420(rgba.get(), 3, 4, a420.get()), DSP_INVALID_ARGUMENT);
+    EXPECT_EQ(dsp_convert_rgba_to_a420(rgba.get(), 4, 3, a420.get()), DSP_INVALID_ARGUMENT);
+    EXPECT_EQ(dsp_convert_rgba_to_a420(NULL, 4, 4, a420.get()), DSP_INVALID_ARGUMENT);
+}
+
+class OverlayRgbaTest : public ::testing::Test {
+   protected:
+    void SetUp() override
+    {
+        ASSERT_EQ(m_device.status(), DSP_SUCCESS);
+        m_rgba.fill_random(1);
+        ASSERT_EQ(dsp_create_overlay_rgba(m_device, m_rgba.get(), OVERLAY_WIDTH, OVERLAY_HEIGHT, &m_overlay),
+                  DSP_SUCCESS);
+        ASSERT_EQ(dsp_overlay_get_image(m_overlay, &m_image), DSP_SUCCESS);
+    }
+
+    void TearDown() override { EXPECT_EQ(dsp_release_overlay(m_overlay), DSP_SUCCESS); }
+
+    // Writes a mark on the first luma line of a band of the resident image, behind the back of the overlay
+    void tamper(size_t band)
+    {
+        auto luma = static_cast<uint8_t *>(m_image->planes[0].userptr);
+        memset(luma + band * BAND_LINES * m_image->planes[0].bytesperline, 0x5a, OVERLAY_WIDTH);
+    }
+
+    bool is_tampered(size_t band)
+    {
+        auto luma = static_cast<const uint8_t *>(m_image->planes[0].userptr);
+        const uint8_t *line = luma + band * BAND_LINES * m_image->planes[0].bytesperline;
+        return std::all_of(line, line + OVERLAY_WIDTH, [](uint8_t value) { return value == 0x5a; });
+    }
+
+    EmulatorDevice m_device;
+    RgbaImage m_rgba{OVERLAY_WIDTH, OVERLAY_HEIGHT};
+    dsp_overlay m_overlay = nullptr;
+    const dsp_image_properties_t *m_image = nullptr;
+};
+
+TEST_F(OverlayRgbaTest, CreateMatchesConvert)
+{
+    EXPECT_TRUE(copy_image(*m_image) == m_rgba.to_a420());
+}
+
+TEST_F(OverlayRgbaTest, UpdateConvertsChangedBands)
+{
+    // A single pixel, lines across a band boundary, and the last line of the partial last band
+    m_rgba.pixel(17, 37)[0] ^= 0x55;
+    for (size_t y = BAND_LINES - 1; y < BAND_LINES + 2; ++y) {
+        memset(m_rgba.pixel(0, y), 0x33, OVERLAY_WIDTH * 4);
+    }
+    m_rgba.pixel(OVERLAY_WIDTH - 1, OVERLAY_HEIGHT - 1)[2] ^= 0x01;
+    ASSERT_EQ(dsp_overlay_update_rgba(m_overlay, m_rgba.get()), DSP_SUCCESS);
+    EXPECT_TRUE(copy_image(*m_image) == m_rgba.to_a420());
+}
+
+TEST_F(OverlayRgbaTest, UpdateSkipsUnchangedBands)
+{
+    tamper(0);
+    tamper(4);
+    ASSERT_EQ(dsp_overlay_update_rgba(m_overlay, m_rgba.get()), DSP_SUCCESS);
+    EXPECT_TRUE(is_tampered(0));
+    EXPECT_TRUE(is_tampered(4));
+
+    // Only the band of the change is written again
+    m_rgba.pixel(3, 4 * BAND_LINES + 7)[1] ^= 0x10;
+    ASSERT_EQ(dsp_overlay_update_rgba(m_overlay, m_rgba.get()), DSP_SUCCESS);
+    EXPECT_TRUE(is_tampered(0));
+    EXPECT_FALSE(is_tampered(4));
+}
+
+TEST_F(OverlayRgbaTest, UpdateAfterOverlayUpdateConvertsEverything)
+{
+    TestImage other(OVERLAY_WIDTH, OVERLAY_HEIGHT, DSP_IMAGE_FORMAT_A420);
+    other.fill_random(2);
+    ASSERT_EQ(dsp_overlay_update(m_overlay, other.get(), NULL), DSP_SUCCESS);
+    EXPECT_TRUE(copy_image(*m_image) == other);
+
+    // The RGBA image did not change since the overlay was created, yet every band is converted
+    ASSERT_EQ(dsp_overlay_update_rgba(m_overlay, m_rgba.get()), DSP_SUCCESS);
+    EXPECT_TRUE(copy_image(*m_image) == m_rgba.to_a420());
+}
+
+TEST_F(OverlayRgbaTest, UpdateIsBlended)
+{
+    for (size_t y = 40; y < 60; ++y) {
+        memset(m_rgba.pixel(0, y), 0xc0, OVERLAY_WIDTH * 4);
+    }
+    ASSERT_EQ(dsp_overlay_update_rgba(m_overlay, m_rgba.get()), DSP_SUCCESS);
+
+    TestImage background(640, 360, DSP_IMAGE_FORMAT_NV12);
+    background.fill_random(3);
+    TestImage image(background);
+    dsp_overlay_placement_t placement = {.overlay = m_overlay, .x_offset = 10, .y_offset = 20};
+    dsp_overlay_set overlay_set;
+    ASSERT_EQ(dsp_create_overlay_set(&placement, 1, &overlay_set), DSP_SUCCESS);
+    ASSERT_EQ(dsp_blend_overlay_set(m_device, image.get(), overlay_set), DSP_SUCCESS);
+    EXPECT_EQ(dsp_release_overlay_set(overlay_set), DSP_SUCCESS);
+
+    TestImage converted = m_rgba.to_a420();
+    dsp_overlay_properties_t overlay = {.overlay = *converted.get(), .x_offset = 10, .y_offset = 20};
+    ASSERT_EQ(dsp_blend(m_device, background.get(), &overlay, 1), DSP_SUCCESS);
+    EXPECT_TRUE(image == background);
+}
+
+TEST_F(OverlayRgbaTest, RejectsUpdateOfOtherSize)
+{
+    RgbaImage short_rgba(OVERLAY_WIDTH, OVERLAY_HEIGHT - 2);
+    EXPECT_EQ(dsp_overlay_update_rgba(m_overlay, short_rgba.get()), DSP_INVALID_ARGUMENT);
+    EXPECT_EQ(dsp_overlay_update_rgba(m_overlay, NULL), DSP_INVALID_ARGUMENT);
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2017-2024 Hailo Technologies Ltd. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "test_utils.hpp"
+
+#include <gtest/gtest.h>
+
+// More than the ROIs of a single blur request, so the plan holds chained requests
+#define CHAINED_BLUR_ROIS_COUNT (200)
+
+class PlanTest : public ::testing::Test {
+   protected:
+    void SetUp() override { ASSERT_EQ(m_device.status(), DSP_SUCCESS); }
+
+    void TearDown() override
+    {
+        if (m_plan) {
+            EXPECT_EQ(dsp_release_plan(m_plan), DSP_SUCCESS);
+        }
+    }
+
+    EmulatorDevice m_device;
+    dsp_plan m_plan = nullptr;
+};
+
+TEST_F(PlanTest, ResizeMatchesOperation)
+{
+    TestImage src(320, 240, DSP_IMAGE_FORMAT_NV12);
+    src.fill(0);
+    TestImage dst(64, 64, DSP_IMAGE_FORMAT_NV12);
+    dsp_resize_params_t params = {src.get(), dst.get(), INTERPOLATION_TYPE_BILINEAR};
+    ASSERT_EQ(dsp_plan_create_resize(m_device, &params, &m_plan), DSP_SUCCESS);
+
+    size_t planes_count = 0;
+    ASSERT_EQ(dsp_plan_get_planes_count(m_plan, &planes_count), DSP_SUCCESS);
+    ASSERT_EQ(planes_count, 4u);
+
+    TestImage frame(320, 240, DSP_IMAGE_FORMAT_NV12);
+    frame.fill_random(1);
+    TestImage plan_dst(64, 64, DSP_IMAGE_FORMAT_NV12);
+    dsp_data_plane_t planes[] = {frame.planes()[0], frame.planes()[1], plan_dst.planes()[0], plan_dst.planes()[1]};
+    ASSERT_EQ(dsp_plan_execute(m_plan, planes, planes_count), DSP_SUCCESS);
+
+    TestImage op_dst(64, 64, DSP_IMAGE_FORMAT_NV12);
+    dsp_resize_params_t op_params = {frame.get(), op_dst.get(), INTERPOLATION_TYPE_BILINEAR};
+    ASSERT_EQ(dsp_resize(m_device, &op_params), DSP_SUCCESS);
+    EXPECT_TRUE(plan_dst == op_dst);
+}
+
+TEST_F(PlanTest, ExecuteRejectsLayoutChange)
+{
+    TestImage src(128, 128, DSP_IMAGE_FORMAT_GRAY8);
+    TestImage dst(32, 32, DSP_IMAGE_FORMAT_GRAY8);
+    dsp_resize_params_t params = {src.get(), dst.get(), INTERPOLATION_TYPE_BILINEAR};
+    ASSERT_EQ(dsp_plan_create_resize(m_device, &params, &m_plan), DSP_SUCCESS);
+
+    dsp_data_plane_t planes[] = {src.planes()[0], dst.planes()[0]};
+    planes[0].bytesperline /= 2;
+    EXPECT_EQ(dsp_plan_execute(m_plan, planes, 2), DSP_INVALID_ARGUMENT);
+    EXPECT_EQ(dsp_plan_execute(m_plan, planes, 1), DSP_INVALID_ARGUMENT);
+}
+
+TEST_F(PlanTest, ChainedBlurMatchesOperation)
+{
+    std::vector<dsp_roi_t> rois;
+    for (size_t i = 0; i < CHAINED_BLUR_ROIS_COUNT; ++i) {
+        size_t x = (i % 20) * 32;
+        size_t y = (i / 20) * 24;
+        rois.push_back({.start_x = x, .start_y = y, .end_x = x + 24, .end_y = y + 16});
+    }
+
+    TestImage recorded(640, 240, DSP_IMAGE_FORMAT_GRAY8);
+    ASSERT_EQ(dsp_plan_create_blur(m_device, recorded.get(), rois.data(), rois.size(), 5, &m_plan), DSP_SUCCESS);
+
+    // The plan's requests and the payload they are chained through must outlive the image the plan was created with
+    TestImage frame(640, 240, DSP_IMAGE_FORMAT_GRAY8);
+    frame.fill_random(2);
+    TestImage op_frame(frame);
+    ASSERT_EQ(dsp_plan_execute(m_plan, frame.planes(), 1), DSP_SUCCESS);
+    ASSERT_EQ(dsp_blur(m_device, op_frame.get(), rois.data(), rois.size(), 5), DSP_SUCCESS);
+    EXPECT_TRUE(frame == op_frame);
+
+    // Every chained request is bound to the new frame, including the last ROIs
+    TestImage other(640, 240, DSP_IMAGE_FORMAT_GRAY8);
+    other.fill_random(3);
+    TestImage op_other(other);
+    ASSERT_EQ(dsp_plan_execute(m_plan, other.planes(), 1), DSP_SUCCESS);
+    ASSERT_EQ(dsp_blur(m_device, op_other.get(), rois.data(), rois.size(), 5), DSP_SUCCESS);
+    EXPECT_TRUE(other == op_other);
+    EXPECT_TRUE(recorded == TestImage(640, 240, DSP_IMAGE_FORMAT_GRAY8));
+}
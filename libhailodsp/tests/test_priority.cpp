@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2017-2024 Hailo Technologies Ltd. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+// Command priorities against the emulator, which runs one command at a time and picks the waiting command of the
+// highest XRP queue. Commands are no-ops of a fixed latency, so the order and the latencies only depend on scheduling
+
+#include <linux/types.h>
+#define HAVE___U8
+#define HAVE___U32
+#define HAVE___S32
+#define HAVE___U64
+
+#include "device.hpp"
+#include "test_utils.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <iostream>
+#include <sys/ioctl.h>
+#include <thread>
+
+#define LATENCY_US (5000)
+// Longer commands for the order of completion, so that the threads reach the queue in the order they were started
+// even when they are slow to be scheduled
+#define ORDER_LATENCY_US (50000)
+#define BACKGROUND_THREADS_COUNT (4)
+#define MEASURED_COMMANDS_COUNT (20)
+
+using namespace std::chrono;
+
+TEST(PriorityTest, NormalPriorityUsesQueueZero)
+{
+    EXPECT_EQ(get_queue_priority(DSP_PRIORITY_NORMAL), 0u);
+    EXPECT_EQ(get_queue_priority(DSP_PRIORITY_LOW), 0u);
+    EXPECT_EQ(get_queue_priority(DSP_PRIORITY_HIGH), 1u);
+
+    EmulatorDevice device;
+    ASSERT_EQ(device.status(), DSP_SUCCESS);
+    EXPECT_EQ(get_queue_priority(get_command_priority(device)), 0u);
+}
+
+class PriorityOrderTest : public ::testing::Test {
+   protected:
+    void SetUp() override { ASSERT_EQ(m_device.status(), DSP_SUCCESS); }
+
+    // Resizes on a thread of its own with the given priority, and records the position the command completed at
+    std::thread start_command(dsp_device device, dsp_priority_t priority, int &position)
+    {
+        return std::thread([this, device, priority, &position] {
+            (void)dsp_set_thread_priority(priority);
+            TestImage src(64, 64, DSP_IMAGE_FORMAT_GRAY8);
+            TestImage dst(32, 32, DSP_IMAGE_FORMAT_GRAY8);
+            dsp_resize_params_t params = {src.get(), dst.get(), INTERPOLATION_TYPE_BILINEAR};
+            EXPECT_EQ(dsp_resize(device, &params), DSP_SUCCESS);
+            position = m_completed.fetch_add(1);
+        });
+    }
+
+    EmulatorDevice m_device{LATENCY_US, true};
+    std::atomic<int> m_completed = 0;
+};
+
+TEST_F(PriorityOrderTest, HighPriorityOvertakesWaitingCommands)
+{
+    EmulatorDevice device(ORDER_LATENCY_US, true);
+    ASSERT_EQ(device.status(), DSP_SUCCESS);
+    int running = -1;
+    int normal[3] = {-1, -1, -1};
+    int high = -1;
+
+    // The first command occupies the DSP, the next ones wait behind it
+    std::vector<std::thread> threads;
+    threads.push_back(start_command(device, DSP_PRIORITY_NORMAL, running));
+    std::this_thread::sleep_for(microseconds(ORDER_LATENCY_US / 5));
+    for (auto &position : normal) {
+        threads.push_back(start_command(device, DSP_PRIORITY_NORMAL, position));
+    }
+    std::this_thread::sleep_for(microseconds(ORDER_LATENCY_US / 5));
+    threads.push_back(start_command(device, DSP_PRIORITY_HIGH, high));
+
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(running, 0);
+    EXPECT_EQ(high, 1);
+}
+
+// Asynchronous jobs are sent one at a time by the worker thread of the device, which picks the highest priority
+TEST_F(PriorityOrderTest, HighPriorityJobOvertakesQueuedJobs)
+{
+    EmulatorDevice device(ORDER_LATENCY_US, true);
+    ASSERT_EQ(device.status(), DSP_SUCCESS);
+    TestImage src(64, 64, DSP_IMAGE_FORMAT_GRAY8);
+    TestImage dst(32, 32, DSP_IMAGE_FORMAT_GRAY8);
+    dsp_resize_params_t params = {src.get(), dst.get(), INTERPOLATION_TYPE_BILINEAR};
+
+    // Queued by another thread, since the jobs of a thread keep their order
+    dsp_job low[4];
+    std::thread([&] {
+        (void)dsp_set_thread_priority(DSP_PRIORITY_LOW);
+        for (auto &job : low) {
+            EXPECT_EQ(dsp_resize_async(device, &params, &job), DSP_SUCCESS);
+        }
+    }).join();
+
+    (void)dsp_set_thread_priority(DSP_PRIORITY_HIGH);
+    dsp_job high;
+    ASSERT_EQ(dsp_resize_async(device, &params, &high), DSP_SUCCESS);
+    (void)dsp_set_thread_priority(DSP_PRIORITY_DEFAULT);
+    EXPECT_EQ(dsp_job_wait(high), DSP_SUCCESS);
+
+    // At most the job that was already executing completed before the high priority job
+    size_t completed_low = 0;
+    for (auto job : low) {
+        completed_low += (dsp_job_poll(job) == DSP_SUCCESS);
+    }
+    EXPECT_LE(completed_low, 1u);
+
+    EXPECT_EQ(dsp_job_release(high), DSP_SUCCESS);
+    for (auto job : low) {
+        EXPECT_EQ(dsp_job_release(job), DSP_SUCCESS);
+    }
+}
+
+TEST_F(PriorityOrderTest, HighPriorityLatencyUnderBackgroundLoad)
+{
+    std::atomic<bool> stop = false;
+    std::vector<std::thread> background;
+    for (size_t i = 0; i < BACKGROUND_THREADS_COUNT; ++i) {
+        background.emplace_back([this, &stop] {
+            (void)dsp_set_thread_priority(DSP_PRIORITY_LOW);
+            TestImage src(64, 64, DSP_IMAGE_FORMAT_GRAY8);
+            TestImage dst(32, 32, DSP_IMAGE_FORMAT_GRAY8);
+            dsp_resize_params_t params = {src.get(), dst.get(), INTERPOLATION_TYPE_BILINEAR};
+            while (!stop) {
+                (void)dsp_resize(m_device, &params);
+            }
+        });
+    }
+    std::this_thread::sleep_for(microseconds(2 * LATENCY_US));
+
+    TestImage src(64, 64, DSP_IMAGE_FORMAT_GRAY8);
+    TestImage dst(32, 32, DSP_IMAGE_FORMAT_GRAY8);
+    dsp_resize_params_t params = {src.get(), dst.get(), INTERPOLATION_TYPE_BILINEAR};
+    auto measure = [&](dsp_priority_t priority) {
+        (void)dsp_set_thread_priority(priority);
+        steady_clock::duration total(0);
+        for (size_t i = 0; i < MEASURED_COMMANDS_COUNT; ++i) {
+            auto start = steady_clock::now();
+            EXPECT_EQ(dsp_resize(m_device, &params), DSP_SUCCESS);
+            total += steady_clock::now() - start;
+        }
+        return duration_cast<microseconds>(total).count() / MEASURED_COMMANDS_COUNT;
+    };
+    auto normal_latency_us = measure(DSP_PRIORITY_NORMAL);
+    auto high_latency_us = measure(DSP_PRIORITY_HIGH);
+    (void)dsp_set_thread_priority(DSP_PRIORITY_DEFAULT);
+
+    stop = true;
+    for (auto &thread : background) {
+        thread.join();
+    }
+
+    std::cout << "Average latency with " << BACKGROUND_THREADS_COUNT << " low priority threads: normal "
+              << normal_latency_us << " us, high " << high_latency_us << " us (command " << LATENCY_US << " us)\n";
+    RecordProperty("normal_latency_us", std::to_string(normal_latency_us));
+    RecordProperty("high_latency_us", std::to_string(high_latency_us));
+
+    // A high priority command waits for the executing command at most, never for the waiting ones
+    EXPECT_LT(high_latency_us, 5 * LATENCY_US / 2);
+}
@@ -0,0 +1,301 @@
+/*
+ * Copyright (c) 2017-2024 Hailo Technologies Ltd. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+// Privacy mask bitmask and ROIs built from per-pixel masks and from polygons, against references computed per pixel
+
+#include "test_utils.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <tuple>
+
+// The bitmask has a bit per 4x4 pixels, LSB first, with lines padded to a multiple of 8 bytes
+class Bitmask {
+   public:
+    Bitmask(size_t image_width, size_t image_height) :
+        m_width((image_width + 3) / 4),
+        m_height((image_height + 3) / 4),
+        m_stride(((image_width + 31) / 32 + 7) / 8 * 8),
+        m_data(m_stride * m_height, 0)
+    {}
+
+    void set_pixel(size_t x, size_t y) { m_data[y / 4 * m_stride + x / 32] |= 1 << ((x / 4) % 8); }
+
+    size_t width() const { return m_width; }
+    size_t height() const { return m_height; }
+    size_t size() const { return m_data.size(); }
+    const std::vector<uint8_t> &data() const { return m_data; }
+
+   private:
+    size_t m_width;
+    size_t m_height;
+    size_t m_stride;
+    std::vector<uint8_t> m_data;
+};
+
+static bool is_set(const std::vector<uint8_t> &bitmask, const Bitmask &layout, size_t x, size_t y)
+{
+    size_t stride = layout.size() / layout.height();
+    return (bitmask[y * stride + x / 8] >> (x % 8)) & 1;
+}
+
+static bool operator==(const dsp_roi_t &a, const dsp_roi_t &b)
+{
+    return (a.start_x == b.start_x) && (a.start_y == b.start_y) && (a.end_x == b.end_x) && (a.end_y == b.end_y);
+}
+
+// The ROIs cover all the set bits, and every edge of every ROI has a set bit, so that no ROI is larger than needed
+static void expect_tight_rois(const std::vector<uint8_t> &bitmask,
+                              const Bitmask &layout,
+                              const dsp_roi_t *rois,
+                              size_t rois_count)
+{
+    ASSERT_GE(rois_count, 1u);
+    ASSERT_LE(rois_count, DSP_PRIVACY_MASK_MAX_ROIS);
+    for (size_t i = 0; i < rois_count; ++i) {
+        const auto &roi = rois[i];
+        ASSERT_LT(roi.start_x, roi.end_x);
+        ASSERT_LT(roi.start_y, roi.end_y);
+        ASSERT_LE(roi.end_x, layout.width());
+        ASSERT_LE(roi.end_y, layout.height());
+
+        bool top = false, bottom = false, left = false, right = false;
+        for (size_t x = roi.start_x; x < roi.end_x; ++x) {
+            top |= is_set(bitmask, layout, x, roi.start_y);
+            bottom |= is_set(bitmask, layout, x, roi.end_y - 1);
+        }
+        for (size_t y = roi.start_y; y < roi.end_y; ++y) {
+            left |= is_set(bitmask, layout, roi.start_x, y);
+            right |= is_set(bitmask, layout, roi.end_x - 1, y);
+        }
+        EXPECT_TRUE(top && bottom && left && right) << "roi " << i;
+    }
+
+    for (size_t y = 0; y < layout.height(); ++y) {
+        for (size_t x = 0; x < layout.width(); ++x) {
+            if (!is_set(bitmask, layout, x, y)) {
+                continue;
+            }
+            bool covered = std::any_of(rois, rois + rois_count, [x, y](const dsp_roi_t &roi) {
+                return (x >= roi.start_x) && (x < roi.end_x) && (y >= roi.start_y) && (y < roi.end_y);
+            });
+            ASSERT_TRUE(covered) << "bit (" << x << ", " << y << ")";
+        }
+    }
+}
+
+// Even-odd rule at the pixel center
+static bool is_inside(const std::vector<dsp_point_t> &polygon, double x, double y)
+{
+    bool inside = false;
+    for (size_t i = 0, j = polygon.size() - 1; i < polygon.size(); j = i++) {
+        double xi = polygon[i].x, yi = polygon[i].y, xj = polygon[j].x, yj = polygon[j].y;
+        if (((yi > y) != (yj > y)) && (x < (xj - xi) * (y - yi) / (yj - yi) + xi)) {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+
+// Sizes that are not multiples of the 32 pixels of a bitmask byte, nor of the 4 pixels of a bit
+class PrivacyMaskBuilderTest : public ::testing::TestWithParam<std::tuple<size_t, size_t>> {};
+
+TEST_P(PrivacyMaskBuilderTest, MaskMatchesPerPixelReference)
+{
+    auto [width, height] = GetParam();
+    std::mt19937 generator(width * height);
+
+    // Padded lines, where the padding must be ignored
+    size_t bytesperline = width + 5;
+    std::vector<uint8_t> mask(bytesperline * height, 7);
+    Bitmask reference(width, height);
+    for (size_t y = 0; y < height; ++y) {
+        for (size_t x = 0; x < width; ++x) {
+            mask[y * bytesperline + x] = (generator() % 50 == 0) ? static_cast<uint8_t>(1 + generator() % 255) : 0;
+            if (mask[y * bytesperline + x]) {
+                reference.set_pixel(x, y);
+            }
+        }
+    }
+    dsp_data_plane_t plane = {.userptr = mask.data(), .bytesperline = bytesperline, .bytesused = mask.size()};
+    dsp_image_properties_t mask_image = {
+        .width = width,
+        .height = height,
+        .planes = &plane,
+        .planes_count = 1,
+        .format = DSP_IMAGE_FORMAT_GRAY8,
+        .memory = DSP_MEMORY_TYPE_USERPTR,
+    };
+
+    size_t bitmask_size;
+    ASSERT_EQ(dsp_privacy_mask_get_bitmask_size(width, height, &bitmask_size), DSP_SUCCESS);
+    ASSERT_EQ(bitmask_size, reference.size());
+
+    // The whole bitmask is written, including the line padding
+    std::vector<uint8_t> bitmask(bitmask_size, 0xcc);
+    dsp_roi_t rois[DSP_PRIVACY_MASK_MAX_ROIS];
+    size_t rois_count;
+    ASSERT_EQ(dsp_privacy_mask_build_from_mask(&mask_image, bitmask.data(), bitmask.size(), rois, &rois_count),
+              DSP_SUCCESS);
+    EXPECT_TRUE(bitmask == reference.data());
+    expect_tight_rois(bitmask, reference, rois, rois_count);
+}
+
+TEST_P(PrivacyMaskBuilderTest, PolygonsMatchPointInPolygonReference)
+{
+    auto [width, height] = GetParam();
+    std::mt19937 generator(width + height);
+
+    // Random polygons, which may be concave, self intersecting, and partly outside the image
+    std::vector<std::vector<dsp_point_t>> points(12);
+    std::vector<dsp_polygon_t> polygons;
+    for (auto &polygon : points) {
+        size_t center_x = generator() % width;
+        size_t center_y = generator() % height;
+        size_t points_count = 3 + generator() % 6;
+        for (size_t i = 0; i < points_count; ++i) {
+            polygon.push_back({center_x + generator() % 60, center_y + generator() % 60});
+        }
+        polygons.push_back({.points = polygon.data(), .points_count = polygon.size()});
+    }
+
+    Bitmask reference(width, height);
+    for (const auto &polygon : points) {
+        for (size_t y = 0; y < height; ++y) {
+            for (size_t x = 0; x < width; ++x) {
+                if (is_inside(polygon, x + 0.5, y + 0.5)) {
+                    reference.set_pixel(x, y);
+                }
+            }
+        }
+    }
+
+    std::vector<uint8_t> bitmask(reference.size(), 0xcc);
+    dsp_roi_t rois[DSP_PRIVACY_MASK_MAX_ROIS];
+    size_t rois_count;
+    ASSERT_EQ(dsp_privacy_mask_build_from_polygons(width, height, polygons.data(), polygons.size(), bitmask.data(),
+                                                   bitmask.size(), rois, &rois_count),
+              DSP_SUCCESS);
+    EXPECT_TRUE(bitmask == reference.data());
+    expect_tight_rois(bitmask, reference, rois, rois_count);
+}
+
+INSTANTIATE_TEST_SUITE_P(PrivacyMaskBuilder,
+                         PrivacyMaskBuilderTest,
+                         ::testing::Values(std::make_tuple(64, 64),
+                                           std::make_tuple(37, 21),
+                                           std::make_tuple(321, 243),
+                                           std::make_tuple(400, 130)));
+
+// Up to the maximum, separate regions get ROIs of their own: their exact bounding boxes
+TEST(PrivacyMaskRoisTest, SeparateRegionsGetTheirBoundingBoxes)
+{
+    const size_t width = 256, height = 128;
+    Bitmask bitmask(width, height);
+    std::vector<dsp_roi_t> expected;
+    for (size_t i = 0; i < DSP_PRIVACY_MASK_MAX_ROIS; ++i) {
+        // An L shape in 4x4 units, with a bit that only touches the rest diagonally
+        size_t x = (i % 4) * 16 + 1, y = (i / 4) * 16 + 1;
+        for (size_t dy = 0; dy < 5; ++dy) {
+            bitmask.set_pixel(x * 4, (y + dy) * 4);
+        }
+        for (size_t dx = 0; dx < 3; ++dx) {
+            bitmask.set_pixel((x + dx) * 4, (y + 4) * 4);
+        }
+        bitmask.set_pixel((x + 3) * 4, (y + 5) * 4);
+        expected.push_back({.start_x = x, .start_y = y, .end_x = x + 4, .end_y = y + 6});
+    }
+
+    std::vector<uint8_t> mask(width * height, 0);
+    for (size_t y = 0; y < height; ++y) {
+        for (size_t x = 0; x < width; ++x) {
+            mask[y * width + x] = is_set(bitmask.data(), bitmask, x / 4, y / 4) && (x % 4 == 0) && (y % 4 == 0);
+        }
+    }
+    dsp_data_plane_t plane = {.userptr = mask.data(), .bytesperline = width, .bytesused = mask.size()};
+    dsp_image_properties_t mask_image = {width, height, &plane, 1, DSP_IMAGE_FORMAT_GRAY8, DSP_MEMORY_TYPE_USERPTR};
+
+    std::vector<uint8_t> result(bitmask.size());
+    dsp_roi_t rois[DSP_PRIVACY_MASK_MAX_ROIS];
+    size_t rois_count;
+    ASSERT_EQ(dsp_privacy_mask_build_from_mask(&mask_image, result.data(), result.size(), rois, &rois_count),
+              DSP_SUCCESS);
+    EXPECT_TRUE(result == bitmask.data());
+    ASSERT_EQ(rois_count, expected.size());
+    for (const auto &roi : expected) {
+        EXPECT_NE(std::find(rois, rois + rois_count, roi), rois + rois_count)
+            << "roi (" << roi.start_x << ", " << roi.start_y << ")";
+    }
+}
+
+// Beyond the maximum, regions are merged into fewer ROIs, which still cover all of them
+TEST(PrivacyMaskRoisTest, ManyRegionsAreMerged)
+{
+    const size_t width = 512, height = 256;
+    std::vector<std::vector<dsp_point_t>> points;
+    std::vector<dsp_polygon_t> polygons;
+    for (size_t i = 0; i < 40; ++i) {
+        size_t x = (i % 8) * 64 + 8, y = (i / 8) * 48 + 8;
+        points.push_back({{x, y}, {x + 20 + i % 7, y}, {x + 10, y + 16 + i % 5}});
+    }
+    for (const auto &polygon : points) {
+        polygons.push_back({.points = polygon.data(), .points_count = polygon.size()});
+    }
+
+    Bitmask layout(width, height);
+    std::vector<uint8_t> bitmask(layout.size());
+    dsp_roi_t rois[DSP_PRIVACY_MASK_MAX_ROIS];
+    size_t rois_count;
+    ASSERT_EQ(dsp_privacy_mask_build_from_polygons(width, height, polygons.data(), polygons.size(), bitmask.data(),
+                                                   bitmask.size(), rois, &rois_count),
+              DSP_SUCCESS);
+    EXPECT_EQ(rois_count, DSP_PRIVACY_MASK_MAX_ROIS);
+    expect_tight_rois(bitmask, layout, rois, rois_count);
+}
+
+TEST(PrivacyMaskRoisTest, EmptyMaskGetsSingleRoi)
+{
+    Bitmask layout(64, 64);
+    std::vector<uint8_t> bitmask(layout.size(), 0xff);
+    dsp_roi_t rois[DSP_PRIVACY_MASK_MAX_ROIS];
+    size_t rois_count;
+    ASSERT_EQ(dsp_privacy_mask_build_from_polygons(64, 64, NULL, 0, bitmask.data(), bitmask.size(), rois, &rois_count),
+              DSP_SUCCESS);
+    EXPECT_TRUE(bitmask == layout.data());
+    ASSERT_EQ(rois_count, 1u);
+    EXPECT_EQ(rois[0].end_x - rois[0].start_x, 1u);
+    EXPECT_EQ(rois[0].end_y - rois[0].start_y, 1u);
+}
+
+TEST(PrivacyMaskRoisTest, RejectsSmallBitmask)
+{
+    Bitmask layout(4000, 64);
+    std::vector<uint8_t> bitmask(layout.size());
+    dsp_roi_t rois[DSP_PRIVACY_MASK_MAX_ROIS];
+    size_t rois_count;
+    EXPECT_EQ(dsp_privacy_mask_build_from_polygons(4000, 64, NULL, 0, bitmask.data(), bitmask.size() - 1, rois,
+                                                   &rois_count),
+              DSP_INVALID_ARGUMENT);
+}
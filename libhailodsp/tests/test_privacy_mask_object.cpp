@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) 2017-2024 Hailo Technologies Ltd. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+// Privacy mask objects, whose bitmask is kept in a DSP buffer and only partly rewritten on updates, against privacy
+// masks built in user memory
+
+#include "test_utils.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <iterator>
+
+#define WIDTH (640)
+#define HEIGHT (360)
+#define Y_COLOR (16)
+#define UV_COLOR (128)
+
+class PrivacyMaskObjectTest : public ::testing::Test {
+   protected:
+    void SetUp() override
+    {
+        ASSERT_EQ(m_device.status(), DSP_SUCCESS);
+        ASSERT_EQ(dsp_create_privacy_mask(m_device, WIDTH, HEIGHT, Y_COLOR, UV_COLOR, UV_COLOR, &m_privacy_mask),
+                  DSP_SUCCESS);
+        ASSERT_EQ(dsp_privacy_mask_get_bitmask_size(WIDTH, HEIGHT, &m_bitmask_size), DSP_SUCCESS);
+        m_src.fill_random(1);
+    }
+
+    void TearDown() override { EXPECT_EQ(dsp_release_privacy_mask(m_privacy_mask), DSP_SUCCESS); }
+
+    // The object holds the bitmask and ROIs of the reference, and masks a crop&resize the same way
+    void expect_same_as(std::vector<uint8_t> &bitmask, dsp_roi_t *rois, size_t rois_count)
+    {
+        dsp_privacy_mask_t params;
+        ASSERT_EQ(dsp_privacy_mask_get_params(m_privacy_mask, &params), DSP_SUCCESS);
+        EXPECT_EQ(memcmp(params.bitmask, bitmask.data(), m_bitmask_size), 0);
+        ASSERT_EQ(params.rois_count, rois_count);
+        for (size_t i = 0; i < rois_count; ++i) {
+            EXPECT_EQ(params.rois[i].start_x, rois[i].start_x);
+            EXPECT_EQ(params.rois[i].start_y, rois[i].start_y);
+            EXPECT_EQ(params.rois[i].end_x, rois[i].end_x);
+            EXPECT_EQ(params.rois[i].end_y, rois[i].end_y);
+        }
+
+        dsp_privacy_mask_t reference_params = params;
+        reference_params.bitmask = bitmask.data();
+        reference_params.rois = rois;
+        TestImage dst(WIDTH / 2, HEIGHT / 2, DSP_IMAGE_FORMAT_NV12);
+        TestImage reference(WIDTH / 2, HEIGHT / 2, DSP_IMAGE_FORMAT_NV12);
+        dsp_roi_t crop = {.start_x = 0, .start_y = 0, .end_x = WIDTH, .end_y = HEIGHT};
+        dsp_multi_resize_params_t resize_params = {
+            .src = m_src.get(),
+            .dst = {dst.get()},
+            .interpolation = INTERPOLATION_TYPE_BILINEAR,
+        };
+        ASSERT_EQ(dsp_multi_crop_and_resize_privacy_mask(m_device, &resize_params, &crop, &params), DSP_SUCCESS);
+        resize_params.dst[0] = reference.get();
+        ASSERT_EQ(dsp_multi_crop_and_resize_privacy_mask(m_device, &resize_params, &crop, &reference_params),
+                  DSP_SUCCESS);
+        EXPECT_TRUE(dst == reference);
+    }
+
+    EmulatorDevice m_device;
+    dsp_privacy_mask m_privacy_mask = nullptr;
+    size_t m_bitmask_size = 0;
+    TestImage m_src{WIDTH, HEIGHT, DSP_IMAGE_FORMAT_NV12};
+};
+
+TEST_F(PrivacyMaskObjectTest, PolygonUpdatesMatchBuiltMask)
+{
+    std::vector<uint8_t> bitmask(m_bitmask_size);
+    dsp_roi_t rois[DSP_PRIVACY_MASK_MAX_ROIS];
+    size_t rois_count;
+
+    // Frames that move one polygon, keep it still, move it back, and add and remove another one, so that the updates
+    // rewrite some lines only, or none
+    const size_t offsets[] = {0, 40, 40, 0, 120, 0};
+    for (size_t frame = 0; frame < std::size(offsets); ++frame) {
+        size_t offset = offsets[frame];
+        dsp_point_t moving[] = {{100 + offset, 50 + offset}, {300, 60}, {280, 200}, {90 + offset, 180}};
+        dsp_point_t still[] = {{400, 200}, {600, 350}, {420, 340}};
+        dsp_polygon_t polygons[] = {{moving, std::size(moving)}, {still, std::size(still)}};
+        size_t polygons_count = (frame % 2) ? 2 : 1;
+
+        ASSERT_EQ(dsp_privacy_mask_update_polygons(m_privacy_mask, polygons, polygons_count), DSP_SUCCESS);
+        ASSERT_EQ(dsp_privacy_mask_build_from_polygons(WIDTH, HEIGHT, polygons, polygons_count, bitmask.data(),
+                                                       bitmask.size(), rois, &rois_count),
+                  DSP_SUCCESS);
+        SCOPED_TRACE(frame);
+        expect_same_as(bitmask, rois, rois_count);
+    }
+}
+
+TEST_F(PrivacyMaskObjectTest, MaskAndBitmaskUpdatesMatchBuiltMask)
+{
+    std::vector<uint8_t> mask(WIDTH * HEIGHT, 0);
+    for (size_t y = 10; y < 30; ++y) {
+        for (size_t x = 5; x < 50; ++x) {
+            mask[y * WIDTH + x] = 1;
+        }
+    }
+    dsp_data_plane_t plane = {.userptr = mask.data(), .bytesperline = WIDTH, .bytesused = mask.size()};
+    dsp_image_properties_t mask_image = {WIDTH, HEIGHT, &plane, 1, DSP_IMAGE_FORMAT_GRAY8, DSP_MEMORY_TYPE_USERPTR};
+
+    std::vector<uint8_t> bitmask(m_bitmask_size);
+    dsp_roi_t rois[DSP_PRIVACY_MASK_MAX_ROIS];
+    size_t rois_count;
+    ASSERT_EQ(dsp_privacy_mask_update_mask(m_privacy_mask, &mask_image), DSP_SUCCESS);
+    ASSERT_EQ(dsp_privacy_mask_build_from_mask(&mask_image, bitmask.data(), bitmask.size(), rois, &rois_count),
+              DSP_SUCCESS);
+    expect_same_as(bitmask, rois, rois_count);
+
+    // A bitmask that only changes the last line, which is the partial line of the image
+    bitmask[bitmask.size() - 8] |= 1;
+    ASSERT_EQ(dsp_privacy_mask_update_bitmask(m_privacy_mask, bitmask.data()), DSP_SUCCESS);
+    dsp_privacy_mask_t params;
+    ASSERT_EQ(dsp_privacy_mask_get_params(m_privacy_mask, &params), DSP_SUCCESS);
+    EXPECT_EQ(memcmp(params.bitmask, bitmask.data(), m_bitmask_size), 0);
+    EXPECT_EQ(params.rois_count, 2u);
+
+    std::vector<uint8_t> empty(m_bitmask_size, 0);
+    ASSERT_EQ(dsp_privacy_mask_update_bitmask(m_privacy_mask, empty.data()), DSP_SUCCESS);
+    ASSERT_EQ(dsp_privacy_mask_get_params(m_privacy_mask, &params), DSP_SUCCESS);
+    EXPECT_EQ(memcmp(params.bitmask, empty.data(), m_bitmask_size), 0);
+    EXPECT_EQ(params.rois_count, 1u);
+}
+
+TEST_F(PrivacyMaskObjectTest, RejectsMaskOfOtherSize)
+{
+    std::vector<uint8_t> mask(WIDTH * HEIGHT, 0);
+    dsp_data_plane_t plane = {.userptr = mask.data(), .bytesperline = WIDTH, .bytesused = mask.size()};
+    dsp_image_properties_t mask_image = {WIDTH / 2, HEIGHT, &plane, 1, DSP_IMAGE_FORMAT_GRAY8,
+                                         DSP_MEMORY_TYPE_USERPTR};
+    EXPECT_EQ(dsp_privacy_mask_update_mask(m_privacy_mask, &mask_image), DSP_INVALID_ARGUMENT);
+}
+
+// The last bitmask byte of a line is partly padding when the width is not a multiple of 8 quantization cells
+TEST_F(PrivacyMaskObjectTest, IgnoresPaddingBitsOfBitmask)
+{
+    const size_t width = WIDTH + 10;
+    dsp_privacy_mask privacy_mask;
+    ASSERT_EQ(dsp_create_privacy_mask(m_device, width, HEIGHT, Y_COLOR, UV_COLOR, UV_COLOR, &privacy_mask),
+              DSP_SUCCESS);
+    size_t bitmask_size;
+    ASSERT_EQ(dsp_privacy_mask_get_bitmask_size(width, HEIGHT, &bitmask_size), DSP_SUCCESS);
+
+    // Every bit beyond the image is set, and a single cell of the image
+    size_t columns = (width + 3) / 4;
+    size_t lines = (HEIGHT + 3) / 4;
+    size_t stride = bitmask_size / lines;
+    std::vector<uint8_t> bitmask(bitmask_size, 0);
+    for (size_t y = 0; y < lines; ++y) {
+        for (size_t x = columns; x < stride * 8; ++x) {
+            bitmask[y * stride + x / 8] |= 1 << (x % 8);
+        }
+    }
+    bitmask[stride * 2] |= 1;
+    ASSERT_EQ(dsp_privacy_mask_update_bitmask(privacy_mask, bitmask.data()), DSP_SUCCESS);
+
+    dsp_privacy_mask_t params;
+    ASSERT_EQ(dsp_privacy_mask_get_params(privacy_mask, &params), DSP_SUCCESS);
+    ASSERT_EQ(params.rois_count, 1u);
+    EXPECT_EQ(params.rois[0].start_x, 0u);
+    EXPECT_EQ(params.rois[0].start_y, 2u);
+    EXPECT_EQ(params.rois[0].end_x, 1u);
+    EXPECT_EQ(params.rois[0].end_y, 3u);
+
+    TestImage src(width, HEIGHT, DSP_IMAGE_FORMAT_NV12);
+    src.fill_random(2);
+    TestImage dst(WIDTH / 2, HEIGHT / 2, DSP_IMAGE_FORMAT_NV12);
+    dsp_roi_t crop = {.start_x = 0, .start_y = 0, .end_x = width, .end_y = HEIGHT};
+    dsp_multi_resize_params_t resize_params = {
+        .src = src.get(),
+        .dst = {dst.get()},
+        .interpolation = INTERPOLATION_TYPE_BILINEAR,
+    };
+    EXPECT_EQ(dsp_multi_crop_and_resize_privacy_mask(m_device, &resize_params, &crop, &params), DSP_SUCCESS);
+    EXPECT_EQ(dsp_release_privacy_mask(privacy_mask), DSP_SUCCESS);
+}
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2017-2024 Hailo Technologies Ltd. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+// In place privacy mask and masked crop&resize, against a mask painted on the CPU, through every submission path
+
+#include "test_utils.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+
+#define WIDTH (320)
+#define HEIGHT (184)
+#define Y_COLOR (20)
+#define U_COLOR (200)
+#define V_COLOR (60)
+
+class PrivacyMaskOpTest : public ::testing::Test {
+   protected:
+    void SetUp() override
+    {
+        ASSERT_EQ(m_device.status(), DSP_SUCCESS);
+        m_image.fill_random(1);
+
+        // Set bits inside and outside the ROIs. The bits outside must be ignored
+        size_t bitmask_size;
+        ASSERT_EQ(dsp_privacy_mask_get_bitmask_size(WIDTH, HEIGHT, &bitmask_size), DSP_SUCCESS);
+        m_stride = bitmask_size / (HEIGHT / 4);
+        m_bitmask.resize(bitmask_size);
+        std::mt19937 generator(2);
+        for (auto &byte : m_bitmask) {
+            byte = static_cast<uint8_t>(generator());
+        }
+        m_rois = {
+            {.start_x = 2, .start_y = 3, .end_x = 20, .end_y = 11},
+            {.start_x = 30, .start_y = 20, .end_x = 80, .end_y = 46},
+            {.start_x = 15, .start_y = 8, .end_x = 40, .end_y = 30},
+        };
+        m_privacy_mask = {
+            .bitmask = m_bitmask.data(),
+            .y_color = Y_COLOR,
+            .u_color = U_COLOR,
+            .v_color = V_COLOR,
+            .rois = m_rois.data(),
+            .rois_count = m_rois.size(),
+        };
+    }
+
+    bool is_masked(size_t qx, size_t qy) const
+    {
+        bool in_roi = std::any_of(m_rois.begin(), m_rois.end(), [qx, qy](const dsp_roi_t &roi) {
+            return (qx >= roi.start_x) && (qx < roi.end_x) && (qy >= roi.start_y) && (qy < roi.end_y);
+        });
+        return in_roi && ((m_bitmask[qy * m_stride + qx / 8] >> (qx % 8)) & 1);
+    }
+
+    // Every masked 4x4 cell gets the Y color, and its 2x2 chroma samples the UV color
+    TestImage masked_on_cpu()
+    {
+        TestImage masked(m_image);
+        for (size_t y = 0; y < HEIGHT; ++y) {
+            for (size_t x = 0; x < WIDTH; ++x) {
+                if (is_masked(x / 4, y / 4)) {
+                    masked.plane(0)[y * WIDTH + x] = Y_COLOR;
+                }
+            }
+        }
+        for (size_t y = 0; y < HEIGHT / 2; ++y) {
+            for (size_t x = 0; x < WIDTH / 2; ++x) {
+                if (is_masked(x / 2, y / 2)) {
+                    masked.plane(1)[y * WIDTH + 2 * x] = U_COLOR;
+                    masked.plane(1)[y * WIDTH + 2 * x + 1] = V_COLOR;
+                }
+            }
+        }
+        return masked;
+    }
+
+    EmulatorDevice m_device;
+    TestImage m_image{WIDTH, HEIGHT, DSP_IMAGE_FORMAT_NV12};
+    std::vector<uint8_t> m_bitmask;
+    size_t m_stride = 0;
+    std::vector<dsp_roi_t> m_rois;
+    dsp_privacy_mask_t m_privacy_mask = {};
+};
+
+TEST_F(PrivacyMaskOpTest, ApplyMatchesCpu)
+{
+    auto reference = masked_on_cpu();
+    ASSERT_FALSE(reference == m_image);
+
+    TestImage sync_image(m_image);
+    ASSERT_EQ(dsp_apply_privacy_mask(m_device, sync_image.get(), &m_privacy_mask), DSP_SUCCESS);
+    EXPECT_TRUE(sync_image == reference);
+
+    TestImage async_image(m_image);
+    dsp_job job;
+    ASSERT_EQ(dsp_apply_privacy_mask_async(m_device, async_image.get(), &m_privacy_mask, &job), DSP_SUCCESS);
+    ASSERT_EQ(dsp_job_wait(job), DSP_SUCCESS);
+    ASSERT_EQ(dsp_job_release(job), DSP_SUCCESS);
+    EXPECT_TRUE(async_image == reference);
+
+    TestImage cmdbuf_image(m_image);
+    dsp_cmdbuf cmdbuf;
+    ASSERT_EQ(dsp_create_cmdbuf(m_device, &cmdbuf), DSP_SUCCESS);
+    ASSERT_EQ(dsp_cmdbuf_record_apply_privacy_mask(cmdbuf, cmdbuf_image.get(), &m_privacy_mask), DSP_SUCCESS);
+    ASSERT_EQ(dsp_cmdbuf_submit(cmdbuf), DSP_SUCCESS);
+    ASSERT_EQ(dsp_release_cmdbuf(cmdbuf), DSP_SUCCESS);
+    EXPECT_TRUE(cmdbuf_image == reference);
+
+    TestImage plan_image(m_image);
+    dsp_plan plan;
+    ASSERT_EQ(dsp_plan_create_apply_privacy_mask(m_device, plan_image.get(), &m_privacy_mask, &plan), DSP_SUCCESS);
+    ASSERT_EQ(dsp_plan_execute(plan, plan_image.planes(), plan_image.planes_count()), DSP_SUCCESS);
+    ASSERT_EQ(dsp_release_plan(plan), DSP_SUCCESS);
+    EXPECT_TRUE(plan_image == reference);
+}
+
+// Masking the source in place and resizing it gives the same image as the masked crop&resize, which leaves the
+// source unmodified
+TEST_F(PrivacyMaskOpTest, CropAndResizeMatchesMaskedSource)
+{
+    auto masked = masked_on_cpu();
+    dsp_roi_t crop = {.start_x = 8, .start_y = 6, .end_x = 300, .end_y = 170};
+
+    for (auto format : {DSP_IMAGE_FORMAT_NV12, DSP_IMAGE_FORMAT_RGB}) {
+        TestImage dst(128, 72, format);
+        TestImage reference(128, 72, format);
+        TestImage src(m_image);
+
+        dsp_resize_params_t params = {src.get(), dst.get(), INTERPOLATION_TYPE_BILINEAR};
+        ASSERT_EQ(dsp_crop_and_resize_privacy_mask(m_device, &params, &crop, &m_privacy_mask), DSP_SUCCESS);
+        EXPECT_TRUE(src == m_image);
+
+        dsp_resize_params_t reference_params = {masked.get(), reference.get(), INTERPOLATION_TYPE_BILINEAR};
+        ASSERT_EQ(dsp_crop_and_resize(m_device, &reference_params, &crop), DSP_SUCCESS);
+        EXPECT_TRUE(dst == reference) << "format " << format;
+
+        // Through the multi crop&resize too
+        TestImage multi_dst(128, 72, format);
+        dsp_multi_resize_params_t multi_params = {
+            .src = src.get(),
+            .dst = {multi_dst.get()},
+            .interpolation = INTERPOLATION_TYPE_BILINEAR,
+        };
+        ASSERT_EQ(dsp_multi_crop_and_resize_privacy_mask(m_device, &multi_params, &crop, &m_privacy_mask),
+                  DSP_SUCCESS);
+        EXPECT_TRUE(multi_dst == reference) << "format " << format;
+    }
+}
+
+TEST_F(PrivacyMaskOpTest, RejectsNonNv12Image)
+{
+    TestImage image(WIDTH, HEIGHT, DSP_IMAGE_FORMAT_RGB);
+    EXPECT_EQ(dsp_apply_privacy_mask(m_device, image.get(), &m_privacy_mask), DSP_INVALID_ARGUMENT);
+}
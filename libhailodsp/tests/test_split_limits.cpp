@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2017-2024 Hailo Technologies Ltd. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+// Operations beyond the limits of a single DSP request are split into chained requests (blend overlays, blur ROIs,
+// multi crop&resize outputs) or merged (privacy mask ROIs). Every limit is checked at the limit and just past it,
+// against a reference made of calls that are within the limits
+
+#include "test_utils.hpp"
+
+#include <gtest/gtest.h>
+
+// Limits of a single request, see user_dsp_interface.h
+#define MAX_BLEND_OVERLAYS (50)
+#define MAX_BLUR_ROIS (80)
+
+#define BACKGROUND_WIDTH (256)
+#define BACKGROUND_HEIGHT (128)
+#define OVERLAY_SIZE (16)
+
+class SplitLimitsTest : public ::testing::TestWithParam<size_t> {
+   protected:
+    void SetUp() override { ASSERT_EQ(m_device.status(), DSP_SUCCESS); }
+
+    EmulatorDevice m_device;
+};
+
+class BlendLimitTest : public SplitLimitsTest {};
+
+TEST_P(BlendLimitTest, MatchesOverlaysBlendedOneByOne)
+{
+    size_t overlays_count = GetParam();
+    std::vector<TestImage> images(overlays_count, TestImage(OVERLAY_SIZE, OVERLAY_SIZE, DSP_IMAGE_FORMAT_A420));
+    std::vector<dsp_overlay_properties_t> overlays;
+    for (size_t i = 0; i < overlays_count; ++i) {
+        images[i].fill_random(i);
+        // Overlapping, so the result depends on the blending order
+        overlays.push_back({
+            .overlay = *images[i].get(),
+            .x_offset = (i * 7) % (BACKGROUND_WIDTH - OVERLAY_SIZE),
+            .y_offset = (i * 3) % (BACKGROUND_HEIGHT - OVERLAY_SIZE),
+        });
+    }
+
+    TestImage background(BACKGROUND_WIDTH, BACKGROUND_HEIGHT, DSP_IMAGE_FORMAT_NV12);
+    background.fill_random(100);
+    TestImage reference(background);
+
+    ASSERT_EQ(dsp_blend(m_device, background.get(), overlays.data(), overlays.size()), DSP_SUCCESS);
+    for (const auto &overlay : overlays) {
+        ASSERT_EQ(dsp_blend(m_device, reference.get(), &overlay, 1), DSP_SUCCESS);
+    }
+    EXPECT_TRUE(background == reference);
+}
+
+INSTANTIATE_TEST_SUITE_P(SplitLimits, BlendLimitTest, ::testing::Values(MAX_BLEND_OVERLAYS, MAX_BLEND_OVERLAYS + 1));
+
+class BlurLimitTest : public SplitLimitsTest {};
+
+TEST_P(BlurLimitTest, MatchesRoisBlurredOneByOne)
+{
+    // Disjoint ROIs, so each one is blurred from the original pixels in both cases
+    std::vector<dsp_roi_t> rois;
+    for (size_t i = 0; i < GetParam(); ++i) {
+        size_t x = (i % 16) * 16;
+        size_t y = (i / 16) * 12;
+        rois.push_back({.start_x = x, .start_y = y, .end_x = x + 12, .end_y = y + 10});
+    }
+
+    TestImage image(BACKGROUND_WIDTH, BACKGROUND_HEIGHT, DSP_IMAGE_FORMAT_GRAY8);
+    image.fill_random(1);
+    TestImage reference(image);
+
+    ASSERT_EQ(dsp_blur(m_device, image.get(), rois.data(), rois.size(), 5), DSP_SUCCESS);
+    for (const auto &roi : rois) {
+        ASSERT_EQ(dsp_blur(m_device, reference.get(), &roi, 1, 5), DSP_SUCCESS);
+    }
+    EXPECT_TRUE(image == reference);
+}
+
+INSTANTIATE_TEST_SUITE_P(SplitLimits, BlurLimitTest, ::testing::Values(MAX_BLUR_ROIS, MAX_BLUR_ROIS + 1));
+
+class MultiResizeLimitTest : public SplitLimitsTest {};
+
+TEST_P(MultiResizeLimitTest, MatchesOutputsResizedOneByOne)
+{
+    size_t outputs_count = GetParam();
+    TestImage src(BACKGROUND_WIDTH, BACKGROUND_HEIGHT, DSP_IMAGE_FORMAT_NV12);
+    src.fill_random(1);
+
+    std::vector<TestImage> outputs;
+    std::vector<TestImage> references;
+    for (size_t i = 0; i < outputs_count; ++i) {
+        outputs.emplace_back(32 + 4 * i, 16 + 2 * i, DSP_IMAGE_FORMAT_NV12);
+        references.emplace_back(32 + 4 * i, 16 + 2 * i, DSP_IMAGE_FORMAT_NV12);
+    }
+    std::vector<const dsp_image_properties_t *> dst;
+    for (auto &output : outputs) {
+        dst.push_back(output.get());
+    }
+
+    dsp_roi_t crop = {.start_x = 10, .start_y = 4, .end_x = 210, .end_y = 104};
+    dsp_multi_resize_list_params_t params = {
+        .src = src.get(),
+        .dst = dst.data(),
+        .dst_count = dst.size(),
+        .interpolation = INTERPOLATION_TYPE_BILINEAR,
+    };
+    ASSERT_EQ(dsp_multi_crop_and_resize_list(m_device, &params, &crop, NULL), DSP_SUCCESS);
+
+    for (size_t i = 0; i < outputs_count; ++i) {
+        dsp_resize_params_t resize_params = {src.get(), references[i].get(), INTERPOLATION_TYPE_BILINEAR};
+        ASSERT_EQ(dsp_crop_and_resize(m_device, &resize_params, &crop), DSP_SUCCESS);
+        EXPECT_TRUE(outputs[i] == references[i]) << "output " << i;
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(SplitLimits,
+                         MultiResizeLimitTest,
+                         ::testing::Values(DSP_MULTI_RESIZE_OUTPUTS_COUNT, DSP_MULTI_RESIZE_OUTPUTS_COUNT + 1));
+
+class PrivacyMaskLimitTest : public SplitLimitsTest {
+   protected:
+    static void set_bit(std::vector<uint8_t> &bitmask, size_t stride, size_t x, size_t y)
+    {
+        bitmask[y * stride + x / 8] |= 1 << (x % 8);
+    }
+};
+
+TEST_P(PrivacyMaskLimitTest, MatchesBitmaskClearOutsideRois)
+{
+    size_t bitmask_size;
+    ASSERT_EQ(dsp_privacy_mask_get_bitmask_size(BACKGROUND_WIDTH, BACKGROUND_HEIGHT, &bitmask_size), DSP_SUCCESS);
+    size_t stride = bitmask_size / (BACKGROUND_HEIGHT / 4);
+
+    // Every ROI has a set bit in its first cell and in its last cell
+    std::vector<uint8_t> bitmask(bitmask_size, 0);
+    std::vector<dsp_roi_t> rois;
+    for (size_t i = 0; i < GetParam(); ++i) {
+        size_t x = (i % 4) * 16;
+        size_t y = (i / 4) * 10;
+        rois.push_back({.start_x = x, .start_y = y, .end_x = x + 6, .end_y = y + 4});
+        set_bit(bitmask, stride, x, y);
+        set_bit(bitmask, stride, x + 5, y + 3);
+    }
+
+    TestImage image(BACKGROUND_WIDTH, BACKGROUND_HEIGHT, DSP_IMAGE_FORMAT_NV12);
+    image.fill_random(1);
+    TestImage reference(image);
+    TestImage unmasked(image);
+
+    dsp_privacy_mask_t privacy_mask = {
+        .bitmask = bitmask.data(),
+        .y_color = 16,
+        .u_color = 128,
+        .v_color = 128,
+        .rois = rois.data(),
+        .rois_count = rois.size(),
+    };
+    ASSERT_EQ(dsp_apply_privacy_mask(m_device, image.get(), &privacy_mask), DSP_SUCCESS);
+
+    dsp_roi_t whole_image = {.start_x = 0, .start_y = 0, .end_x = BACKGROUND_WIDTH / 4, .end_y = BACKGROUND_HEIGHT / 4};
+    privacy_mask.rois = &whole_image;
+    privacy_mask.rois_count = 1;
+    ASSERT_EQ(dsp_apply_privacy_mask(m_device, reference.get(), &privacy_mask), DSP_SUCCESS);
+
+    EXPECT_TRUE(image == reference);
+    EXPECT_FALSE(image == unmasked);
+}
+
+TEST_F(SplitLimitsTest, PrivacyMaskRoisWithinLimitAreKept)
+{
+    size_t bitmask_size;
+    ASSERT_EQ(dsp_privacy_mask_get_bitmask_size(BACKGROUND_WIDTH, BACKGROUND_HEIGHT, &bitmask_size), DSP_SUCCESS);
+
+    // With a full bitmask, only the pixels of the ROIs are colored
+    std::vector<uint8_t> bitmask(bitmask_size, 0xff);
+    std::vector<dsp_roi_t> rois;
+    for (size_t i = 0; i < DSP_PRIVACY_MASK_MAX_ROIS; ++i) {
+        rois.push_back({.start_x = i * 8, .start_y = i * 4, .end_x = i * 8 + 2, .end_y = i * 4 + 2});
+    }
+
+    TestImage image(BACKGROUND_WIDTH, BACKGROUND_HEIGHT, DSP_IMAGE_FORMAT_NV12);
+    image.fill(0);
+    dsp_privacy_mask_t privacy_mask = {
+        .bitmask = bitmask.data(),
+        .y_color = 200,
+        .u_color = 128,
+        .v_color = 128,
+        .rois = rois.data(),
+        .rois_count = rois.size(),
+    };
+    ASSERT_EQ(dsp_apply_privacy_mask(m_device, image.get(), &privacy_mask), DSP_SUCCESS);
+
+    size_t colored = 0;
+    for (auto luma : image.plane(0)) {
+        colored += (luma == 200);
+    }
+    EXPECT_EQ(colored, DSP_PRIVACY_MASK_MAX_ROIS * (2 * 4) * (2 * 4));
+}
+
+INSTANTIATE_TEST_SUITE_P(SplitLimits,
+                         PrivacyMaskLimitTest,
+                         ::testing::Values(DSP_PRIVACY_MASK_MAX_ROIS, DSP_PRIVACY_MASK_MAX_ROIS + 1));
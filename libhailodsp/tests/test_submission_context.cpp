@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2017-2024 Hailo Technologies Ltd. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <linux/types.h>
+#define HAVE___U8
+#define HAVE___U32
+#define HAVE___S32
+#define HAVE___U64
+
+#include "device.hpp"
+#include "test_utils.hpp"
+
+#include <gtest/gtest.h>
+#include <sys/ioctl.h>
+#include <thread>
+
+#define LATENCY_US (20000)
+
+static int32_t thread_outstanding_commands(dsp_device device)
+{
+    return get_submission_context(device).outstanding_commands.load();
+}
+
+TEST(SubmissionContextTest, AsyncJobIsDiscountedFromSubmittingThread)
+{
+    EmulatorDevice device(LATENCY_US, true);
+    ASSERT_EQ(device.status(), DSP_SUCCESS);
+    TestImage src(64, 64, DSP_IMAGE_FORMAT_GRAY8);
+    TestImage dst(32, 32, DSP_IMAGE_FORMAT_GRAY8);
+    dsp_resize_params_t params = {src.get(), dst.get(), INTERPOLATION_TYPE_BILINEAR};
+
+    dsp_job first;
+    dsp_job second;
+    ASSERT_EQ(dsp_resize_async(device, &params, &first), DSP_SUCCESS);
+    ASSERT_EQ(dsp_resize_async(device, &params, &second), DSP_SUCCESS);
+    EXPECT_GE(thread_outstanding_commands(device), 1);
+    EXPECT_GE(get_outstanding_commands(device), 2u);
+
+    EXPECT_EQ(dsp_job_release(first), DSP_SUCCESS);
+    EXPECT_EQ(dsp_job_release(second), DSP_SUCCESS);
+    EXPECT_EQ(thread_outstanding_commands(device), 0);
+    EXPECT_EQ(get_outstanding_commands(device), 0u);
+}
+
+TEST(SubmissionContextTest, ContextsAreSeparatePerThread)
+{
+    EmulatorDevice device;
+    ASSERT_EQ(device.status(), DSP_SUCCESS);
+
+    auto context = &get_submission_context(device);
+    EXPECT_EQ(&get_submission_context(device), context);
+
+    SubmissionContext *other_context = nullptr;
+    std::thread([&] { other_context = &get_submission_context(device); }).join();
+    EXPECT_NE(other_context, context);
+    EXPECT_EQ(static_cast<dsp_device>(device)->submission_contexts.size(), 2u);
+}
+
+TEST(SubmissionContextTest, ReleasedDeviceSlotIsReused)
+{
+    size_t slot;
+    {
+        EmulatorDevice device;
+        ASSERT_EQ(device.status(), DSP_SUCCESS);
+        slot = static_cast<dsp_device>(device)->slot;
+        get_submission_context(device).outstanding_commands = 5;
+    }
+
+    EmulatorDevice device;
+    ASSERT_EQ(device.status(), DSP_SUCCESS);
+    EXPECT_EQ(static_cast<dsp_device>(device)->slot, slot);
+
+    // The entry of the released device is replaced, not matched
+    auto &context = get_submission_context(device);
+    EXPECT_EQ(context.outstanding_commands, 0);
+    ASSERT_EQ(static_cast<dsp_device>(device)->submission_contexts.size(), 1u);
+    EXPECT_EQ(static_cast<dsp_device>(device)->submission_contexts[0].get(), &context);
+}
@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) 2017-2024 Hailo Technologies Ltd. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+// Crop&resize into a tensor, against the tensor elements computed on the CPU from the RGB crop&resize output
+
+#include "test_utils.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <tuple>
+
+#define TENSOR_WIDTH (32)
+#define TENSOR_HEIGHT (24)
+// Padding at the end of every tensor row, which must not be written
+#define ROW_PADDING (8)
+#define PADDING_VALUE (0xa5)
+
+// The DSP folds the normalization and the quantization into a single multiply-add per element, which may round the
+// other way than the CPU reference
+#define QUANTIZED_TOLERANCE (1)
+#define FLOAT16_RELATIVE_TOLERANCE (2e-3)
+
+static float half_to_float(uint16_t half)
+{
+    int exponent = (half >> 10) & 0x1f;
+    int mantissa = half & 0x3ff;
+    float value = (exponent == 0) ? std::ldexp(static_cast<float>(mantissa), -24)
+                                  : std::ldexp(1.0f + mantissa / 1024.0f, exponent - 15);
+    return (half & 0x8000) ? -value : value;
+}
+
+class TensorOutputTest
+    : public ::testing::TestWithParam<
+          std::tuple<dsp_image_format_t, dsp_tensor_layout_t, dsp_tensor_channel_order_t, dsp_tensor_data_type_t>> {
+   protected:
+    void SetUp() override { ASSERT_EQ(m_device.status(), DSP_SUCCESS); }
+
+    EmulatorDevice m_device;
+};
+
+TEST_P(TensorOutputTest, MatchesCpuReference)
+{
+    auto [src_format, layout, channel_order, data_type] = GetParam();
+    TestImage src(128, 96, src_format);
+    src.fill_random(1);
+    dsp_roi_t crop = {.start_x = 10, .start_y = 6, .end_x = 110, .end_y = 86};
+
+    TestImage rgb(TENSOR_WIDTH, TENSOR_HEIGHT, DSP_IMAGE_FORMAT_RGB);
+    dsp_resize_params_t resize_params = {src.get(), rgb.get(), INTERPOLATION_TYPE_BILINEAR};
+    ASSERT_EQ(dsp_crop_and_resize(m_device, &resize_params, &crop), DSP_SUCCESS);
+
+    const float mean[] = {123.7f, 116.3f, 103.5f};
+    const float std[] = {58.4f, 57.1f, 57.4f};
+    size_t element_size = (data_type == DSP_TENSOR_DATA_TYPE_FLOAT16) ? 2 : 1;
+    size_t row_elements = (layout == DSP_TENSOR_LAYOUT_NHWC) ? TENSOR_WIDTH * 3 : TENSOR_WIDTH;
+    size_t rows = (layout == DSP_TENSOR_LAYOUT_NHWC) ? TENSOR_HEIGHT : TENSOR_HEIGHT * 3;
+    size_t bytesperline = row_elements * element_size + ROW_PADDING;
+    std::vector<uint8_t> data(bytesperline * rows, PADDING_VALUE);
+
+    dsp_tensor_t tensor = {
+        .width = TENSOR_WIDTH,
+        .height = TENSOR_HEIGHT,
+        .layout = layout,
+        .channel_order = channel_order,
+        .data_type = data_type,
+        .mean = {},
+        .std = {},
+        .quant_scale = 0.02f,
+        .quant_zero_point = (data_type == DSP_TENSOR_DATA_TYPE_UINT8) ? 128 : 3,
+        .plane = {.userptr = data.data(), .bytesperline = bytesperline, .bytesused = data.size()},
+        .memory = DSP_MEMORY_TYPE_USERPTR,
+    };
+    // The mean and std are given in the channel order of the tensor
+    auto rgb_channel = [&](size_t c) { return (channel_order == DSP_TENSOR_CHANNEL_ORDER_BGR) ? 2 - c : c; };
+    for (size_t c = 0; c < 3; ++c) {
+        tensor.mean[c] = mean[rgb_channel(c)];
+        tensor.std[c] = std[rgb_channel(c)];
+    }
+
+    dsp_tensor_resize_params_t params = {src.get(), &tensor, INTERPOLATION_TYPE_BILINEAR};
+    ASSERT_EQ(dsp_crop_and_resize_to_tensor(m_device, &params, &crop), DSP_SUCCESS);
+
+    double difference = 0;
+    for (size_t y = 0; y < TENSOR_HEIGHT; ++y) {
+        for (size_t x = 0; x < TENSOR_WIDTH; ++x) {
+            for (size_t c = 0; c < 3; ++c) {
+                float value = (rgb.plane(0)[(y * TENSOR_WIDTH + x) * 3 + rgb_channel(c)] - tensor.mean[c]) /
+                              tensor.std[c];
+                size_t offset = (layout == DSP_TENSOR_LAYOUT_NHWC)
+                                    ? y * bytesperline + (x * 3 + c) * element_size
+                                    : (c * TENSOR_HEIGHT + y) * bytesperline + x * element_size;
+                // Normalized by the tolerance of the data type
+                double error;
+                switch (data_type) {
+                    case DSP_TENSOR_DATA_TYPE_UINT8: {
+                        float expected = std::clamp(std::round(value / tensor.quant_scale) + 128, 0.0f, 255.0f);
+                        error = std::fabs(data[offset] - expected) / QUANTIZED_TOLERANCE;
+                        break;
+                    }
+                    case DSP_TENSOR_DATA_TYPE_INT8: {
+                        float expected = std::clamp(std::round(value / tensor.quant_scale) + 3, -128.0f, 127.0f);
+                        error = std::fabs(static_cast<int8_t>(data[offset]) - expected) / QUANTIZED_TOLERANCE;
+                        break;
+                    }
+                    default: {
+                        uint16_t half;
+                        memcpy(&half, &data[offset], sizeof(half));
+                        error = std::fabs(half_to_float(half) - value) / std::max(std::fabs(value), 1.0f) /
+                                FLOAT16_RELATIVE_TOLERANCE;
+                        break;
+                    }
+                }
+                difference = std::max(difference, error);
+            }
+        }
+    }
+    EXPECT_LE(difference, 1.0);
+
+    for (size_t row = 0; row < rows; ++row) {
+        size_t end = row * bytesperline + row_elements * element_size;
+        for (size_t i = 0; i < ROW_PADDING; ++i) {
+            ASSERT_EQ(data[end + i], PADDING_VALUE) << "row " << row;
+        }
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(TensorOutput,
+                         TensorOutputTest,
+                         ::testing::Combine(::testing::Values(DSP_IMAGE_FORMAT_NV12, DSP_IMAGE_FORMAT_RGB),
+                                            ::testing::Values(DSP_TENSOR_LAYOUT_NHWC, DSP_TENSOR_LAYOUT_NCHW),
+                                            ::testing::Values(DSP_TENSOR_CHANNEL_ORDER_RGB,
+                                                              DSP_TENSOR_CHANNEL_ORDER_BGR),
+                                            ::testing::Values(DSP_TENSOR_DATA_TYPE_UINT8, DSP_TENSOR_DATA_TYPE_INT8,
+                                                              DSP_TENSOR_DATA_TYPE_FLOAT16)));
+
+class TensorOutputParamsTest : public ::testing::Test {
+   protected:
+    void SetUp() override { ASSERT_EQ(m_device.status(), DSP_SUCCESS); }
+
+    EmulatorDevice m_device;
+};
+
+TEST_F(TensorOutputParamsTest, RejectsInvalidTensors)
+{
+    TestImage src(128, 96, DSP_IMAGE_FORMAT_RGB);
+    std::vector<uint8_t> data(TENSOR_WIDTH * TENSOR_HEIGHT * 3);
+    dsp_tensor_t tensor = {
+        .width = TENSOR_WIDTH,
+        .height = TENSOR_HEIGHT,
+        .layout = DSP_TENSOR_LAYOUT_NHWC,
+        .channel_order = DSP_TENSOR_CHANNEL_ORDER_RGB,
+        .data_type = DSP_TENSOR_DATA_TYPE_UINT8,
+        .mean = {0, 0, 0},
+        .std = {1, 1, 1},
+        .quant_scale = 1,
+        .quant_zero_point = 0,
+        .plane = {.userptr = data.data(), .bytesperline = TENSOR_WIDTH * 3, .bytesused = data.size()},
+        .memory = DSP_MEMORY_TYPE_USERPTR,
+    };
+    dsp_roi_t crop = {.start_x = 0, .start_y = 0, .end_x = 128, .end_y = 96};
+    dsp_tensor_resize_params_t params = {src.get(), &tensor, INTERPOLATION_TYPE_BILINEAR};
+    ASSERT_EQ(dsp_crop_and_resize_to_tensor(m_device, &params, &crop), DSP_SUCCESS);
+
+    tensor.std[1] = 0;
+    EXPECT_EQ(dsp_crop_and_resize_to_tensor(m_device, &params, &crop), DSP_INVALID_ARGUMENT);
+    tensor.std[1] = 1;
+
+    tensor.quant_scale = 0;
+    EXPECT_EQ(dsp_crop_and_resize_to_tensor(m_device, &params, &crop), DSP_INVALID_ARGUMENT);
+    tensor.quant_scale = 1;
+
+    tensor.plane.bytesused = data.size() - 1;
+    EXPECT_EQ(dsp_crop_and_resize_to_tensor(m_device, &params, &crop), DSP_INVALID_ARGUMENT);
+    tensor.plane.bytesused = data.size();
+
+    tensor.plane.bytesperline = TENSOR_WIDTH * 3 - 1;
+    EXPECT_EQ(dsp_crop_and_resize_to_tensor(m_device, &params, &crop), DSP_INVALID_ARGUMENT);
+}
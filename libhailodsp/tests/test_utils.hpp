@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2017-2024 Hailo Technologies Ltd. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "image_utils.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <hailo/hailodsp.h>
+#include <random>
+#include <string>
+#include <vector>
+
+#define EMULATOR_LATENCY_ENV_NAME ("HAILODSP_EMULATOR_LATENCY_US")
+#define EMULATOR_NOOP_ENV_NAME ("HAILODSP_EMULATOR_NOOP")
+#define EMULATOR_FAILING_SYNC_ENV_NAME ("HAILODSP_EMULATOR_FAILING_SYNC")
+
+// Emulator device that is released at the end of the scope. The emulator reads its configuration when the device is
+// created, so the latency, no-op mode and failing buffer sync (1-based, 0 for none) only apply to this device
+class EmulatorDevice {
+   public:
+    explicit EmulatorDevice(unsigned latency_us = 0,
+                            bool noop = false,
+                            dsp_priority_t priority = DSP_PRIORITY_DEFAULT,
+                            unsigned failing_sync = 0)
+    {
+        setenv(EMULATOR_LATENCY_ENV_NAME, std::to_string(latency_us).c_str(), 1);
+        setenv(EMULATOR_NOOP_ENV_NAME, noop ? "1" : "0", 1);
+        setenv(EMULATOR_FAILING_SYNC_ENV_NAME, std::to_string(failing_sync).c_str(), 1);
+
+        dsp_device_params_t params = {
+            .driver = DSP_DRIVER_TYPE_EMULATOR,
+            .index = 0,
+            .path = nullptr,
+            .priority = priority,
+        };
+        m_status = dsp_create_device_ex(&params, &m_device);
+
+        unsetenv(EMULATOR_LATENCY_ENV_NAME);
+        unsetenv(EMULATOR_NOOP_ENV_NAME);
+        unsetenv(EMULATOR_FAILING_SYNC_ENV_NAME);
+    }
+
+    ~EmulatorDevice()
+    {
+        if (m_status == DSP_SUCCESS) {
+            (void)dsp_release_device(m_device);
+        }
+    }
+
+    EmulatorDevice(const EmulatorDevice &) = delete;
+    EmulatorDevice &operator=(const EmulatorDevice &) = delete;
+
+    dsp_status status() const { return m_status; }
+    operator dsp_device() const { return m_device; }
+
+   private:
+    dsp_status m_status;
+    dsp_device m_device = nullptr;
+};
+
+// Tightly packed USERPTR image in host memory
+class TestImage {
+   public:
+    TestImage(size_t width, size_t height, dsp_image_format_t format)
+    {
+        size_t planes_count = 0;
+        m_status = get_packed_image_layout(format, width, height, m_planes, planes_count);
+        for (size_t i = 0; i < planes_count; ++i) {
+            m_data[i].resize(m_planes[i].bytesused);
+            m_planes[i].userptr = m_data[i].data();
+        }
+
+        m_image = {
+            .width = width,
+            .height = height,
+            .planes = m_planes,
+            .planes_count = planes_count,
+            .format = format,
+            .memory = DSP_MEMORY_TYPE_USERPTR,
+        };
+    }
+
+    TestImage(const TestImage &other) : TestImage(other.m_image.width, other.m_image.height, other.m_image.format)
+    {
+        for (size_t i = 0; i < m_image.planes_count; ++i) {
+            m_data[i] = other.m_data[i];
+        }
+    }
+
+    TestImage &operator=(const TestImage &) = delete;
+
+    dsp_status status() const { return m_status; }
+    dsp_image_properties_t *get() { return &m_image; }
+    dsp_data_plane_t *planes() { return m_planes; }
+    size_t planes_count() const { return m_image.planes_count; }
+    std::vector<uint8_t> &plane(size_t index) { return m_data[index]; }
+    const std::vector<uint8_t> &plane(size_t index) const { return m_data[index]; }
+
+    void fill_random(unsigned seed)
+    {
+        std::mt19937 generator(seed);
+        for (size_t i = 0; i < m_image.planes_count; ++i) {
+            for (auto &byte : m_data[i]) {
+                byte = static_cast<uint8_t>(generator());
+            }
+        }
+    }
+
+    void fill(uint8_t value)
+    {
+        for (size_t i = 0; i < m_image.planes_count; ++i) {
+            std::fill(m_data[i].begin(), m_data[i].end(), value);
+        }
+    }
+
+    bool operator==(const TestImage &other) const
+    {
+        if (m_image.planes_count != other.m_image.planes_count) {
+            return false;
+        }
+        for (size_t i = 0; i < m_image.planes_count; ++i) {
+            if (m_data[i] != other.m_data[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Largest absolute difference between the pixels of the two images
+    int max_difference(const TestImage &other) const
+    {
+        int difference = 0;
+        for (size_t i = 0; i < m_image.planes_count; ++i) {
+            for (size_t j = 0; j < m_data[i].size(); ++j) {
+                difference = std::max(difference, std::abs(m_data[i][j] - other.m_data[i][j]));
+            }
+        }
+        return difference;
+    }
+
+   private:
+    dsp_status m_status;
+    dsp_data_plane_t m_planes[MAX_PLANES] = {};
+    std::vector<uint8_t> m_data[MAX_PLANES];
+    dsp_image_properties_t m_image;
+};
+
+// Packed copy of a USERPTR image of any line stride, such as the image of a persistent overlay
+inline TestImage copy_image(const dsp_image_properties_t &image)
+{
+    TestImage copy(image.width, image.height, image.format);
+    for (size_t i = 0; i < copy.planes_count(); ++i) {
+        const auto &src = image.planes[i];
+        const auto &dst = copy.planes()[i];
+        for (size_t row = 0; row < dst.bytesused / dst.bytesperline; ++row) {
+            memcpy(copy.plane(i).data() + row * dst.bytesperline,
+                   static_cast<const uint8_t *>(src.userptr) + row * src.bytesperline, dst.bytesperline);
+        }
+    }
+    return copy;
+}